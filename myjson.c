@@ -64,8 +64,70 @@
 // [SECTION] INCLUDES
 //-------------------------------------------------------------------------
 
+/* The io_uring system calls and MAP_POPULATE are GNU extensions. */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "myjson.h"
 
+#include <float.h>
+
+/* The x86 kernels are compiled with per-function target attributes and selected at runtime. */
+#ifndef MYJSON_X86_KERNELS
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) &&              \
+    (MYJSON_COMPILER_SINCE(GCC, 5, 0, 0) || MYJSON_COMPILER_SINCE(CLANG, 3, 9, 0) || \
+     MYJSON_COMPILER_SINCE(APPLE, 9, 0, 0) || MYJSON_COMPILER_SINCE(MSVC, 19, 14, 0))
+#define MYJSON_X86_KERNELS 1
+#else
+#define MYJSON_X86_KERNELS 0
+#endif
+#endif
+
+#if MYJSON_X86_KERNELS
+#include <immintrin.h>
+#if !MYJSON_COMPILER_IS(MSVC)
+#include <cpuid.h>
+#endif
+#endif
+
+#if MYJSON_COMPILER_IS(MSVC)
+#include <intrin.h>
+#endif
+
+/* Memory-mapped file input, and threads. */
+#include <errno.h>
+#if MYJSON_PLATFORM_IS(WINDOWS)
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+/* The read-ahead input uses io_uring (through the raw system calls) where the kernel headers have it. */
+#ifndef MYJSON_IO_URING
+#if MYJSON_PLATFORM_IS(LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define MYJSON_IO_URING 1
+#endif
+#endif
+#endif
+
+#ifndef MYJSON_IO_URING
+#define MYJSON_IO_URING 0
+#endif
+
+#if MYJSON_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
 #pragma region Internal
 
 //-------------------------------------------------------------------------
@@ -101,6 +163,48 @@
  */
 #define MYJSON_INPUT_BUFFER_SIZE (MYJSON_INPUT_RAW_BUFFER_SIZE * 3)
 
+/**
+ * @def MYJSON_READ_AHEAD_COUNT
+ * @brief The default number of chunks in flight of a read-ahead input.
+ * @note Default is 4.
+ */
+#define MYJSON_READ_AHEAD_COUNT 4
+
+/**
+ * @def MYJSON_READ_AHEAD_SIZE
+ * @brief The default size of the chunks of a read-ahead input.
+ * @note Default is 262144 [`2^18`].
+ */
+#define MYJSON_READ_AHEAD_SIZE 262144
+
+/**
+ * @def MYJSON_NDJSON_CHUNK_SIZE
+ * @brief The largest chunk of a parallel NDJSON input handed to a worker at once.
+ * @note Default is 1048576 [`2^20`]; smaller inputs are cut into smaller chunks, down to 1/16 of it.
+ */
+#define MYJSON_NDJSON_CHUNK_SIZE 1048576
+
+/**
+ * @def MYJSON_PARALLEL_PIECE_SIZE
+ * @brief The smallest piece of an array or object body loaded by a thread of its own.
+ * @note Default is 262144 [`2^18`]; smaller bodies are loaded by the calling thread.
+ */
+#define MYJSON_PARALLEL_PIECE_SIZE 262144
+
+/**
+ * @def MYJSON_POOL_SIZE
+ * @brief The number of parsers, and of emitters, kept by the pool of a thread.
+ * @note Default is 4.
+ */
+#define MYJSON_POOL_SIZE 4
+
+/**
+ * @def MYJSON_PAGE_SIZE
+ * @brief The alignment of the read-ahead chunks.
+ * @note Default is 4096 [`2^12`].
+ */
+#define MYJSON_PAGE_SIZE 4096
+
 /**
  * @def MYJSON_OUTPUT_RAW_BUFFER_SIZE
  * @brief The size of the output raw buffer.
@@ -119,9 +223,16 @@
 /**
  * @def MYJSON_MAX_NUMBER_LENGTH
  * @brief Maximum length for JSON number values.
- * @note Default is 9.
+ * @note Default is 1024 [`2^10`]; numbers are decoded exactly at any length.
+ */
+#define MYJSON_MAX_NUMBER_LENGTH 1024
+
+/**
+ * @def MYJSON_DECIMAL_DIGITS
+ * @brief The number of significant digits kept by the exact number decoder.
+ * @note Default is 800; more digits only matter as a sticky rounding bit.
  */
-#define MYJSON_MAX_NUMBER_LENGTH 9
+#define MYJSON_DECIMAL_DIGITS 800
 
 /**
  * @def MYJSON_MAX_ARRAY_LENGTH
@@ -130,12 +241,464 @@
  */
 #define MYJSON_MAX_ARRAY_LENGTH 131072
 
-#define MYJSON_MALLOC(type) (type *)_myyaml_malloc(sizeof(type))
+#define MYJSON_MALLOC(allocator, type) (type *)_myjson_malloc((allocator), sizeof(type))
+
+/**
+ * @def MYJSON_INITIAL_STACK_SIZE
+ * @brief The initial size of the internal stacks and queues.
+ * @note Default is 16.
+ */
+#define MYJSON_INITIAL_STACK_SIZE 16
+
+/**
+ * @def MYJSON_ARENA_CHUNK_SIZE
+ * @brief The size of the first chunk of a document arena; the next ones double.
+ * @note Default is 4096 [`2^12`].
+ */
+#define MYJSON_ARENA_CHUNK_SIZE 4096
+
+/**
+ * @def MYJSON_ARENA_MAX_CHUNK_SIZE
+ * @brief The size the chunks of a document arena stop doubling at.
+ * @note Default is 1048576 [`2^20`]; a larger block still gets a chunk of its own.
+ */
+#define MYJSON_ARENA_MAX_CHUNK_SIZE 1048576
+
+/**
+ * @def MYJSON_ARENA_ALIGNMENT
+ * @brief The alignment of the items, pairs and packed values in a document arena.
+ * @note Default is 8, for the 64-bit packed values.
+ */
+#define MYJSON_ARENA_ALIGNMENT 8
+
+/**
+ * @def MYJSON_TOKEN_QUEUE_SIZE
+ * @brief The capacity of the tokens ring (one slot is kept free).
+ * @note Default is 16; the parser never looks more than two tokens ahead.
+ */
+#define MYJSON_TOKEN_QUEUE_SIZE 16
+
+/**
+ * @def MYJSON_STRUCTURAL_BLOCK_SIZE
+ * @brief The number of bytes classified at once by the structural indexer.
+ * @note Fixed at 64, one bit per byte of a 64-bit mask.
+ */
+#define MYJSON_STRUCTURAL_BLOCK_SIZE 64
+
+/**
+ * @def MYJSON_STRUCTURAL_INDEX_SIZE
+ * @brief The number of structural offsets indexed ahead of the scanner.
+ * @note Default is 4096 [`2^12`].
+ */
+#define MYJSON_STRUCTURAL_INDEX_SIZE 4096
+
+#define MYJSON_MEMORY_ERROR(context) \
+    ((context)->error.type = JSON_MEMORY_ERROR, (context)->error.message = "memory error", MYJSON_FAILURE)
+
+#define MYJSON_STACK_INIT(context, allocator, stack, type)                                                 \
+    (((stack).start = (type *)_myjson_malloc((allocator), MYJSON_INITIAL_STACK_SIZE * sizeof(*(stack).start))) \
+         ? ((stack).top = (stack).start, (stack).end = (stack).start + MYJSON_INITIAL_STACK_SIZE, MYJSON_SUCCESS) \
+         : MYJSON_MEMORY_ERROR(context))
+
+#define MYJSON_STACK_DEL(allocator, stack)                                                                  \
+    (_myjson_free((allocator), (stack).start, (char *)(stack).end - (char *)(stack).start),                 \
+     (stack).start = (stack).top = (stack).end = 0)
+
+#define MYJSON_STACK_EMPTY(stack) ((stack).start == (stack).top)
+
+#define MYJSON_PUSH(context, allocator, stack, value)                                                      \
+    (((stack).top != (stack).end ||                                                                        \
+      _myjson_stack_extend((allocator), (void **)&(stack).start, (void **)&(stack).top, (void **)&(stack).end)) \
+         ? (*((stack).top++) = value, MYJSON_SUCCESS)                                                      \
+         : MYJSON_MEMORY_ERROR(context))
+
+#define MYJSON_POP(context, stack) (*(--(stack).top))
+
+/* The stacks of the array and object nodes live in the arena of their document. */
+#define MYJSON_ARENA_STACK_INIT(context, document, stack, type)                                             \
+    (((stack).start = (type *)_myjson_arena_alloc((document), MYJSON_INITIAL_STACK_SIZE * sizeof(*(stack).start), \
+                                                  MYJSON_ARENA_ALIGNMENT))                                 \
+         ? ((stack).top = (stack).start, (stack).end = (stack).start + MYJSON_INITIAL_STACK_SIZE, MYJSON_SUCCESS) \
+         : MYJSON_MEMORY_ERROR(context))
+
+#define MYJSON_ARENA_PUSH(context, document, stack, value)                                                  \
+    (((stack).top != (stack).end ||                                                                        \
+      _myjson_arena_extend((document), (void **)&(stack).start, (void **)&(stack).top, (void **)&(stack).end)) \
+         ? (*((stack).top++) = value, MYJSON_SUCCESS)                                                      \
+         : MYJSON_MEMORY_ERROR(context))
+
+#define MYJSON_QUEUE_INIT(context, allocator, queue, type, size)                                           \
+    (((queue).start = (type *)_myjson_malloc((allocator), (size) * sizeof(*(queue).start)))                \
+         ? ((queue).head = (queue).tail = (queue).start, (queue).end = (queue).start + (size), MYJSON_SUCCESS) \
+         : MYJSON_MEMORY_ERROR(context))
+
+#define MYJSON_QUEUE_DEL(allocator, queue)                                                                  \
+    (_myjson_free((allocator), (queue).start, (char *)(queue).end - (char *)(queue).start),                 \
+     (queue).start = (queue).head = (queue).tail = (queue).end = 0)
+
+#define MYJSON_QUEUE_EMPTY(queue) ((queue).head == (queue).tail)
+
+/* The queues are fixed rings: a pointer wraps around from the end to the beginning. */
+#define MYJSON_QUEUE_NEXT(queue, pointer) ((pointer) + 1 == (queue).end ? (queue).start : (pointer) + 1)
+
+#define MYJSON_ENQUEUE(context, queue, value)                                                              \
+    ((MYJSON_QUEUE_NEXT(queue, (queue).tail) != (queue).head)                                              \
+         ? (*((queue).tail) = value, (queue).tail = MYJSON_QUEUE_NEXT(queue, (queue).tail), MYJSON_SUCCESS) \
+         : MYJSON_MEMORY_ERROR(context))
+
+#define MYJSON_DEQUEUE(context, queue)                                                                     \
+    (*((queue).head = MYJSON_QUEUE_NEXT(queue, (queue).head),                                              \
+       ((queue).head == (queue).start ? (queue).end : (queue).head) - 1))
+
+#define MYJSON_PEEK_TOKEN(parser) \
+    (((parser)->token_available || _myjson_parser_fetch_more_tokens(parser)) ? (parser)->tokens.head : NULL)
+
+#define MYJSON_SKIP_TOKEN(parser)                                                             \
+    ((parser)->token_available = 0, (parser)->tokens_parsed++,                                \
+     (parser)->token_line = (parser)->tokens.head->end_pos.line,                              \
+     (parser)->stream_end_produced = ((parser)->tokens.head->type == JSON_EOF_TOKEN),         \
+     (parser)->tokens.head = MYJSON_QUEUE_NEXT((parser)->tokens, (parser)->tokens.head))
+
+#define MYJSON_TAPE_WORD(type, payload) (((uint64_t)(type) << 56) | (uint64_t)(payload))
+#define MYJSON_TAPE_TYPE(word) ((JsonTapeType)((word) >> 56))
+#define MYJSON_TAPE_PAYLOAD(word) ((size_t)((word) & 0x00FFFFFFFFFFFFFFULL))
+
+#define MYJSON_MIN_POWER_OF_TEN -348 /**< The first power of ten of the Eisel-Lemire table. */
+#define MYJSON_MAX_POWER_OF_TEN 347  /**< The last power of ten of the Eisel-Lemire table. */
+
+#define MYJSON_SWAR_ONES 0x0101010101010101ULL
+#define MYJSON_SWAR_LOWS 0x7F7F7F7F7F7F7F7FULL
+#define MYJSON_SWAR_HIGHS 0x8080808080808080ULL
+
+/* The error classes of the UTF-8 lookup tables, one bit each (two classes share 0x40). */
+#define MYJSON_UTF8_TOO_SHORT 0x01      /**< A lead byte not followed by a continuation byte. */
+#define MYJSON_UTF8_TOO_LONG 0x02       /**< An ASCII byte followed by a continuation byte. */
+#define MYJSON_UTF8_OVERLONG_3 0x04     /**< E0 followed by 80..9F. */
+#define MYJSON_UTF8_TOO_LARGE 0x08      /**< F4 followed by 90..BF, or F5..FF. */
+#define MYJSON_UTF8_SURROGATE 0x10      /**< ED followed by A0..BF. */
+#define MYJSON_UTF8_OVERLONG_2 0x20     /**< C0 or C1. */
+#define MYJSON_UTF8_TOO_LARGE_1000 0x40 /**< F5..FF followed by 80..8F. */
+#define MYJSON_UTF8_OVERLONG_4 0x40     /**< F0 followed by 80..8F. */
+#define MYJSON_UTF8_TWO_CONTS 0x80      /**< Two continuation bytes in a row. */
+#define MYJSON_UTF8_CARRY (MYJSON_UTF8_TOO_SHORT | MYJSON_UTF8_TOO_LONG | MYJSON_UTF8_TWO_CONTS)
+
+#if MYJSON_COMPILER_IS(MSVC)
+#define MYJSON_TARGET(isa)
+#else
+#define MYJSON_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+#define MYJSON_CPU_SSE42 0x1  /**< SSE4.2 and POPCNT. */
+#define MYJSON_CPU_AVX2 0x2   /**< AVX2 with the YMM state enabled by the OS. */
+#define MYJSON_CPU_AVX512 0x4 /**< AVX-512F/BW with the ZMM state enabled by the OS. */
 
 //-----------------------------------------------------------------------------
 // [SECTION] Data Structures
 //-----------------------------------------------------------------------------
 
+/*
+ * The header in front of the string of a token or event, which is freed without its parser.
+ */
+typedef struct JsonStringHeader {
+    const JsonAllocator *allocator; /**< The allocator of the string. */
+    size_t size;                    /**< The size of the block, header included. */
+} JsonStringHeader;
+
+/*
+ * The classification of a 64-byte input block, one bit per byte.
+ */
+typedef struct JsonStructuralBlock {
+    uint64_t quote;      /**< The `"` characters. */
+    uint64_t backslash;  /**< The `\` characters. */
+    uint64_t whitespace; /**< The space, tab, line feed and carriage return characters. */
+    uint64_t op;         /**< The `{`, `}`, `[`, `]`, `:` and `,` characters. */
+} JsonStructuralBlock;
+
+/*
+ * A set of implementations of the hot routines for one instruction set.
+ */
+typedef struct JsonKernel {
+    JsonKernelType type; /**< The kernel type. */
+
+    /**
+     * Classify a 64-byte block and check that it continues the UTF-8 text
+     * ending with the 4 bytes of `previous` (the last one in the high byte).
+     * On success `previous` is updated with the end of the block.
+     */
+    int (*classify_block)(const JsonChar_t *block, JsonStructuralBlock *masks, uint32_t *previous);
+
+    /** Get the offset of the first invalid UTF-8 sequence, or `length`. */
+    size_t (*validate_utf8)(const JsonChar_t *string, size_t length);
+
+    /** Get the offset of the first `"`, `\` or control character, or `length`. */
+    size_t (*scan_string)(const JsonChar_t *string, size_t length);
+
+    /** Count the line feeds, and the characters after the last one in `tail`. */
+    size_t (*count_newlines)(const JsonChar_t *string, size_t length, size_t *tail);
+
+    /** Copy the leading ASCII characters of `count` UTF-16 code units to `output`, and get their number. */
+    size_t (*narrow_utf16)(const unsigned char *string, size_t count, int big_endian, JsonChar_t *output);
+
+    /** Copy the leading ASCII characters of `count` UTF-32 code units to `output`, and get their number. */
+    size_t (*narrow_utf32)(const unsigned char *string, size_t count, int big_endian, JsonChar_t *output);
+
+    /** Write the leading ASCII characters of a UTF-8 text as UTF-16 code units, and get their number. */
+    size_t (*widen_utf16)(const JsonChar_t *string, size_t length, int big_endian, unsigned char *output);
+
+    /** Write the leading ASCII characters of a UTF-8 text as UTF-32 code units, and get their number. */
+    size_t (*widen_utf32)(const JsonChar_t *string, size_t length, int big_endian, unsigned char *output);
+} JsonKernel;
+
+/*
+ * A thread running `routine(data)`.
+ */
+typedef struct JsonThread {
+#if MYJSON_PLATFORM_IS(WINDOWS)
+    HANDLE handle; /**< The thread handle. */
+#else
+    pthread_t handle; /**< The thread handle. */
+#endif
+    void (*routine)(void *data); /**< The thread routine. */
+    void *data;                  /**< The argument of the routine. */
+} JsonThread;
+
+#if MYJSON_PLATFORM_IS(WINDOWS)
+typedef SRWLOCK JsonMutex;
+typedef CONDITION_VARIABLE JsonCondition;
+#else
+typedef pthread_mutex_t JsonMutex;
+typedef pthread_cond_t JsonCondition;
+#endif
+
+/*
+ * A chunk of a read-ahead input.
+ */
+typedef struct JsonReadAheadChunk {
+    unsigned char *start; /**< The chunk buffer (page-aligned). */
+    uint64_t offset;      /**< The file offset of the buffer (io_uring). */
+    size_t size;          /**< The number of bytes requested. */
+    size_t length;        /**< The number of bytes read. */
+    size_t pointer;       /**< The number of bytes handed to the parser. */
+    int done;             /**< Has the read completed (io_uring)? */
+    int error;            /**< Has the read failed? */
+#if MYJSON_IO_URING
+    struct iovec vector; /**< The read request. */
+#endif
+} JsonReadAheadChunk;
+
+#if MYJSON_IO_URING
+/*
+ * An io_uring instance, mapped without liburing.
+ */
+typedef struct JsonRing {
+    int fd; /**< The ring file descriptor. */
+
+    unsigned *sq_head;         /**< The submission queue head (moved by the kernel). */
+    unsigned *sq_tail;         /**< The submission queue tail. */
+    unsigned *sq_mask;         /**< The submission queue mask. */
+    unsigned *sq_array;        /**< The submission queue indices. */
+    struct io_uring_sqe *sqes; /**< The submission queue entries. */
+
+    unsigned *cq_head;         /**< The completion queue head. */
+    unsigned *cq_tail;         /**< The completion queue tail (moved by the kernel). */
+    unsigned *cq_mask;         /**< The completion queue mask. */
+    struct io_uring_cqe *cqes; /**< The completion queue entries. */
+
+    void *sq_ring;       /**< The submission queue mapping. */
+    size_t sq_ring_size; /**< The size of the submission queue mapping. */
+    void *cq_ring;       /**< The completion queue mapping (may be the submission one). */
+    size_t cq_ring_size; /**< The size of the completion queue mapping. */
+    size_t sqes_size;    /**< The size of the submission queue entries mapping. */
+} JsonRing;
+#endif
+
+/*
+ * The private state of a read-ahead input.
+ *
+ * Chunk `k` of the input is read into `chunks[k % count]`, until it is handed
+ * to the parser and chunk `k + count` can take its place.
+ */
+typedef struct JsonReadAheadState {
+    unsigned char *memory;      /**< The chunk buffers (unaligned). */
+    JsonReadAheadChunk *chunks; /**< The chunks. */
+    size_t current;             /**< The chunk being handed to the parser. */
+    size_t submitted;           /**< The number of chunks submitted (io_uring) or read (thread). */
+    int eof;                    /**< Has the parser reached the end of the input? */
+
+    const JsonAllocator *allocator; /**< The allocator of the state, its memory and chunks. */
+
+    JsonThread thread;       /**< The reading thread. */
+    JsonMutex mutex;         /**< The lock of `current`, `submitted` and `stop`. */
+    JsonCondition condition; /**< Signalled when a chunk is read or released. */
+    int stop;                /**< Should the thread stop? */
+
+#if MYJSON_IO_URING
+    JsonRing ring;  /**< The io_uring instance. */
+    size_t pending; /**< The number of reads in flight. */
+    uint64_t base;  /**< The file offset of the first chunk. */
+#endif
+} JsonReadAheadState;
+
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
+/*
+ * A document of a parallel NDJSON input, waiting for its turn.
+ */
+typedef struct JsonNdjsonDocument {
+    JsonDocument document; /**< The document. */
+    size_t offset;         /**< The offset of the document in the input. */
+} JsonNdjsonDocument;
+
+/*
+ * A chunk of whole lines of a parallel NDJSON input.
+ */
+typedef struct JsonNdjsonChunk {
+    const unsigned char *start; /**< The beginning of the chunk. */
+    size_t size;                /**< The length of the chunk. */
+
+    /** The documents of the chunk, kept until it is its turn (ordered delivery). */
+    struct {
+        JsonNdjsonDocument *start; /**< The beginning of the stack. */
+        JsonNdjsonDocument *end;   /**< The end of the stack. */
+        JsonNdjsonDocument *top;   /**< The top of the stack. */
+    } documents;
+
+    int done;  /**< Has the chunk been parsed? */
+    int error; /**< Did the chunk fail? */
+} JsonNdjsonChunk;
+
+/*
+ * A worker of a parallel NDJSON parse, with its own parser.
+ *
+ * The worker owns the chunks `index`, `index + count`, `index + 2 * count`...
+ * of its pool: it takes them from the front, and the idle workers steal them
+ * from the back.
+ */
+typedef struct JsonNdjsonWorker {
+    struct JsonNdjsonPool *pool; /**< The pool of the worker. */
+    size_t index;                /**< The worker number. */
+    JsonParser parser;           /**< The parser, reset for every chunk. */
+    JsonThread thread;           /**< The worker thread (not for the calling thread). */
+    int started;                 /**< Has the thread been started? */
+
+    JsonMutex mutex; /**< The lock of `head` and `tail`. */
+    size_t head;     /**< The first chunk left (as a multiple of the worker count). */
+    size_t tail;     /**< The end of the chunks left (as a multiple of the worker count). */
+} JsonNdjsonWorker;
+
+/*
+ * The shared state of a parallel NDJSON parse.
+ */
+typedef struct JsonNdjsonPool {
+    JsonNdjsonChunk *chunks;   /**< The chunks. */
+    size_t count;              /**< The number of chunks. */
+    size_t capacity;           /**< The number of chunks allocated. */
+    JsonNdjsonWorker *workers; /**< The workers. */
+    size_t worker_count;       /**< The number of workers. */
+
+    const JsonAllocator *allocator; /**< The allocator of the chunks, workers and their parsers. */
+
+    JsonDocumentHandler *handler; /**< The document handler. */
+    void *handler_data;           /**< A pointer for passing to the document handler. */
+    int ordered;                  /**< Are the documents delivered in the input order? */
+
+    JsonMutex mutex; /**< The lock of the handler calls, `next`, `done` and `stop`. */
+    size_t next;     /**< The next chunk to deliver (ordered delivery). */
+    int stop;        /**< Has a chunk failed, or the handler stopped the parse? */
+} JsonNdjsonPool;
+
+/*
+ * A piece of an array or object body, between two of its separators, loaded on its own.
+ *
+ * The piece is loaded into a document whose root node is a stand-in for the
+ * array or object; its positions are relative to the beginning of the piece.
+ */
+typedef struct JsonPiece {
+    JsonChar_t *start;     /**< The beginning of the piece (after the bracket, or at a separator). */
+    size_t size;           /**< The length of the piece (up to the next separator, or the closing bracket). */
+    JsonDocument document; /**< The loaded nodes. */
+    JsonPosition end_pos;  /**< The end of the piece (relative to its beginning). */
+    int loaded;            /**< Has the piece been loaded? */
+
+    JsonPosition base;  /**< The beginning of the piece in the input. */
+    size_t node_offset; /**< The place of the nodes of the piece in the document. */
+    size_t item_offset; /**< The place of the items (or pairs) of the piece in the body. */
+} JsonPiece;
+
+/*
+ * The shared state of the threads loading the pieces of a body.
+ */
+typedef struct JsonPieceWork {
+    JsonPiece *pieces;   /**< The pieces. */
+    size_t count;        /**< The number of pieces. */
+    size_t thread_count; /**< The number of threads, the calling one included. */
+    JsonValueType type;  /**< The type of the body (@c JSON_ARRAY or @c JSON_OBJECT). */
+    int in_situ;         /**< May the strings be unescaped in place? */
+    int pack_flags;      /**< The packing flags of the pieces. */
+
+    JsonDocument *document; /**< The document, once the pieces are loaded. */
+    int node_id;            /**< The body node. */
+    int moving;             /**< Are the pieces moved to the document (rather than loaded)? */
+
+    const JsonAllocator *allocator; /**< The allocator of the parser, used by every thread. */
+
+    JsonMutex mutex; /**< The lock of `next` and `failed`. */
+    size_t next;     /**< The next piece to load. */
+    int failed;      /**< Has a piece failed? */
+} JsonPieceWork;
+
+/*
+ * An array or object entered by a query, with the steps reaching it.
+ */
+typedef struct JsonQueryFrame {
+    size_t first; /**< The first step reaching the container (in the steps reached). */
+    size_t last;  /**< The end of the steps reaching the container. */
+    size_t index; /**< The index of the next item (of an array). */
+    int object;   /**< Is the container an object? */
+    int node_id;  /**< The container node (of a projection). */
+} JsonQueryFrame;
+
+/*
+ * The state of a query run over the events of a parser.
+ */
+typedef struct JsonQueryRun {
+    JsonParser *parser;        /**< The parser. */
+    JsonQuery *query;          /**< The query. */
+    JsonQueryHandler *handler; /**< The match handler. */
+    void *handler_data;        /**< A pointer for passing to the match handler. */
+    JsonDocument *document;    /**< The projection loaded, or NULL to hand the matches to the handler. */
+    JsonEvent key;             /**< The key of the coming member of a projection, until its value is kept or skipped. */
+
+    /** The steps reaching the containers entered, then the value coming next. */
+    struct {
+        size_t *start; /** The beginning of the stack. */
+        size_t *end;   /** The end of the stack. */
+        size_t *top;   /** The top of the stack. */
+    } reached;
+
+    /** The containers entered. */
+    struct {
+        JsonQueryFrame *start; /** The beginning of the stack. */
+        JsonQueryFrame *end;   /** The end of the stack. */
+        JsonQueryFrame *top;   /** The top of the stack. */
+    } frames;
+} JsonQueryRun;
+
+#endif  // MYJSON_DISABLE_READER
+
+/*
+ * An arbitrary precision decimal number, for the exact number decoder.
+ */
+typedef struct JsonDecimal {
+    int count;     /**< The number of digits. */
+    int point;     /**< The position of the decimal point in the digits. */
+    int negative;  /**< Is the number negative? */
+    int truncated; /**< Were non-zero digits dropped? */
+
+    /** The digits (not characters), with room for a left shift. */
+    unsigned char digits[MYJSON_DECIMAL_DIGITS + 20];
+} JsonDecimal;
+
 //-----------------------------------------------------------------------------
 // [SECTION] C Only Functions
 //-----------------------------------------------------------------------------
@@ -154,451 +717,10910 @@ extern "C" {
 // [SECTION] Memory Management
 //-----------------------------------------------------------------------------
 
+/*
+ * The default allocator functions (malloc, realloc and free).
+ */
+static void *_myjson_default_allocate(void *data, size_t size);
+static void *_myjson_default_reallocate(void *data, void *pointer, size_t old_size, size_t size);
+static void _myjson_default_deallocate(void *data, void *pointer, size_t size);
+
 /*
  * Allocate a dynamic memory block.
  */
-void *_myjson_malloc(size_t size);
+void *_myjson_malloc(const JsonAllocator *allocator, size_t size);
+
+/*
+ * Reallocate a dynamic memory block of `old_size` bytes.
+ */
+void *_myjson_realloc(const JsonAllocator *allocator, void *ptr, size_t old_size, size_t size);
+
+/*
+ * Free a dynamic memory block of `size` bytes.
+ */
+void _myjson_free(const JsonAllocator *allocator, void *ptr, size_t size);
+
+/*
+ * Allocate the string of a token or event, which keeps its allocator and size (it is freed without its parser).
+ */
+static JsonChar_t *_myjson_string_malloc(const JsonAllocator *allocator, size_t size);
 
 /*
- * Reallocate a dynamic memory block.
+ * Free the string of a token or event.
  */
-void *_myjson_realloc(void *ptr, size_t size);
+static void _myjson_string_free(JsonChar_t *string);
 
 /*
- * Free a dynamic memory block.
+ * Double the size of a stack.
  */
-void _myjson_free(void *ptr);
+static int _myjson_stack_extend(const JsonAllocator *allocator, void **start, void **top, void **end);
 
 #if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
 
-//-----------------------------------------------------------------------------
-// [SECTION] Parser
-//-----------------------------------------------------------------------------
+/*
+ * Extend a stack to hold at least `size` bytes.
+ */
+static int _myjson_stack_reserve(const JsonAllocator *allocator, void **start, void **top, void **end, size_t size);
+
+#endif  // MYJSON_DISABLE_READER
 
 /*
- * String read handler.
+ * Allocate `size` bytes from the arena of a document, aligned to `alignment`.
  */
-static int _myjson_string_read_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read);
+static void *_myjson_arena_alloc(JsonDocument *document, size_t size, size_t alignment);
 
 /*
- * File read handler.
+ * Start a new chunk of at least `size` bytes in the arena of a document.
  */
-static int _myjson_file_read_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read);
+static int _myjson_arena_grow(JsonDocument *document, size_t size);
+
+/*
+ * Double the size of a stack kept in the arena of a document.
+ */
+static int _myjson_arena_extend(JsonDocument *document, void **start, void **top, void **end);
+
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
+/*
+ * Extend a stack kept in the arena of a document to hold at least `size` bytes.
+ */
+static int _myjson_arena_reserve(JsonDocument *document, void **start, void **top, void **end, size_t size);
+
+/*
+ * Hand the chunks of the arena of a document over to another document.
+ */
+static void _myjson_arena_adopt(JsonDocument *document, JsonDocument *source);
 
 #endif  // MYJSON_DISABLE_READER
 
-#if !defined(MYJSON_DISABLE_WRITER) || !MYJSON_DISABLE_WRITER
+/*
+ * Free a list of arena chunks.
+ */
+static void _myjson_arena_free(const JsonAllocator *allocator, JsonArenaChunk *chunk);
 
 //-----------------------------------------------------------------------------
-// [SECTION] Emitter
+// [SECTION] Threads
 //-----------------------------------------------------------------------------
 
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
 /*
- * String write handler.
+ * Start a thread running `routine(data)`.
  */
-static int _myjson_string_write_handler(void *data, unsigned char *buffer, size_t size);
+static int _myjson_thread_create(JsonThread *thread, void (*routine)(void *data), void *data);
 
 /*
- * File write handler.
+ * Wait for a thread to finish.
  */
-static int _myjson_file_write_handler(void *data, unsigned char *buffer, size_t size);
+static void _myjson_thread_join(JsonThread *thread);
 
-#endif  // MYJSON_DISABLE_WRITER
+/*
+ * Initialize, lock, unlock and destroy a mutex.
+ */
+static int _myjson_mutex_initialize(JsonMutex *mutex);
+static void _myjson_mutex_lock(JsonMutex *mutex);
+static void _myjson_mutex_unlock(JsonMutex *mutex);
+static void _myjson_mutex_delete(JsonMutex *mutex);
 
-#pragma endregion  // C Declarations
+/*
+ * Initialize, wait on, wake the waiters of, and destroy a condition variable.
+ */
+static int _myjson_condition_initialize(JsonCondition *condition);
+static void _myjson_condition_wait(JsonCondition *condition, JsonMutex *mutex);
+static void _myjson_condition_broadcast(JsonCondition *condition);
+static void _myjson_condition_delete(JsonCondition *condition);
 
-#pragma region C Def
+/*
+ * Get the number of online processors.
+ */
+static size_t _myjson_processor_count(void);
+
+#endif  // MYJSON_DISABLE_READER
 
 //-----------------------------------------------------------------------------
-// [SECTION] Definations
+// [SECTION] Atomics
 //-----------------------------------------------------------------------------
 
-void *_myjson_malloc(size_t size) { return malloc(size ? size : 1); };
-
-void *_myjson_realloc(void *ptr, size_t size) { return ptr ? realloc(ptr, size ? size : 1) : malloc(size ? size : 1); };
-
-void _myjson_free(void *ptr) {
-    if (ptr) {
-        free(ptr);
-    }
-};
+/*
+ * Load a word shared between threads (acquire).
+ */
+static MYJSON_INLINE int _myjson_atomic_load(volatile int *value);
 
-#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+/*
+ * Store a word shared between threads (release).
+ */
+static MYJSON_INLINE void _myjson_atomic_store(volatile int *value, int desired);
 
-#pragma region Reader
+/*
+ * Replace a word shared between threads if it still holds `expected`.
+ */
+static MYJSON_INLINE int _myjson_atomic_compare_exchange(volatile int *value, int expected, int desired);
 
 //-----------------------------------------------------------------------------
-// [SECTION] Parser
+// [SECTION] Kernels
 //-----------------------------------------------------------------------------
 
 /*
- * String read handler.
+ * Load 8 bytes as a little-endian word.
  */
-static int _myjson_string_read_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read) {
-    JsonParser *parser = (JsonParser *)data;
+static MYJSON_INLINE uint64_t _myjson_load_u64(const JsonChar_t *bytes);
 
-    if (parser->input.string.current == parser->input.string.end) {
-        *size_read = 0;
-        return MYJSON_SUCCESS;
-    }
+/*
+ * Set the high bit of every byte of `word` equal to `c`.
+ */
+static MYJSON_INLINE uint64_t _myjson_swar_eq(uint64_t word, uint64_t c);
 
-    if (size > (size_t)(parser->input.string.end - parser->input.string.current)) {
-        size = parser->input.string.end - parser->input.string.current;
-    }
+/*
+ * Set the high bit of the lowest byte of `word` less than `c` (bytes above it may be set too).
+ */
+static MYJSON_INLINE uint64_t _myjson_swar_lt(uint64_t word, uint64_t c);
 
-    memcpy(buffer, parser->input.string.current, size);
-    parser->input.string.current += size;
-    *size_read = size;
+/*
+ * Gather the high bits of the bytes of a word into an 8-bit mask.
+ */
+static MYJSON_INLINE uint64_t _myjson_swar_movemask(uint64_t highs);
 
-    return MYJSON_SUCCESS;
-};
+/*
+ * Count the trailing zero bits of a non-zero mask.
+ */
+static MYJSON_INLINE int _myjson_trailing_zeroes(uint64_t bits);
 
 /*
- * File read handler.
+ * Count the leading zero bits of a non-zero mask.
  */
-static int _myjson_file_read_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read) {
-    JsonParser *parser = (JsonParser *)data;
+static MYJSON_INLINE int _myjson_leading_zeroes(uint64_t bits);
 
-    *size_read = fread(buffer, 1, size, parser->input.file);
-    return !ferror(parser->input.file);
-};
+/*
+ * Count the set bits of a mask.
+ */
+static MYJSON_INLINE int _myjson_popcount(uint64_t bits);
 
-#pragma endregion  // Reader
+/*
+ * Get the length of the UTF-8 sequence at `string`, or 0 if it is invalid or truncated.
+ */
+static size_t _myjson_utf8_sequence_length(const JsonChar_t *string, size_t length);
 
-#endif  // MYJSON_DISABLE_READER
+/*
+ * Get the number of bytes of the sequence left open by the last 4 bytes of a valid text.
+ */
+static MYJSON_INLINE size_t _myjson_utf8_pending(uint32_t previous);
 
-#if !defined(MYJSON_DISABLE_WRITER) || !MYJSON_DISABLE_WRITER
+/*
+ * Check a 64-byte block with the UTF-8 lookup tables, one byte at a time.
+ */
+static int _myjson_utf8_check_fallback(const JsonChar_t *block, uint32_t *previous);
 
-#pragma region Writer
+/*
+ * Decode the valid UTF-8 sequence of `width` bytes at `string`.
+ */
+static MYJSON_INLINE unsigned int _myjson_utf8_decode(const JsonChar_t *string, size_t width);
 
-//-----------------------------------------------------------------------------
-// [SECTION] Emitter
-//-----------------------------------------------------------------------------
+/*
+ * Encode a code point as UTF-8 and get the number of bytes written.
+ */
+static MYJSON_INLINE size_t _myjson_utf8_encode(unsigned int code, JsonChar_t *output);
 
 /*
- * String write handler.
+ * Read a UTF-16 or UTF-32 code unit of `width` bytes.
  */
-static int _myjson_string_write_handler(void *data, unsigned char *buffer, size_t size) {
-    JsonEmitter *emitter = (JsonEmitter *)data;
+static MYJSON_INLINE unsigned int _myjson_load_unit(const unsigned char *string, size_t width, int big_endian);
+
+/*
+ * Write a UTF-16 or UTF-32 code unit of `width` bytes.
+ */
+static MYJSON_INLINE void _myjson_store_unit(unsigned char *output, unsigned int unit, size_t width, int big_endian);
+
+/*
+ * The portable (SWAR) kernel.
+ */
+static int _myjson_classify_block_fallback(const JsonChar_t *block, JsonStructuralBlock *masks, uint32_t *previous);
+static size_t _myjson_validate_utf8_fallback(const JsonChar_t *string, size_t length);
+static size_t _myjson_scan_string_fallback(const JsonChar_t *string, size_t length);
+static size_t _myjson_count_newlines_fallback(const JsonChar_t *string, size_t length, size_t *tail);
+static size_t _myjson_narrow_utf16_fallback(const unsigned char *string, size_t count, int big_endian,
+                                            JsonChar_t *output);
+static size_t _myjson_narrow_utf32_fallback(const unsigned char *string, size_t count, int big_endian,
+                                            JsonChar_t *output);
+static size_t _myjson_widen_utf16_fallback(const JsonChar_t *string, size_t length, int big_endian,
+                                           unsigned char *output);
+static size_t _myjson_widen_utf32_fallback(const JsonChar_t *string, size_t length, int big_endian,
+                                           unsigned char *output);
+
+#if MYJSON_X86_KERNELS
+
+/*
+ * The SSE4.2 kernel.
+ */
+static MYJSON_TARGET("sse4.2,popcnt") int _myjson_utf8_check_sse42(const __m128i *input, uint32_t *previous);
+static MYJSON_TARGET("sse4.2,popcnt") int _myjson_classify_block_sse42(const JsonChar_t *block,
+                                                                       JsonStructuralBlock *masks, uint32_t *previous);
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_validate_utf8_sse42(const JsonChar_t *string, size_t length);
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_scan_string_sse42(const JsonChar_t *string, size_t length);
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_count_newlines_sse42(const JsonChar_t *string, size_t length,
+                                                                          size_t *tail);
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_narrow_utf16_sse42(const unsigned char *string, size_t count,
+                                                                        int big_endian, JsonChar_t *output);
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_narrow_utf32_sse42(const unsigned char *string, size_t count,
+                                                                        int big_endian, JsonChar_t *output);
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_widen_utf16_sse42(const JsonChar_t *string, size_t length,
+                                                                       int big_endian, unsigned char *output);
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_widen_utf32_sse42(const JsonChar_t *string, size_t length,
+                                                                       int big_endian, unsigned char *output);
+
+/*
+ * The AVX2 kernel.
+ */
+static MYJSON_TARGET("avx2,popcnt") int _myjson_utf8_check_avx2(const __m256i *input, uint32_t *previous);
+static MYJSON_TARGET("avx2,popcnt") int _myjson_classify_block_avx2(const JsonChar_t *block, JsonStructuralBlock *masks,
+                                                                    uint32_t *previous);
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_validate_utf8_avx2(const JsonChar_t *string, size_t length);
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_scan_string_avx2(const JsonChar_t *string, size_t length);
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_count_newlines_avx2(const JsonChar_t *string, size_t length,
+                                                                       size_t *tail);
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_narrow_utf16_avx2(const unsigned char *string, size_t count,
+                                                                     int big_endian, JsonChar_t *output);
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_narrow_utf32_avx2(const unsigned char *string, size_t count,
+                                                                     int big_endian, JsonChar_t *output);
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_widen_utf16_avx2(const JsonChar_t *string, size_t length,
+                                                                    int big_endian, unsigned char *output);
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_widen_utf32_avx2(const JsonChar_t *string, size_t length,
+                                                                    int big_endian, unsigned char *output);
+
+/*
+ * The AVX-512BW kernel.
+ */
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") int _myjson_utf8_check_avx512(__m512i input, uint32_t *previous);
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") int _myjson_classify_block_avx512(const JsonChar_t *block,
+                                                                                  JsonStructuralBlock *masks,
+                                                                                  uint32_t *previous);
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_validate_utf8_avx512(const JsonChar_t *string,
+                                                                                    size_t length);
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_scan_string_avx512(const JsonChar_t *string,
+                                                                                   size_t length);
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_count_newlines_avx512(const JsonChar_t *string,
+                                                                                      size_t length, size_t *tail);
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_narrow_utf16_avx512(const unsigned char *string,
+                                                                                   size_t count, int big_endian,
+                                                                                   JsonChar_t *output);
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_narrow_utf32_avx512(const unsigned char *string,
+                                                                                   size_t count, int big_endian,
+                                                                                   JsonChar_t *output);
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_widen_utf16_avx512(const JsonChar_t *string,
+                                                                                  size_t length, int big_endian,
+                                                                                  unsigned char *output);
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_widen_utf32_avx512(const JsonChar_t *string,
+                                                                                  size_t length, int big_endian,
+                                                                                  unsigned char *output);
+
+/*
+ * Detect the CPU features usable by the kernels (MYJSON_CPU_* flags).
+ */
+static int _myjson_cpu_features(void);
+
+#endif  // MYJSON_X86_KERNELS
+
+/*
+ * Find a compiled kernel by type.
+ */
+static const JsonKernel *_myjson_kernel_find(JsonKernelType type);
+
+/*
+ * Get the kernel for a new parser or emitter: the forced one, the one named
+ * by MYJSON_KERNEL, or the best one supported by the CPU.
+ */
+static const JsonKernel *_myjson_kernel_resolve(void);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Strings
+//-----------------------------------------------------------------------------
+
+/*
+ * Decode the 4 hexadecimal digits of a `\u` escape sequence.
+ */
+static int _myjson_parse_hex4(const JsonChar_t *digits, unsigned int *code);
+
+/*
+ * Decode the escape sequences of a string body into `value`, or only check
+ * them if `value` is NULL.  Returns the problem (and its offset) on error.
+ */
+static const char *_myjson_unescape(const JsonKernel *kernel, const JsonChar_t *string, size_t length,
+                                    JsonChar_t *value, size_t *value_length, size_t *problem_offset);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Atoms
+//-----------------------------------------------------------------------------
+
+/*
+ * Hash a string (FNV-1a).
+ */
+static uint32_t _myjson_atom_hash(const JsonChar_t *value, size_t length);
+
+/*
+ * Find the slot of a string in the hash index of an atom table: its atom, or the free slot to put it in.
+ */
+static int *_myjson_atom_table_slot(const JsonAtomTable *table, const JsonChar_t *value, size_t length,
+                                    uint32_t hash);
+
+/*
+ * Double the hash index of an atom table.
+ */
+static int _myjson_atom_table_grow(JsonAtomTable *table);
+
+/*
+ * Copy a string into the chunks of an atom table, where it never moves.
+ */
+static JsonChar_t *_myjson_atom_table_store(JsonAtomTable *table, const JsonChar_t *value, size_t length);
+
+/*
+ * Get the entry of an atom in the key map of a document, extending the map as needed.
+ */
+static int *_myjson_document_key_node(JsonDocument *document, int atom);
+
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
+//-----------------------------------------------------------------------------
+// [SECTION] Numbers
+//-----------------------------------------------------------------------------
+
+/*
+ * Check if the next 8 characters are all digits.
+ */
+static MYJSON_INLINE int _myjson_is_eight_digits(const JsonChar_t *digits);
+
+/*
+ * Convert 8 digits to their value at once (SWAR).
+ */
+static MYJSON_INLINE uint32_t _myjson_parse_eight_digits(const JsonChar_t *digits);
+
+/*
+ * Multiply two 64-bit words into a 128-bit product; return the low word.
+ */
+static MYJSON_INLINE uint64_t _myjson_multiply(uint64_t a, uint64_t b, uint64_t *high);
+
+/*
+ * Compute the double nearest to `mantissa * 10^exponent` with the Eisel-Lemire
+ * algorithm; return 0 if it cannot decide the rounding.
+ */
+static int _myjson_eisel_lemire(uint64_t mantissa, int exponent, int negative, double *value);
+
+/*
+ * Read a decimal number from its (valid) text.
+ */
+static void _myjson_decimal_assign(JsonDecimal *decimal, const JsonChar_t *number, size_t length);
+
+/*
+ * Drop the trailing zeros of a decimal number.
+ */
+static void _myjson_decimal_trim(JsonDecimal *decimal);
+
+/*
+ * Multiply a decimal number by `2^shift`, for a shift of at most 60.
+ */
+static void _myjson_decimal_left_shift(JsonDecimal *decimal, int shift);
+
+/*
+ * Divide a decimal number by `2^shift`, for a shift of at most 60.
+ */
+static void _myjson_decimal_right_shift(JsonDecimal *decimal, int shift);
+
+/*
+ * Multiply a decimal number by `2^shift` (divide if negative).
+ */
+static void _myjson_decimal_shift(JsonDecimal *decimal, int shift);
+
+/*
+ * Get the integer part of a decimal number, rounded half to even.
+ */
+static uint64_t _myjson_decimal_rounded_integer(JsonDecimal *decimal);
+
+/*
+ * Convert a decimal number to the nearest double (the exact slow path).
+ */
+static double _myjson_decimal_to_double(JsonDecimal *decimal);
+
+/*
+ * Check a number against the JSON grammar and decode its value.
+ */
+static int _myjson_parse_number(const JsonChar_t *number, size_t length, JsonValueType *type, JsonNumber *value,
+                                int *flags);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Parser
+//-----------------------------------------------------------------------------
+
+/*
+ * String read handler.
+ */
+static int _myjson_string_read_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read);
+
+/*
+ * File read handler.
+ */
+static int _myjson_file_read_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read);
+
+/*
+ * Map a file read-only and set it as the parser input.
+ */
+static int _myjson_parser_map_file(JsonParser *parser, int fd, int flags);
+
+/*
+ * Unmap the input file.
+ */
+static void _myjson_parser_unmap_file(JsonParser *parser);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Reader
+//-----------------------------------------------------------------------------
+
+/*
+ * Set the reader error (at a byte offset of the input) and return 0.
+ */
+static int _myjson_parser_set_reader_error(JsonParser *parser, const char *problem, size_t offset);
+
+/*
+ * Detect the encoding of an input from its byte order mark (`bom` is set to
+ * its length), or from the zero bytes around its first two ASCII characters.
+ */
+static JsonEncoding _myjson_detect_encoding(const unsigned char *string, size_t length, size_t *bom);
+
+/*
+ * Allocate the buffers, determine the input encoding and skip the byte order mark.
+ */
+static int _myjson_parser_determine_encoding(JsonParser *parser);
+
+/*
+ * Call the read handler, and set the EOF flag when it returns no bytes.
+ */
+static int _myjson_parser_read(JsonParser *parser, unsigned char *buffer, size_t size, size_t *size_read);
+
+/*
+ * Update the raw buffer.
+ */
+static int _myjson_parser_update_raw_buffer(JsonParser *parser);
+
+/*
+ * Is the whole input decoded into the working buffer?
+ */
+static int _myjson_parser_drained(JsonParser *parser);
+
+/*
+ * Discard the scanned characters at the beginning of the working buffer.
+ */
+static void _myjson_parser_shift_buffer(JsonParser *parser);
+
+/*
+ * Transcode the UTF-16 or UTF-32 raw buffer into the working buffer.
+ */
+static int _myjson_parser_decode_raw_buffer(JsonParser *parser);
+
+/*
+ * Ensure that the working buffer contains at least `length` unread characters.
+ */
+static int _myjson_parser_update_buffer(JsonParser *parser, size_t length);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Read Ahead
+//-----------------------------------------------------------------------------
+
+/*
+ * The reading thread of a read-ahead input: read the chunks in order, one read each.
+ */
+static void _myjson_read_ahead_run(void *data);
+
+/*
+ * Wait for the chunk being handed to the parser to be read.
+ */
+static int _myjson_read_ahead_wait(JsonReadAhead *reader, JsonReadAheadChunk *chunk);
+
+/*
+ * Release the chunk handed to the parser, and read the next one in its place.
+ */
+static int _myjson_read_ahead_release(JsonReadAhead *reader, JsonReadAheadChunk *chunk);
+
+#if MYJSON_IO_URING
+
+/*
+ * Set up an io_uring instance with `entries` entries.
+ */
+static int _myjson_ring_initialize(JsonRing *ring, unsigned entries);
+
+/*
+ * Tear down an io_uring instance.
+ */
+static void _myjson_ring_delete(JsonRing *ring);
+
+/*
+ * Submit the read of a chunk.
+ */
+static int _myjson_read_ahead_submit(JsonReadAhead *reader, JsonReadAheadChunk *chunk);
+
+/*
+ * Collect the completed reads, waiting for at least `count` of them.
+ */
+static int _myjson_read_ahead_complete(JsonReadAhead *reader, unsigned count);
+
+#endif
+
+//-----------------------------------------------------------------------------
+// [SECTION] Structural Index
+//-----------------------------------------------------------------------------
+
+/*
+ * Compute the inclusive prefix XOR of a mask (the bits between quote pairs).
+ */
+static MYJSON_INLINE uint64_t _myjson_prefix_xor(uint64_t bits);
+
+/*
+ * Find the characters escaped by a backslash, carrying odd runs across blocks.
+ */
+static MYJSON_INLINE uint64_t _myjson_find_escaped(uint64_t backslash, uint64_t *carry);
+
+/*
+ * Allocate a structural index of `capacity` offsets, and their bracket links.
+ */
+static int _myjson_parser_initialize_index(JsonParser *parser, size_t capacity);
+
+static void _myjson_parser_delete_index(JsonParser *parser);
+
+/*
+ * Drop the pending structurals and index again from `offset`, outside of any string.
+ */
+static void _myjson_parser_reset_index(JsonParser *parser, size_t offset);
+
+/*
+ * Report the first invalid UTF-8 sequence of the block at `offset`.
+ */
+static int _myjson_parser_set_utf8_error(JsonParser *parser, size_t offset, uint32_t previous);
+
+/*
+ * Link an indexed bracket to its matching one.
+ */
+static MYJSON_INLINE int _myjson_parser_link_bracket(JsonParser *parser, size_t *structural, JsonChar_t c);
+
+/*
+ * Validate a block and append its structurals to the index.
+ */
+static int _myjson_parser_index_block(JsonParser *parser, const JsonChar_t *block, size_t offset);
+
+/*
+ * Index the buffered input until the index is full or a block is incomplete.
+ */
+static int _myjson_parser_index_structurals(JsonParser *parser);
+
+/*
+ * Ensure that at least `count` structurals are indexed ahead of the scanner.
+ */
+static int _myjson_parser_fetch_structurals(JsonParser *parser, size_t count);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Scanner
+//-----------------------------------------------------------------------------
+
+/*
+ * Set the scanner error and return 0.
+ */
+static int _myjson_parser_set_scanner_error(JsonParser *parser, const char *problem, JsonPosition position);
+
+/*
+ * Is the character a part of a number or a literal?
+ */
+static MYJSON_INLINE int _myjson_is_scalar(JsonChar_t c);
+
+/*
+ * Advance the scanner over insignificant whitespace.
+ */
+static void _myjson_parser_skip_whitespace(JsonParser *parser, JsonChar_t *target);
+
+/*
+ * Move the scanner to the next structural, or set `pointer` to NULL at the end of the input.
+ */
+static int _myjson_parser_next_structural(JsonParser *parser, JsonChar_t **pointer);
+
+/*
+ * Move the scanner after the bracket closing the container it is in, linked to it by the index.
+ */
+static int _myjson_parser_skip_container(JsonParser *parser, JsonChar_t close);
+
+/*
+ * Ensure that the tokens queue contains at least one token.
+ */
+static int _myjson_parser_fetch_more_tokens(JsonParser *parser);
+
+/*
+ * Fetch the next token.
+ */
+static int _myjson_parser_fetch_next_token(JsonParser *parser);
+
+/*
+ * Fetch the tokens the next parser state looks at: the next one, and the one after a separator.
+ */
+static int _myjson_parser_fetch_lookahead(JsonParser *parser);
+
+/*
+ * Skip the input up to the next line.
+ */
+static int _myjson_parser_skip_line(JsonParser *parser);
+
+/*
+ * Fetch the EOF token.
+ */
+static int _myjson_parser_fetch_stream_end(JsonParser *parser);
+
+/*
+ * Fetch a single character token.
+ */
+static int _myjson_parser_fetch_indicator(JsonParser *parser, JsonTokenType type);
+
+/*
+ * Fetch a string token.
+ */
+static int _myjson_parser_fetch_string(JsonParser *parser);
+
+/*
+ * Fetch a number or a literal token.
+ */
+static int _myjson_parser_fetch_scalar(JsonParser *parser);
+
+/*
+ * Find the length of the number or literal at the scanner position.
+ */
+static int _myjson_parser_scan_scalar(JsonParser *parser, size_t max_length, size_t *length);
+
+/*
+ * Copy a string body resolving its escape sequences, or only check them if `value` is NULL.
+ */
+static int _myjson_parser_unescape_string(JsonParser *parser, const JsonChar_t *string, size_t length,
+                                          JsonChar_t *value, size_t *value_length);
+
+/*
+ * Destroy a token object.
+ */
+static void _myjson_token_delete(JsonToken *token);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Parser States
+//-----------------------------------------------------------------------------
+
+/*
+ * Set the parser error and return 0.
+ */
+static int _myjson_parser_set_parser_error(JsonParser *parser, const char *problem, JsonPosition position);
+
+/*
+ * Produce the next event according to the parser state.
+ */
+static int _myjson_parser_state_machine(JsonParser *parser, JsonEvent *event);
+
+/*
+ * Produce the STREAM-START event.
+ */
+/*
+ * Recover from a scanner or parser error: drop the malformed line and expect the next document.
+ */
+static void _myjson_parser_resync(JsonParser *parser);
+
+static int _myjson_parser_parse_stream_start(JsonParser *parser, JsonEvent *event);
+
+/*
+ * Produce the DOCUMENT-START event.
+ */
+static int _myjson_parser_parse_document_start(JsonParser *parser, JsonEvent *event);
+
+/*
+ * Produce the DOCUMENT-END event.
+ */
+static int _myjson_parser_parse_document_end(JsonParser *parser, JsonEvent *event);
+
+/*
+ * Produce the STREAM-END event.
+ */
+static int _myjson_parser_parse_stream_end(JsonParser *parser, JsonEvent *event);
+
+/*
+ * Produce the event of a value.
+ */
+static int _myjson_parser_parse_value(JsonParser *parser, JsonEvent *event);
+
+/*
+ * Produce the event of an array item or the ARRAY-END event.
+ */
+static int _myjson_parser_parse_array_item(JsonParser *parser, JsonEvent *event, int first);
+
+/*
+ * Produce the event of an object key or the OBJECT-END event.
+ */
+static int _myjson_parser_parse_object_key(JsonParser *parser, JsonEvent *event, int first);
+
+/*
+ * Produce the event of an object value.
+ */
+static int _myjson_parser_parse_object_value(JsonParser *parser, JsonEvent *event);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Loader
+//-----------------------------------------------------------------------------
+
+/*
+ * Parse the next event for the loader, which cannot wait for more input.
+ */
+static int _myjson_parser_load_event(JsonParser *parser, JsonEvent *event);
+
+/*
+ * Load the next document of the stream into an empty document object (left empty at the end of the stream).
+ */
+static int _myjson_parser_load_next(JsonParser *parser, JsonDocument *document);
+
+/*
+ * Load the nodes of a document, up to the DOCUMENT-END event.
+ */
+static int _myjson_parser_load_document(JsonParser *parser, JsonEvent *event, JsonDocument *document);
+
+/*
+ * Load the nodes of the value starting with `event`, up to its last event.
+ */
+static int _myjson_parser_load_value(JsonParser *parser, JsonEvent *event, JsonDocument *document);
+
+/*
+ * Add the node of a SCALAR event, taking over its value; return the node id or 0.
+ */
+static int _myjson_parser_load_scalar(JsonParser *parser, JsonDocument *document, JsonEvent *event);
+
+/*
+ * Check if the next node of a document being loaded is the key of a member.
+ */
+static MYJSON_INLINE int _myjson_parser_load_expects_key(JsonParser *parser, JsonDocument *document);
+
+/*
+ * Add the key of a member to a document with an atom table: one key node per distinct key.
+ */
+static int _myjson_parser_load_key(JsonParser *parser, JsonDocument *document, JsonEvent *event);
+
+/*
+ * Add an empty array or object node; return the node id or 0.
+ */
+static int _myjson_parser_load_container(JsonParser *parser, JsonDocument *document, JsonEvent *event,
+                                         JsonValueType type);
+
+/*
+ * Append a node to its parent array or object (as a key, then as its value).
+ */
+static int _myjson_parser_load_append(JsonParser *parser, JsonDocument *document, int parent, int node_id);
+
+/*
+ * Pack a closed array made only of numbers, which are the last nodes of the document.
+ */
+static int _myjson_parser_load_pack(JsonParser *parser, JsonDocument *document, int node_id);
+
+/*
+ * Append the words of a SCALAR event to a tape (copying its string), and delete the event.
+ */
+static int _myjson_parser_load_tape_scalar(JsonParser *parser, JsonTape *tape, JsonEvent *event);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Parallel NDJSON
+//-----------------------------------------------------------------------------
+
+/*
+ * Run a worker: parse its chunks, then steal the chunks of the others.
+ */
+static void _myjson_ndjson_run(void *data);
+
+/*
+ * Take the next chunk of a worker (from the front), or steal one from another (from the back).
+ */
+static int _myjson_ndjson_take(JsonNdjsonWorker *worker, size_t *chunk);
+
+/*
+ * Parse a chunk, and deliver or keep its documents.
+ */
+static int _myjson_ndjson_parse_chunk(JsonNdjsonWorker *worker, JsonNdjsonChunk *chunk);
+
+/*
+ * Deliver the kept documents of the parsed chunks whose turn has come (with the pool locked).
+ */
+static void _myjson_ndjson_deliver(JsonNdjsonPool *pool);
+
+/*
+ * Delete the kept documents of a chunk.
+ */
+static void _myjson_ndjson_delete_documents(JsonNdjsonPool *pool, JsonNdjsonChunk *chunk);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Parallel Loader
+//-----------------------------------------------------------------------------
+
+/*
+ * Load the body of the array or object just started on several threads, if it is large enough.
+ */
+static int _myjson_parser_load_parallel(JsonParser *parser, JsonEvent *event, JsonDocument *document, int node_id,
+                                        int *loaded);
+
+/*
+ * Find the top-level separators to cut a body at, and its closing bracket.
+ */
+static int _myjson_parser_split_body(JsonParser *parser, size_t open, size_t piece_size, size_t max_piece_size,
+                                     size_t **splits, size_t *count, size_t *capacity, size_t *close);
+
+/*
+ * Load, or move, the pieces on the threads of the work, the calling one included.
+ */
+static void _myjson_piece_work_run(JsonPieceWork *work);
+
+/*
+ * Run a thread loading, or moving, pieces.
+ */
+static void _myjson_piece_run(void *data);
+
+/*
+ * Load a piece, and check that it ends with the body (last) or between two values.
+ */
+static int _myjson_parser_load_piece(JsonParser *parser, JsonPiece *piece, JsonValueType type, int first, int last);
+
+/*
+ * Get the position `relative` to `base`.
+ */
+static MYJSON_INLINE JsonPosition _myjson_position_advance(JsonPosition base, JsonPosition relative);
+
+/*
+ * Move the nodes of a piece to their place in the document, under the body node.
+ */
+static void _myjson_piece_move(JsonPieceWork *work, JsonPiece *piece);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Cursor
+//-----------------------------------------------------------------------------
+
+/*
+ * Ensure that `count` structurals are indexed at the cursor; get the first one, or NULL if there are fewer.
+ */
+static int _myjson_cursor_fetch(JsonCursor *cursor, size_t count, JsonChar_t **pointer);
+
+/*
+ * Set a parser error at the current structural (or at the end of the input).
+ */
+static int _myjson_cursor_set_error(JsonCursor *cursor, const char *problem);
+
+/*
+ * Skip the current value, jumping over the containers linked by the index.
+ */
+static int _myjson_cursor_skip(JsonCursor *cursor);
+
+/*
+ * Read the key of a member and its ':'.
+ */
+static int _myjson_cursor_read_key(JsonCursor *cursor);
+
+/*
+ * Check the escape sequences of a string (or unescape it in place); set its flags.
+ */
+static int _myjson_cursor_read_string(JsonCursor *cursor, JsonChar_t *string, size_t *length, int *flags);
+
+/*
+ * Compare the key of the current member with `key`.
+ */
+static int _myjson_cursor_match_key(JsonCursor *cursor, const JsonChar_t *key, size_t length, int *match);
+
+/*
+ * Get the current number or literal; return the length of the scalar, or 0 for another value.
+ */
+static size_t _myjson_cursor_scalar(JsonCursor *cursor, JsonChar_t **value);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Query
+//-----------------------------------------------------------------------------
+
+/*
+ * Set a query error at `offset` in the expression.
+ */
+static int _myjson_query_set_error(JsonQuery *query, const char *problem, size_t offset);
+
+/*
+ * Parse a JSON Pointer expression into steps, from the root step.
+ */
+static int _myjson_query_parse_pointer(JsonQuery *query, const char *expression, JsonChar_t *key, size_t *step);
+
+/*
+ * Parse a JSONPath expression into steps, from the root step.
+ */
+static int _myjson_query_parse_path(JsonQuery *query, const char *expression, JsonChar_t *key, size_t *step);
+
+/*
+ * Get the array index written in a key, or (size_t)-1 if it is not one.
+ */
+static size_t _myjson_query_index(const JsonChar_t *key, size_t length);
+
+/*
+ * Go to the step following `step` with this key, index or wildcard, adding it if needed.
+ */
+static int _myjson_query_add_step(JsonQuery *query, size_t *step, const JsonChar_t *key, size_t length, size_t index,
+                                  int wildcard);
+
+/*
+ * Check whether a step takes a member (with its key) or an item (with a NULL key, and its index).
+ */
+static MYJSON_INLINE int _myjson_query_step_match(const JsonQueryStep *step, const JsonChar_t *key, size_t length,
+                                                 size_t index);
+
+/*
+ * Reach the steps following the steps of a container with a member or an item, for its value.
+ */
+static int _myjson_query_follow(JsonQueryRun *run, JsonQueryFrame *frame, const JsonChar_t *key, size_t length,
+                                size_t index);
+
+/*
+ * Reach the steps following the steps of an object with the key of a SCALAR event.
+ */
+static int _myjson_query_follow_key(JsonQueryRun *run, JsonQueryFrame *frame, JsonEvent *event);
+
+/*
+ * Follow the events of a value, from its first one (the root value of a document).
+ */
+static int _myjson_query_run_value(JsonQueryRun *run, JsonEvent *event);
+
+/*
+ * Skip, load or enter the value starting with `event`, after the steps from `first`.
+ */
+static int _myjson_query_value(JsonQueryRun *run, JsonEvent *event, size_t first);
+
+/*
+ * Load the value matched, and hand its matches to the handler.
+ */
+static int _myjson_query_load(JsonQueryRun *run, JsonEvent *event, size_t first, int descend);
+
+/*
+ * Add the value to the projection, with its key: whole, or only its container node to enter it.
+ */
+static int _myjson_query_keep(JsonQueryRun *run, JsonEvent *event, int whole, int *node_id);
+
+/*
+ * Hand the matches of a step at a node to the handler, then match the steps following it under the node.
+ */
+static int _myjson_query_reach(JsonQueryRun *run, JsonDocument *document, size_t step, int node_id);
+
+#endif  // MYJSON_DISABLE_READER
+
+#if !defined(MYJSON_DISABLE_WRITER) || !MYJSON_DISABLE_WRITER
+
+//-----------------------------------------------------------------------------
+// [SECTION] Emitter
+//-----------------------------------------------------------------------------
+
+/*
+ * String write handler.
+ */
+static int _myjson_string_write_handler(void *data, unsigned char *buffer, size_t size);
+
+/*
+ * File write handler.
+ */
+static int _myjson_file_write_handler(void *data, unsigned char *buffer, size_t size);
+
+/*
+ * Set the emitter error and return 0.
+ */
+static int _myjson_emitter_set_emitter_error(JsonEmitter *emitter, const char *problem);
+
+/*
+ * Set the writer error and return 0.
+ */
+static int _myjson_emitter_set_writer_error(JsonEmitter *emitter, const char *problem);
+
+/*
+ * Transcode the complete characters of the output buffer to UTF-16 or UTF-32 and write them.
+ */
+static int _myjson_emitter_encode_buffer(JsonEmitter *emitter);
+
+/*
+ * Append characters to the output buffer, flushing it when it is full.
+ */
+static int _myjson_emitter_write(JsonEmitter *emitter, const JsonChar_t *value, size_t length);
+
+/*
+ * Append a character to the output buffer.
+ */
+static int _myjson_emitter_put(JsonEmitter *emitter, JsonChar_t value);
+
+/*
+ * Write a quoted and escaped string.
+ */
+static int _myjson_emitter_write_string(JsonEmitter *emitter, const JsonChar_t *value, size_t length, int flags);
+
+/*
+ * Write a scalar value (strings are quoted, other values are written as is).
+ */
+static int _myjson_emitter_write_scalar(JsonEmitter *emitter, JsonEvent *event);
+
+//-----------------------------------------------------------------------------
+// [SECTION] Emitter States
+//-----------------------------------------------------------------------------
+
+/*
+ * State dispatcher.
+ */
+static int _myjson_emitter_state_machine(JsonEmitter *emitter, JsonEvent *event);
+
+/*
+ * Expect STREAM-START.
+ */
+static int _myjson_emitter_emit_stream_start(JsonEmitter *emitter, JsonEvent *event);
+
+/*
+ * Expect DOCUMENT-START or STREAM-END.
+ */
+static int _myjson_emitter_emit_document_start(JsonEmitter *emitter, JsonEvent *event);
+
+/*
+ * Expect DOCUMENT-END.
+ */
+static int _myjson_emitter_emit_document_end(JsonEmitter *emitter, JsonEvent *event);
+
+/*
+ * Expect a SCALAR, ARRAY-START or OBJECT-START.
+ */
+static int _myjson_emitter_emit_value(JsonEmitter *emitter, JsonEvent *event);
+
+/*
+ * Expect an array item or ARRAY-END.
+ */
+static int _myjson_emitter_emit_array_item(JsonEmitter *emitter, JsonEvent *event, int first);
+
+/*
+ * Expect an object key or OBJECT-END.
+ */
+static int _myjson_emitter_emit_object_key(JsonEmitter *emitter, JsonEvent *event, int first);
+
+/*
+ * Expect an object value.
+ */
+static int _myjson_emitter_emit_object_value(JsonEmitter *emitter, JsonEvent *event);
+
+#endif  // MYJSON_DISABLE_WRITER
+
+#pragma endregion  // C Declarations
+
+#pragma region C Def
+
+//-----------------------------------------------------------------------------
+// [SECTION] Definations
+//-----------------------------------------------------------------------------
+
+static void *_myjson_default_allocate(void *data, size_t size) {
+    (void)data;
+    return malloc(size);
+};
+
+static void *_myjson_default_reallocate(void *data, void *pointer, size_t old_size, size_t size) {
+    (void)data;
+    (void)old_size;
+    return realloc(pointer, size);
+};
+
+static void _myjson_default_deallocate(void *data, void *pointer, size_t size) {
+    (void)data;
+    (void)size;
+    free(pointer);
+};
+
+static const JsonAllocator _myjson_default_allocator = {_myjson_default_allocate, _myjson_default_reallocate,
+                                                        _myjson_default_deallocate, NULL};
+static const JsonAllocator *_myjson_allocator = &_myjson_default_allocator;
+
+void *_myjson_malloc(const JsonAllocator *allocator, size_t size) {
+    return allocator->allocate(allocator->data, size ? size : 1);
+};
+
+void *_myjson_realloc(const JsonAllocator *allocator, void *ptr, size_t old_size, size_t size) {
+    if (!ptr) {
+        return _myjson_malloc(allocator, size);
+    }
+
+    return allocator->reallocate(allocator->data, ptr, old_size ? old_size : 1, size ? size : 1);
+};
+
+void _myjson_free(const JsonAllocator *allocator, void *ptr, size_t size) {
+    if (ptr) {
+        allocator->deallocate(allocator->data, ptr, size ? size : 1);
+    }
+};
+
+static JsonChar_t *_myjson_string_malloc(const JsonAllocator *allocator, size_t size) {
+    JsonStringHeader *header = (JsonStringHeader *)_myjson_malloc(allocator, sizeof(JsonStringHeader) + size);
+
+    if (!header) {
+        return NULL;
+    }
+
+    header->allocator = allocator;
+    header->size = sizeof(JsonStringHeader) + size;
+
+    return (JsonChar_t *)(header + 1);
+};
+
+static void _myjson_string_free(JsonChar_t *string) {
+    JsonStringHeader *header;
+
+    if (string) {
+        header = (JsonStringHeader *)string - 1;
+        _myjson_free(header->allocator, header, header->size);
+    }
+};
+
+static int _myjson_stack_extend(const JsonAllocator *allocator, void **start, void **top, void **end) {
+    size_t size = (char *)*end - (char *)*start;
+    void *new_start = _myjson_realloc(allocator, *start, size, size * 2);
+
+    if (!new_start) {
+        return MYJSON_FAILURE;
+    }
+
+    *top = (char *)new_start + ((char *)*top - (char *)*start);
+    *end = (char *)new_start + size * 2;
+    *start = new_start;
+
+    return MYJSON_SUCCESS;
+};
+
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
+static int _myjson_stack_reserve(const JsonAllocator *allocator, void **start, void **top, void **end, size_t size) {
+    while ((size_t)((char *)*end - (char *)*start) < size) {
+        if (!_myjson_stack_extend(allocator, start, top, end)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+#endif  // MYJSON_DISABLE_READER
+
+static void *_myjson_arena_alloc(JsonDocument *document, size_t size, size_t alignment) {
+    size_t padding = (size_t)(-(uintptr_t)document->arena.pointer & (alignment - 1));
+    JsonChar_t *pointer;
+
+    if ((size_t)(document->arena.end - document->arena.pointer) < padding + size) {
+        if (!_myjson_arena_grow(document, size + alignment - 1)) {
+            return NULL;
+        }
+        padding = (size_t)(-(uintptr_t)document->arena.pointer & (alignment - 1));
+    }
+
+    pointer = document->arena.pointer + padding;
+    document->arena.pointer = pointer + size;
+
+    return pointer;
+};
+
+static int _myjson_arena_grow(JsonDocument *document, size_t size) {
+    JsonArenaChunk *chunk = document->arena.spare;
+    size_t chunk_size = document->arena.chunks ? document->arena.chunks->size * 2 : MYJSON_ARENA_CHUNK_SIZE;
+
+    /* A chunk kept by a reset is used again if it is large enough. */
+    if (chunk && chunk->size >= size) {
+        document->arena.spare = chunk->next;
+    } else {
+        if (chunk_size > MYJSON_ARENA_MAX_CHUNK_SIZE) {
+            chunk_size = MYJSON_ARENA_MAX_CHUNK_SIZE;
+        }
+        if (chunk_size < size) {
+            chunk_size = size;
+        }
+
+        chunk = (JsonArenaChunk *)_myjson_malloc(document->allocator, sizeof(JsonArenaChunk) + chunk_size);
+        if (!chunk) {
+            return MYJSON_FAILURE;
+        }
+        chunk->size = chunk_size;
+    }
+
+    chunk->next = document->arena.chunks;
+    document->arena.chunks = chunk;
+    document->arena.pointer = (JsonChar_t *)(chunk + 1);
+    document->arena.end = document->arena.pointer + chunk->size;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_arena_extend(JsonDocument *document, void **start, void **top, void **end) {
+    size_t size = (char *)*end - (char *)*start;
+    void *new_start;
+
+    /* The last block of the newest chunk grows in place... */
+    if ((JsonChar_t *)*end == document->arena.pointer &&
+        (size_t)(document->arena.end - document->arena.pointer) >= size) {
+        document->arena.pointer += size;
+        *end = (char *)*end + size;
+        return MYJSON_SUCCESS;
+    }
+
+    /* ...any other is copied, and its old place left to the arena. */
+    new_start = _myjson_arena_alloc(document, size * 2, MYJSON_ARENA_ALIGNMENT);
+    if (!new_start) {
+        return MYJSON_FAILURE;
+    }
+    memcpy(new_start, *start, (char *)*top - (char *)*start);
+
+    *top = (char *)new_start + ((char *)*top - (char *)*start);
+    *end = (char *)new_start + size * 2;
+    *start = new_start;
+
+    return MYJSON_SUCCESS;
+};
+
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
+static int _myjson_arena_reserve(JsonDocument *document, void **start, void **top, void **end, size_t size) {
+    while ((size_t)((char *)*end - (char *)*start) < size) {
+        if (!_myjson_arena_extend(document, start, top, end)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static void _myjson_arena_adopt(JsonDocument *document, JsonDocument *source) {
+    JsonArenaChunk *last = source->arena.chunks;
+
+    if (!last) {
+        return;
+    }
+
+    /* The chunks go behind the newest one, which stays the one allocated from. */
+    while (last->next) {
+        last = last->next;
+    }
+
+    if (document->arena.chunks) {
+        last->next = document->arena.chunks->next;
+        document->arena.chunks->next = source->arena.chunks;
+    } else {
+        document->arena.chunks = source->arena.chunks;
+        document->arena.pointer = source->arena.pointer;
+        document->arena.end = source->arena.end;
+    }
+
+    source->arena.chunks = NULL;
+    source->arena.pointer = source->arena.end = NULL;
+};
+
+#endif  // MYJSON_DISABLE_READER
+
+static void _myjson_arena_free(const JsonAllocator *allocator, JsonArenaChunk *chunk) {
+    while (chunk) {
+        JsonArenaChunk *next = chunk->next;
+
+        _myjson_free(allocator, chunk, sizeof(JsonArenaChunk) + chunk->size);
+        chunk = next;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Threads
+//-----------------------------------------------------------------------------
+
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
+#if MYJSON_PLATFORM_IS(WINDOWS)
+
+static DWORD WINAPI _myjson_thread_start(LPVOID data) {
+    JsonThread *thread = (JsonThread *)data;
+
+    thread->routine(thread->data);
+    return 0;
+};
+
+static int _myjson_thread_create(JsonThread *thread, void (*routine)(void *data), void *data) {
+    thread->routine = routine;
+    thread->data = data;
+    thread->handle = CreateThread(NULL, 0, _myjson_thread_start, thread, 0, NULL);
+
+    return thread->handle != NULL;
+};
+
+static void _myjson_thread_join(JsonThread *thread) {
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+};
+
+static int _myjson_mutex_initialize(JsonMutex *mutex) {
+    InitializeSRWLock(mutex);
+    return MYJSON_SUCCESS;
+};
+
+static void _myjson_mutex_lock(JsonMutex *mutex) { AcquireSRWLockExclusive(mutex); };
+
+static void _myjson_mutex_unlock(JsonMutex *mutex) { ReleaseSRWLockExclusive(mutex); };
+
+static void _myjson_mutex_delete(JsonMutex *mutex) { (void)mutex; };
+
+static int _myjson_condition_initialize(JsonCondition *condition) {
+    InitializeConditionVariable(condition);
+    return MYJSON_SUCCESS;
+};
+
+static void _myjson_condition_wait(JsonCondition *condition, JsonMutex *mutex) {
+    SleepConditionVariableSRW(condition, mutex, INFINITE, 0);
+};
+
+static void _myjson_condition_broadcast(JsonCondition *condition) { WakeAllConditionVariable(condition); };
+
+static void _myjson_condition_delete(JsonCondition *condition) { (void)condition; };
+
+static size_t _myjson_processor_count(void) {
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+};
+
+#else
+
+static void *_myjson_thread_start(void *data) {
+    JsonThread *thread = (JsonThread *)data;
+
+    thread->routine(thread->data);
+    return NULL;
+};
+
+static int _myjson_thread_create(JsonThread *thread, void (*routine)(void *data), void *data) {
+    thread->routine = routine;
+    thread->data = data;
+
+    return !pthread_create(&thread->handle, NULL, _myjson_thread_start, thread);
+};
+
+static void _myjson_thread_join(JsonThread *thread) { pthread_join(thread->handle, NULL); };
+
+static int _myjson_mutex_initialize(JsonMutex *mutex) { return !pthread_mutex_init(mutex, NULL); };
+
+static void _myjson_mutex_lock(JsonMutex *mutex) { pthread_mutex_lock(mutex); };
+
+static void _myjson_mutex_unlock(JsonMutex *mutex) { pthread_mutex_unlock(mutex); };
+
+static void _myjson_mutex_delete(JsonMutex *mutex) { pthread_mutex_destroy(mutex); };
+
+static int _myjson_condition_initialize(JsonCondition *condition) { return !pthread_cond_init(condition, NULL); };
+
+static void _myjson_condition_wait(JsonCondition *condition, JsonMutex *mutex) { pthread_cond_wait(condition, mutex); };
+
+static void _myjson_condition_broadcast(JsonCondition *condition) { pthread_cond_broadcast(condition); };
+
+static void _myjson_condition_delete(JsonCondition *condition) { pthread_cond_destroy(condition); };
+
+static size_t _myjson_processor_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (size_t)count : 1;
+};
+
+#endif
+
+#endif  // MYJSON_DISABLE_READER
+
+//-----------------------------------------------------------------------------
+// [SECTION] Atomics
+//-----------------------------------------------------------------------------
+
+static MYJSON_INLINE int _myjson_atomic_load(volatile int *value) {
+#if MYJSON_COMPILER_IS(MSVC)
+    return (int)_InterlockedCompareExchange((volatile long *)value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+};
+
+static MYJSON_INLINE void _myjson_atomic_store(volatile int *value, int desired) {
+#if MYJSON_COMPILER_IS(MSVC)
+    _InterlockedExchange((volatile long *)value, desired);
+#else
+    __atomic_store_n(value, desired, __ATOMIC_RELEASE);
+#endif
+};
+
+static MYJSON_INLINE int _myjson_atomic_compare_exchange(volatile int *value, int expected, int desired) {
+#if MYJSON_COMPILER_IS(MSVC)
+    return _InterlockedCompareExchange((volatile long *)value, desired, expected) == expected;
+#else
+    return __atomic_compare_exchange_n(value, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Kernels
+//-----------------------------------------------------------------------------
+
+static MYJSON_INLINE uint64_t _myjson_load_u64(const JsonChar_t *bytes) {
+    uint64_t word;
+
+    memcpy(&word, bytes, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+
+    return word;
+};
+
+static MYJSON_INLINE uint64_t _myjson_swar_eq(uint64_t word, uint64_t c) {
+    uint64_t x = word ^ (MYJSON_SWAR_ONES * c);
+
+    /* A byte has its high bit clear only when it is zero. */
+    return ~(((x & MYJSON_SWAR_LOWS) + MYJSON_SWAR_LOWS) | x) & MYJSON_SWAR_HIGHS;
+};
+
+static MYJSON_INLINE uint64_t _myjson_swar_lt(uint64_t word, uint64_t c) {
+    return (word - MYJSON_SWAR_ONES * c) & ~word & MYJSON_SWAR_HIGHS;
+};
+
+static MYJSON_INLINE uint64_t _myjson_swar_movemask(uint64_t highs) {
+    return ((highs >> 7) * 0x0102040810204080ULL) >> 56;
+};
+
+static MYJSON_INLINE int _myjson_trailing_zeroes(uint64_t bits) {
+#if MYJSON_HAS_BUILTIN(__builtin_ctzll) || MYJSON_COMPILER_SINCE(GCC, 3, 4, 0)
+    return __builtin_ctzll(bits);
+#elif MYJSON_COMPILER_IS(MSVC) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    int count = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        count++;
+    }
+    return count;
+#endif
+};
+
+static MYJSON_INLINE int _myjson_leading_zeroes(uint64_t bits) {
+#if MYJSON_HAS_BUILTIN(__builtin_clzll) || MYJSON_COMPILER_SINCE(GCC, 3, 4, 0)
+    return __builtin_clzll(bits);
+#elif MYJSON_COMPILER_IS(MSVC) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, bits);
+    return 63 - (int)index;
+#else
+    int count = 0;
+    while (!(bits & 0x8000000000000000ULL)) {
+        bits <<= 1;
+        count++;
+    }
+    return count;
+#endif
+};
+
+static MYJSON_INLINE int _myjson_popcount(uint64_t bits) {
+#if MYJSON_HAS_BUILTIN(__builtin_popcountll) || MYJSON_COMPILER_SINCE(GCC, 3, 4, 0)
+    return __builtin_popcountll(bits);
+#else
+    bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((bits * MYJSON_SWAR_ONES) >> 56);
+#endif
+};
+
+static size_t _myjson_utf8_sequence_length(const JsonChar_t *string, size_t length) {
+    JsonChar_t lead = string[0];
+    JsonChar_t lower = 0x80, upper = 0xBF;
+    size_t width, i;
+
+    if (lead < 0x80) {
+        return 1;
+    }
+
+    /* The well-formed sequences of RFC 3629 (no overlongs, surrogates or code points above U+10FFFF). */
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        width = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        width = 3;
+        if (lead == 0xE0) {
+            lower = 0xA0;
+        } else if (lead == 0xED) {
+            upper = 0x9F;
+        }
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        width = 4;
+        if (lead == 0xF0) {
+            lower = 0x90;
+        } else if (lead == 0xF4) {
+            upper = 0x8F;
+        }
+    } else {
+        return 0;
+    }
+
+    if (length < width || string[1] < lower || string[1] > upper) {
+        return 0;
+    }
+
+    for (i = 2; i < width; i++) {
+        if ((string[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+
+    return width;
+};
+
+/* The error classes of the first byte of a pair, by its high nibble. */
+static const JsonChar_t _myjson_utf8_byte_1_high[16] = {
+    MYJSON_UTF8_TOO_LONG,  MYJSON_UTF8_TOO_LONG,  MYJSON_UTF8_TOO_LONG,  MYJSON_UTF8_TOO_LONG,
+    MYJSON_UTF8_TOO_LONG,  MYJSON_UTF8_TOO_LONG,  MYJSON_UTF8_TOO_LONG,  MYJSON_UTF8_TOO_LONG,
+    MYJSON_UTF8_TWO_CONTS, MYJSON_UTF8_TWO_CONTS, MYJSON_UTF8_TWO_CONTS, MYJSON_UTF8_TWO_CONTS,
+    MYJSON_UTF8_TOO_SHORT | MYJSON_UTF8_OVERLONG_2,
+    MYJSON_UTF8_TOO_SHORT,
+    MYJSON_UTF8_TOO_SHORT | MYJSON_UTF8_OVERLONG_3 | MYJSON_UTF8_SURROGATE,
+    MYJSON_UTF8_TOO_SHORT | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000 | MYJSON_UTF8_OVERLONG_4};
+
+/* The error classes of the first byte of a pair, by its low nibble. */
+static const JsonChar_t _myjson_utf8_byte_1_low[16] = {
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_OVERLONG_3 | MYJSON_UTF8_OVERLONG_2 | MYJSON_UTF8_OVERLONG_4,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_OVERLONG_2,
+    MYJSON_UTF8_CARRY,
+    MYJSON_UTF8_CARRY,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000 | MYJSON_UTF8_SURROGATE,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000,
+    MYJSON_UTF8_CARRY | MYJSON_UTF8_TOO_LARGE | MYJSON_UTF8_TOO_LARGE_1000};
+
+/* The error classes of the second byte of a pair, by its high nibble. */
+static const JsonChar_t _myjson_utf8_byte_2_high[16] = {
+    MYJSON_UTF8_TOO_SHORT, MYJSON_UTF8_TOO_SHORT, MYJSON_UTF8_TOO_SHORT, MYJSON_UTF8_TOO_SHORT,
+    MYJSON_UTF8_TOO_SHORT, MYJSON_UTF8_TOO_SHORT, MYJSON_UTF8_TOO_SHORT, MYJSON_UTF8_TOO_SHORT,
+    MYJSON_UTF8_TOO_LONG | MYJSON_UTF8_OVERLONG_2 | MYJSON_UTF8_TWO_CONTS | MYJSON_UTF8_OVERLONG_3 |
+        MYJSON_UTF8_TOO_LARGE_1000 | MYJSON_UTF8_OVERLONG_4,
+    MYJSON_UTF8_TOO_LONG | MYJSON_UTF8_OVERLONG_2 | MYJSON_UTF8_TWO_CONTS | MYJSON_UTF8_OVERLONG_3 |
+        MYJSON_UTF8_TOO_LARGE,
+    MYJSON_UTF8_TOO_LONG | MYJSON_UTF8_OVERLONG_2 | MYJSON_UTF8_TWO_CONTS | MYJSON_UTF8_SURROGATE |
+        MYJSON_UTF8_TOO_LARGE,
+    MYJSON_UTF8_TOO_LONG | MYJSON_UTF8_OVERLONG_2 | MYJSON_UTF8_TWO_CONTS | MYJSON_UTF8_SURROGATE |
+        MYJSON_UTF8_TOO_LARGE,
+    MYJSON_UTF8_TOO_SHORT, MYJSON_UTF8_TOO_SHORT, MYJSON_UTF8_TOO_SHORT, MYJSON_UTF8_TOO_SHORT};
+
+static MYJSON_INLINE size_t _myjson_utf8_pending(uint32_t previous) {
+    JsonChar_t last = (JsonChar_t)(previous >> 24);
+    JsonChar_t second = (JsonChar_t)(previous >> 16);
+
+    if (last >= 0xC0) {
+        return 1;
+    }
+
+    if ((last & 0xC0) != 0x80) {
+        return 0;
+    }
+
+    if (second >= 0xE0) {
+        return 2;
+    }
+
+    return ((second & 0xC0) == 0x80 && (JsonChar_t)(previous >> 8) >= 0xF0) ? 3 : 0;
+};
+
+static int _myjson_utf8_check_fallback(const JsonChar_t *block, uint32_t *previous) {
+    uint32_t window = *previous;
+    int error = 0, i;
+
+    for (i = 0; i < MYJSON_STRUCTURAL_BLOCK_SIZE; i++) {
+        JsonChar_t prev1 = (JsonChar_t)(window >> 24);
+        JsonChar_t prev2 = (JsonChar_t)(window >> 16);
+        JsonChar_t prev3 = (JsonChar_t)(window >> 8);
+        int special = _myjson_utf8_byte_1_high[prev1 >> 4] & _myjson_utf8_byte_1_low[prev1 & 0x0F] &
+                      _myjson_utf8_byte_2_high[block[i] >> 4];
+
+        /* Only the third and fourth bytes of a sequence may follow two continuation bytes. */
+        error |= ((prev2 >= 0xE0 || prev3 >= 0xF0) ? 0x80 : 0) ^ special;
+        window = (window >> 8) | ((uint32_t)block[i] << 24);
+    }
+
+    if (error) {
+        return MYJSON_FAILURE;
+    }
+
+    *previous = window;
+
+    return MYJSON_SUCCESS;
+};
+
+static MYJSON_INLINE unsigned int _myjson_utf8_decode(const JsonChar_t *string, size_t width) {
+    switch (width) {
+        case 1:
+            return string[0];
+        case 2:
+            return ((unsigned int)(string[0] & 0x1F) << 6) | (string[1] & 0x3F);
+        case 3:
+            return ((unsigned int)(string[0] & 0x0F) << 12) | ((unsigned int)(string[1] & 0x3F) << 6) |
+                   (string[2] & 0x3F);
+        default:
+            return ((unsigned int)(string[0] & 0x07) << 18) | ((unsigned int)(string[1] & 0x3F) << 12) |
+                   ((unsigned int)(string[2] & 0x3F) << 6) | (string[3] & 0x3F);
+    }
+};
+
+static MYJSON_INLINE size_t _myjson_utf8_encode(unsigned int code, JsonChar_t *output) {
+    if (code < 0x80) {
+        output[0] = (JsonChar_t)code;
+        return 1;
+    }
+
+    if (code < 0x800) {
+        output[0] = (JsonChar_t)(0xC0 | (code >> 6));
+        output[1] = (JsonChar_t)(0x80 | (code & 0x3F));
+        return 2;
+    }
+
+    if (code < 0x10000) {
+        output[0] = (JsonChar_t)(0xE0 | (code >> 12));
+        output[1] = (JsonChar_t)(0x80 | ((code >> 6) & 0x3F));
+        output[2] = (JsonChar_t)(0x80 | (code & 0x3F));
+        return 3;
+    }
+
+    output[0] = (JsonChar_t)(0xF0 | (code >> 18));
+    output[1] = (JsonChar_t)(0x80 | ((code >> 12) & 0x3F));
+    output[2] = (JsonChar_t)(0x80 | ((code >> 6) & 0x3F));
+    output[3] = (JsonChar_t)(0x80 | (code & 0x3F));
+    return 4;
+};
+
+static MYJSON_INLINE unsigned int _myjson_load_unit(const unsigned char *string, size_t width, int big_endian) {
+    unsigned int unit = 0;
+    size_t i;
+
+    for (i = 0; i < width; i++) {
+        unit |= (unsigned int)string[big_endian ? width - 1 - i : i] << (8 * i);
+    }
+
+    return unit;
+};
+
+static MYJSON_INLINE void _myjson_store_unit(unsigned char *output, unsigned int unit, size_t width, int big_endian) {
+    size_t i;
+
+    for (i = 0; i < width; i++) {
+        output[big_endian ? width - 1 - i : i] = (unsigned char)(unit >> (8 * i));
+    }
+};
+
+static int _myjson_classify_block_fallback(const JsonChar_t *block, JsonStructuralBlock *masks, uint32_t *previous) {
+    uint64_t highs = 0;
+    int i;
+
+    memset(masks, 0, sizeof(JsonStructuralBlock));
+
+    for (i = 0; i < MYJSON_STRUCTURAL_BLOCK_SIZE / 8; i++) {
+        uint64_t word = _myjson_load_u64(block + i * 8);
+        uint64_t curly = word | (MYJSON_SWAR_ONES * 0x20); /* '[' and ']' become '{' and '}'. */
+        int shift = i * 8;
+
+        highs |= word;
+        masks->quote |= _myjson_swar_movemask(_myjson_swar_eq(word, '"')) << shift;
+        masks->backslash |= _myjson_swar_movemask(_myjson_swar_eq(word, '\\')) << shift;
+        masks->whitespace |= _myjson_swar_movemask(_myjson_swar_eq(word, ' ') | _myjson_swar_eq(word, '\t') |
+                                                   _myjson_swar_eq(word, '\n') | _myjson_swar_eq(word, '\r'))
+                             << shift;
+        masks->op |= _myjson_swar_movemask(_myjson_swar_eq(word, ',') | _myjson_swar_eq(word, ':') |
+                                           _myjson_swar_eq(curly, '{') | _myjson_swar_eq(curly, '}'))
+                     << shift;
+    }
+
+    /* An ASCII block is valid unless the previous block left a sequence open. */
+    if (!(highs & MYJSON_SWAR_HIGHS) && !_myjson_utf8_pending(*previous)) {
+        *previous = 0;
+        return MYJSON_SUCCESS;
+    }
+
+    return _myjson_utf8_check_fallback(block, previous);
+};
+
+static size_t _myjson_validate_utf8_fallback(const JsonChar_t *string, size_t length) {
+    size_t i = 0;
+
+    while (i < length) {
+        size_t width;
+
+        /* Skip ASCII a word at a time. */
+        if (length - i >= 8 && !(_myjson_load_u64(string + i) & MYJSON_SWAR_HIGHS)) {
+            i += 8;
+            continue;
+        }
+
+        width = _myjson_utf8_sequence_length(string + i, length - i);
+        if (!width) {
+            return i;
+        }
+        i += width;
+    }
+
+    return length;
+};
+
+static size_t _myjson_scan_string_fallback(const JsonChar_t *string, size_t length) {
+    size_t i = 0;
+
+    for (; length - i >= 8; i += 8) {
+        uint64_t word = _myjson_load_u64(string + i);
+        uint64_t special = _myjson_swar_eq(word, '"') | _myjson_swar_eq(word, '\\') | _myjson_swar_lt(word, 0x20);
+
+        if (special) {
+            return i + (_myjson_trailing_zeroes(special) >> 3);
+        }
+    }
+
+    for (; i < length; i++) {
+        if (string[i] == '"' || string[i] == '\\' || string[i] < 0x20) {
+            return i;
+        }
+    }
+
+    return length;
+};
+
+static size_t _myjson_count_newlines_fallback(const JsonChar_t *string, size_t length, size_t *tail) {
+    const JsonChar_t *pointer = string;
+    const JsonChar_t *end = string + length;
+    const JsonChar_t *newline;
+    size_t count = 0;
+
+    while ((newline = (const JsonChar_t *)memchr(pointer, '\n', end - pointer))) {
+        count++;
+        pointer = newline + 1;
+    }
+
+    *tail = end - pointer;
+
+    return count;
+};
+
+static size_t _myjson_narrow_utf16_fallback(const unsigned char *string, size_t count, int big_endian,
+                                            JsonChar_t *output) {
+    /* The high byte of each unit and the high bit of its low byte (read as little-endian words). */
+    const uint64_t mask = big_endian ? 0x80FF80FF80FF80FFULL : 0xFF80FF80FF80FF80ULL;
+    size_t i = 0;
+
+    for (; count - i >= 4; i += 4) {
+        uint64_t word = _myjson_load_u64(string + i * 2);
+        int j;
+
+        if (word & mask) {
+            break;
+        }
+
+        word >>= big_endian ? 8 : 0;
+        for (j = 0; j < 4; j++) {
+            output[i + j] = (JsonChar_t)(word >> (16 * j));
+        }
+    }
+
+    for (; i < count; i++) {
+        unsigned int unit = _myjson_load_unit(string + i * 2, 2, big_endian);
+
+        if (unit >= 0x80) {
+            break;
+        }
+        output[i] = (JsonChar_t)unit;
+    }
+
+    return i;
+};
+
+static size_t _myjson_narrow_utf32_fallback(const unsigned char *string, size_t count, int big_endian,
+                                            JsonChar_t *output) {
+    const uint64_t mask = big_endian ? 0x80FFFFFF80FFFFFFULL : 0xFFFFFF80FFFFFF80ULL;
+    size_t i = 0;
+
+    for (; count - i >= 2; i += 2) {
+        uint64_t word = _myjson_load_u64(string + i * 4);
+
+        if (word & mask) {
+            break;
+        }
+
+        word >>= big_endian ? 24 : 0;
+        output[i] = (JsonChar_t)word;
+        output[i + 1] = (JsonChar_t)(word >> 32);
+    }
+
+    for (; i < count; i++) {
+        unsigned int unit = _myjson_load_unit(string + i * 4, 4, big_endian);
+
+        if (unit >= 0x80) {
+            break;
+        }
+        output[i] = (JsonChar_t)unit;
+    }
+
+    return i;
+};
+
+static size_t _myjson_widen_utf16_fallback(const JsonChar_t *string, size_t length, int big_endian,
+                                           unsigned char *output) {
+    size_t count = 0, i;
+
+    /* Find the ASCII prefix a word at a time, then write it. */
+    while (length - count >= 8 && !(_myjson_load_u64(string + count) & MYJSON_SWAR_HIGHS)) {
+        count += 8;
+    }
+    while (count < length && string[count] < 0x80) {
+        count++;
+    }
+
+    for (i = 0; i < count; i++) {
+        _myjson_store_unit(output + i * 2, string[i], 2, big_endian);
+    }
+
+    return count;
+};
+
+static size_t _myjson_widen_utf32_fallback(const JsonChar_t *string, size_t length, int big_endian,
+                                           unsigned char *output) {
+    size_t count = 0, i;
+
+    while (length - count >= 8 && !(_myjson_load_u64(string + count) & MYJSON_SWAR_HIGHS)) {
+        count += 8;
+    }
+    while (count < length && string[count] < 0x80) {
+        count++;
+    }
+
+    for (i = 0; i < count; i++) {
+        _myjson_store_unit(output + i * 4, string[i], 4, big_endian);
+    }
+
+    return count;
+};
+
+#if MYJSON_X86_KERNELS
+
+static MYJSON_TARGET("sse4.2,popcnt") int _myjson_utf8_check_sse42(const __m128i *input, uint32_t *previous) {
+    const __m128i byte_1_high = _mm_loadu_si128((const __m128i *)_myjson_utf8_byte_1_high);
+    const __m128i byte_1_low = _mm_loadu_si128((const __m128i *)_myjson_utf8_byte_1_low);
+    const __m128i byte_2_high = _mm_loadu_si128((const __m128i *)_myjson_utf8_byte_2_high);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i highs = _mm_or_si128(_mm_or_si128(input[0], input[1]), _mm_or_si128(input[2], input[3]));
+    __m128i prev = _mm_set_epi32((int)*previous, 0, 0, 0);
+    __m128i error = _mm_setzero_si128();
+    int i;
+
+    /* An ASCII block is valid unless the previous block left a sequence open. */
+    if (!_mm_movemask_epi8(highs) && !_myjson_utf8_pending(*previous)) {
+        *previous = 0;
+        return MYJSON_SUCCESS;
+    }
+
+    for (i = 0; i < MYJSON_STRUCTURAL_BLOCK_SIZE / 16; i++) {
+        __m128i prev1 = _mm_alignr_epi8(input[i], prev, 15);
+        __m128i prev2 = _mm_alignr_epi8(input[i], prev, 14);
+        __m128i prev3 = _mm_alignr_epi8(input[i], prev, 13);
+        __m128i special = _mm_and_si128(
+            _mm_and_si128(_mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                          _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+            _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input[i], 4), nibble)));
+        __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80))),
+                                      _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80))));
+
+        error = _mm_or_si128(error, _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8((char)0x80)), special));
+        prev = input[i];
+    }
+
+    if (!_mm_testz_si128(error, error)) {
+        return MYJSON_FAILURE;
+    }
+
+    *previous = (uint32_t)_mm_extract_epi32(input[3], 3);
+
+    return MYJSON_SUCCESS;
+};
+
+static MYJSON_TARGET("sse4.2,popcnt") int _myjson_classify_block_sse42(const JsonChar_t *block,
+                                                                       JsonStructuralBlock *masks, uint32_t *previous) {
+    /* Tables indexed by the low nibble; 0x80 never matches an ASCII byte. */
+    const __m128i whitespace_table = _mm_setr_epi8(' ', -128, -128, -128, -128, -128, -128, -128, -128, '\t', '\n',
+                                                   -128, -128, '\r', -128, -128);
+    const __m128i op_table =
+        _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, ':', -128, ',', -128, -128, -128);
+    const __m128i curly_table =
+        _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, '{', -128, '}', -128, -128);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i curl = _mm_set1_epi8(0x20);
+    __m128i input[MYJSON_STRUCTURAL_BLOCK_SIZE / 16];
+    int i;
+
+    memset(masks, 0, sizeof(JsonStructuralBlock));
+
+    for (i = 0; i < MYJSON_STRUCTURAL_BLOCK_SIZE / 16; i++) {
+        __m128i in = input[i] = _mm_loadu_si128((const __m128i *)(block + i * 16));
+        __m128i curly = _mm_or_si128(in, curl);
+        __m128i whitespace = _mm_cmpeq_epi8(in, _mm_shuffle_epi8(whitespace_table, in));
+        __m128i op = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_shuffle_epi8(op_table, in)),
+                                  _mm_cmpeq_epi8(curly, _mm_shuffle_epi8(curly_table, in)));
+        int shift = i * 16;
+
+        masks->quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(in, quote)) << shift;
+        masks->backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(in, backslash)) << shift;
+        masks->whitespace |= (uint64_t)(uint16_t)_mm_movemask_epi8(whitespace) << shift;
+        masks->op |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << shift;
+    }
+
+    return _myjson_utf8_check_sse42(input, previous);
+};
+
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_validate_utf8_sse42(const JsonChar_t *string, size_t length) {
+    uint32_t previous = 0;
+    size_t i = 0;
+
+    for (; length - i >= MYJSON_STRUCTURAL_BLOCK_SIZE; i += MYJSON_STRUCTURAL_BLOCK_SIZE) {
+        __m128i input[MYJSON_STRUCTURAL_BLOCK_SIZE / 16];
+        int j;
+
+        for (j = 0; j < MYJSON_STRUCTURAL_BLOCK_SIZE / 16; j++) {
+            input[j] = _mm_loadu_si128((const __m128i *)(string + i + j * 16));
+        }
+
+        if (!_myjson_utf8_check_sse42(input, &previous)) {
+            break;
+        }
+    }
+
+    /* Locate the error (or check the tail) from the start of the open sequence. */
+    i -= _myjson_utf8_pending(previous);
+
+    return i + _myjson_validate_utf8_fallback(string + i, length - i);
+};
+
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_scan_string_sse42(const JsonChar_t *string, size_t length) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    size_t i = 0;
+
+    for (; length - i >= 16; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(string + i));
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(in, quote), _mm_cmpeq_epi8(in, backslash)),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(in, control), in));
+        int mask = _mm_movemask_epi8(special);
+
+        if (mask) {
+            return i + _myjson_trailing_zeroes(mask);
+        }
+    }
+
+    return i + _myjson_scan_string_fallback(string + i, length - i);
+};
+
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_count_newlines_sse42(const JsonChar_t *string, size_t length,
+                                                                          size_t *tail) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t count = 0, last = 0, i = 0, rest;
+
+    for (; length - i >= 16; i += 16) {
+        uint64_t mask =
+            (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(string + i)), newline));
+
+        if (mask) {
+            count += _myjson_popcount(mask);
+            last = i + 64 - _myjson_leading_zeroes(mask);
+        }
+    }
+
+    count += _myjson_count_newlines_fallback(string + i, length - i, &rest);
+    *tail = (rest != length - i) ? rest : length - last;
+
+    return count;
+};
+
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_narrow_utf16_sse42(const unsigned char *string, size_t count,
+                                                                        int big_endian, JsonChar_t *output) {
+    const __m128i mask = _mm_set1_epi16((short)(big_endian ? 0x80FF : 0xFF80));
+    size_t i = 0;
+
+    for (; count - i >= 16; i += 16) {
+        __m128i low = _mm_loadu_si128((const __m128i *)(string + i * 2));
+        __m128i high = _mm_loadu_si128((const __m128i *)(string + i * 2 + 16));
+
+        if (!_mm_testz_si128(_mm_or_si128(low, high), mask)) {
+            break;
+        }
+
+        if (big_endian) {
+            low = _mm_srli_epi16(low, 8);
+            high = _mm_srli_epi16(high, 8);
+        }
+
+        _mm_storeu_si128((__m128i *)(output + i), _mm_packus_epi16(low, high));
+    }
+
+    return i + _myjson_narrow_utf16_fallback(string + i * 2, count - i, big_endian, output + i);
+};
+
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_narrow_utf32_sse42(const unsigned char *string, size_t count,
+                                                                        int big_endian, JsonChar_t *output) {
+    const __m128i mask = _mm_set1_epi32((int)(big_endian ? 0x80FFFFFFU : 0xFFFFFF80U));
+    size_t i = 0;
+
+    for (; count - i >= 16; i += 16) {
+        __m128i in[4];
+        int j;
+
+        for (j = 0; j < 4; j++) {
+            in[j] = _mm_loadu_si128((const __m128i *)(string + i * 4 + j * 16));
+        }
+
+        if (!_mm_testz_si128(_mm_or_si128(_mm_or_si128(in[0], in[1]), _mm_or_si128(in[2], in[3])), mask)) {
+            break;
+        }
+
+        if (big_endian) {
+            for (j = 0; j < 4; j++) {
+                in[j] = _mm_srli_epi32(in[j], 24);
+            }
+        }
+
+        _mm_storeu_si128((__m128i *)(output + i),
+                         _mm_packus_epi16(_mm_packs_epi32(in[0], in[1]), _mm_packs_epi32(in[2], in[3])));
+    }
+
+    return i + _myjson_narrow_utf32_fallback(string + i * 4, count - i, big_endian, output + i);
+};
+
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_widen_utf16_sse42(const JsonChar_t *string, size_t length,
+                                                                       int big_endian, unsigned char *output) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; length - i >= 16; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(string + i));
+
+        if (_mm_movemask_epi8(in)) {
+            break;
+        }
+
+        _mm_storeu_si128((__m128i *)(output + i * 2),
+                         big_endian ? _mm_unpacklo_epi8(zero, in) : _mm_unpacklo_epi8(in, zero));
+        _mm_storeu_si128((__m128i *)(output + i * 2 + 16),
+                         big_endian ? _mm_unpackhi_epi8(zero, in) : _mm_unpackhi_epi8(in, zero));
+    }
+
+    return i + _myjson_widen_utf16_fallback(string + i, length - i, big_endian, output + i * 2);
+};
+
+static MYJSON_TARGET("sse4.2,popcnt") size_t _myjson_widen_utf32_sse42(const JsonChar_t *string, size_t length,
+                                                                       int big_endian, unsigned char *output) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; length - i >= 16; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(string + i));
+        __m128i low, high;
+
+        if (_mm_movemask_epi8(in)) {
+            break;
+        }
+
+        if (big_endian) {
+            low = _mm_unpacklo_epi8(zero, in);
+            high = _mm_unpackhi_epi8(zero, in);
+            _mm_storeu_si128((__m128i *)(output + i * 4), _mm_unpacklo_epi16(zero, low));
+            _mm_storeu_si128((__m128i *)(output + i * 4 + 16), _mm_unpackhi_epi16(zero, low));
+            _mm_storeu_si128((__m128i *)(output + i * 4 + 32), _mm_unpacklo_epi16(zero, high));
+            _mm_storeu_si128((__m128i *)(output + i * 4 + 48), _mm_unpackhi_epi16(zero, high));
+        } else {
+            low = _mm_unpacklo_epi8(in, zero);
+            high = _mm_unpackhi_epi8(in, zero);
+            _mm_storeu_si128((__m128i *)(output + i * 4), _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128((__m128i *)(output + i * 4 + 16), _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128((__m128i *)(output + i * 4 + 32), _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128((__m128i *)(output + i * 4 + 48), _mm_unpackhi_epi16(high, zero));
+        }
+    }
+
+    return i + _myjson_widen_utf32_fallback(string + i, length - i, big_endian, output + i * 4);
+};
+
+static MYJSON_TARGET("avx2,popcnt") int _myjson_utf8_check_avx2(const __m256i *input, uint32_t *previous) {
+    const __m256i byte_1_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)_myjson_utf8_byte_1_high));
+    const __m256i byte_1_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)_myjson_utf8_byte_1_low));
+    const __m256i byte_2_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)_myjson_utf8_byte_2_high));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i prev = _mm256_set_epi32((int)*previous, 0, 0, 0, 0, 0, 0, 0);
+    __m256i error = _mm256_setzero_si256();
+    int i;
+
+    /* An ASCII block is valid unless the previous block left a sequence open. */
+    if (!_mm256_movemask_epi8(_mm256_or_si256(input[0], input[1])) && !_myjson_utf8_pending(*previous)) {
+        *previous = 0;
+        return MYJSON_SUCCESS;
+    }
+
+    for (i = 0; i < MYJSON_STRUCTURAL_BLOCK_SIZE / 32; i++) {
+        /* The bytes before each lane: the high lane of `prev`, then the low lane of the input. */
+        __m256i shifted = _mm256_permute2x128_si256(prev, input[i], 0x21);
+        __m256i prev1 = _mm256_alignr_epi8(input[i], shifted, 15);
+        __m256i prev2 = _mm256_alignr_epi8(input[i], shifted, 14);
+        __m256i prev3 = _mm256_alignr_epi8(input[i], shifted, 13);
+        __m256i special = _mm256_and_si256(
+            _mm256_and_si256(_mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                             _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+            _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input[i], 4), nibble)));
+        __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+                                         _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+
+        error = _mm256_or_si256(error,
+                                _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8((char)0x80)), special));
+        prev = input[i];
+    }
+
+    if (!_mm256_testz_si256(error, error)) {
+        return MYJSON_FAILURE;
+    }
+
+    *previous = (uint32_t)_mm256_extract_epi32(input[1], 7);
+
+    return MYJSON_SUCCESS;
+};
+
+static MYJSON_TARGET("avx2,popcnt") int _myjson_classify_block_avx2(const JsonChar_t *block, JsonStructuralBlock *masks,
+                                                                    uint32_t *previous) {
+    /* Tables indexed by the low nibble; 0x80 never matches an ASCII byte. */
+    const __m256i whitespace_table = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        ' ', -128, -128, -128, -128, -128, -128, -128, -128, '\t', '\n', -128, -128, '\r', -128, -128));
+    const __m256i op_table = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, ':', -128, ',', -128, -128, -128));
+    const __m256i curly_table = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, '{', -128, '}', -128, -128));
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i curl = _mm256_set1_epi8(0x20);
+    __m256i input[MYJSON_STRUCTURAL_BLOCK_SIZE / 32];
+    int i;
+
+    memset(masks, 0, sizeof(JsonStructuralBlock));
+
+    for (i = 0; i < MYJSON_STRUCTURAL_BLOCK_SIZE / 32; i++) {
+        __m256i in = input[i] = _mm256_loadu_si256((const __m256i *)(block + i * 32));
+        __m256i curly = _mm256_or_si256(in, curl);
+        __m256i whitespace = _mm256_cmpeq_epi8(in, _mm256_shuffle_epi8(whitespace_table, in));
+        __m256i op = _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_shuffle_epi8(op_table, in)),
+                                     _mm256_cmpeq_epi8(curly, _mm256_shuffle_epi8(curly_table, in)));
+        int shift = i * 32;
+
+        masks->quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(in, quote)) << shift;
+        masks->backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(in, backslash)) << shift;
+        masks->whitespace |= (uint64_t)(uint32_t)_mm256_movemask_epi8(whitespace) << shift;
+        masks->op |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << shift;
+    }
+
+    return _myjson_utf8_check_avx2(input, previous);
+};
+
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_validate_utf8_avx2(const JsonChar_t *string, size_t length) {
+    uint32_t previous = 0;
+    size_t i = 0;
+
+    for (; length - i >= MYJSON_STRUCTURAL_BLOCK_SIZE; i += MYJSON_STRUCTURAL_BLOCK_SIZE) {
+        __m256i input[MYJSON_STRUCTURAL_BLOCK_SIZE / 32];
+
+        input[0] = _mm256_loadu_si256((const __m256i *)(string + i));
+        input[1] = _mm256_loadu_si256((const __m256i *)(string + i + 32));
+
+        if (!_myjson_utf8_check_avx2(input, &previous)) {
+            break;
+        }
+    }
+
+    /* Locate the error (or check the tail) from the start of the open sequence. */
+    i -= _myjson_utf8_pending(previous);
+
+    return i + _myjson_validate_utf8_fallback(string + i, length - i);
+};
+
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_scan_string_avx2(const JsonChar_t *string, size_t length) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    size_t i = 0;
+
+    for (; length - i >= 32; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(string + i));
+        __m256i special =
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(in, quote), _mm256_cmpeq_epi8(in, backslash)),
+                            _mm256_cmpeq_epi8(_mm256_min_epu8(in, control), in));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(special);
+
+        if (mask) {
+            return i + _myjson_trailing_zeroes(mask);
+        }
+    }
+
+    return i + _myjson_scan_string_fallback(string + i, length - i);
+};
+
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_count_newlines_avx2(const JsonChar_t *string, size_t length,
+                                                                       size_t *tail) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t count = 0, last = 0, i = 0, rest;
+
+    for (; length - i >= 32; i += 32) {
+        uint64_t mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(string + i)), newline));
+
+        if (mask) {
+            count += _myjson_popcount(mask);
+            last = i + 64 - _myjson_leading_zeroes(mask);
+        }
+    }
+
+    count += _myjson_count_newlines_fallback(string + i, length - i, &rest);
+    *tail = (rest != length - i) ? rest : length - last;
+
+    return count;
+};
+
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_narrow_utf16_avx2(const unsigned char *string, size_t count,
+                                                                     int big_endian, JsonChar_t *output) {
+    const __m256i mask = _mm256_set1_epi16((short)(big_endian ? 0x80FF : 0xFF80));
+    size_t i = 0;
+
+    for (; count - i >= 32; i += 32) {
+        __m256i low = _mm256_loadu_si256((const __m256i *)(string + i * 2));
+        __m256i high = _mm256_loadu_si256((const __m256i *)(string + i * 2 + 32));
+
+        if (!_mm256_testz_si256(_mm256_or_si256(low, high), mask)) {
+            break;
+        }
+
+        if (big_endian) {
+            low = _mm256_srli_epi16(low, 8);
+            high = _mm256_srli_epi16(high, 8);
+        }
+
+        /* The packing works within lanes: put the quarters back in order. */
+        _mm256_storeu_si256((__m256i *)(output + i),
+                            _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8));
+    }
+
+    return i + _myjson_narrow_utf16_fallback(string + i * 2, count - i, big_endian, output + i);
+};
+
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_narrow_utf32_avx2(const unsigned char *string, size_t count,
+                                                                     int big_endian, JsonChar_t *output) {
+    const __m256i mask = _mm256_set1_epi32((int)(big_endian ? 0x80FFFFFFU : 0xFFFFFF80U));
+    size_t i = 0;
+
+    for (; count - i >= 16; i += 16) {
+        __m256i low = _mm256_loadu_si256((const __m256i *)(string + i * 4));
+        __m256i high = _mm256_loadu_si256((const __m256i *)(string + i * 4 + 32));
+        __m256i units;
+
+        if (!_mm256_testz_si256(_mm256_or_si256(low, high), mask)) {
+            break;
+        }
+
+        if (big_endian) {
+            low = _mm256_srli_epi32(low, 24);
+            high = _mm256_srli_epi32(high, 24);
+        }
+
+        units = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+        _mm_storeu_si128((__m128i *)(output + i),
+                         _mm_packus_epi16(_mm256_castsi256_si128(units), _mm256_extracti128_si256(units, 1)));
+    }
+
+    return i + _myjson_narrow_utf32_fallback(string + i * 4, count - i, big_endian, output + i);
+};
+
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_widen_utf16_avx2(const JsonChar_t *string, size_t length,
+                                                                    int big_endian, unsigned char *output) {
+    size_t i = 0;
+
+    for (; length - i >= 32; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(string + i));
+        __m256i low, high;
+
+        if (_mm256_movemask_epi8(in)) {
+            break;
+        }
+
+        low = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(in));
+        high = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(in, 1));
+        if (big_endian) {
+            low = _mm256_slli_epi16(low, 8);
+            high = _mm256_slli_epi16(high, 8);
+        }
+
+        _mm256_storeu_si256((__m256i *)(output + i * 2), low);
+        _mm256_storeu_si256((__m256i *)(output + i * 2 + 32), high);
+    }
+
+    return i + _myjson_widen_utf16_fallback(string + i, length - i, big_endian, output + i * 2);
+};
+
+static MYJSON_TARGET("avx2,popcnt") size_t _myjson_widen_utf32_avx2(const JsonChar_t *string, size_t length,
+                                                                    int big_endian, unsigned char *output) {
+    size_t i = 0;
+
+    for (; length - i >= 32; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(string + i));
+        __m128i halves[2];
+        int j;
+
+        if (_mm256_movemask_epi8(in)) {
+            break;
+        }
+
+        halves[0] = _mm256_castsi256_si128(in);
+        halves[1] = _mm256_extracti128_si256(in, 1);
+
+        for (j = 0; j < 4; j++) {
+            __m128i quarter = (j & 1) ? _mm_srli_si128(halves[j >> 1], 8) : halves[j >> 1];
+            __m256i units = _mm256_cvtepu8_epi32(quarter);
+
+            if (big_endian) {
+                units = _mm256_slli_epi32(units, 24);
+            }
+            _mm256_storeu_si256((__m256i *)(output + i * 4 + j * 32), units);
+        }
+    }
+
+    return i + _myjson_widen_utf32_fallback(string + i, length - i, big_endian, output + i * 4);
+};
+
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") int _myjson_utf8_check_avx512(__m512i input, uint32_t *previous) {
+    const __m512i byte_1_high = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)_myjson_utf8_byte_1_high));
+    const __m512i byte_1_low = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)_myjson_utf8_byte_1_low));
+    const __m512i byte_2_high = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)_myjson_utf8_byte_2_high));
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    __m512i shifted, prev1, prev2, prev3, special, must23, error;
+
+    /* An ASCII block is valid unless the previous block left a sequence open. */
+    if (!_mm512_movepi8_mask(input) && !_myjson_utf8_pending(*previous)) {
+        *previous = 0;
+        return MYJSON_SUCCESS;
+    }
+
+    /* The bytes before each lane: the end of the previous block, then the lower lanes of the input. */
+    shifted = _mm512_permutex2var_epi64(_mm512_inserti32x4(_mm512_setzero_si512(),
+                                                           _mm_set_epi32((int)*previous, 0, 0, 0), 3),
+                                        _mm512_set_epi64(13, 12, 11, 10, 9, 8, 7, 6), input);
+    prev1 = _mm512_alignr_epi8(input, shifted, 15);
+    prev2 = _mm512_alignr_epi8(input, shifted, 14);
+    prev3 = _mm512_alignr_epi8(input, shifted, 13);
+    special = _mm512_and_si512(
+        _mm512_and_si512(_mm512_shuffle_epi8(byte_1_high, _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble)),
+                         _mm512_shuffle_epi8(byte_1_low, _mm512_and_si512(prev1, nibble))),
+        _mm512_shuffle_epi8(byte_2_high, _mm512_and_si512(_mm512_srli_epi16(input, 4), nibble)));
+    must23 = _mm512_or_si512(_mm512_subs_epu8(prev2, _mm512_set1_epi8((char)(0xE0 - 0x80))),
+                             _mm512_subs_epu8(prev3, _mm512_set1_epi8((char)(0xF0 - 0x80))));
+    error = _mm512_xor_si512(_mm512_and_si512(must23, _mm512_set1_epi8((char)0x80)), special);
+
+    if (_mm512_test_epi8_mask(error, error)) {
+        return MYJSON_FAILURE;
+    }
+
+    *previous = (uint32_t)_mm_extract_epi32(_mm512_extracti32x4_epi32(input, 3), 3);
+
+    return MYJSON_SUCCESS;
+};
+
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") int _myjson_classify_block_avx512(const JsonChar_t *block,
+                                                                                  JsonStructuralBlock *masks,
+                                                                                  uint32_t *previous) {
+    /* Tables indexed by the low nibble; 0x80 never matches an ASCII byte. */
+    const __m512i whitespace_table = _mm512_broadcast_i32x4(_mm_setr_epi8(
+        ' ', -128, -128, -128, -128, -128, -128, -128, -128, '\t', '\n', -128, -128, '\r', -128, -128));
+    const __m512i op_table = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, ':', -128, ',', -128, -128, -128));
+    const __m512i curly_table = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, '{', -128, '}', -128, -128));
+    __m512i in = _mm512_loadu_si512((const void *)block);
+    __m512i curly = _mm512_or_si512(in, _mm512_set1_epi8(0x20));
+
+    masks->quote = _mm512_cmpeq_epi8_mask(in, _mm512_set1_epi8('"'));
+    masks->backslash = _mm512_cmpeq_epi8_mask(in, _mm512_set1_epi8('\\'));
+    masks->whitespace = _mm512_cmpeq_epi8_mask(in, _mm512_shuffle_epi8(whitespace_table, in));
+    masks->op = _mm512_cmpeq_epi8_mask(in, _mm512_shuffle_epi8(op_table, in)) |
+                _mm512_cmpeq_epi8_mask(curly, _mm512_shuffle_epi8(curly_table, in));
+
+    return _myjson_utf8_check_avx512(in, previous);
+};
+
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_validate_utf8_avx512(const JsonChar_t *string,
+                                                                                    size_t length) {
+    uint32_t previous = 0;
+    size_t i = 0;
+
+    for (; length - i >= MYJSON_STRUCTURAL_BLOCK_SIZE; i += MYJSON_STRUCTURAL_BLOCK_SIZE) {
+        if (!_myjson_utf8_check_avx512(_mm512_loadu_si512((const void *)(string + i)), &previous)) {
+            break;
+        }
+    }
+
+    /* Locate the error (or check the tail) from the start of the open sequence. */
+    i -= _myjson_utf8_pending(previous);
+
+    return i + _myjson_validate_utf8_fallback(string + i, length - i);
+};
+
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_scan_string_avx512(const JsonChar_t *string,
+                                                                                   size_t length) {
+    const __m512i quote = _mm512_set1_epi8('"');
+    const __m512i backslash = _mm512_set1_epi8('\\');
+    const __m512i control = _mm512_set1_epi8(0x20);
+    size_t i = 0;
+
+    for (; i < length; i += 64) {
+        /* The tail is loaded with a mask, the missing bytes read as zero. */
+        uint64_t valid = (length - i >= 64) ? ~0ULL : (~0ULL >> (64 - (length - i)));
+        __m512i in = _mm512_maskz_loadu_epi8(valid, (const void *)(string + i));
+        uint64_t mask = (_mm512_cmpeq_epi8_mask(in, quote) | _mm512_cmpeq_epi8_mask(in, backslash) |
+                         _mm512_cmplt_epu8_mask(in, control)) &
+                        valid;
+
+        if (mask) {
+            return i + _myjson_trailing_zeroes(mask);
+        }
+    }
+
+    return length;
+};
+
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_count_newlines_avx512(const JsonChar_t *string,
+                                                                                      size_t length, size_t *tail) {
+    const __m512i newline = _mm512_set1_epi8('\n');
+    size_t count = 0, last = 0, i = 0;
+
+    for (; i < length; i += 64) {
+        uint64_t valid = (length - i >= 64) ? ~0ULL : (~0ULL >> (64 - (length - i)));
+        uint64_t mask = _mm512_cmpeq_epi8_mask(_mm512_maskz_loadu_epi8(valid, (const void *)(string + i)), newline);
+
+        if (mask) {
+            count += _myjson_popcount(mask);
+            last = i + 64 - _myjson_leading_zeroes(mask);
+        }
+    }
+
+    *tail = length - last;
+
+    return count;
+};
+
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_narrow_utf16_avx512(const unsigned char *string,
+                                                                                   size_t count, int big_endian,
+                                                                                   JsonChar_t *output) {
+    const __m512i mask = _mm512_set1_epi16((short)(big_endian ? 0x80FF : 0xFF80));
+    size_t i = 0;
+
+    for (; count - i >= 32; i += 32) {
+        __m512i in = _mm512_loadu_si512((const void *)(string + i * 2));
+
+        if (_mm512_test_epi16_mask(in, mask)) {
+            break;
+        }
+
+        if (big_endian) {
+            in = _mm512_srli_epi16(in, 8);
+        }
+
+        _mm256_storeu_si256((__m256i *)(output + i), _mm512_cvtepi16_epi8(in));
+    }
+
+    return i + _myjson_narrow_utf16_fallback(string + i * 2, count - i, big_endian, output + i);
+};
+
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_narrow_utf32_avx512(const unsigned char *string,
+                                                                                   size_t count, int big_endian,
+                                                                                   JsonChar_t *output) {
+    const __m512i mask = _mm512_set1_epi32((int)(big_endian ? 0x80FFFFFFU : 0xFFFFFF80U));
+    size_t i = 0;
+
+    for (; count - i >= 16; i += 16) {
+        __m512i in = _mm512_loadu_si512((const void *)(string + i * 4));
+
+        if (_mm512_test_epi32_mask(in, mask)) {
+            break;
+        }
+
+        if (big_endian) {
+            in = _mm512_srli_epi32(in, 24);
+        }
+
+        _mm_storeu_si128((__m128i *)(output + i), _mm512_cvtepi32_epi8(in));
+    }
+
+    return i + _myjson_narrow_utf32_fallback(string + i * 4, count - i, big_endian, output + i);
+};
+
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_widen_utf16_avx512(const JsonChar_t *string,
+                                                                                  size_t length, int big_endian,
+                                                                                  unsigned char *output) {
+    size_t i = 0;
+
+    for (; length - i >= 32; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(string + i));
+        __m512i units;
+
+        if (_mm256_movemask_epi8(in)) {
+            break;
+        }
+
+        units = _mm512_cvtepu8_epi16(in);
+        if (big_endian) {
+            units = _mm512_slli_epi16(units, 8);
+        }
+
+        _mm512_storeu_si512((void *)(output + i * 2), units);
+    }
+
+    return i + _myjson_widen_utf16_fallback(string + i, length - i, big_endian, output + i * 2);
+};
+
+static MYJSON_TARGET("avx512f,avx512bw,popcnt") size_t _myjson_widen_utf32_avx512(const JsonChar_t *string,
+                                                                                  size_t length, int big_endian,
+                                                                                  unsigned char *output) {
+    size_t i = 0;
+
+    for (; length - i >= 16; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(string + i));
+        __m512i units;
+
+        if (_mm_movemask_epi8(in)) {
+            break;
+        }
+
+        units = _mm512_cvtepu8_epi32(in);
+        if (big_endian) {
+            units = _mm512_slli_epi32(units, 24);
+        }
+
+        _mm512_storeu_si512((void *)(output + i * 4), units);
+    }
+
+    return i + _myjson_widen_utf32_fallback(string + i, length - i, big_endian, output + i * 4);
+};
+
+static int _myjson_cpu_features(void) {
+    static volatile int detected = -1;
+    unsigned int leaf1_ecx = 0, leaf7_ebx = 0;
+    uint64_t xcr0 = 0;
+    int features = _myjson_atomic_load(&detected);
+
+    if (features >= 0) {
+        return features;
+    }
+
+#if MYJSON_COMPILER_IS(MSVC)
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuidex(info, 7, 0);
+        leaf7_ebx = (unsigned int)info[1];
+    }
+    __cpuid(info, 1);
+    leaf1_ecx = (unsigned int)info[2];
+    if (leaf1_ecx & (1u << 27)) {
+        xcr0 = _xgetbv(0);
+    }
+#else
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0, NULL) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        leaf7_ebx = ebx;
+    }
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        leaf1_ecx = ecx;
+    }
+    /* The OS must save the vector registers (XGETBV is only valid with OSXSAVE). */
+    if (leaf1_ecx & (1u << 27)) {
+        __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        xcr0 = ((uint64_t)edx << 32) | eax;
+    }
+#endif
+
+    features = 0;
+
+    if ((leaf1_ecx & (1u << 20)) && (leaf1_ecx & (1u << 23))) {
+        features |= MYJSON_CPU_SSE42;
+    }
+    if ((leaf1_ecx & (1u << 28)) && (leaf7_ebx & (1u << 5)) && (xcr0 & 0x6) == 0x6) {
+        features |= MYJSON_CPU_AVX2;
+    }
+    if ((leaf7_ebx & (1u << 16)) && (leaf7_ebx & (1u << 30)) && (xcr0 & 0xE6) == 0xE6) {
+        features |= MYJSON_CPU_AVX512;
+    }
+
+    /* Only the whole set is published; threads racing here store the same value. */
+    _myjson_atomic_store(&detected, features);
+
+    return features;
+};
+
+#endif  // MYJSON_X86_KERNELS
+
+/*
+ * The kernel registry, from the most portable to the fastest.
+ */
+static const JsonKernel _myjson_kernels[] = {
+    {JSON_FALLBACK_KERNEL, _myjson_classify_block_fallback, _myjson_validate_utf8_fallback,
+     _myjson_scan_string_fallback, _myjson_count_newlines_fallback, _myjson_narrow_utf16_fallback,
+     _myjson_narrow_utf32_fallback, _myjson_widen_utf16_fallback, _myjson_widen_utf32_fallback},
+#if MYJSON_X86_KERNELS
+    {JSON_SSE42_KERNEL, _myjson_classify_block_sse42, _myjson_validate_utf8_sse42, _myjson_scan_string_sse42,
+     _myjson_count_newlines_sse42, _myjson_narrow_utf16_sse42, _myjson_narrow_utf32_sse42, _myjson_widen_utf16_sse42,
+     _myjson_widen_utf32_sse42},
+    {JSON_AVX2_KERNEL, _myjson_classify_block_avx2, _myjson_validate_utf8_avx2, _myjson_scan_string_avx2,
+     _myjson_count_newlines_avx2, _myjson_narrow_utf16_avx2, _myjson_narrow_utf32_avx2, _myjson_widen_utf16_avx2,
+     _myjson_widen_utf32_avx2},
+    {JSON_AVX512_KERNEL, _myjson_classify_block_avx512, _myjson_validate_utf8_avx512, _myjson_scan_string_avx512,
+     _myjson_count_newlines_avx512, _myjson_narrow_utf16_avx512, _myjson_narrow_utf32_avx512,
+     _myjson_widen_utf16_avx512, _myjson_widen_utf32_avx512},
+#endif  // MYJSON_X86_KERNELS
+};
+
+/*
+ * The forced kernel type in the low byte, and the selected one (0 until it is resolved) in the next.  Both live
+ * in one word so that a selection and a resolution racing each other never mix.
+ */
+static volatile int _myjson_kernel_state = JSON_AUTO_KERNEL;
+
+static const JsonKernel *_myjson_kernel_find(JsonKernelType type) {
+    size_t i;
+
+    for (i = 0; i < sizeof(_myjson_kernels) / sizeof(_myjson_kernels[0]); i++) {
+        if (_myjson_kernels[i].type == type) {
+            return &_myjson_kernels[i];
+        }
+    }
+
+    return NULL;
+};
+
+static const JsonKernel *_myjson_kernel_resolve(void) {
+    int state = _myjson_atomic_load(&_myjson_kernel_state);
+    JsonKernelType type = (JsonKernelType)(state & 0xFF);
+    const char *name;
+    size_t i;
+
+    if (state >> 8) {
+        return _myjson_kernel_find((JsonKernelType)(state >> 8));
+    }
+
+    /* An unknown or unsupported MYJSON_KERNEL is ignored. */
+    if (type == JSON_AUTO_KERNEL && (name = getenv("MYJSON_KERNEL"))) {
+        for (i = JSON_FALLBACK_KERNEL; i <= JSON_AVX512_KERNEL; i++) {
+            if (!strcmp(name, json_kernel_get_name((JsonKernelType)i)) && json_kernel_is_supported((JsonKernelType)i)) {
+                type = (JsonKernelType)i;
+                break;
+            }
+        }
+    }
+
+    if (type == JSON_AUTO_KERNEL) {
+        for (i = sizeof(_myjson_kernels) / sizeof(_myjson_kernels[0]); i > 0; i--) {
+            if (json_kernel_is_supported(_myjson_kernels[i - 1].type)) {
+                type = _myjson_kernels[i - 1].type;
+                break;
+            }
+        }
+    }
+
+    /* A selection made meanwhile wins; this caller still gets the kernel it resolved. */
+    _myjson_atomic_compare_exchange(&_myjson_kernel_state, state, state | ((int)type << 8));
+
+    return _myjson_kernel_find(type);
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Strings
+//-----------------------------------------------------------------------------
+
+static int _myjson_parse_hex4(const JsonChar_t *digits, unsigned int *code) {
+    int i;
+
+    *code = 0;
+
+    for (i = 0; i < 4; i++) {
+        JsonChar_t c = digits[i];
+
+        *code <<= 4;
+        if (c >= '0' && c <= '9') {
+            *code |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            *code |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            *code |= c - 'A' + 10;
+        } else {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static const char *_myjson_unescape(const JsonKernel *kernel, const JsonChar_t *string, size_t length,
+                                    JsonChar_t *value, size_t *value_length, size_t *problem_offset) {
+    const JsonChar_t *pointer = string;
+    const JsonChar_t *end = string + length;
+    size_t written = 0;
+
+    while (pointer != end) {
+        size_t run = kernel->scan_string(pointer, end - pointer);
+        JsonChar_t units[4];
+        size_t count = 1;
+        unsigned int code;
+
+        /* Copy the characters up to the next escape at once (`value` may be `string`). */
+        if (value) {
+            memmove(value + written, pointer, run);
+        }
+        written += run;
+        pointer += run;
+
+        if (pointer == end) {
+            break;
+        }
+
+        *problem_offset = pointer - string;
+
+        if (*pointer != '\\') {
+            return "found control character in string";
+        }
+
+        if (end - pointer < 2) {
+            return "found unknown escape character";
+        }
+
+        switch (pointer[1]) {
+            case '"':
+            case '\\':
+            case '/':
+                units[0] = pointer[1];
+                break;
+            case 'b':
+                units[0] = '\b';
+                break;
+            case 'f':
+                units[0] = '\f';
+                break;
+            case 'n':
+                units[0] = '\n';
+                break;
+            case 'r':
+                units[0] = '\r';
+                break;
+            case 't':
+                units[0] = '\t';
+                break;
+            case 'u':
+                count = 0;
+                break;
+            default:
+                return "found unknown escape character";
+        }
+
+        if (count) {
+            pointer += 2;
+        } else {
+            if (end - pointer < 6 || !_myjson_parse_hex4(pointer + 2, &code)) {
+                return "found invalid unicode escape sequence";
+            }
+
+            /* Combine a surrogate pair. */
+            if (code >= 0xD800 && code <= 0xDBFF) {
+                unsigned int low;
+
+                if (end - pointer < 12 || pointer[6] != '\\' || pointer[7] != 'u' ||
+                    !_myjson_parse_hex4(pointer + 8, &low) || low < 0xDC00 || low > 0xDFFF) {
+                    return "found invalid surrogate pair";
+                }
+
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                pointer += 6;
+            } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                return "found invalid surrogate pair";
+            }
+
+            pointer += 6;
+            count = _myjson_utf8_encode(code, units);
+        }
+
+        if (value) {
+            memcpy(value + written, units, count);
+        }
+        written += count;
+    }
+
+    *value_length = written;
+
+    return NULL;
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Atoms
+//-----------------------------------------------------------------------------
+
+static uint32_t _myjson_atom_hash(const JsonChar_t *value, size_t length) {
+    uint32_t hash = 2166136261U;
+
+    while (length--) {
+        hash = (hash ^ *value++) * 16777619U;
+    }
+
+    return hash;
+};
+
+static int *_myjson_atom_table_slot(const JsonAtomTable *table, const JsonChar_t *value, size_t length,
+                                    uint32_t hash) {
+    size_t mask = (size_t)(table->slots.end - table->slots.start) - 1;
+    size_t index = hash & mask;
+
+    /* Linear probing: the index is never more than half full. */
+    for (;; index = (index + 1) & mask) {
+        int *slot = table->slots.start + index;
+        JsonAtom *atom;
+
+        if (!*slot) {
+            return slot;
+        }
+
+        atom = table->atoms.start + *slot - 1;
+        if (atom->hash == hash && atom->length == length && !memcmp(atom->value, value, length)) {
+            return slot;
+        }
+    }
+};
+
+static int _myjson_atom_table_grow(JsonAtomTable *table) {
+    size_t size = (size_t)(table->slots.end - table->slots.start) * 2;
+    int *slots = (int *)_myjson_malloc(table->allocator, size * sizeof(int));
+    JsonAtom *atom;
+
+    if (!slots) {
+        return MYJSON_FAILURE;
+    }
+
+    _myjson_free(table->allocator, table->slots.start, (size / 2) * sizeof(int));
+    memset(slots, 0, size * sizeof(int));
+    table->slots.start = slots;
+    table->slots.end = slots + size;
+
+    for (atom = table->atoms.start; atom != table->atoms.top; atom++) {
+        *_myjson_atom_table_slot(table, atom->value, atom->length, atom->hash) = (int)(atom - table->atoms.start) + 1;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static JsonChar_t *_myjson_atom_table_store(JsonAtomTable *table, const JsonChar_t *value, size_t length) {
+    JsonChar_t *string;
+
+    if ((size_t)(table->strings.end - table->strings.pointer) < length + 1) {
+        size_t chunk_size = table->strings.chunks ? table->strings.chunks->size * 2 : MYJSON_ARENA_CHUNK_SIZE;
+        JsonArenaChunk *chunk;
+
+        if (chunk_size > MYJSON_ARENA_MAX_CHUNK_SIZE) {
+            chunk_size = MYJSON_ARENA_MAX_CHUNK_SIZE;
+        }
+        if (chunk_size < length + 1) {
+            chunk_size = length + 1;
+        }
+
+        chunk = (JsonArenaChunk *)_myjson_malloc(table->allocator, sizeof(JsonArenaChunk) + chunk_size);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->size = chunk_size;
+        chunk->next = table->strings.chunks;
+        table->strings.chunks = chunk;
+        table->strings.pointer = (JsonChar_t *)(chunk + 1);
+        table->strings.end = table->strings.pointer + chunk_size;
+    }
+
+    string = table->strings.pointer;
+    table->strings.pointer += length + 1;
+    memcpy(string, value, length);
+    string[length] = '\0';
+
+    return string;
+};
+
+static int *_myjson_document_key_node(JsonDocument *document, int atom) {
+    size_t size = (size_t)(document->keys.end - document->keys.start), new_size;
+    int *keys;
+
+    if ((size_t)atom <= size) {
+        return document->keys.start + atom - 1;
+    }
+
+    /* The map is sized for the whole table at first, so that a shared table is mapped at once. */
+    new_size = size ? size * 2 : (size_t)(document->atoms->atoms.top - document->atoms->atoms.start);
+    if (new_size < MYJSON_INITIAL_STACK_SIZE) {
+        new_size = MYJSON_INITIAL_STACK_SIZE;
+    }
+    while (new_size < (size_t)atom) {
+        new_size *= 2;
+    }
+
+    /* The old map is left to the arena. */
+    keys = (int *)_myjson_arena_alloc(document, new_size * sizeof(int), sizeof(int));
+    if (!keys) {
+        return NULL;
+    }
+    if (size) {
+        memcpy(keys, document->keys.start, size * sizeof(int));
+    }
+    memset(keys + size, 0, (new_size - size) * sizeof(int));
+
+    document->keys.start = keys;
+    document->keys.end = keys + new_size;
+
+    return keys + atom - 1;
+};
+
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
+//-----------------------------------------------------------------------------
+// [SECTION] Numbers
+//-----------------------------------------------------------------------------
+
+/* The exact powers of ten from 1e0 to 1e22 (the Clinger fast path). */
+static const double _myjson_exact_powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                     1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                     1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/* The 128-bit mantissas (rounded down) of the powers of ten, high word first. */
+static const uint64_t _myjson_powers_of_ten[][2] = {
+    {0xFA8FD5A0081C0288ULL, 0x1732C869CD60E453ULL}, /* 1e-348 */
+    {0x9C99E58405118195ULL, 0x0E7FBD42205C8EB4ULL}, /* 1e-347 */
+    {0xC3C05EE50655E1FAULL, 0x521FAC92A873B261ULL}, /* 1e-346 */
+    {0xF4B0769E47EB5A78ULL, 0xE6A797B752909EF9ULL}, /* 1e-345 */
+    {0x98EE4A22ECF3188BULL, 0x9028BED2939A635CULL}, /* 1e-344 */
+    {0xBF29DCABA82FDEAEULL, 0x7432EE873880FC33ULL}, /* 1e-343 */
+    {0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL}, /* 1e-342 */
+    {0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL}, /* 1e-341 */
+    {0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL}, /* 1e-340 */
+    {0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL}, /* 1e-339 */
+    {0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL}, /* 1e-338 */
+    {0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL}, /* 1e-337 */
+    {0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL}, /* 1e-336 */
+    {0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL}, /* 1e-335 */
+    {0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL}, /* 1e-334 */
+    {0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL}, /* 1e-333 */
+    {0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL}, /* 1e-332 */
+    {0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL}, /* 1e-331 */
+    {0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL}, /* 1e-330 */
+    {0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL}, /* 1e-329 */
+    {0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL}, /* 1e-328 */
+    {0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL}, /* 1e-327 */
+    {0x84A57695FE98746DULL, 0x014BB630F7604B57ULL}, /* 1e-326 */
+    {0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL}, /* 1e-325 */
+    {0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL}, /* 1e-324 */
+    {0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL}, /* 1e-323 */
+    {0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL}, /* 1e-322 */
+    {0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL}, /* 1e-321 */
+    {0xFD00B897478238D0ULL, 0x8920B098955522B4ULL}, /* 1e-320 */
+    {0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL}, /* 1e-319 */
+    {0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL}, /* 1e-318 */
+    {0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL}, /* 1e-317 */
+    {0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL}, /* 1e-316 */
+    {0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL}, /* 1e-315 */
+    {0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL}, /* 1e-314 */
+    {0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL}, /* 1e-313 */
+    {0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL}, /* 1e-312 */
+    {0xEBA09271E88D976BULL, 0xF7864A44C633682EULL}, /* 1e-311 */
+    {0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL}, /* 1e-310 */
+    {0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL}, /* 1e-309 */
+    {0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL}, /* 1e-308 */
+    {0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL}, /* 1e-307 */
+    {0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL}, /* 1e-306 */
+    {0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL}, /* 1e-305 */
+    {0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL}, /* 1e-304 */
+    {0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL}, /* 1e-303 */
+    {0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL}, /* 1e-302 */
+    {0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL}, /* 1e-301 */
+    {0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL}, /* 1e-300 */
+    {0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL}, /* 1e-299 */
+    {0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL}, /* 1e-298 */
+    {0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL}, /* 1e-297 */
+    {0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL}, /* 1e-296 */
+    {0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL}, /* 1e-295 */
+    {0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL}, /* 1e-294 */
+    {0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL}, /* 1e-293 */
+    {0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL}, /* 1e-292 */
+    {0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL}, /* 1e-291 */
+    {0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL}, /* 1e-290 */
+    {0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL}, /* 1e-289 */
+    {0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL}, /* 1e-288 */
+    {0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL}, /* 1e-287 */
+    {0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL}, /* 1e-286 */
+    {0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL}, /* 1e-285 */
+    {0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL}, /* 1e-284 */
+    {0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL}, /* 1e-283 */
+    {0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL}, /* 1e-282 */
+    {0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL}, /* 1e-281 */
+    {0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL}, /* 1e-280 */
+    {0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL}, /* 1e-279 */
+    {0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL}, /* 1e-278 */
+    {0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL}, /* 1e-277 */
+    {0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL}, /* 1e-276 */
+    {0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL}, /* 1e-275 */
+    {0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL}, /* 1e-274 */
+    {0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL}, /* 1e-273 */
+    {0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL}, /* 1e-272 */
+    {0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL}, /* 1e-271 */
+    {0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL}, /* 1e-270 */
+    {0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL}, /* 1e-269 */
+    {0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL}, /* 1e-268 */
+    {0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL}, /* 1e-267 */
+    {0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL}, /* 1e-266 */
+    {0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL}, /* 1e-265 */
+    {0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL}, /* 1e-264 */
+    {0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL}, /* 1e-263 */
+    {0xC987434744AC874EULL, 0xA327FFB266B56220ULL}, /* 1e-262 */
+    {0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL}, /* 1e-261 */
+    {0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL}, /* 1e-260 */
+    {0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL}, /* 1e-259 */
+    {0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL}, /* 1e-258 */
+    {0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL}, /* 1e-257 */
+    {0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL}, /* 1e-256 */
+    {0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL}, /* 1e-255 */
+    {0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL}, /* 1e-254 */
+    {0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL}, /* 1e-253 */
+    {0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL}, /* 1e-252 */
+    {0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL}, /* 1e-251 */
+    {0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL}, /* 1e-250 */
+    {0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL}, /* 1e-249 */
+    {0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL}, /* 1e-248 */
+    {0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL}, /* 1e-247 */
+    {0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL}, /* 1e-246 */
+    {0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL}, /* 1e-245 */
+    {0xAECC49914078536DULL, 0x58FAE9F773886E18ULL}, /* 1e-244 */
+    {0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL}, /* 1e-243 */
+    {0x888F99797A5E012DULL, 0x6D8406C952429603ULL}, /* 1e-242 */
+    {0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL}, /* 1e-241 */
+    {0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL}, /* 1e-240 */
+    {0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL}, /* 1e-239 */
+    {0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL}, /* 1e-238 */
+    {0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL}, /* 1e-237 */
+    {0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL}, /* 1e-236 */
+    {0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL}, /* 1e-235 */
+    {0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL}, /* 1e-234 */
+    {0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL}, /* 1e-233 */
+    {0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL}, /* 1e-232 */
+    {0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL}, /* 1e-231 */
+    {0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL}, /* 1e-230 */
+    {0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL}, /* 1e-229 */
+    {0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL}, /* 1e-228 */
+    {0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL}, /* 1e-227 */
+    {0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL}, /* 1e-226 */
+    {0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL}, /* 1e-225 */
+    {0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL}, /* 1e-224 */
+    {0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL}, /* 1e-223 */
+    {0xB913179899F68584ULL, 0x28E2557B59846E3FULL}, /* 1e-222 */
+    {0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL}, /* 1e-221 */
+    {0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL}, /* 1e-220 */
+    {0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL}, /* 1e-219 */
+    {0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL}, /* 1e-218 */
+    {0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL}, /* 1e-217 */
+    {0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL}, /* 1e-216 */
+    {0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL}, /* 1e-215 */
+    {0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL}, /* 1e-214 */
+    {0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL}, /* 1e-213 */
+    {0xD77485CB25823AC7ULL, 0x7D633293366B828BULL}, /* 1e-212 */
+    {0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL}, /* 1e-211 */
+    {0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL}, /* 1e-210 */
+    {0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL}, /* 1e-209 */
+    {0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL}, /* 1e-208 */
+    {0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL}, /* 1e-207 */
+    {0xCD795BE870516656ULL, 0x67902E276C921F8BULL}, /* 1e-206 */
+    {0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL}, /* 1e-205 */
+    {0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL}, /* 1e-204 */
+    {0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL}, /* 1e-203 */
+    {0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL}, /* 1e-202 */
+    {0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL}, /* 1e-201 */
+    {0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL}, /* 1e-200 */
+    {0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL}, /* 1e-199 */
+    {0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL}, /* 1e-198 */
+    {0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL}, /* 1e-197 */
+    {0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL}, /* 1e-196 */
+    {0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL}, /* 1e-195 */
+    {0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL}, /* 1e-194 */
+    {0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL}, /* 1e-193 */
+    {0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL}, /* 1e-192 */
+    {0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL}, /* 1e-191 */
+    {0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL}, /* 1e-190 */
+    {0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL}, /* 1e-189 */
+    {0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL}, /* 1e-188 */
+    {0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL}, /* 1e-187 */
+    {0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL}, /* 1e-186 */
+    {0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL}, /* 1e-185 */
+    {0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL}, /* 1e-184 */
+    {0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL}, /* 1e-183 */
+    {0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL}, /* 1e-182 */
+    {0xD47487CC8470652BULL, 0x7647C3200069671FULL}, /* 1e-181 */
+    {0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL}, /* 1e-180 */
+    {0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL}, /* 1e-179 */
+    {0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL}, /* 1e-178 */
+    {0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL}, /* 1e-177 */
+    {0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL}, /* 1e-176 */
+    {0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL}, /* 1e-175 */
+    {0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL}, /* 1e-174 */
+    {0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL}, /* 1e-173 */
+    {0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL}, /* 1e-172 */
+    {0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL}, /* 1e-171 */
+    {0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL}, /* 1e-170 */
+    {0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL}, /* 1e-169 */
+    {0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL}, /* 1e-168 */
+    {0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL}, /* 1e-167 */
+    {0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL}, /* 1e-166 */
+    {0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL}, /* 1e-165 */
+    {0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL}, /* 1e-164 */
+    {0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL}, /* 1e-163 */
+    {0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL}, /* 1e-162 */
+    {0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL}, /* 1e-161 */
+    {0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL}, /* 1e-160 */
+    {0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL}, /* 1e-159 */
+    {0x8C974F7383725573ULL, 0x1E414218C73A13FBULL}, /* 1e-158 */
+    {0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL}, /* 1e-157 */
+    {0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL}, /* 1e-156 */
+    {0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL}, /* 1e-155 */
+    {0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL}, /* 1e-154 */
+    {0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL}, /* 1e-153 */
+    {0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL}, /* 1e-152 */
+    {0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL}, /* 1e-151 */
+    {0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL}, /* 1e-150 */
+    {0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL}, /* 1e-149 */
+    {0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL}, /* 1e-148 */
+    {0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL}, /* 1e-147 */
+    {0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL}, /* 1e-146 */
+    {0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL}, /* 1e-145 */
+    {0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL}, /* 1e-144 */
+    {0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL}, /* 1e-143 */
+    {0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL}, /* 1e-142 */
+    {0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL}, /* 1e-141 */
+    {0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL}, /* 1e-140 */
+    {0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL}, /* 1e-139 */
+    {0xBE89523386091465ULL, 0xF6BBB397F1135823ULL}, /* 1e-138 */
+    {0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL}, /* 1e-137 */
+    {0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL}, /* 1e-136 */
+    {0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL}, /* 1e-135 */
+    {0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL}, /* 1e-134 */
+    {0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL}, /* 1e-133 */
+    {0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL}, /* 1e-132 */
+    {0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL}, /* 1e-131 */
+    {0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL}, /* 1e-130 */
+    {0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL}, /* 1e-129 */
+    {0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL}, /* 1e-128 */
+    {0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL}, /* 1e-127 */
+    {0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL}, /* 1e-126 */
+    {0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL}, /* 1e-125 */
+    {0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL}, /* 1e-124 */
+    {0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL}, /* 1e-123 */
+    {0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL}, /* 1e-122 */
+    {0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL}, /* 1e-121 */
+    {0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL}, /* 1e-120 */
+    {0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL}, /* 1e-119 */
+    {0x811CCC668829B887ULL, 0x0806357D5A3F525FULL}, /* 1e-118 */
+    {0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL}, /* 1e-117 */
+    {0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL}, /* 1e-116 */
+    {0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL}, /* 1e-115 */
+    {0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL}, /* 1e-114 */
+    {0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL}, /* 1e-113 */
+    {0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL}, /* 1e-112 */
+    {0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL}, /* 1e-111 */
+    {0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL}, /* 1e-110 */
+    {0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL}, /* 1e-109 */
+    {0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL}, /* 1e-108 */
+    {0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL}, /* 1e-107 */
+    {0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL}, /* 1e-106 */
+    {0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL}, /* 1e-105 */
+    {0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL}, /* 1e-104 */
+    {0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL}, /* 1e-103 */
+    {0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL}, /* 1e-102 */
+    {0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL}, /* 1e-101 */
+    {0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL}, /* 1e-100 */
+    {0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL}, /* 1e-99 */
+    {0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL}, /* 1e-98 */
+    {0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL}, /* 1e-97 */
+    {0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL}, /* 1e-96 */
+    {0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL}, /* 1e-95 */
+    {0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL}, /* 1e-94 */
+    {0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL}, /* 1e-93 */
+    {0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL}, /* 1e-92 */
+    {0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL}, /* 1e-91 */
+    {0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL}, /* 1e-90 */
+    {0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL}, /* 1e-89 */
+    {0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL}, /* 1e-88 */
+    {0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL}, /* 1e-87 */
+    {0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL}, /* 1e-86 */
+    {0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL}, /* 1e-85 */
+    {0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL}, /* 1e-84 */
+    {0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL}, /* 1e-83 */
+    {0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL}, /* 1e-82 */
+    {0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL}, /* 1e-81 */
+    {0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL}, /* 1e-80 */
+    {0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL}, /* 1e-79 */
+    {0xED246723473E3813ULL, 0x290123E9AAB23B68ULL}, /* 1e-78 */
+    {0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL}, /* 1e-77 */
+    {0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL}, /* 1e-76 */
+    {0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL}, /* 1e-75 */
+    {0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL}, /* 1e-74 */
+    {0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL}, /* 1e-73 */
+    {0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL}, /* 1e-72 */
+    {0x8D590723948A535FULL, 0x579C487E5A38AD0EULL}, /* 1e-71 */
+    {0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL}, /* 1e-70 */
+    {0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL}, /* 1e-69 */
+    {0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL}, /* 1e-68 */
+    {0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL}, /* 1e-67 */
+    {0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL}, /* 1e-66 */
+    {0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL}, /* 1e-65 */
+    {0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL}, /* 1e-64 */
+    {0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL}, /* 1e-63 */
+    {0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL}, /* 1e-62 */
+    {0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL}, /* 1e-61 */
+    {0xCDB02555653131B6ULL, 0x3792F412CB06794DULL}, /* 1e-60 */
+    {0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL}, /* 1e-59 */
+    {0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL}, /* 1e-58 */
+    {0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL}, /* 1e-57 */
+    {0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL}, /* 1e-56 */
+    {0x9CED737BB6C4183DULL, 0x55464DD69685606BULL}, /* 1e-55 */
+    {0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL}, /* 1e-54 */
+    {0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL}, /* 1e-53 */
+    {0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL}, /* 1e-52 */
+    {0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL}, /* 1e-51 */
+    {0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL}, /* 1e-50 */
+    {0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL}, /* 1e-49 */
+    {0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL}, /* 1e-48 */
+    {0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL}, /* 1e-47 */
+    {0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL}, /* 1e-46 */
+    {0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL}, /* 1e-45 */
+    {0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL}, /* 1e-44 */
+    {0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL}, /* 1e-43 */
+    {0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL}, /* 1e-42 */
+    {0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL}, /* 1e-41 */
+    {0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL}, /* 1e-40 */
+    {0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL}, /* 1e-39 */
+    {0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL}, /* 1e-38 */
+    {0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL}, /* 1e-37 */
+    {0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL}, /* 1e-36 */
+    {0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL}, /* 1e-35 */
+    {0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL}, /* 1e-34 */
+    {0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL}, /* 1e-33 */
+    {0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL}, /* 1e-32 */
+    {0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL}, /* 1e-31 */
+    {0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL}, /* 1e-30 */
+    {0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL}, /* 1e-29 */
+    {0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL}, /* 1e-28 */
+    {0x9E74D1B791E07E48ULL, 0x775EA264CF55347DULL}, /* 1e-27 */
+    {0xC612062576589DDAULL, 0x95364AFE032A819DULL}, /* 1e-26 */
+    {0xF79687AED3EEC551ULL, 0x3A83DDBD83F52204ULL}, /* 1e-25 */
+    {0x9ABE14CD44753B52ULL, 0xC4926A9672793542ULL}, /* 1e-24 */
+    {0xC16D9A0095928A27ULL, 0x75B7053C0F178293ULL}, /* 1e-23 */
+    {0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6338ULL}, /* 1e-22 */
+    {0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E03ULL}, /* 1e-21 */
+    {0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF584ULL}, /* 1e-20 */
+    {0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E5ULL}, /* 1e-19 */
+    {0x9392EE8E921D5D07ULL, 0x3AFF322E62439FCFULL}, /* 1e-18 */
+    {0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C2ULL}, /* 1e-17 */
+    {0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B3ULL}, /* 1e-16 */
+    {0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A10ULL}, /* 1e-15 */
+    {0xB424DC35095CD80FULL, 0x538484C19EF38C94ULL}, /* 1e-14 */
+    {0xE12E13424BB40E13ULL, 0x2865A5F206B06FB9ULL}, /* 1e-13 */
+    {0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D3ULL}, /* 1e-12 */
+    {0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D748ULL}, /* 1e-11 */
+    {0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1BULL}, /* 1e-10 */
+    {0x89705F4136B4A597ULL, 0x31680A88F8953030ULL}, /* 1e-9 */
+    {0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3DULL}, /* 1e-8 */
+    {0xD6BF94D5E57A42BCULL, 0x3D32907604691B4CULL}, /* 1e-7 */
+    {0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B10FULL}, /* 1e-6 */
+    {0xA7C5AC471B478423ULL, 0x0FCF80DC33721D53ULL}, /* 1e-5 */
+    {0xD1B71758E219652BULL, 0xD3C36113404EA4A8ULL}, /* 1e-4 */
+    {0x83126E978D4FDF3BULL, 0x645A1CAC083126E9ULL}, /* 1e-3 */
+    {0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A3ULL}, /* 1e-2 */
+    {0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCCULL}, /* 1e-1 */
+    {0x8000000000000000ULL, 0x0000000000000000ULL}, /* 1e0 */
+    {0xA000000000000000ULL, 0x0000000000000000ULL}, /* 1e1 */
+    {0xC800000000000000ULL, 0x0000000000000000ULL}, /* 1e2 */
+    {0xFA00000000000000ULL, 0x0000000000000000ULL}, /* 1e3 */
+    {0x9C40000000000000ULL, 0x0000000000000000ULL}, /* 1e4 */
+    {0xC350000000000000ULL, 0x0000000000000000ULL}, /* 1e5 */
+    {0xF424000000000000ULL, 0x0000000000000000ULL}, /* 1e6 */
+    {0x9896800000000000ULL, 0x0000000000000000ULL}, /* 1e7 */
+    {0xBEBC200000000000ULL, 0x0000000000000000ULL}, /* 1e8 */
+    {0xEE6B280000000000ULL, 0x0000000000000000ULL}, /* 1e9 */
+    {0x9502F90000000000ULL, 0x0000000000000000ULL}, /* 1e10 */
+    {0xBA43B74000000000ULL, 0x0000000000000000ULL}, /* 1e11 */
+    {0xE8D4A51000000000ULL, 0x0000000000000000ULL}, /* 1e12 */
+    {0x9184E72A00000000ULL, 0x0000000000000000ULL}, /* 1e13 */
+    {0xB5E620F480000000ULL, 0x0000000000000000ULL}, /* 1e14 */
+    {0xE35FA931A0000000ULL, 0x0000000000000000ULL}, /* 1e15 */
+    {0x8E1BC9BF04000000ULL, 0x0000000000000000ULL}, /* 1e16 */
+    {0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL}, /* 1e17 */
+    {0xDE0B6B3A76400000ULL, 0x0000000000000000ULL}, /* 1e18 */
+    {0x8AC7230489E80000ULL, 0x0000000000000000ULL}, /* 1e19 */
+    {0xAD78EBC5AC620000ULL, 0x0000000000000000ULL}, /* 1e20 */
+    {0xD8D726B7177A8000ULL, 0x0000000000000000ULL}, /* 1e21 */
+    {0x878678326EAC9000ULL, 0x0000000000000000ULL}, /* 1e22 */
+    {0xA968163F0A57B400ULL, 0x0000000000000000ULL}, /* 1e23 */
+    {0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL}, /* 1e24 */
+    {0x84595161401484A0ULL, 0x0000000000000000ULL}, /* 1e25 */
+    {0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL}, /* 1e26 */
+    {0xCECB8F27F4200F3AULL, 0x0000000000000000ULL}, /* 1e27 */
+    {0x813F3978F8940984ULL, 0x4000000000000000ULL}, /* 1e28 */
+    {0xA18F07D736B90BE5ULL, 0x5000000000000000ULL}, /* 1e29 */
+    {0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL}, /* 1e30 */
+    {0xFC6F7C4045812296ULL, 0x4D00000000000000ULL}, /* 1e31 */
+    {0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL}, /* 1e32 */
+    {0xC5371912364CE305ULL, 0x6C28000000000000ULL}, /* 1e33 */
+    {0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL}, /* 1e34 */
+    {0x9A130B963A6C115CULL, 0x3C7F400000000000ULL}, /* 1e35 */
+    {0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL}, /* 1e36 */
+    {0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL}, /* 1e37 */
+    {0x96769950B50D88F4ULL, 0x1314448000000000ULL}, /* 1e38 */
+    {0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL}, /* 1e39 */
+    {0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL}, /* 1e40 */
+    {0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL}, /* 1e41 */
+    {0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL}, /* 1e42 */
+    {0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL}, /* 1e43 */
+    {0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL}, /* 1e44 */
+    {0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL}, /* 1e45 */
+    {0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL}, /* 1e46 */
+    {0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL}, /* 1e47 */
+    {0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL}, /* 1e48 */
+    {0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL}, /* 1e49 */
+    {0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL}, /* 1e50 */
+    {0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL}, /* 1e51 */
+    {0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL}, /* 1e52 */
+    {0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL}, /* 1e53 */
+    {0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL}, /* 1e54 */
+    {0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL}, /* 1e55 */
+    {0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL}, /* 1e56 */
+    {0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL}, /* 1e57 */
+    {0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL}, /* 1e58 */
+    {0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL}, /* 1e59 */
+    {0x9F4F2726179A2245ULL, 0x01D762422C946590ULL}, /* 1e60 */
+    {0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL}, /* 1e61 */
+    {0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL}, /* 1e62 */
+    {0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL}, /* 1e63 */
+    {0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL}, /* 1e64 */
+    {0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL}, /* 1e65 */
+    {0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL}, /* 1e66 */
+    {0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL}, /* 1e67 */
+    {0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL}, /* 1e68 */
+    {0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL}, /* 1e69 */
+    {0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL}, /* 1e70 */
+    {0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL}, /* 1e71 */
+    {0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL}, /* 1e72 */
+    {0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL}, /* 1e73 */
+    {0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL}, /* 1e74 */
+    {0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL}, /* 1e75 */
+    {0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL}, /* 1e76 */
+    {0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL}, /* 1e77 */
+    {0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL}, /* 1e78 */
+    {0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL}, /* 1e79 */
+    {0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL}, /* 1e80 */
+    {0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL}, /* 1e81 */
+    {0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL}, /* 1e82 */
+    {0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL}, /* 1e83 */
+    {0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL}, /* 1e84 */
+    {0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL}, /* 1e85 */
+    {0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL}, /* 1e86 */
+    {0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL}, /* 1e87 */
+    {0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL}, /* 1e88 */
+    {0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL}, /* 1e89 */
+    {0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL}, /* 1e90 */
+    {0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL}, /* 1e91 */
+    {0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL}, /* 1e92 */
+    {0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL}, /* 1e93 */
+    {0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL}, /* 1e94 */
+    {0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL}, /* 1e95 */
+    {0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL}, /* 1e96 */
+    {0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL}, /* 1e97 */
+    {0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL}, /* 1e98 */
+    {0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL}, /* 1e99 */
+    {0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL}, /* 1e100 */
+    {0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL}, /* 1e101 */
+    {0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL}, /* 1e102 */
+    {0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL}, /* 1e103 */
+    {0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL}, /* 1e104 */
+    {0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL}, /* 1e105 */
+    {0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL}, /* 1e106 */
+    {0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL}, /* 1e107 */
+    {0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL}, /* 1e108 */
+    {0x884134FE908658B2ULL, 0x3109058D147FDCDDULL}, /* 1e109 */
+    {0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL}, /* 1e110 */
+    {0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL}, /* 1e111 */
+    {0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL}, /* 1e112 */
+    {0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL}, /* 1e113 */
+    {0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL}, /* 1e114 */
+    {0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL}, /* 1e115 */
+    {0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL}, /* 1e116 */
+    {0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL}, /* 1e117 */
+    {0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL}, /* 1e118 */
+    {0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL}, /* 1e119 */
+    {0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL}, /* 1e120 */
+    {0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL}, /* 1e121 */
+    {0x9AE757596946075FULL, 0x3375788DE9B06958ULL}, /* 1e122 */
+    {0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL}, /* 1e123 */
+    {0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL}, /* 1e124 */
+    {0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL}, /* 1e125 */
+    {0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL}, /* 1e126 */
+    {0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL}, /* 1e127 */
+    {0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL}, /* 1e128 */
+    {0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL}, /* 1e129 */
+    {0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL}, /* 1e130 */
+    {0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL}, /* 1e131 */
+    {0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL}, /* 1e132 */
+    {0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL}, /* 1e133 */
+    {0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL}, /* 1e134 */
+    {0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL}, /* 1e135 */
+    {0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL}, /* 1e136 */
+    {0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL}, /* 1e137 */
+    {0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL}, /* 1e138 */
+    {0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL}, /* 1e139 */
+    {0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL}, /* 1e140 */
+    {0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL}, /* 1e141 */
+    {0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL}, /* 1e142 */
+    {0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL}, /* 1e143 */
+    {0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL}, /* 1e144 */
+    {0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL}, /* 1e145 */
+    {0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL}, /* 1e146 */
+    {0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL}, /* 1e147 */
+    {0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL}, /* 1e148 */
+    {0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL}, /* 1e149 */
+    {0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL}, /* 1e150 */
+    {0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL}, /* 1e151 */
+    {0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL}, /* 1e152 */
+    {0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL}, /* 1e153 */
+    {0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL}, /* 1e154 */
+    {0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL}, /* 1e155 */
+    {0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL}, /* 1e156 */
+    {0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL}, /* 1e157 */
+    {0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL}, /* 1e158 */
+    {0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL}, /* 1e159 */
+    {0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL}, /* 1e160 */
+    {0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL}, /* 1e161 */
+    {0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL}, /* 1e162 */
+    {0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL}, /* 1e163 */
+    {0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL}, /* 1e164 */
+    {0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL}, /* 1e165 */
+    {0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL}, /* 1e166 */
+    {0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL}, /* 1e167 */
+    {0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL}, /* 1e168 */
+    {0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL}, /* 1e169 */
+    {0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL}, /* 1e170 */
+    {0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL}, /* 1e171 */
+    {0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL}, /* 1e172 */
+    {0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL}, /* 1e173 */
+    {0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL}, /* 1e174 */
+    {0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL}, /* 1e175 */
+    {0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL}, /* 1e176 */
+    {0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL}, /* 1e177 */
+    {0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL}, /* 1e178 */
+    {0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL}, /* 1e179 */
+    {0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL}, /* 1e180 */
+    {0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL}, /* 1e181 */
+    {0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL}, /* 1e182 */
+    {0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL}, /* 1e183 */
+    {0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL}, /* 1e184 */
+    {0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL}, /* 1e185 */
+    {0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL}, /* 1e186 */
+    {0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL}, /* 1e187 */
+    {0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL}, /* 1e188 */
+    {0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL}, /* 1e189 */
+    {0x8FA475791A569D10ULL, 0xF96E017D694487BCULL}, /* 1e190 */
+    {0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL}, /* 1e191 */
+    {0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL}, /* 1e192 */
+    {0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL}, /* 1e193 */
+    {0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL}, /* 1e194 */
+    {0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL}, /* 1e195 */
+    {0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL}, /* 1e196 */
+    {0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL}, /* 1e197 */
+    {0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL}, /* 1e198 */
+    {0x85C7056562757456ULL, 0xF6872D5667844E49ULL}, /* 1e199 */
+    {0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL}, /* 1e200 */
+    {0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL}, /* 1e201 */
+    {0x82A45B450226B39CULL, 0xECC0024661173473ULL}, /* 1e202 */
+    {0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL}, /* 1e203 */
+    {0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL}, /* 1e204 */
+    {0xFF290242C83396CEULL, 0x7E67047175A15271ULL}, /* 1e205 */
+    {0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL}, /* 1e206 */
+    {0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL}, /* 1e207 */
+    {0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL}, /* 1e208 */
+    {0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL}, /* 1e209 */
+    {0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL}, /* 1e210 */
+    {0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL}, /* 1e211 */
+    {0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL}, /* 1e212 */
+    {0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL}, /* 1e213 */
+    {0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL}, /* 1e214 */
+    {0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL}, /* 1e215 */
+    {0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL}, /* 1e216 */
+    {0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL}, /* 1e217 */
+    {0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL}, /* 1e218 */
+    {0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL}, /* 1e219 */
+    {0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL}, /* 1e220 */
+    {0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL}, /* 1e221 */
+    {0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL}, /* 1e222 */
+    {0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL}, /* 1e223 */
+    {0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL}, /* 1e224 */
+    {0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL}, /* 1e225 */
+    {0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL}, /* 1e226 */
+    {0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL}, /* 1e227 */
+    {0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL}, /* 1e228 */
+    {0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL}, /* 1e229 */
+    {0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL}, /* 1e230 */
+    {0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL}, /* 1e231 */
+    {0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL}, /* 1e232 */
+    {0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL}, /* 1e233 */
+    {0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL}, /* 1e234 */
+    {0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL}, /* 1e235 */
+    {0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL}, /* 1e236 */
+    {0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL}, /* 1e237 */
+    {0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL}, /* 1e238 */
+    {0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL}, /* 1e239 */
+    {0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL}, /* 1e240 */
+    {0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL}, /* 1e241 */
+    {0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL}, /* 1e242 */
+    {0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL}, /* 1e243 */
+    {0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL}, /* 1e244 */
+    {0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL}, /* 1e245 */
+    {0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL}, /* 1e246 */
+    {0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL}, /* 1e247 */
+    {0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL}, /* 1e248 */
+    {0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL}, /* 1e249 */
+    {0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL}, /* 1e250 */
+    {0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL}, /* 1e251 */
+    {0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL}, /* 1e252 */
+    {0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL}, /* 1e253 */
+    {0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL}, /* 1e254 */
+    {0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL}, /* 1e255 */
+    {0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL}, /* 1e256 */
+    {0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL}, /* 1e257 */
+    {0x8533285C936B35DEULL, 0xD53A88958F87275FULL}, /* 1e258 */
+    {0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL}, /* 1e259 */
+    {0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL}, /* 1e260 */
+    {0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL}, /* 1e261 */
+    {0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL}, /* 1e262 */
+    {0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL}, /* 1e263 */
+    {0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL}, /* 1e264 */
+    {0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL}, /* 1e265 */
+    {0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL}, /* 1e266 */
+    {0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL}, /* 1e267 */
+    {0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL}, /* 1e268 */
+    {0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL}, /* 1e269 */
+    {0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL}, /* 1e270 */
+    {0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL}, /* 1e271 */
+    {0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL}, /* 1e272 */
+    {0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL}, /* 1e273 */
+    {0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL}, /* 1e274 */
+    {0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL}, /* 1e275 */
+    {0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL}, /* 1e276 */
+    {0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL}, /* 1e277 */
+    {0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL}, /* 1e278 */
+    {0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL}, /* 1e279 */
+    {0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL}, /* 1e280 */
+    {0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL}, /* 1e281 */
+    {0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL}, /* 1e282 */
+    {0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL}, /* 1e283 */
+    {0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL}, /* 1e284 */
+    {0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL}, /* 1e285 */
+    {0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL}, /* 1e286 */
+    {0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL}, /* 1e287 */
+    {0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL}, /* 1e288 */
+    {0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL}, /* 1e289 */
+    {0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL}, /* 1e290 */
+    {0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL}, /* 1e291 */
+    {0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL}, /* 1e292 */
+    {0xA0555E361951C366ULL, 0xD7E105BCC332621FULL}, /* 1e293 */
+    {0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL}, /* 1e294 */
+    {0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL}, /* 1e295 */
+    {0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL}, /* 1e296 */
+    {0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL}, /* 1e297 */
+    {0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL}, /* 1e298 */
+    {0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL}, /* 1e299 */
+    {0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL}, /* 1e300 */
+    {0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL}, /* 1e301 */
+    {0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL}, /* 1e302 */
+    {0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL}, /* 1e303 */
+    {0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL}, /* 1e304 */
+    {0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL}, /* 1e305 */
+    {0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL}, /* 1e306 */
+    {0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL}, /* 1e307 */
+    {0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL}, /* 1e308 */
+    {0xB201833B35D63F73ULL, 0x2CD2CC6551E513DAULL}, /* 1e309 */
+    {0xDE81E40A034BCF4FULL, 0xF8077F7EA65E58D1ULL}, /* 1e310 */
+    {0x8B112E86420F6191ULL, 0xFB04AFAF27FAF782ULL}, /* 1e311 */
+    {0xADD57A27D29339F6ULL, 0x79C5DB9AF1F9B563ULL}, /* 1e312 */
+    {0xD94AD8B1C7380874ULL, 0x18375281AE7822BCULL}, /* 1e313 */
+    {0x87CEC76F1C830548ULL, 0x8F2293910D0B15B5ULL}, /* 1e314 */
+    {0xA9C2794AE3A3C69AULL, 0xB2EB3875504DDB22ULL}, /* 1e315 */
+    {0xD433179D9C8CB841ULL, 0x5FA60692A46151EBULL}, /* 1e316 */
+    {0x849FEEC281D7F328ULL, 0xDBC7C41BA6BCD333ULL}, /* 1e317 */
+    {0xA5C7EA73224DEFF3ULL, 0x12B9B522906C0800ULL}, /* 1e318 */
+    {0xCF39E50FEAE16BEFULL, 0xD768226B34870A00ULL}, /* 1e319 */
+    {0x81842F29F2CCE375ULL, 0xE6A1158300D46640ULL}, /* 1e320 */
+    {0xA1E53AF46F801C53ULL, 0x60495AE3C1097FD0ULL}, /* 1e321 */
+    {0xCA5E89B18B602368ULL, 0x385BB19CB14BDFC4ULL}, /* 1e322 */
+    {0xFCF62C1DEE382C42ULL, 0x46729E03DD9ED7B5ULL}, /* 1e323 */
+    {0x9E19DB92B4E31BA9ULL, 0x6C07A2C26A8346D1ULL}, /* 1e324 */
+    {0xC5A05277621BE293ULL, 0xC7098B7305241885ULL}, /* 1e325 */
+    {0xF70867153AA2DB38ULL, 0xB8CBEE4FC66D1EA7ULL}, /* 1e326 */
+    {0x9A65406D44A5C903ULL, 0x737F74F1DC043328ULL}, /* 1e327 */
+    {0xC0FE908895CF3B44ULL, 0x505F522E53053FF2ULL}, /* 1e328 */
+    {0xF13E34AABB430A15ULL, 0x647726B9E7C68FEFULL}, /* 1e329 */
+    {0x96C6E0EAB509E64DULL, 0x5ECA783430DC19F5ULL}, /* 1e330 */
+    {0xBC789925624C5FE0ULL, 0xB67D16413D132072ULL}, /* 1e331 */
+    {0xEB96BF6EBADF77D8ULL, 0xE41C5BD18C57E88FULL}, /* 1e332 */
+    {0x933E37A534CBAAE7ULL, 0x8E91B962F7B6F159ULL}, /* 1e333 */
+    {0xB80DC58E81FE95A1ULL, 0x723627BBB5A4ADB0ULL}, /* 1e334 */
+    {0xE61136F2227E3B09ULL, 0xCEC3B1AAA30DD91CULL}, /* 1e335 */
+    {0x8FCAC257558EE4E6ULL, 0x213A4F0AA5E8A7B1ULL}, /* 1e336 */
+    {0xB3BD72ED2AF29E1FULL, 0xA988E2CD4F62D19DULL}, /* 1e337 */
+    {0xE0ACCFA875AF45A7ULL, 0x93EB1B80A33B8605ULL}, /* 1e338 */
+    {0x8C6C01C9498D8B88ULL, 0xBC72F130660533C3ULL}, /* 1e339 */
+    {0xAF87023B9BF0EE6AULL, 0xEB8FAD7C7F8680B4ULL}, /* 1e340 */
+    {0xDB68C2CA82ED2A05ULL, 0xA67398DB9F6820E1ULL}, /* 1e341 */
+    {0x892179BE91D43A43ULL, 0x88083F8943A1148CULL}, /* 1e342 */
+    {0xAB69D82E364948D4ULL, 0x6A0A4F6B948959B0ULL}, /* 1e343 */
+    {0xD6444E39C3DB9B09ULL, 0x848CE34679ABB01CULL}, /* 1e344 */
+    {0x85EAB0E41A6940E5ULL, 0xF2D80E0C0C0B4E11ULL}, /* 1e345 */
+    {0xA7655D1D2103911FULL, 0x6F8E118F0F0E2195ULL}, /* 1e346 */
+    {0xD13EB46469447567ULL, 0x4B7195F2D2D1A9FBULL}, /* 1e347 */
+};
+
+static MYJSON_INLINE int _myjson_is_eight_digits(const JsonChar_t *digits) {
+    uint64_t word = _myjson_load_u64(digits);
+
+    /* Every byte is in 0x30..0x39: its high nibble is 3, even after adding 6. */
+    return !(((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ^
+             0x3333333333333333ULL);
+};
+
+static MYJSON_INLINE uint32_t _myjson_parse_eight_digits(const JsonChar_t *digits) {
+    uint64_t word = _myjson_load_u64(digits) - 0x3030303030303030ULL;
+
+    /* Combine the digits in pairs, then the pairs in fours, then the halves. */
+    word = (word * 10) + (word >> 8);
+    word = (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+            (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+           32;
+
+    return (uint32_t)word;
+};
+
+static MYJSON_INLINE uint64_t _myjson_multiply(uint64_t a, uint64_t b, uint64_t *high) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+
+    *high = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+#elif MYJSON_COMPILER_IS(MSVC) && defined(_M_X64)
+    return _umul128(a, b, high);
+#else
+    uint64_t a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+    uint64_t b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+    uint64_t low = a_low * b_low;
+    uint64_t middle1 = a_high * b_low + (low >> 32);
+    uint64_t middle2 = a_low * b_high + (middle1 & 0xFFFFFFFF);
+
+    *high = a_high * b_high + (middle1 >> 32) + (middle2 >> 32);
+    return (middle2 << 32) | (low & 0xFFFFFFFF);
+#endif
+};
+
+static int _myjson_eisel_lemire(uint64_t mantissa, int exponent, int negative, double *value) {
+    const uint64_t *power;
+    uint64_t high, low, bits, exponent2;
+    int shift;
+
+    if (!mantissa) {
+        bits = (uint64_t)negative << 63;
+        memcpy(value, &bits, sizeof(bits));
+        return MYJSON_SUCCESS;
+    }
+
+    if (exponent < MYJSON_MIN_POWER_OF_TEN || exponent > MYJSON_MAX_POWER_OF_TEN) {
+        return MYJSON_FAILURE;
+    }
+
+    power = _myjson_powers_of_ten[exponent - MYJSON_MIN_POWER_OF_TEN];
+
+    /* Normalize the mantissa and estimate the binary exponent (217706 / 2^16 ~ log2(10)). */
+    shift = _myjson_leading_zeroes(mantissa);
+    mantissa <<= shift;
+    exponent2 = (uint64_t)(((217706 * exponent) >> 16) + 64 + 1023) - (uint64_t)shift;
+
+    low = _myjson_multiply(mantissa, power[0], &high);
+
+    /* Widen the approximation when the truncated product may carry into the kept bits. */
+    if ((high & 0x1FF) == 0x1FF && low + mantissa < mantissa) {
+        uint64_t wide_high, wide_low = _myjson_multiply(mantissa, power[1], &wide_high);
+        uint64_t merged_high = high, merged_low = low + wide_high;
+
+        if (merged_low < low) {
+            merged_high++;
+        }
+
+        if ((merged_high & 0x1FF) == 0x1FF && merged_low + 1 == 0 && wide_low + mantissa < mantissa) {
+            return MYJSON_FAILURE;
+        }
+
+        high = merged_high;
+        low = merged_low;
+    }
+
+    /* Keep 54 bits. */
+    bits = high >> ((high >> 63) + 9);
+    exponent2 -= 1 ^ (high >> 63);
+
+    /* A halfway case cannot be decided from the approximation. */
+    if (!low && !(high & 0x1FF) && (bits & 3) == 1) {
+        return MYJSON_FAILURE;
+    }
+
+    /* Round to 53 bits. */
+    bits += bits & 1;
+    bits >>= 1;
+    if (bits >> 53) {
+        bits >>= 1;
+        exponent2++;
+    }
+
+    /* Subnormal numbers and overflows go to the slow path. */
+    if (exponent2 - 1 >= 0x7FF - 1) {
+        return MYJSON_FAILURE;
+    }
+
+    bits = (exponent2 << 52) | (bits & 0x000FFFFFFFFFFFFFULL) | ((uint64_t)negative << 63);
+    memcpy(value, &bits, sizeof(bits));
+
+    return MYJSON_SUCCESS;
+};
+
+static void _myjson_decimal_assign(JsonDecimal *decimal, const JsonChar_t *number, size_t length) {
+    const JsonChar_t *pointer = number;
+    const JsonChar_t *end = number + length;
+    int digits = 0, fraction = 0, exponent = 0, exponent_negative = 0;
+
+    decimal->count = 0;
+    decimal->point = 0;
+    decimal->negative = 0;
+    decimal->truncated = 0;
+
+    if (*pointer == '-') {
+        decimal->negative = 1;
+        pointer++;
+    }
+
+    /* The value is 0.d1d2d3... * 10^point. */
+    for (; pointer != end && *pointer != 'e' && *pointer != 'E'; pointer++) {
+        if (*pointer == '.') {
+            fraction = 1;
+            continue;
+        }
+
+        /* A leading zero only moves the point. */
+        if (*pointer == '0' && !digits) {
+            decimal->point -= fraction;
+            continue;
+        }
+
+        decimal->point += !fraction;
+
+        if (decimal->count < MYJSON_DECIMAL_DIGITS) {
+            decimal->digits[decimal->count++] = *pointer - '0';
+        } else if (*pointer != '0') {
+            decimal->truncated = 1;
+        }
+        digits++;
+    }
+
+    if (pointer != end) {
+        pointer++;
+        if (*pointer == '+' || *pointer == '-') {
+            exponent_negative = (*pointer == '-');
+            pointer++;
+        }
+
+        for (; pointer != end; pointer++) {
+            if (exponent < 10000) {
+                exponent = exponent * 10 + (*pointer - '0');
+            }
+        }
+
+        decimal->point += exponent_negative ? -exponent : exponent;
+    }
+
+    _myjson_decimal_trim(decimal);
+};
+
+static void _myjson_decimal_trim(JsonDecimal *decimal) {
+    while (decimal->count && !decimal->digits[decimal->count - 1]) {
+        decimal->count--;
+    }
+
+    if (!decimal->count) {
+        decimal->point = 0;
+    }
+};
+
+static void _myjson_decimal_left_shift(JsonDecimal *decimal, int shift) {
+    int read = decimal->count;
+    int write = decimal->count + 19;
+    int count;
+    uint64_t n = 0;
+
+    /* Multiply from the last digit, writing the product up to 19 digits further (2^60 < 10^19). */
+    while (read > 0) {
+        uint64_t quotient;
+
+        n += (uint64_t)decimal->digits[--read] << shift;
+        quotient = n / 10;
+        decimal->digits[--write] = (unsigned char)(n - 10 * quotient);
+        n = quotient;
+    }
+
+    while (n) {
+        uint64_t quotient = n / 10;
+
+        decimal->digits[--write] = (unsigned char)(n - 10 * quotient);
+        n = quotient;
+    }
+
+    count = decimal->count + 19 - write;
+    memmove(decimal->digits, decimal->digits + write, count);
+    decimal->point += count - decimal->count;
+
+    if (count > MYJSON_DECIMAL_DIGITS) {
+        for (read = MYJSON_DECIMAL_DIGITS; read < count; read++) {
+            decimal->truncated |= (decimal->digits[read] != 0);
+        }
+        count = MYJSON_DECIMAL_DIGITS;
+    }
+
+    decimal->count = count;
+    _myjson_decimal_trim(decimal);
+};
+
+static void _myjson_decimal_right_shift(JsonDecimal *decimal, int shift) {
+    int read = 0, write = 0;
+    uint64_t n = 0;
+    uint64_t mask = ((uint64_t)1 << shift) - 1;
+
+    /* Pick up enough leading digits to cover the first shift. */
+    for (; !(n >> shift); read++) {
+        if (read >= decimal->count) {
+            if (!n) {
+                decimal->count = 0;
+                decimal->point = 0;
+                return;
+            }
+            while (!(n >> shift)) {
+                n *= 10;
+                read++;
+            }
+            break;
+        }
+        n = n * 10 + decimal->digits[read];
+    }
+
+    decimal->point -= read - 1;
+
+    /* Pick up a digit, put down a digit. */
+    for (; read < decimal->count; read++) {
+        unsigned char digit = (unsigned char)(n >> shift);
+
+        n &= mask;
+        decimal->digits[write++] = digit;
+        n = n * 10 + decimal->digits[read];
+    }
+
+    /* Put down the remaining digits. */
+    while (n) {
+        unsigned char digit = (unsigned char)(n >> shift);
+
+        n &= mask;
+        if (write < MYJSON_DECIMAL_DIGITS) {
+            decimal->digits[write++] = digit;
+        } else if (digit) {
+            decimal->truncated = 1;
+        }
+        n *= 10;
+    }
+
+    decimal->count = write;
+    _myjson_decimal_trim(decimal);
+};
+
+static void _myjson_decimal_shift(JsonDecimal *decimal, int shift) {
+    if (!decimal->count) {
+        return;
+    }
+
+    /* Shift by at most 60 bits at a time, so that the running value fits 64 bits. */
+    while (shift > 60) {
+        _myjson_decimal_left_shift(decimal, 60);
+        shift -= 60;
+    }
+    while (shift < -60) {
+        _myjson_decimal_right_shift(decimal, 60);
+        shift += 60;
+    }
+
+    if (shift > 0) {
+        _myjson_decimal_left_shift(decimal, shift);
+    } else if (shift < 0) {
+        _myjson_decimal_right_shift(decimal, -shift);
+    }
+};
+
+static uint64_t _myjson_decimal_rounded_integer(JsonDecimal *decimal) {
+    uint64_t n = 0;
+    int i, round_up;
+
+    if (decimal->point > 20) {
+        return 0xFFFFFFFFFFFFFFFFULL;
+    }
+
+    for (i = 0; i < decimal->point && i < decimal->count; i++) {
+        n = n * 10 + decimal->digits[i];
+    }
+    for (; i < decimal->point; i++) {
+        n *= 10;
+    }
+
+    /* Round half to even, unless non-zero digits were dropped past the half. */
+    if (decimal->point < 0 || decimal->point >= decimal->count) {
+        round_up = 0;
+    } else if (decimal->digits[decimal->point] == 5 && decimal->point + 1 == decimal->count) {
+        round_up = decimal->truncated || (decimal->point > 0 && (decimal->digits[decimal->point - 1] & 1));
+    } else {
+        round_up = decimal->digits[decimal->point] >= 5;
+    }
+
+    return n + round_up;
+};
+
+static double _myjson_decimal_to_double(JsonDecimal *decimal) {
+    /* The number of bits to shift by to move the point by 0 to 8 digits. */
+    static const int shifts[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+    uint64_t mantissa = 0, bits;
+    int exponent = 0;
+    double value;
+
+    if (!decimal->count || decimal->point < -330) {
+        exponent = -1023;
+        goto done;
+    }
+
+    if (decimal->point > 310) {
+        goto overflow;
+    }
+
+    /* Scale by powers of two into [0.5, 1). */
+    while (decimal->point > 0) {
+        int shift = (decimal->point >= 9) ? 27 : shifts[decimal->point];
+
+        _myjson_decimal_shift(decimal, -shift);
+        exponent += shift;
+    }
+
+    while (decimal->point < 0 || (!decimal->point && decimal->digits[0] < 5)) {
+        int shift = (-decimal->point >= 9) ? 27 : shifts[-decimal->point];
+
+        _myjson_decimal_shift(decimal, shift);
+        exponent -= shift;
+    }
+
+    /* The range of a double mantissa is [1, 2). */
+    exponent--;
+
+    /* Denormalize below the smallest exponent. */
+    if (exponent < -1022) {
+        int shift = -1022 - exponent;
+
+        _myjson_decimal_shift(decimal, -shift);
+        exponent += shift;
+    }
+
+    if (exponent + 1023 >= 0x7FF) {
+        goto overflow;
+    }
+
+    /* Extract 53 bits. */
+    _myjson_decimal_shift(decimal, 53);
+    mantissa = _myjson_decimal_rounded_integer(decimal);
+
+    /* Rounding might have added a bit. */
+    if (mantissa == (2ULL << 52)) {
+        mantissa >>= 1;
+        exponent++;
+        if (exponent + 1023 >= 0x7FF) {
+            goto overflow;
+        }
+    }
+
+    if (!(mantissa & (1ULL << 52))) {
+        exponent = -1023;
+    }
+
+    goto done;
+
+overflow:
+    mantissa = 0;
+    exponent = 0x7FF - 1023;
+
+done:
+    bits = (mantissa & 0x000FFFFFFFFFFFFFULL) | ((uint64_t)((exponent + 1023) & 0x7FF) << 52) |
+           ((uint64_t)decimal->negative << 63);
+    memcpy(&value, &bits, sizeof(bits));
+
+    return value;
+};
+
+static int _myjson_parse_number(const JsonChar_t *number, size_t length, JsonValueType *type, JsonNumber *value,
+                                int *flags) {
+    const JsonChar_t *pointer = number;
+    const JsonChar_t *end = number + length;
+    const JsonChar_t *digits, *integer_end, *fraction = NULL, *fraction_end = NULL;
+    uint64_t mantissa = 0;
+    long exponent = 0, explicit_exponent = 0;
+    size_t digit_count;
+    int negative = 0, is_integer = 1, truncated = 0;
+    double real, upper;
+
+    if (pointer != end && *pointer == '-') {
+        negative = 1;
+        pointer++;
+    }
+
+    /* The integer part. */
+    digits = pointer;
+    if (pointer == end || *pointer < '0' || *pointer > '9') {
+        return MYJSON_FAILURE;
+    }
+
+    if (*pointer == '0') {
+        pointer++;
+    } else {
+        while (end - pointer >= 8 && _myjson_is_eight_digits(pointer)) {
+            mantissa = mantissa * 100000000 + _myjson_parse_eight_digits(pointer);
+            pointer += 8;
+        }
+        while (pointer != end && *pointer >= '0' && *pointer <= '9') {
+            mantissa = mantissa * 10 + (*pointer - '0');
+            pointer++;
+        }
+    }
+
+    integer_end = pointer;
+    digit_count = integer_end - digits;
+
+    /* The fraction part. */
+    if (pointer != end && *pointer == '.') {
+        is_integer = 0;
+        fraction = ++pointer;
+
+        while (end - pointer >= 8 && _myjson_is_eight_digits(pointer)) {
+            mantissa = mantissa * 100000000 + _myjson_parse_eight_digits(pointer);
+            pointer += 8;
+        }
+        while (pointer != end && *pointer >= '0' && *pointer <= '9') {
+            mantissa = mantissa * 10 + (*pointer - '0');
+            pointer++;
+        }
+
+        if (pointer == fraction) {
+            return MYJSON_FAILURE;
+        }
+
+        fraction_end = pointer;
+        exponent = -(long)(fraction_end - fraction);
+        digit_count += fraction_end - fraction;
+    }
+
+    /* The exponent part. */
+    if (pointer != end && (*pointer == 'e' || *pointer == 'E')) {
+        const JsonChar_t *exponent_digits;
+        int exponent_negative = 0;
+
+        is_integer = 0;
+        pointer++;
+
+        if (pointer != end && (*pointer == '+' || *pointer == '-')) {
+            exponent_negative = (*pointer == '-');
+            pointer++;
+        }
+
+        exponent_digits = pointer;
+        while (pointer != end && *pointer >= '0' && *pointer <= '9') {
+            if (explicit_exponent < 0x10000) {
+                explicit_exponent = explicit_exponent * 10 + (*pointer - '0');
+            }
+            pointer++;
+        }
+
+        if (pointer == exponent_digits) {
+            return MYJSON_FAILURE;
+        }
+
+        if (exponent_negative) {
+            explicit_exponent = -explicit_exponent;
+        }
+        exponent += explicit_exponent;
+    }
+
+    if (pointer != end) {
+        return MYJSON_FAILURE;
+    }
+
+    if (is_integer) {
+        /* 20 digits fit only below 2 * 10^19, and then wrap around at most once. */
+        if (digit_count < 20 || (digit_count == 20 && *digits == '1' && mantissa >= 10000000000000000000ULL)) {
+            if (!negative) {
+                *type = JSON_INTEGER;
+                if (mantissa > (uint64_t)INT64_MAX) {
+                    value->uinteger = mantissa;
+                    *flags |= JSON_UNSIGNED_FLAG;
+                } else {
+                    value->integer = (int64_t)mantissa;
+                }
+                return MYJSON_SUCCESS;
+            }
+
+            if (mantissa <= (uint64_t)INT64_MAX + 1) {
+                *type = JSON_INTEGER;
+                value->integer = mantissa ? -(int64_t)(mantissa - 1) - 1 : 0;
+                return MYJSON_SUCCESS;
+            }
+        }
+
+        /* Integers out of the 64-bit range are decoded as doubles. */
+    }
+
+    *type = JSON_DOUBLE;
+
+    /* Keep the first 19 significant digits only. */
+    if (digit_count > 19) {
+        const JsonChar_t *start = digits;
+
+        while (start != end && (*start == '0' || *start == '.')) {
+            digit_count -= (*start == '0');
+            start++;
+        }
+
+        if (digit_count > 19) {
+            truncated = 1;
+            mantissa = 0;
+            pointer = digits;
+
+            while (mantissa < 1000000000000000000ULL && pointer != integer_end) {
+                mantissa = mantissa * 10 + (*pointer - '0');
+                pointer++;
+            }
+
+            if (mantissa >= 1000000000000000000ULL) {
+                exponent = (long)(integer_end - pointer) + explicit_exponent;
+            } else {
+                pointer = fraction;
+                while (mantissa < 1000000000000000000ULL && pointer != fraction_end) {
+                    mantissa = mantissa * 10 + (*pointer - '0');
+                    pointer++;
+                }
+                exponent = (long)(fraction - pointer) + explicit_exponent;
+            }
+        }
+    }
+
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+    /* Both the mantissa and the power of ten are exact doubles (Clinger). */
+    if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        real = (double)mantissa;
+        real = (exponent < 0) ? real / _myjson_exact_powers_of_ten[-exponent]
+                              : real * _myjson_exact_powers_of_ten[exponent];
+        value->real = negative ? -real : real;
+        return MYJSON_SUCCESS;
+    }
+#endif
+
+    /* A truncated mantissa decides the rounding only if rounding it up gives the same double. */
+    if (exponent >= MYJSON_MIN_POWER_OF_TEN && exponent <= MYJSON_MAX_POWER_OF_TEN &&
+        _myjson_eisel_lemire(mantissa, (int)exponent, negative, &real) &&
+        (!truncated || (_myjson_eisel_lemire(mantissa + 1, (int)exponent, negative, &upper) && upper == real))) {
+        value->real = real;
+        return MYJSON_SUCCESS;
+    }
+
+    {
+        JsonDecimal decimal;
+
+        _myjson_decimal_assign(&decimal, number, length);
+        value->real = _myjson_decimal_to_double(&decimal);
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+#pragma region Reader
+
+//-----------------------------------------------------------------------------
+// [SECTION] Parser
+//-----------------------------------------------------------------------------
+
+/*
+ * String read handler.
+ */
+static int _myjson_string_read_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read) {
+    JsonParser *parser = (JsonParser *)data;
+
+    if (parser->input.string.current == parser->input.string.end) {
+        *size_read = 0;
+        return MYJSON_SUCCESS;
+    }
+
+    if (size > (size_t)(parser->input.string.end - parser->input.string.current)) {
+        size = parser->input.string.end - parser->input.string.current;
+    }
+
+    memcpy(buffer, parser->input.string.current, size);
+    parser->input.string.current += size;
+    *size_read = size;
+
+    return MYJSON_SUCCESS;
+};
+
+/*
+ * File read handler.
+ */
+static int _myjson_file_read_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read) {
+    JsonParser *parser = (JsonParser *)data;
+
+    *size_read = fread(buffer, 1, size, parser->input.file);
+    return !ferror(parser->input.file);
+};
+
+#if MYJSON_PLATFORM_IS(WINDOWS)
+
+static int _myjson_parser_map_file(JsonParser *parser, int fd, int flags) {
+    HANDLE file = (HANDLE)_get_osfhandle(fd);
+    LARGE_INTEGER size;
+
+    (void)flags; /* Large pages need a privilege and cannot back a file view. */
+
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size)) {
+        return _myjson_parser_set_reader_error(parser, "cannot map the input file", 0);
+    }
+
+    if ((unsigned long long)size.QuadPart > (size_t)-1) {
+        return _myjson_parser_set_reader_error(parser, "input is too long", 0);
+    }
+
+    /* An empty file cannot be mapped. */
+    if (!size.QuadPart) {
+        return json_parser_set_input_string(parser, (const unsigned char *)"", 0);
+    }
+
+    parser->mapping.handle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!parser->mapping.handle) {
+        return _myjson_parser_set_reader_error(parser, "cannot map the input file", 0);
+    }
+
+    parser->mapping.start = MapViewOfFile(parser->mapping.handle, FILE_MAP_READ, 0, 0, 0);
+    if (!parser->mapping.start) {
+        CloseHandle(parser->mapping.handle);
+        parser->mapping.handle = NULL;
+        return _myjson_parser_set_reader_error(parser, "cannot map the input file", 0);
+    }
+    parser->mapping.size = (size_t)size.QuadPart;
+
+    return json_parser_set_input_string(parser, (const unsigned char *)parser->mapping.start, parser->mapping.size);
+};
+
+static void _myjson_parser_unmap_file(JsonParser *parser) {
+    if (parser->mapping.start) {
+        UnmapViewOfFile(parser->mapping.start);
+        CloseHandle(parser->mapping.handle);
+    }
+};
+
+#else
+
+static int _myjson_parser_map_file(JsonParser *parser, int fd, int flags) {
+    struct stat status;
+    void *start;
+
+    if (fstat(fd, &status) || !S_ISREG(status.st_mode)) {
+        return _myjson_parser_set_reader_error(parser, "cannot map the input file", 0);
+    }
+
+    if ((unsigned long long)status.st_size > (size_t)-1) {
+        return _myjson_parser_set_reader_error(parser, "input is too long", 0);
+    }
+
+    /* An empty file cannot be mapped. */
+    if (!status.st_size) {
+        return json_parser_set_input_string(parser, (const unsigned char *)"", 0);
+    }
+
+    start = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (start == MAP_FAILED) {
+        return _myjson_parser_set_reader_error(parser, "cannot map the input file", 0);
+    }
+    parser->mapping.start = start;
+    parser->mapping.size = (size_t)status.st_size;
+
+    /* The input is read once, front to back: read ahead, and drop the pages behind. */
+#if defined(POSIX_MADV_SEQUENTIAL)
+    posix_madvise(start, parser->mapping.size, POSIX_MADV_SEQUENTIAL);
+    posix_madvise(start, parser->mapping.size, POSIX_MADV_WILLNEED);
+#endif
+#if defined(MADV_HUGEPAGE)
+    if (flags & JSON_MAP_HUGE_PAGES) {
+        madvise(start, parser->mapping.size, MADV_HUGEPAGE);
+    }
+#else
+    (void)flags;
+#endif
+
+    return json_parser_set_input_string(parser, (const unsigned char *)start, parser->mapping.size);
+};
+
+static void _myjson_parser_unmap_file(JsonParser *parser) {
+    if (parser->mapping.start) {
+        munmap(parser->mapping.start, parser->mapping.size);
+    }
+};
+
+#endif
+
+//-----------------------------------------------------------------------------
+// [SECTION] Reader
+//-----------------------------------------------------------------------------
+
+static int _myjson_parser_set_reader_error(JsonParser *parser, const char *problem, size_t offset) {
+    parser->error.type = JSON_READER_ERROR;
+    parser->error.message = problem;
+    parser->error_pos = parser->position;
+    parser->error_pos.index = offset;
+
+    return MYJSON_FAILURE;
+};
+
+static JsonEncoding _myjson_detect_encoding(const unsigned char *string, size_t length, size_t *bom) {
+    *bom = 0;
+
+    /* The byte order marks (a UTF-32LE one starts like a UTF-16LE one). */
+    if (length >= 4 && !memcmp(string, "\x00\x00\xFE\xFF", 4)) {
+        *bom = 4;
+        return JSON_UTF32BE_ENCODING;
+    }
+    if (length >= 4 && !memcmp(string, "\xFF\xFE\x00\x00", 4)) {
+        *bom = 4;
+        return JSON_UTF32LE_ENCODING;
+    }
+    if (length >= 3 && !memcmp(string, "\xEF\xBB\xBF", 3)) {
+        *bom = 3;
+        return JSON_UTF8_ENCODING;
+    }
+    if (length >= 2 && !memcmp(string, "\xFE\xFF", 2)) {
+        *bom = 2;
+        return JSON_UTF16BE_ENCODING;
+    }
+    if (length >= 2 && !memcmp(string, "\xFF\xFE", 2)) {
+        *bom = 2;
+        return JSON_UTF16LE_ENCODING;
+    }
+
+    /* A JSON text starts with two ASCII characters (RFC 4627), the zeros give the encoding away. */
+    if (length >= 4 && !string[0] && !string[1] && !string[2] && string[3]) {
+        return JSON_UTF32BE_ENCODING;
+    }
+    if (length >= 4 && string[0] && !string[1] && !string[2] && !string[3]) {
+        return JSON_UTF32LE_ENCODING;
+    }
+    if (length >= 2 && !string[0] && string[1]) {
+        return JSON_UTF16BE_ENCODING;
+    }
+    if (length >= 2 && string[0] && !string[1]) {
+        return JSON_UTF16LE_ENCODING;
+    }
+
+    return JSON_UTF8_ENCODING;
+};
+
+static int _myjson_parser_determine_encoding(JsonParser *parser) {
+    size_t bom, size;
+
+    /* A UTF-8 input string is used as is, and validated as it is indexed. */
+    if (parser->in_place) {
+        size = parser->buffer.last - parser->buffer.start;
+
+        if (_myjson_detect_encoding(parser->buffer.start, size, &bom) == JSON_UTF8_ENCODING) {
+            parser->buffer.start += bom;
+            parser->buffer.pointer = parser->buffer.start;
+            parser->offset = bom;
+            size -= bom;
+
+            if (size > MYJSON_MAX_FILE_SIZE && !parser->mapping.start) {
+                return _myjson_parser_set_reader_error(parser, "input is too long", parser->offset);
+            }
+
+            parser->offset += size;
+            parser->encoding = JSON_UTF8_ENCODING;
+
+            /* A short input needs a short index: at most a structural per byte, and a padded block. */
+            if (size + 2 * MYJSON_STRUCTURAL_BLOCK_SIZE < MYJSON_STRUCTURAL_INDEX_SIZE) {
+                return _myjson_parser_initialize_index(parser, size + 2 * MYJSON_STRUCTURAL_BLOCK_SIZE);
+            }
+
+            return _myjson_parser_initialize_index(parser, MYJSON_STRUCTURAL_INDEX_SIZE);
+        }
+
+        /* The other encodings are read with the string read handler and transcoded, like a stream. */
+        parser->buffer.start = NULL;
+        parser->buffer.pointer = NULL;
+        parser->buffer.last = NULL;
+        parser->buffer.end = NULL;
+        parser->eof = 0;
+        parser->in_place = 0;
+        parser->in_situ = 0;
+    }
+
+    /* A push parser may come back here with the next chunk, and a reset parser with a short index. */
+    if (!_myjson_parser_initialize_index(parser, MYJSON_STRUCTURAL_INDEX_SIZE)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!parser->buffer.start) {
+        parser->buffer.start = (JsonChar_t *)_myjson_malloc(parser->allocator, MYJSON_INPUT_BUFFER_SIZE);
+        if (!parser->buffer.start) {
+            return MYJSON_MEMORY_ERROR(parser);
+        }
+        parser->buffer.pointer = parser->buffer.start;
+        parser->buffer.last = parser->buffer.start;
+        parser->buffer.end = parser->buffer.start + MYJSON_INPUT_BUFFER_SIZE;
+    }
+
+    /* Read the beginning of the input straight into the working buffer. */
+    while (!parser->eof && parser->buffer.last - parser->buffer.start < 4) {
+        if (!_myjson_parser_read(parser, parser->buffer.last,
+                                 MYJSON_INPUT_RAW_BUFFER_SIZE - (parser->buffer.last - parser->buffer.start), &size)) {
+            return MYJSON_FAILURE;
+        }
+        parser->buffer.last += size;
+
+        if (parser->waiting) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    size = parser->buffer.last - parser->buffer.start;
+    parser->encoding = _myjson_detect_encoding(parser->buffer.start, size, &bom);
+
+    /* UTF-8 is read straight into the working buffer from now on. */
+    if (parser->encoding == JSON_UTF8_ENCODING) {
+        memmove(parser->buffer.start, parser->buffer.start + bom, size - bom);
+        parser->buffer.last -= bom;
+        parser->offset += size;
+
+        return MYJSON_SUCCESS;
+    }
+
+    /* The other encodings go through the raw buffer (a reset parser may still have it). */
+    if (!parser->raw_buffer.start) {
+        parser->raw_buffer.start = (unsigned char *)_myjson_malloc(parser->allocator, MYJSON_INPUT_RAW_BUFFER_SIZE);
+        if (!parser->raw_buffer.start) {
+            return MYJSON_MEMORY_ERROR(parser);
+        }
+    }
+    parser->raw_buffer.pointer = parser->raw_buffer.start;
+    parser->raw_buffer.last = parser->raw_buffer.start + (size - bom);
+    parser->raw_buffer.end = parser->raw_buffer.start + MYJSON_INPUT_RAW_BUFFER_SIZE;
+
+    memcpy(parser->raw_buffer.start, parser->buffer.start + bom, size - bom);
+    parser->buffer.last = parser->buffer.start;
+    parser->offset += bom;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_read(JsonParser *parser, unsigned char *buffer, size_t size, size_t *size_read) {
+    *size_read = 0;
+
+    if (!parser->read_handler(parser->read_handler_data, buffer, size, size_read)) {
+        return _myjson_parser_set_reader_error(parser, "input error", parser->offset);
+    }
+
+    /* A push parser waits for the next chunk, unless the last one was fed. */
+    if (!*size_read) {
+        if (parser->push && !parser->last_fed) {
+            parser->waiting = 1;
+        } else {
+            parser->eof = 1;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_update_raw_buffer(JsonParser *parser) {
+    size_t size_read;
+
+    /* Return if the raw buffer is full. */
+    if (parser->raw_buffer.start == parser->raw_buffer.pointer && parser->raw_buffer.last == parser->raw_buffer.end) {
+        return MYJSON_SUCCESS;
+    }
+
+    /* Return on EOF. */
+    if (parser->eof) {
+        return MYJSON_SUCCESS;
+    }
+
+    /* Move the remaining bytes in the raw buffer to the beginning. */
+    if (parser->raw_buffer.start < parser->raw_buffer.pointer && parser->raw_buffer.pointer < parser->raw_buffer.last) {
+        memmove(parser->raw_buffer.start, parser->raw_buffer.pointer,
+                parser->raw_buffer.last - parser->raw_buffer.pointer);
+    }
+    parser->raw_buffer.last -= parser->raw_buffer.pointer - parser->raw_buffer.start;
+    parser->raw_buffer.pointer = parser->raw_buffer.start;
+
+    /* Call the read handler to fill the buffer. */
+    if (!_myjson_parser_read(parser, parser->raw_buffer.last, parser->raw_buffer.end - parser->raw_buffer.last,
+                             &size_read)) {
+        return MYJSON_FAILURE;
+    }
+
+    parser->raw_buffer.last += size_read;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_drained(JsonParser *parser) {
+    return parser->eof && parser->raw_buffer.pointer == parser->raw_buffer.last;
+};
+
+static void _myjson_parser_shift_buffer(JsonParser *parser) {
+    size_t shift = parser->buffer.pointer - parser->buffer.start;
+    size_t *structural;
+
+    /* Keep the characters that are not indexed yet. */
+    if (shift > parser->structurals.indexed) {
+        shift = parser->structurals.indexed;
+    }
+
+    if (!shift) {
+        return;
+    }
+
+    memmove(parser->buffer.start, parser->buffer.start + shift, parser->buffer.last - parser->buffer.start - shift);
+    parser->buffer.pointer -= shift;
+    parser->buffer.last -= shift;
+    parser->structurals.indexed -= shift;
+
+    for (structural = parser->structurals.head; structural != parser->structurals.tail; structural++) {
+        *structural -= shift;
+    }
+};
+
+static int _myjson_parser_decode_raw_buffer(JsonParser *parser) {
+    unsigned char *raw = parser->raw_buffer.pointer;
+    const unsigned char *raw_end = parser->raw_buffer.last;
+    JsonChar_t *output = parser->buffer.last;
+    int big_endian = (parser->encoding == JSON_UTF16BE_ENCODING || parser->encoding == JSON_UTF32BE_ENCODING);
+    size_t width = (parser->encoding == JSON_UTF16LE_ENCODING || parser->encoding == JSON_UTF16BE_ENCODING) ? 2 : 4;
+
+    while ((size_t)(raw_end - raw) >= width) {
+        size_t count = (raw_end - raw) / width;
+        unsigned int code;
+
+        /* Copy the ASCII characters with the kernel. */
+        if (count > (size_t)(parser->buffer.end - output)) {
+            count = parser->buffer.end - output;
+        }
+
+        count = (width == 2) ? parser->kernel->narrow_utf16(raw, count, big_endian, output)
+                             : parser->kernel->narrow_utf32(raw, count, big_endian, output);
+        raw += count * width;
+        output += count;
+
+        if ((size_t)(raw_end - raw) < width || parser->buffer.end - output < 4) {
+            break;
+        }
+
+        /* Decode the next character. */
+        code = _myjson_load_unit(raw, width, big_endian);
+
+        if (width == 2 && code >= 0xDC00 && code <= 0xDFFF) {
+            return _myjson_parser_set_reader_error(parser, "unexpected low surrogate area",
+                                                   parser->offset + (raw - parser->raw_buffer.pointer));
+        }
+
+        if (width == 2 && code >= 0xD800 && code <= 0xDBFF) {
+            unsigned int low;
+
+            if (raw_end - raw < 4) {
+                if (parser->eof) {
+                    return _myjson_parser_set_reader_error(parser, "incomplete UTF-16 surrogate pair",
+                                                           parser->offset + (raw - parser->raw_buffer.pointer));
+                }
+                break;
+            }
+
+            low = _myjson_load_unit(raw + 2, 2, big_endian);
+            if (low < 0xDC00 || low > 0xDFFF) {
+                return _myjson_parser_set_reader_error(parser, "expected low surrogate area",
+                                                       parser->offset + (raw + 2 - parser->raw_buffer.pointer));
+            }
+
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            raw += 2;
+        }
+
+        if (width == 4 && (code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF))) {
+            return _myjson_parser_set_reader_error(parser, "invalid Unicode character",
+                                                   parser->offset + (raw - parser->raw_buffer.pointer));
+        }
+
+        raw += width;
+        output += _myjson_utf8_encode(code, output);
+    }
+
+    if (parser->eof && raw != raw_end && (size_t)(raw_end - raw) < width) {
+        return _myjson_parser_set_reader_error(
+            parser, (width == 2) ? "incomplete UTF-16 character" : "incomplete UTF-32 character",
+            parser->offset + (raw - parser->raw_buffer.pointer));
+    }
+
+    parser->offset += raw - parser->raw_buffer.pointer;
+    parser->raw_buffer.pointer = raw;
+    parser->buffer.last = output;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_update_buffer(JsonParser *parser, size_t length) {
+    MYJSON_ASSERT(parser->read_handler); /* Read handler must be set. */
+
+    parser->waiting = 0;
+
+    /* Determine the input encoding if it is not known yet. */
+    if (!parser->encoding) {
+        if (!_myjson_parser_determine_encoding(parser)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    /* Return if the buffer contains enough characters. */
+    if ((size_t)(parser->buffer.last - parser->buffer.pointer) >= length) {
+        return MYJSON_SUCCESS;
+    }
+
+    /* If the EOF flag is set and the raw buffer is empty, do nothing. */
+    if (_myjson_parser_drained(parser)) {
+        return MYJSON_SUCCESS;
+    }
+
+    /* Move the unread characters to the beginning of the buffer. */
+    _myjson_parser_shift_buffer(parser);
+
+    /* Fill the buffer until it has enough characters. */
+    while ((size_t)(parser->buffer.last - parser->buffer.pointer) < length &&
+           parser->buffer.last != parser->buffer.end) {
+        JsonChar_t *last = parser->buffer.last;
+
+        /* Read UTF-8 straight into the working buffer (it is validated by the structural index). */
+        if (parser->encoding == JSON_UTF8_ENCODING) {
+            size_t size;
+
+            if (!_myjson_parser_read(parser, parser->buffer.last, parser->buffer.end - parser->buffer.last, &size)) {
+                return MYJSON_FAILURE;
+            }
+
+            parser->buffer.last += size;
+            parser->offset += size;
+        } else {
+            if (!_myjson_parser_update_raw_buffer(parser) || !_myjson_parser_decode_raw_buffer(parser)) {
+                return MYJSON_FAILURE;
+            }
+
+            /* No room is left for the next character. */
+            if (parser->buffer.last == last && parser->raw_buffer.last - parser->raw_buffer.pointer >= 4) {
+                break;
+            }
+        }
+
+        if (parser->waiting) {
+            break;
+        }
+
+        if (parser->offset > MYJSON_MAX_FILE_SIZE && !parser->mapping.start) {
+            return _myjson_parser_set_reader_error(parser, "input is too long", parser->offset);
+        }
+
+        if (_myjson_parser_drained(parser)) {
+            break;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Read Ahead
+//-----------------------------------------------------------------------------
+
+static void _myjson_read_ahead_run(void *data) {
+    JsonReadAhead *reader = (JsonReadAhead *)data;
+    JsonReadAheadState *state = (JsonReadAheadState *)reader->state;
+    JsonReadAheadChunk *chunk;
+
+    for (;;) {
+        size_t length = 0;
+        int error = 0;
+
+        /* Wait for a free chunk. */
+        _myjson_mutex_lock(&state->mutex);
+        while (!state->stop && state->submitted == state->current + reader->count) {
+            _myjson_condition_wait(&state->condition, &state->mutex);
+        }
+        if (state->stop) {
+            _myjson_mutex_unlock(&state->mutex);
+            return;
+        }
+        chunk = state->chunks + state->submitted % reader->count;
+        _myjson_mutex_unlock(&state->mutex);
+
+        /* Hand over whatever a single read returns: a pipe or a socket should not wait for a full chunk. */
+        for (;;) {
+#if MYJSON_PLATFORM_IS(WINDOWS)
+            int result = _read(reader->fd, chunk->start, (unsigned)reader->size);
+#else
+            ssize_t result = read(reader->fd, chunk->start, reader->size);
+#endif
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result < 0) {
+                error = 1;
+            } else {
+                length = (size_t)result;
+            }
+            break;
+        }
+
+        _myjson_mutex_lock(&state->mutex);
+        chunk->length = length;
+        chunk->pointer = 0;
+        chunk->error = error;
+        state->submitted++;
+        _myjson_condition_broadcast(&state->condition);
+        _myjson_mutex_unlock(&state->mutex);
+
+        /* Stop at the end of the input, or on error. */
+        if (!length) {
+            return;
+        }
+    }
+};
+
+static int _myjson_read_ahead_wait(JsonReadAhead *reader, JsonReadAheadChunk *chunk) {
+    JsonReadAheadState *state = (JsonReadAheadState *)reader->state;
+
+#if MYJSON_IO_URING
+    if (reader->io_uring) {
+        while (!chunk->done) {
+            if (!_myjson_read_ahead_complete(reader, 1)) {
+                return MYJSON_FAILURE;
+            }
+        }
+
+        return MYJSON_SUCCESS;
+    }
+#else
+    (void)chunk;
+#endif
+
+    _myjson_mutex_lock(&state->mutex);
+    while (state->submitted == state->current) {
+        _myjson_condition_wait(&state->condition, &state->mutex);
+    }
+    _myjson_mutex_unlock(&state->mutex);
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_read_ahead_release(JsonReadAhead *reader, JsonReadAheadChunk *chunk) {
+    JsonReadAheadState *state = (JsonReadAheadState *)reader->state;
+
+#if MYJSON_IO_URING
+    if (reader->io_uring) {
+        /* Read the rest of a short chunk, or the chunk `count` places ahead. */
+        if (chunk->length < chunk->size) {
+            chunk->offset += chunk->length;
+            chunk->size -= chunk->length;
+        } else {
+            state->current++;
+            chunk->offset = state->base + (uint64_t)(state->current + reader->count - 1) * reader->size;
+            chunk->size = reader->size;
+        }
+
+        return _myjson_read_ahead_submit(reader, chunk);
+    }
+#else
+    (void)chunk;
+#endif
+
+    _myjson_mutex_lock(&state->mutex);
+    state->current++;
+    _myjson_condition_broadcast(&state->condition);
+    _myjson_mutex_unlock(&state->mutex);
+
+    return MYJSON_SUCCESS;
+};
+
+#if MYJSON_IO_URING
+
+static int _myjson_ring_initialize(JsonRing *ring, unsigned entries) {
+    struct io_uring_params params;
+    unsigned char *sq_ring, *cq_ring;
+
+    memset(ring, 0, sizeof(JsonRing));
+    memset(&params, 0, sizeof(params));
+
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) {
+        return MYJSON_FAILURE;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    /* Both rings may share a single mapping. */
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_ring_size > ring->sq_ring_size) {
+            ring->sq_ring_size = ring->cq_ring_size;
+        }
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                         IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+        goto error;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                             IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED) {
+            munmap(ring->sq_ring, ring->sq_ring_size);
+            goto error;
+        }
+    }
+
+    ring->sqes = (struct io_uring_sqe *)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                             ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        if (ring->cq_ring != ring->sq_ring) {
+            munmap(ring->cq_ring, ring->cq_ring_size);
+        }
+        munmap(ring->sq_ring, ring->sq_ring_size);
+        goto error;
+    }
+
+    sq_ring = (unsigned char *)ring->sq_ring;
+    ring->sq_head = (unsigned *)(sq_ring + params.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq_ring + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq_ring + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq_ring + params.sq_off.array);
+
+    cq_ring = (unsigned char *)ring->cq_ring;
+    ring->cq_head = (unsigned *)(cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq_ring + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq_ring + params.cq_off.cqes);
+
+    return MYJSON_SUCCESS;
+
+error:
+    close(ring->fd);
+    return MYJSON_FAILURE;
+};
+
+static void _myjson_ring_delete(JsonRing *ring) {
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+};
+
+static int _myjson_read_ahead_submit(JsonReadAhead *reader, JsonReadAheadChunk *chunk) {
+    JsonReadAheadState *state = (JsonReadAheadState *)reader->state;
+    JsonRing *ring = &state->ring;
+    unsigned tail = *ring->sq_tail, index = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = ring->sqes + index;
+
+    chunk->length = 0;
+    chunk->pointer = 0;
+    chunk->done = 0;
+    chunk->error = 0;
+    chunk->vector.iov_base = chunk->start;
+    chunk->vector.iov_len = chunk->size;
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = reader->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&chunk->vector;
+    sqe->len = 1;
+    sqe->off = chunk->offset;
+    sqe->user_data = (uint64_t)(chunk - state->chunks);
+
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    while (syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0) < 0) {
+        if (errno != EINTR) {
+            return MYJSON_FAILURE;
+        }
+    }
+    state->pending++;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_read_ahead_complete(JsonReadAhead *reader, unsigned count) {
+    JsonReadAheadState *state = (JsonReadAheadState *)reader->state;
+    JsonRing *ring = &state->ring;
+
+    for (;;) {
+        unsigned head = *ring->cq_head;
+
+        /* Collect the completions. */
+        while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe *cqe = ring->cqes + (head & *ring->cq_mask);
+            JsonReadAheadChunk *chunk = state->chunks + cqe->user_data;
+
+            if (cqe->res < 0) {
+                chunk->error = 1;
+            } else {
+                chunk->length = (size_t)cqe->res;
+            }
+            chunk->done = 1;
+            state->pending--;
+            head++;
+
+            if (count) {
+                count--;
+            }
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+        if (!count) {
+            return MYJSON_SUCCESS;
+        }
+
+        if (syscall(__NR_io_uring_enter, ring->fd, 0, count, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+            errno != EINTR) {
+            return MYJSON_FAILURE;
+        }
+    }
+};
+
+#endif
+
+//-----------------------------------------------------------------------------
+// [SECTION] Structural Index
+//-----------------------------------------------------------------------------
+
+static MYJSON_INLINE uint64_t _myjson_prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+};
+
+static MYJSON_INLINE uint64_t _myjson_find_escaped(uint64_t backslash, uint64_t *carry) {
+    const uint64_t even_bits = 0x5555555555555555ULL;
+    uint64_t follows_escape, odd_starts, sequences;
+
+    if (!backslash && !*carry) {
+        return 0;
+    }
+
+    /* A backslash escaped by the previous block does not start a sequence. */
+    backslash &= ~*carry;
+    follows_escape = (backslash << 1) | *carry;
+
+    /* Runs of backslashes starting on an odd bit overflow into an even bit. */
+    odd_starts = backslash & ~even_bits & ~follows_escape;
+    sequences = odd_starts + backslash;
+    *carry = sequences < odd_starts;
+
+    return (even_bits ^ (sequences << 1)) & follows_escape;
+};
+
+static int _myjson_parser_initialize_index(JsonParser *parser, size_t capacity) {
+    /* A reset parser keeps its index when it is large enough. */
+    if ((size_t)(parser->structurals.end - parser->structurals.start) < capacity) {
+        _myjson_parser_delete_index(parser);
+
+        parser->structurals.start = (size_t *)_myjson_malloc(parser->allocator, 2 * capacity * sizeof(size_t));
+        if (!parser->structurals.start) {
+            return MYJSON_MEMORY_ERROR(parser);
+        }
+        parser->structurals.end = parser->structurals.start + capacity;
+        parser->structurals.matches = parser->structurals.end;
+    }
+
+    if (!parser->structurals.opens.start &&
+        (!MYJSON_STACK_INIT(parser, parser->allocator, parser->structurals.opens, size_t) ||
+         !MYJSON_STACK_INIT(parser, parser->allocator, parser->structurals.closes, size_t))) {
+        return MYJSON_FAILURE;
+    }
+
+    parser->structurals.head = parser->structurals.start;
+    parser->structurals.tail = parser->structurals.start;
+    parser->structurals.base = 0;
+    parser->structurals.opens.top = parser->structurals.opens.start;
+    parser->structurals.closes.top = parser->structurals.closes.start;
+
+    return MYJSON_SUCCESS;
+};
+
+static void _myjson_parser_delete_index(JsonParser *parser) {
+    /* The links are allocated after the offsets. */
+    _myjson_free(parser->allocator, parser->structurals.start,
+                 2 * (parser->structurals.end - parser->structurals.start) * sizeof(size_t));
+    MYJSON_STACK_DEL(parser->allocator, parser->structurals.opens);
+    MYJSON_STACK_DEL(parser->allocator, parser->structurals.closes);
+    parser->structurals.start = parser->structurals.head = parser->structurals.tail = parser->structurals.end = NULL;
+    parser->structurals.matches = NULL;
+};
+
+static void _myjson_parser_reset_index(JsonParser *parser, size_t offset) {
+    parser->structurals.head = parser->structurals.start;
+    parser->structurals.tail = parser->structurals.start;
+    parser->structurals.base = 0;
+    parser->structurals.opens.top = parser->structurals.opens.start;
+    parser->structurals.closes.top = parser->structurals.closes.start;
+    parser->structurals.indexed = offset;
+    parser->structurals.escaped = 0;
+    parser->structurals.string = 0;
+    parser->structurals.scalar = 0;
+    parser->structurals.utf8 = 0;
+};
+
+static int _myjson_parser_set_utf8_error(JsonParser *parser, size_t offset, uint32_t previous) {
+    JsonChar_t sequence[3 + MYJSON_STRUCTURAL_BLOCK_SIZE + 3];
+    size_t pending = _myjson_utf8_pending(previous);
+    size_t length = (parser->buffer.last - parser->buffer.start) - offset;
+    size_t valid, i;
+
+    /* Check the block again one sequence at a time, from the sequence left open before it. */
+    for (i = 0; i < pending; i++) {
+        sequence[i] = (JsonChar_t)(previous >> (8 * (4 - pending + i)));
+    }
+
+    if (length > MYJSON_STRUCTURAL_BLOCK_SIZE + 3) {
+        length = MYJSON_STRUCTURAL_BLOCK_SIZE + 3;
+    }
+
+    memcpy(sequence + pending, parser->buffer.start + offset, length);
+    valid = _myjson_validate_utf8_fallback(sequence, pending + length);
+
+    return _myjson_parser_set_reader_error(parser, "invalid UTF-8 octet sequence",
+                                           parser->offset - (parser->buffer.last - parser->buffer.start) + offset -
+                                               pending + valid);
+};
+
+static MYJSON_INLINE int _myjson_parser_link_bracket(JsonParser *parser, size_t *structural, JsonChar_t c) {
+    size_t number = parser->structurals.base + (structural - parser->structurals.start);
+    size_t open, depth;
+
+    switch (c) {
+        case '[':
+        case '{':
+            parser->structurals.matches[structural - parser->structurals.start] = 0;
+            return MYJSON_PUSH(parser, parser->allocator, parser->structurals.opens, number);
+        case ']':
+        case '}':
+            /* An unbalanced bracket is left to the parser. */
+            if (MYJSON_STACK_EMPTY(parser->structurals.opens)) {
+                return MYJSON_SUCCESS;
+            }
+            open = MYJSON_POP(parser, parser->structurals.opens);
+            if (open >= parser->structurals.base) {
+                parser->structurals.matches[open - parser->structurals.base] = number - open;
+            }
+
+            /* The scanner may be in the container already. */
+            depth = parser->structurals.opens.top - parser->structurals.opens.start;
+            if ((size_t)(parser->structurals.closes.top - parser->structurals.closes.start) > depth &&
+                !parser->structurals.closes.start[depth]) {
+                parser->structurals.closes.start[depth] = number;
+            }
+            return MYJSON_SUCCESS;
+        default:
+            return MYJSON_SUCCESS;
+    }
+};
+
+static int _myjson_parser_index_block(JsonParser *parser, const JsonChar_t *block, size_t offset) {
+    JsonStructuralBlock masks;
+    uint64_t escaped, quote, string, scalar, structurals, operators;
+    size_t *tail = parser->structurals.tail;
+    uint32_t previous = parser->structurals.utf8;
+
+    if (!parser->kernel->classify_block(block, &masks, &parser->structurals.utf8)) {
+        return _myjson_parser_set_utf8_error(parser, offset, previous);
+    }
+
+    /* The string bodies, including the opening but not the closing quotes. */
+    escaped = _myjson_find_escaped(masks.backslash, &parser->structurals.escaped);
+    quote = masks.quote & ~escaped;
+    string = _myjson_prefix_xor(quote) ^ parser->structurals.string;
+    parser->structurals.string = 0 - (string >> 63);
+
+    /* Operators outside of strings, every quote, and the first byte of each number or literal. */
+    scalar = ~(masks.op | masks.whitespace | quote | string);
+    operators = masks.op & ~string;
+    structurals = operators | quote | (scalar & ~((scalar << 1) | parser->structurals.scalar));
+    parser->structurals.scalar = scalar >> 63;
+
+    while (structurals) {
+        uint64_t bit = structurals & (0 - structurals);
+        size_t position = _myjson_trailing_zeroes(structurals);
+
+        *tail = offset + position;
+        if ((bit & operators) && !_myjson_parser_link_bracket(parser, tail, block[position])) {
+            return MYJSON_FAILURE;
+        }
+        tail++;
+        structurals ^= bit;
+    }
+
+    parser->structurals.tail = tail;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_index_structurals(JsonParser *parser) {
+    JsonChar_t *block = parser->buffer.start + parser->structurals.indexed;
+
+    /* Move the pending structurals to the beginning of the index. */
+    if (parser->structurals.head != parser->structurals.start) {
+        size_t pending = parser->structurals.tail - parser->structurals.head;
+        size_t dropped = parser->structurals.head - parser->structurals.start;
+
+        memmove(parser->structurals.start, parser->structurals.head, pending * sizeof(size_t));
+        memmove(parser->structurals.matches, parser->structurals.matches + dropped, pending * sizeof(size_t));
+        parser->structurals.base += dropped;
+        parser->structurals.head = parser->structurals.start;
+        parser->structurals.tail = parser->structurals.start + pending;
+    }
+
+    while (parser->structurals.end - parser->structurals.tail >= MYJSON_STRUCTURAL_BLOCK_SIZE) {
+        size_t available = parser->buffer.last - block;
+
+        if (available >= MYJSON_STRUCTURAL_BLOCK_SIZE) {
+            if (!_myjson_parser_index_block(parser, block, block - parser->buffer.start)) {
+                return MYJSON_FAILURE;
+            }
+            block += MYJSON_STRUCTURAL_BLOCK_SIZE;
+            continue;
+        }
+
+        /* The last block of the input is padded with whitespace. */
+        if (available && _myjson_parser_drained(parser)) {
+            JsonChar_t padded[MYJSON_STRUCTURAL_BLOCK_SIZE];
+
+            memset(padded, ' ', MYJSON_STRUCTURAL_BLOCK_SIZE);
+            memcpy(padded, block, available);
+            if (!_myjson_parser_index_block(parser, padded, block - parser->buffer.start)) {
+                return MYJSON_FAILURE;
+            }
+            block += available;
+        }
+
+        break;
+    }
+
+    parser->structurals.indexed = block - parser->buffer.start;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_fetch_structurals(JsonParser *parser, size_t count) {
+    while ((size_t)(parser->structurals.tail - parser->structurals.head) < count) {
+        size_t unindexed = (parser->buffer.last - parser->buffer.start) - parser->structurals.indexed;
+        size_t length;
+
+        if (unindexed >= MYJSON_STRUCTURAL_BLOCK_SIZE || (unindexed && _myjson_parser_drained(parser))) {
+            if (!_myjson_parser_index_structurals(parser)) {
+                return MYJSON_FAILURE;
+            }
+            continue;
+        }
+
+        if (_myjson_parser_drained(parser)) {
+            /* The input must not end in the middle of a sequence. */
+            if (_myjson_utf8_pending(parser->structurals.utf8)) {
+                return _myjson_parser_set_utf8_error(parser, parser->structurals.indexed, parser->structurals.utf8);
+            }
+            break;
+        }
+
+        /* Read enough input to complete the next block. */
+        length = (parser->buffer.start + parser->structurals.indexed + MYJSON_STRUCTURAL_BLOCK_SIZE) -
+                 parser->buffer.pointer;
+
+        if (!_myjson_parser_update_buffer(parser, length)) {
+            return MYJSON_FAILURE;
+        }
+
+        if ((parser->buffer.last - parser->buffer.start) - parser->structurals.indexed == unindexed &&
+            !_myjson_parser_drained(parser)) {
+            /* A push parser waits for the next chunk. */
+            if (parser->waiting) {
+                return MYJSON_FAILURE;
+            }
+
+            return _myjson_parser_set_scanner_error(parser, "found a token longer than the input buffer",
+                                                    parser->position);
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Scanner
+//-----------------------------------------------------------------------------
+
+static int _myjson_parser_set_scanner_error(JsonParser *parser, const char *problem, JsonPosition position) {
+    parser->error.type = JSON_SCANNER_ERROR;
+    parser->error.message = problem;
+    parser->error_pos = position;
+
+    return MYJSON_FAILURE;
+};
+
+static MYJSON_INLINE int _myjson_is_scalar(JsonChar_t c) {
+    switch (c) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case ',':
+        case ':':
+        case '[':
+        case ']':
+        case '{':
+        case '}':
+        case '"':
+            return 0;
+        default:
+            return 1;
+    }
+};
+
+static void _myjson_parser_skip_whitespace(JsonParser *parser, JsonChar_t *target) {
+    size_t length = target - parser->buffer.pointer;
+    size_t lines, tail;
+
+    MYJSON_ASSERT(parser->buffer.pointer <= target); /* The scanner never moves backwards. */
+
+    lines = parser->kernel->count_newlines(parser->buffer.pointer, length, &tail);
+
+    parser->position.index += length;
+    parser->position.line += lines;
+    parser->position.column = lines ? tail : parser->position.column + tail;
+    parser->buffer.pointer = target;
+};
+
+static int _myjson_parser_next_structural(JsonParser *parser, JsonChar_t **pointer) {
+    while (parser->structurals.head == parser->structurals.tail) {
+        JsonChar_t *indexed = parser->buffer.start + parser->structurals.indexed;
+
+        /* Everything indexed after the last token is whitespace. */
+        if (parser->buffer.pointer < indexed) {
+            _myjson_parser_skip_whitespace(parser, indexed);
+        }
+
+        if (!_myjson_parser_fetch_structurals(parser, 1)) {
+            return MYJSON_FAILURE;
+        }
+
+        /* Check for the end of the input. */
+        if (parser->structurals.head == parser->structurals.tail) {
+            indexed = parser->buffer.start + parser->structurals.indexed;
+            if (parser->buffer.pointer < indexed) {
+                _myjson_parser_skip_whitespace(parser, indexed);
+            }
+
+            *pointer = NULL;
+            return MYJSON_SUCCESS;
+        }
+    }
+
+    _myjson_parser_skip_whitespace(parser, parser->buffer.start + *parser->structurals.head);
+    *pointer = parser->buffer.pointer;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_skip_container(JsonParser *parser, JsonChar_t close) {
+    JsonChar_t *pointer = NULL;
+    size_t depth = 1;
+
+    /* The tokens fetched ahead are the first ones of the container. */
+    while (!MYJSON_QUEUE_EMPTY(parser->tokens)) {
+        JsonToken token = MYJSON_DEQUEUE(parser, parser->tokens);
+
+        if (token.type == JSON_ARRAY_BEGIN_TOKEN || token.type == JSON_OBJECT_BEGIN_TOKEN) {
+            depth++;
+        } else if (token.type == JSON_ARRAY_END_TOKEN || token.type == JSON_OBJECT_END_TOKEN) {
+            depth--;
+        }
+        _myjson_token_delete(&token);
+
+        if (!depth) {
+            parser->token_available = 0;
+            if (token.type != (close == ']' ? JSON_ARRAY_END_TOKEN : JSON_OBJECT_END_TOKEN)) {
+                return _myjson_parser_set_parser_error(parser, (close == ']') ? "did not find expected ',' or ']'"
+                                                                              : "did not find expected ',' or '}'",
+                                                       token.start_pos);
+            }
+            return MYJSON_SUCCESS;
+        }
+    }
+    parser->token_available = 0;
+
+    /* Nothing inside the container is tokenized: jump to its closing bracket once it is indexed. */
+    if ((size_t)(parser->structurals.closes.top - parser->structurals.closes.start) >= depth) {
+        size_t *match = parser->structurals.closes.top - depth;
+
+        while (!*match) {
+            /* Let the buffer move on: everything indexed so far is in the container. */
+            parser->structurals.head = parser->structurals.tail;
+            _myjson_parser_skip_whitespace(parser, parser->buffer.start + parser->structurals.indexed);
+
+            if (!_myjson_parser_fetch_structurals(parser, 1)) {
+                return MYJSON_FAILURE;
+            }
+
+            if (parser->structurals.head == parser->structurals.tail) {
+                break;
+            }
+        }
+
+        if (*match) {
+            parser->structurals.head = parser->structurals.start + (*match - parser->structurals.base);
+            pointer = parser->buffer.start + *parser->structurals.head++;
+            depth = 0;
+        }
+        parser->structurals.closes.top = match;
+    } else {
+        parser->structurals.closes.top = parser->structurals.closes.start;
+    }
+
+    /* A container opened before the index was reset: count its brackets. */
+    while (depth) {
+        JsonChar_t c;
+
+        if (parser->structurals.head == parser->structurals.tail) {
+            /* Let the buffer move on: everything indexed so far is in the container. */
+            _myjson_parser_skip_whitespace(parser, parser->buffer.start + parser->structurals.indexed);
+
+            if (!_myjson_parser_fetch_structurals(parser, 1)) {
+                return MYJSON_FAILURE;
+            }
+
+            if (parser->structurals.head == parser->structurals.tail) {
+                break;
+            }
+        }
+
+        pointer = parser->buffer.start + *parser->structurals.head++;
+        c = *pointer;
+        depth += (c == '[' || c == '{');
+        depth -= (c == ']' || c == '}');
+    }
+
+    if (depth || *pointer != close) {
+        if (!depth) {
+            _myjson_parser_skip_whitespace(parser, pointer);
+        }
+        return _myjson_parser_set_parser_error(parser, (close == ']') ? "did not find expected ',' or ']'"
+                                                                      : "did not find expected ',' or '}'",
+                                               parser->position);
+    }
+
+    _myjson_parser_skip_whitespace(parser, pointer + 1);
+    parser->token_line = parser->position.line;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_fetch_more_tokens(JsonParser *parser) {
+    if (MYJSON_QUEUE_EMPTY(parser->tokens)) {
+        if (!_myjson_parser_fetch_next_token(parser)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    parser->token_available = 1;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_fetch_next_token(JsonParser *parser) {
+    JsonChar_t *pointer;
+
+    if (!_myjson_parser_next_structural(parser, &pointer)) {
+        return MYJSON_FAILURE;
+    }
+
+    /* Is it the end of the stream? */
+    if (!pointer) {
+        return _myjson_parser_fetch_stream_end(parser);
+    }
+
+    switch (*pointer) {
+        case '[':
+            return _myjson_parser_fetch_indicator(parser, JSON_ARRAY_BEGIN_TOKEN);
+        case ']':
+            return _myjson_parser_fetch_indicator(parser, JSON_ARRAY_END_TOKEN);
+        case '{':
+            return _myjson_parser_fetch_indicator(parser, JSON_OBJECT_BEGIN_TOKEN);
+        case '}':
+            return _myjson_parser_fetch_indicator(parser, JSON_OBJECT_END_TOKEN);
+        case ':':
+            return _myjson_parser_fetch_indicator(parser, JSON_NAME_SEPERATOR_TOKEN);
+        case ',':
+            return _myjson_parser_fetch_indicator(parser, JSON_VALUE_SEPERATOR_TOKEN);
+        case '"':
+            return _myjson_parser_fetch_string(parser);
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case 't':
+        case 'f':
+        case 'n':
+            return _myjson_parser_fetch_scalar(parser);
+        default:
+            return _myjson_parser_set_scanner_error(parser, "found character that cannot start any token",
+                                                    parser->position);
+    }
+};
+
+static int _myjson_parser_fetch_lookahead(JsonParser *parser) {
+    if (MYJSON_QUEUE_EMPTY(parser->tokens) && !_myjson_parser_fetch_next_token(parser)) {
+        return MYJSON_FAILURE;
+    }
+
+    /* A state skips a ',' or a ':' before it looks at the next token. */
+    if (MYJSON_QUEUE_NEXT(parser->tokens, parser->tokens.head) == parser->tokens.tail &&
+        (parser->tokens.head->type == JSON_VALUE_SEPERATOR_TOKEN ||
+         parser->tokens.head->type == JSON_NAME_SEPERATOR_TOKEN)) {
+        return _myjson_parser_fetch_next_token(parser);
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_skip_line(JsonParser *parser) {
+    for (;;) {
+        size_t available = parser->buffer.last - parser->buffer.pointer;
+        JsonChar_t *newline = (JsonChar_t *)memchr(parser->buffer.pointer, '\n', available);
+        JsonChar_t *target = newline ? newline + 1 : parser->buffer.last;
+
+        /* The index may have paired quotes across the line break: start it over. */
+        _myjson_parser_skip_whitespace(parser, target);
+        _myjson_parser_reset_index(parser, target - parser->buffer.start);
+
+        if (newline || _myjson_parser_drained(parser)) {
+            return MYJSON_SUCCESS;
+        }
+
+        /* A push parser comes back here with the next chunk. */
+        if (!_myjson_parser_update_buffer(parser, 1) || parser->waiting) {
+            return MYJSON_FAILURE;
+        }
+    }
+};
+
+static int _myjson_parser_fetch_stream_end(JsonParser *parser) {
+    JsonToken token;
+
+    memset(&token, 0, sizeof(JsonToken));
+    token.type = JSON_EOF_TOKEN;
+    token.start_pos = parser->position;
+    token.end_pos = parser->position;
+
+    return MYJSON_ENQUEUE(parser, parser->tokens, token);
+};
+
+static int _myjson_parser_fetch_indicator(JsonParser *parser, JsonTokenType type) {
+    size_t slot = parser->structurals.head - parser->structurals.start;
+    JsonToken token;
+
+    memset(&token, 0, sizeof(JsonToken));
+    token.type = type;
+    token.start_pos = parser->position;
+
+    /* Keep the closing bracket of each open container, as soon as it is indexed. */
+    if (type == JSON_ARRAY_BEGIN_TOKEN || type == JSON_OBJECT_BEGIN_TOKEN) {
+        size_t match = parser->structurals.matches[slot];
+
+        if (!MYJSON_PUSH(parser, parser->allocator, parser->structurals.closes,
+                         match ? parser->structurals.base + slot + match : 0)) {
+            return MYJSON_FAILURE;
+        }
+    } else if ((type == JSON_ARRAY_END_TOKEN || type == JSON_OBJECT_END_TOKEN) &&
+               !MYJSON_STACK_EMPTY(parser->structurals.closes)) {
+        (void)MYJSON_POP(parser, parser->structurals.closes);
+    }
+
+    parser->structurals.head++;
+    parser->buffer.pointer++;
+    parser->position.index++;
+    parser->position.column++;
+
+    token.end_pos = parser->position;
+
+    return MYJSON_ENQUEUE(parser, parser->tokens, token);
+};
+
+static int _myjson_parser_fetch_string(JsonParser *parser) {
+    JsonToken token;
+    JsonChar_t *start;
+    size_t length, unescaped;
+
+    /* The opening and the closing quotes. */
+    if (!_myjson_parser_fetch_structurals(parser, 2)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (parser->structurals.tail - parser->structurals.head < 2) {
+        return _myjson_parser_set_scanner_error(parser, "found unexpected end of stream while scanning a string",
+                                                parser->position);
+    }
+
+    start = parser->buffer.start + parser->structurals.head[0] + 1;
+    length = parser->structurals.head[1] - parser->structurals.head[0] - 1;
+
+    memset(&token, 0, sizeof(JsonToken));
+    token.type = JSON_STRING_TOKEN;
+    token.start_pos = parser->position;
+
+    if (parser->in_place) {
+        /* Borrow the body from the input: a mutable input is unescaped in place,
+           otherwise escape sequences are only checked. */
+        JsonChar_t *value = parser->in_situ ? start : NULL;
+
+        token.data.value = start;
+        token.data.length = length;
+        token.data.flags = JSON_BORROWED_FLAG;
+
+        if (parser->kernel->scan_string(start, length) != length) {
+            if (!_myjson_parser_unescape_string(parser, start, length, value, &unescaped)) {
+                return MYJSON_FAILURE;
+            }
+
+            if (value) {
+                token.data.length = unescaped;
+            } else {
+                token.data.flags |= JSON_ESCAPED_FLAG;
+            }
+        }
+
+        /* The closing quote (or a decoded escape) makes room for the NUL. */
+        if (value) {
+            value[token.data.length] = '\0';
+        }
+    } else {
+        token.data.value = _myjson_string_malloc(parser->allocator, length + 1);
+        if (!token.data.value) {
+            return MYJSON_MEMORY_ERROR(parser);
+        }
+
+        if (!_myjson_parser_unescape_string(parser, start, length, token.data.value, &token.data.length)) {
+            _myjson_string_free(token.data.value);
+            return MYJSON_FAILURE;
+        }
+        token.data.value[token.data.length] = '\0';
+    }
+
+    /* Jump over the string body. */
+    parser->structurals.head += 2;
+    parser->buffer.pointer += length + 2;
+    parser->position.index += length + 2;
+    parser->position.column += length + 2;
+
+    token.end_pos = parser->position;
+
+    if (!MYJSON_ENQUEUE(parser, parser->tokens, token)) {
+        _myjson_token_delete(&token);
+        return MYJSON_FAILURE;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_fetch_scalar(JsonParser *parser) {
+    JsonToken token;
+    JsonChar_t *pointer;
+    JsonValueType type;
+    size_t length;
+
+    if (!_myjson_parser_scan_scalar(parser, MYJSON_MAX_NUMBER_LENGTH, &length)) {
+        return MYJSON_FAILURE;
+    }
+
+    pointer = parser->buffer.pointer;
+
+    memset(&token, 0, sizeof(JsonToken));
+    token.start_pos = parser->position;
+
+    if (*pointer == 't' || *pointer == 'f' || *pointer == 'n') {
+        if (length == 4 && !memcmp(pointer, "true", 4)) {
+            token.type = JSON_TRUE_TOKEN;
+        } else if (length == 5 && !memcmp(pointer, "false", 5)) {
+            token.type = JSON_FALSE_TOKEN;
+        } else if (length == 4 && !memcmp(pointer, "null", 4)) {
+            token.type = JSON_NULL_TOKEN;
+        } else {
+            return _myjson_parser_set_scanner_error(parser, "found unknown literal", parser->position);
+        }
+    } else {
+        if (length > MYJSON_MAX_NUMBER_LENGTH) {
+            return _myjson_parser_set_scanner_error(parser, "found a number longer than MYJSON_MAX_NUMBER_LENGTH",
+                                                    parser->position);
+        }
+
+        if (!_myjson_parse_number(pointer, length, &type, &token.data.number, &token.data.flags)) {
+            return _myjson_parser_set_scanner_error(parser, "found invalid number", parser->position);
+        }
+
+        token.type = (type == JSON_INTEGER) ? JSON_INTEGER_TOKEN : JSON_FLOAT_TOKEN;
+    }
+
+    if (parser->in_place) {
+        token.data.value = pointer;
+        token.data.flags |= JSON_BORROWED_FLAG;
+    } else {
+        token.data.value = _myjson_string_malloc(parser->allocator, length + 1);
+        if (!token.data.value) {
+            return MYJSON_MEMORY_ERROR(parser);
+        }
+
+        memcpy(token.data.value, pointer, length);
+        token.data.value[length] = '\0';
+    }
+    token.data.length = length;
+
+    parser->structurals.head++;
+    parser->buffer.pointer += length;
+    parser->position.index += length;
+    parser->position.column += length;
+
+    token.end_pos = parser->position;
+
+    if (!MYJSON_ENQUEUE(parser, parser->tokens, token)) {
+        _myjson_token_delete(&token);
+        return MYJSON_FAILURE;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_scan_scalar(JsonParser *parser, size_t max_length, size_t *length) {
+    size_t offset = 0;
+
+    for (;;) {
+        JsonChar_t *pointer = parser->buffer.pointer + offset;
+        size_t available;
+
+        while (pointer != parser->buffer.last && _myjson_is_scalar(*pointer)) {
+            pointer++;
+        }
+
+        offset = pointer - parser->buffer.pointer;
+
+        /* Stop at a delimiter, at the end of the input, or once the scalar is too long anyway. */
+        if (pointer != parser->buffer.last || offset > max_length || _myjson_parser_drained(parser)) {
+            break;
+        }
+
+        available = parser->buffer.last - parser->buffer.pointer;
+
+        if (!_myjson_parser_update_buffer(parser, offset + MYJSON_STRUCTURAL_BLOCK_SIZE)) {
+            return MYJSON_FAILURE;
+        }
+
+        /* A push parser waits for the next chunk, otherwise the buffer is full. */
+        if ((size_t)(parser->buffer.last - parser->buffer.pointer) == available) {
+            if (parser->waiting) {
+                return MYJSON_FAILURE;
+            }
+            break;
+        }
+    }
+
+    *length = offset;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_unescape_string(JsonParser *parser, const JsonChar_t *string, size_t length,
+                                          JsonChar_t *value, size_t *value_length) {
+    size_t offset;
+    const char *problem = _myjson_unescape(parser->kernel, string, length, value, value_length, &offset);
+    JsonPosition position;
+
+    if (problem) {
+        /* Point at the offending character (after the opening quote). */
+        position = parser->position;
+        position.index += offset + 1;
+        position.column += offset + 1;
+        return _myjson_parser_set_scanner_error(parser, problem, position);
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static void _myjson_token_delete(JsonToken *token) {
+    MYJSON_ASSERT(token); /* Non-NULL token object expected. */
+
+    if (!(token->data.flags & JSON_BORROWED_FLAG)) {
+        _myjson_string_free(token->data.value);
+    }
+    memset(token, 0, sizeof(JsonToken));
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Parser States
+//-----------------------------------------------------------------------------
+
+static int _myjson_parser_set_parser_error(JsonParser *parser, const char *problem, JsonPosition position) {
+    parser->error.type = JSON_PARSER_ERROR;
+    parser->error.message = problem;
+    parser->error_pos = position;
+
+    return MYJSON_FAILURE;
+};
+
+static int _myjson_parser_state_machine(JsonParser *parser, JsonEvent *event) {
+    switch (parser->event) {
+        case JSON_PARSE_STREAM_START_EVENT:
+            return _myjson_parser_parse_stream_start(parser, event);
+        case JSON_PARSE_DOCUMENT_START_EVENT:
+            return _myjson_parser_parse_document_start(parser, event);
+        case JSON_PARSE_DOCUMENT_END_EVENT:
+            return _myjson_parser_parse_document_end(parser, event);
+        case JSON_PARSE_STREAM_END_EVENT:
+            return _myjson_parser_parse_stream_end(parser, event);
+        case JSON_PARSE_VALUE_EVENT:
+            return _myjson_parser_parse_value(parser, event);
+        case JSON_PARSE_ARRAY_FIRST_ITEM_EVENT:
+            return _myjson_parser_parse_array_item(parser, event, 1);
+        case JSON_PARSE_ARRAY_ITEM_EVENT:
+            return _myjson_parser_parse_array_item(parser, event, 0);
+        case JSON_PARSE_OBJECT_FIRST_KEY_EVENT:
+            return _myjson_parser_parse_object_key(parser, event, 1);
+        case JSON_PARSE_OBJECT_KEY_EVENT:
+            return _myjson_parser_parse_object_key(parser, event, 0);
+        case JSON_PARSE_OBJECT_VALUE_EVENT:
+            return _myjson_parser_parse_object_value(parser, event);
+        default:
+            return MYJSON_SUCCESS;
+    }
+};
+
+static void _myjson_parser_resync(JsonParser *parser) {
+    size_t line = parser->error_pos.line;
+    int skip = 1;
+
+    /* A parser error is found at the token at the head of the queue. */
+    if (parser->error.type == JSON_PARSER_ERROR && !MYJSON_QUEUE_EMPTY(parser->tokens)) {
+        /* The document was cut short by the end of a line: the token starts the next one. */
+        if (parser->tokens.head->start_pos.line > parser->token_line) {
+            skip = 0;
+        }
+    } else {
+        line = parser->position.line;
+    }
+
+    /* Drop the tokens of the malformed line, and the rest of it if the scanner is still on it. */
+    if (skip) {
+        while (!MYJSON_QUEUE_EMPTY(parser->tokens) && parser->tokens.head->start_pos.line <= line) {
+            _myjson_token_delete(&MYJSON_DEQUEUE(parser, parser->tokens));
+        }
+        skip = MYJSON_QUEUE_EMPTY(parser->tokens) && parser->position.line == line;
+    }
+
+    parser->events.top = parser->events.start;
+    parser->marks.top = parser->marks.start;
+    parser->token_available = 0;
+    parser->token_line = line;
+
+    parser->error.type = JSON_NO_ERROR;
+    parser->error.message = NULL;
+
+    parser->event = skip ? JSON_PARSE_SKIP_LINE_EVENT : JSON_PARSE_DOCUMENT_START_EVENT;
+};
+
+static int _myjson_parser_parse_stream_start(JsonParser *parser, JsonEvent *event) {
+    /* Determine the input encoding. */
+    if (!_myjson_parser_update_buffer(parser, 1)) {
+        return MYJSON_FAILURE;
+    }
+
+    parser->stream_start_produced = 1;
+    parser->event = JSON_PARSE_DOCUMENT_START_EVENT;
+
+    event->type = JSON_STREAM_START_EVENT;
+    event->start_pos = parser->position;
+    event->end_pos = parser->position;
+    event->data.stream_start.encoding = parser->encoding;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_parse_document_start(JsonParser *parser, JsonEvent *event) {
+    JsonToken *token = MYJSON_PEEK_TOKEN(parser);
+
+    if (!token) {
+        return MYJSON_FAILURE;
+    }
+
+    /* A stream of documents may end before any of them. */
+    if (token->type == JSON_EOF_TOKEN) {
+        if (parser->stream_flags & JSON_MULTI_DOCUMENT_FLAG) {
+            return _myjson_parser_parse_stream_end(parser, event);
+        }
+
+        return _myjson_parser_set_parser_error(parser, "did not find expected value", token->start_pos);
+    }
+
+    if (!MYJSON_PUSH(parser, parser->allocator, parser->events, JSON_PARSE_DOCUMENT_END_EVENT)) {
+        return MYJSON_FAILURE;
+    }
+
+    parser->event = JSON_PARSE_VALUE_EVENT;
+
+    event->type = JSON_DOCUMENT_START_EVENT;
+    event->start_pos = token->start_pos;
+    event->end_pos = token->start_pos;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_parse_document_end(JsonParser *parser, JsonEvent *event) {
+    JsonToken *token = MYJSON_PEEK_TOKEN(parser);
+
+    if (!token) {
+        return MYJSON_FAILURE;
+    }
+
+    parser->event = (parser->stream_flags & JSON_MULTI_DOCUMENT_FLAG) ? JSON_PARSE_DOCUMENT_START_EVENT
+                                                                     : JSON_PARSE_STREAM_END_EVENT;
+
+    event->type = JSON_DOCUMENT_END_EVENT;
+    event->start_pos = token->start_pos;
+    event->end_pos = token->start_pos;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_parse_stream_end(JsonParser *parser, JsonEvent *event) {
+    JsonToken *token = MYJSON_PEEK_TOKEN(parser);
+
+    if (!token) {
+        return MYJSON_FAILURE;
+    }
+
+    if (token->type != JSON_EOF_TOKEN) {
+        return _myjson_parser_set_parser_error(parser, "did not find expected end of stream", token->start_pos);
+    }
+
+    parser->event = JSON_PARSE_END_EVENT;
+
+    event->type = JSON_STREAM_END_EVENT;
+    event->start_pos = token->start_pos;
+    event->end_pos = token->end_pos;
+
+    MYJSON_SKIP_TOKEN(parser);
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_parse_value(JsonParser *parser, JsonEvent *event) {
+    JsonToken *token = MYJSON_PEEK_TOKEN(parser);
+    JsonValueType type;
+
+    if (!token) {
+        return MYJSON_FAILURE;
+    }
+
+    switch (token->type) {
+        case JSON_ARRAY_BEGIN_TOKEN:
+        case JSON_OBJECT_BEGIN_TOKEN:
+            if (!MYJSON_PUSH(parser, parser->allocator, parser->marks, token->start_pos)) {
+                return MYJSON_FAILURE;
+            }
+
+            if (token->type == JSON_ARRAY_BEGIN_TOKEN) {
+                event->type = JSON_ARRAY_START_EVENT;
+                parser->event = JSON_PARSE_ARRAY_FIRST_ITEM_EVENT;
+            } else {
+                event->type = JSON_OBJECT_START_EVENT;
+                parser->event = JSON_PARSE_OBJECT_FIRST_KEY_EVENT;
+            }
+
+            event->start_pos = token->start_pos;
+            event->end_pos = token->end_pos;
+
+            MYJSON_SKIP_TOKEN(parser);
+            return MYJSON_SUCCESS;
+
+        case JSON_STRING_TOKEN:
+            type = JSON_STRING;
+            break;
+        case JSON_INTEGER_TOKEN:
+            type = JSON_INTEGER;
+            break;
+        case JSON_FLOAT_TOKEN:
+            type = JSON_DOUBLE;
+            break;
+        case JSON_TRUE_TOKEN:
+        case JSON_FALSE_TOKEN:
+            type = JSON_BOOLOEAN;
+            break;
+        case JSON_NULL_TOKEN:
+            type = JSON_NULL;
+            break;
+
+        default:
+            return _myjson_parser_set_parser_error(parser, "did not find expected value", token->start_pos);
+    }
+
+    /* The event takes the ownership of the token value. */
+    event->type = JSON_SCALAR_EVENT;
+    event->start_pos = token->start_pos;
+    event->end_pos = token->end_pos;
+    event->data.scalar.value = token->data.value;
+    event->data.scalar.length = token->data.length;
+    event->data.scalar.flags = token->data.flags;
+    event->data.scalar.number = token->data.number;
+    event->data.scalar.type = type;
+
+    parser->event = MYJSON_POP(parser, parser->events);
+
+    MYJSON_SKIP_TOKEN(parser);
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_parse_array_item(JsonParser *parser, JsonEvent *event, int first) {
+    JsonToken *token = MYJSON_PEEK_TOKEN(parser);
+
+    if (!token) {
+        return MYJSON_FAILURE;
+    }
+
+    /* The ARRAY-END event spans the whole array. */
+    if (token->type == JSON_ARRAY_END_TOKEN) {
+        parser->event = MYJSON_POP(parser, parser->events);
+
+        event->type = JSON_ARRAY_END_EVENT;
+        event->start_pos = MYJSON_POP(parser, parser->marks);
+        event->end_pos = token->end_pos;
+
+        MYJSON_SKIP_TOKEN(parser);
+        return MYJSON_SUCCESS;
+    }
+
+    if (!first) {
+        if (token->type != JSON_VALUE_SEPERATOR_TOKEN) {
+            return _myjson_parser_set_parser_error(parser, "did not find expected ',' or ']'", token->start_pos);
+        }
+
+        MYJSON_SKIP_TOKEN(parser);
+    }
+
+    if (!MYJSON_PUSH(parser, parser->allocator, parser->events, JSON_PARSE_ARRAY_ITEM_EVENT)) {
+        return MYJSON_FAILURE;
+    }
+
+    return _myjson_parser_parse_value(parser, event);
+};
+
+static int _myjson_parser_parse_object_key(JsonParser *parser, JsonEvent *event, int first) {
+    JsonToken *token = MYJSON_PEEK_TOKEN(parser);
+
+    if (!token) {
+        return MYJSON_FAILURE;
+    }
+
+    /* The OBJECT-END event spans the whole object. */
+    if (token->type == JSON_OBJECT_END_TOKEN) {
+        parser->event = MYJSON_POP(parser, parser->events);
+
+        event->type = JSON_OBJECT_END_EVENT;
+        event->start_pos = MYJSON_POP(parser, parser->marks);
+        event->end_pos = token->end_pos;
+
+        MYJSON_SKIP_TOKEN(parser);
+        return MYJSON_SUCCESS;
+    }
+
+    if (!first) {
+        if (token->type != JSON_VALUE_SEPERATOR_TOKEN) {
+            return _myjson_parser_set_parser_error(parser, "did not find expected ',' or '}'", token->start_pos);
+        }
+
+        MYJSON_SKIP_TOKEN(parser);
+
+        token = MYJSON_PEEK_TOKEN(parser);
+        if (!token) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    if (token->type != JSON_STRING_TOKEN) {
+        return _myjson_parser_set_parser_error(parser, "did not find expected key", token->start_pos);
+    }
+
+    /* The event takes the ownership of the token value. */
+    event->type = JSON_SCALAR_EVENT;
+    event->start_pos = token->start_pos;
+    event->end_pos = token->end_pos;
+    event->data.scalar.value = token->data.value;
+    event->data.scalar.length = token->data.length;
+    event->data.scalar.flags = token->data.flags;
+    event->data.scalar.number = token->data.number;
+    event->data.scalar.type = JSON_STRING;
+
+    parser->event = JSON_PARSE_OBJECT_VALUE_EVENT;
+
+    MYJSON_SKIP_TOKEN(parser);
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_parse_object_value(JsonParser *parser, JsonEvent *event) {
+    JsonToken *token = MYJSON_PEEK_TOKEN(parser);
+
+    if (!token) {
+        return MYJSON_FAILURE;
+    }
+
+    if (token->type != JSON_NAME_SEPERATOR_TOKEN) {
+        return _myjson_parser_set_parser_error(parser, "did not find expected ':'", token->start_pos);
+    }
+
+    MYJSON_SKIP_TOKEN(parser);
+
+    if (!MYJSON_PUSH(parser, parser->allocator, parser->events, JSON_PARSE_OBJECT_KEY_EVENT)) {
+        return MYJSON_FAILURE;
+    }
+
+    return _myjson_parser_parse_value(parser, event);
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Loader
+//-----------------------------------------------------------------------------
+
+static int _myjson_parser_load_event(JsonParser *parser, JsonEvent *event) {
+    int result = json_parser_parse(parser, event);
+
+    if (result == MYJSON_NEED_MORE_INPUT) {
+        return _myjson_parser_set_reader_error(parser, "cannot load a document from a partial input", parser->offset);
+    }
+
+    return result;
+};
+
+static int _myjson_parser_load_next(JsonParser *parser, JsonDocument *document) {
+    JsonEvent event;
+
+    /* Skip the STREAM-START event. */
+    if (parser->event == JSON_PARSE_STREAM_START_EVENT) {
+        if (!_myjson_parser_load_event(parser, &event)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    if (!_myjson_parser_load_event(parser, &event)) {
+        return MYJSON_FAILURE;
+    }
+
+    /* The document is left empty at the end of the stream. */
+    if (event.type != JSON_DOCUMENT_START_EVENT) {
+        return MYJSON_SUCCESS;
+    }
+
+    return _myjson_parser_load_document(parser, &event, document);
+};
+
+static int _myjson_parser_load_document(JsonParser *parser, JsonEvent *event, JsonDocument *document) {
+    MYJSON_ASSERT(event->type == JSON_DOCUMENT_START_EVENT); /* DOCUMENT-START is expected. */
+
+    document->start_pos = event->start_pos;
+
+    if (!_myjson_parser_load_event(parser, event) || !_myjson_parser_load_value(parser, event, document) ||
+        !_myjson_parser_load_event(parser, event)) {
+        return MYJSON_FAILURE;
+    }
+
+    MYJSON_ASSERT(event->type == JSON_DOCUMENT_END_EVENT); /* DOCUMENT-END follows the root value. */
+
+    document->end_pos = event->end_pos;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_load_value(JsonParser *parser, JsonEvent *event, JsonDocument *document) {
+    int node_id, loaded;
+
+    /* The stack is the parser's, so that loading the next document does not allocate it again. */
+    parser->parents.top = parser->parents.start;
+
+    /* The loop goes on while a container is open. */
+    do {
+        switch (event->type) {
+            case JSON_SCALAR_EVENT:
+                node_id = (document->atoms && _myjson_parser_load_expects_key(parser, document))
+                              ? _myjson_parser_load_key(parser, document, event)
+                              : _myjson_parser_load_scalar(parser, document, event);
+                break;
+            case JSON_ARRAY_START_EVENT:
+                node_id = _myjson_parser_load_container(parser, document, event, JSON_ARRAY);
+                break;
+            case JSON_OBJECT_START_EVENT:
+                node_id = _myjson_parser_load_container(parser, document, event, JSON_OBJECT);
+                break;
+            case JSON_ARRAY_END_EVENT:
+            case JSON_OBJECT_END_EVENT:
+                node_id = MYJSON_POP(parser, parser->parents);
+                document->nodes.start[node_id - 1].end_pos = event->end_pos;
+                if (event->type == JSON_ARRAY_END_EVENT && parser->pack_flags &&
+                    !_myjson_parser_load_pack(parser, document, node_id)) {
+                    return MYJSON_FAILURE;
+                }
+                continue;
+            default:
+                /* The parser failed without an error. */
+                MYJSON_ASSERT(parser->error.type);
+                return MYJSON_FAILURE;
+        }
+
+        if (!node_id) {
+            return MYJSON_FAILURE;
+        }
+
+        if (!MYJSON_STACK_EMPTY(parser->parents) &&
+            !_myjson_parser_load_append(parser, document, parser->parents.top[-1], node_id)) {
+            return MYJSON_FAILURE;
+        }
+
+        if (event->type == JSON_SCALAR_EVENT) {
+            continue;
+        }
+
+        /* A large body may be loaded on several threads, up to its end (the atom table is not shared by them). */
+        if (parser->thread_count != 1 && !document->atoms) {
+            if (!_myjson_parser_load_parallel(parser, event, document, node_id, &loaded)) {
+                return MYJSON_FAILURE;
+            }
+            if (loaded) {
+                continue;
+            }
+        }
+
+        if (!MYJSON_PUSH(parser, parser->allocator, parser->parents, node_id)) {
+            return MYJSON_FAILURE;
+        }
+    } while (!MYJSON_STACK_EMPTY(parser->parents) && _myjson_parser_load_event(parser, event));
+
+    if (!MYJSON_STACK_EMPTY(parser->parents)) {
+        return MYJSON_FAILURE;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_load_scalar(JsonParser *parser, JsonDocument *document, JsonEvent *event) {
+    JsonNode node;
+
+    memset(&node, 0, sizeof(JsonNode));
+    node.type = event->data.scalar.type;
+    node.data.scalar.value = event->data.scalar.value;
+    node.data.scalar.length = event->data.scalar.length;
+    node.data.scalar.flags = event->data.scalar.flags;
+    node.data.scalar.number = event->data.scalar.number;
+    node.start_pos = event->start_pos;
+    node.end_pos = event->end_pos;
+
+    /* A borrowed string still holding escape sequences is decoded into the arena... */
+    if (node.data.scalar.flags & JSON_ESCAPED_FLAG) {
+        node.data.scalar.value = (JsonChar_t *)_myjson_arena_alloc(document, event->data.scalar.length + 1, 1);
+        if (!node.data.scalar.value) {
+            return MYJSON_MEMORY_ERROR(parser);
+        }
+
+        if (!json_string_unescape(event->data.scalar.value, event->data.scalar.length, node.data.scalar.value,
+                                  &node.data.scalar.length)) {
+            return _myjson_parser_set_parser_error(parser, "found invalid escape sequence", event->start_pos);
+        }
+
+        node.data.scalar.value[node.data.scalar.length] = '\0';
+        node.data.scalar.flags = 0;
+    }
+
+    /* ...and a copy made by the scanner is moved there (the event borrows it then). */
+    else if (!(node.data.scalar.flags & JSON_BORROWED_FLAG)) {
+        node.data.scalar.value = (JsonChar_t *)_myjson_arena_alloc(document, event->data.scalar.length + 1, 1);
+        if (!node.data.scalar.value) {
+            _myjson_string_free(event->data.scalar.value);
+            return MYJSON_MEMORY_ERROR(parser);
+        }
+
+        memcpy(node.data.scalar.value, event->data.scalar.value, event->data.scalar.length + 1);
+        _myjson_string_free(event->data.scalar.value);
+        event->data.scalar.value = node.data.scalar.value;
+        event->data.scalar.flags |= JSON_BORROWED_FLAG;
+    }
+
+    if (!MYJSON_PUSH(parser, document->allocator, document->nodes, node)) {
+        return 0;
+    }
+
+    return (int)(document->nodes.top - document->nodes.start);
+};
+
+static MYJSON_INLINE int _myjson_parser_load_expects_key(JsonParser *parser, JsonDocument *document) {
+    JsonNode *parent;
+
+    if (MYJSON_STACK_EMPTY(parser->parents)) {
+        return 0;
+    }
+
+    parent = document->nodes.start + parser->parents.top[-1] - 1;
+
+    return parent->type == JSON_OBJECT &&
+           (MYJSON_STACK_EMPTY(parent->data.object.pairs) || parent->data.object.pairs.top[-1].value);
+};
+
+static int _myjson_parser_load_key(JsonParser *parser, JsonDocument *document, JsonEvent *event) {
+    const JsonChar_t *value = event->data.scalar.value;
+    size_t length = event->data.scalar.length;
+    JsonChar_t *decoded = NULL;
+    JsonAtom *atom;
+    JsonNode node;
+    int atom_id, *key_node;
+
+    /* An escaped key is interned decoded. */
+    if (event->data.scalar.flags & JSON_ESCAPED_FLAG) {
+        decoded = (JsonChar_t *)_myjson_malloc(parser->allocator, event->data.scalar.length);
+        if (!decoded && event->data.scalar.length) {
+            return MYJSON_MEMORY_ERROR(parser);
+        }
+
+        if (!json_string_unescape(value, event->data.scalar.length, decoded, &length)) {
+            _myjson_free(parser->allocator, decoded, event->data.scalar.length);
+            return _myjson_parser_set_parser_error(parser, "found invalid escape sequence", event->start_pos);
+        }
+        value = decoded;
+    }
+
+    atom_id = json_atom_table_intern(document->atoms, value, (int)length);
+    if (decoded) {
+        _myjson_free(parser->allocator, decoded, event->data.scalar.length);
+    }
+    key_node = atom_id ? _myjson_document_key_node(document, atom_id) : NULL;
+
+    /* A copy made by the scanner is not kept (the event borrows the atom then). */
+    if (!(event->data.scalar.flags & JSON_BORROWED_FLAG)) {
+        _myjson_string_free(event->data.scalar.value);
+        event->data.scalar.value = NULL;
+    }
+
+    if (!key_node) {
+        return MYJSON_MEMORY_ERROR(parser);
+    }
+
+    atom = document->atoms->atoms.start + atom_id - 1;
+    if (!event->data.scalar.value) {
+        event->data.scalar.value = atom->value;
+        event->data.scalar.flags |= JSON_BORROWED_FLAG;
+    }
+
+    if (*key_node) {
+        return *key_node;
+    }
+
+    memset(&node, 0, sizeof(JsonNode));
+    node.type = event->data.scalar.type;
+    node.data.scalar.value = atom->value;
+    node.data.scalar.length = atom->length;
+    node.start_pos = event->start_pos;
+    node.end_pos = event->end_pos;
+
+    if (!MYJSON_PUSH(parser, document->allocator, document->nodes, node)) {
+        return 0;
+    }
+
+    *key_node = (int)(document->nodes.top - document->nodes.start);
+
+    return *key_node;
+};
+
+static int _myjson_parser_load_container(JsonParser *parser, JsonDocument *document, JsonEvent *event,
+                                         JsonValueType type) {
+    JsonNode node;
+
+    memset(&node, 0, sizeof(JsonNode));
+    node.type = type;
+    node.start_pos = event->start_pos;
+    node.end_pos = event->end_pos;
+
+    if (type == JSON_ARRAY) {
+        if (!MYJSON_ARENA_STACK_INIT(parser, document, node.data.array.items, JsonNodeItem)) {
+            return 0;
+        }
+    } else {
+        if (!MYJSON_ARENA_STACK_INIT(parser, document, node.data.object.pairs, JsonNodePair)) {
+            return 0;
+        }
+    }
+
+    if (!MYJSON_PUSH(parser, document->allocator, document->nodes, node)) {
+        return 0;
+    }
+
+    return (int)(document->nodes.top - document->nodes.start);
+};
+
+static int _myjson_parser_load_append(JsonParser *parser, JsonDocument *document, int parent, int node_id) {
+    JsonNode *node = document->nodes.start + parent - 1;
+    JsonNodePair pair;
+
+    if (node->type == JSON_ARRAY) {
+        return MYJSON_ARENA_PUSH(parser, document, node->data.array.items, node_id);
+    }
+
+    /* A key opens a pair, and the next node is its value. */
+    if (MYJSON_STACK_EMPTY(node->data.object.pairs) || node->data.object.pairs.top[-1].value) {
+        pair.key = node_id;
+        pair.value = 0;
+        return MYJSON_ARENA_PUSH(parser, document, node->data.object.pairs, pair);
+    }
+
+    node->data.object.pairs.top[-1].value = node_id;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_load_pack(JsonParser *parser, JsonDocument *document, int node_id) {
+    JsonNode *node = document->nodes.start + node_id - 1, *item;
+    size_t length = node->data.array.items.top - node->data.array.items.start, k;
+    int fraction = 0, wide = 0, inexact = 0;
+    JsonPackedType type;
+    void *values;
+
+    /* The items are the nodes after the array, unless one is a container. */
+    if (!length || (size_t)(document->nodes.top - node) != length + 1) {
+        return MYJSON_SUCCESS;
+    }
+
+    for (item = node + 1; item != document->nodes.top; item++) {
+        if (item->type == JSON_DOUBLE) {
+            fraction = 1;
+        } else if (item->type != JSON_INTEGER || (item->data.scalar.flags & JSON_UNSIGNED_FLAG)) {
+            return MYJSON_SUCCESS;
+        } else {
+            int64_t integer = item->data.scalar.number.integer;
+
+            wide |= (integer < INT32_MIN || integer > INT32_MAX);
+            inexact |= (integer < -9007199254740992LL || integer > 9007199254740992LL);
+        }
+    }
+
+    if (fraction && inexact && !(parser->pack_flags & JSON_PACK_FLOAT32)) {
+        return MYJSON_SUCCESS;
+    }
+
+    if (fraction) {
+        type = (parser->pack_flags & JSON_PACK_FLOAT32) ? JSON_PACKED_FLOAT : JSON_PACKED_DOUBLE;
+    } else {
+        type = wide ? JSON_PACKED_INT64 : JSON_PACKED_INT32;
+    }
+
+    values = _myjson_arena_alloc(document, length * (type == JSON_PACKED_INT32 || type == JSON_PACKED_FLOAT ? 4 : 8),
+                                 MYJSON_ARENA_ALIGNMENT);
+    if (!values) {
+        return MYJSON_MEMORY_ERROR(parser);
+    }
+
+    for (k = 0, item = node + 1; k < length; k++, item++) {
+        JsonNumber number = item->data.scalar.number;
+        double real = (item->type == JSON_DOUBLE) ? number.real : (double)number.integer;
+
+        switch (type) {
+            case JSON_PACKED_INT32:
+                ((int32_t *)values)[k] = (int32_t)number.integer;
+                break;
+            case JSON_PACKED_INT64:
+                ((int64_t *)values)[k] = number.integer;
+                break;
+            case JSON_PACKED_FLOAT:
+                ((float *)values)[k] = (float)real;
+                break;
+            default:
+                ((double *)values)[k] = real;
+                break;
+        }
+    }
+
+    /* The items and their strings are left to the arena. */
+    document->nodes.top = node + 1;
+
+    node->type = JSON_PACKED_ARRAY;
+    node->data.packed.values = values;
+    node->data.packed.length = length;
+    node->data.packed.type = type;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_parser_load_tape_scalar(JsonParser *parser, JsonTape *tape, JsonEvent *event) {
+    size_t offset = (size_t)(tape->strings.top - tape->strings.start);
+    uint64_t value, length;
+    int result;
+
+    switch (event->data.scalar.type) {
+        case JSON_STRING:
+            /* The length comes first, then the (decoded) bytes and a NUL. */
+            result = _myjson_stack_reserve(tape->allocator, (void **)&tape->strings.start, (void **)&tape->strings.top,
+                                           (void **)&tape->strings.end,
+                                           offset + sizeof(uint64_t) + event->data.scalar.length + 1);
+            if (!result) {
+                result = MYJSON_MEMORY_ERROR(parser);
+                break;
+            }
+
+            length = event->data.scalar.length;
+            if (event->data.scalar.flags & JSON_ESCAPED_FLAG) {
+                size_t decoded;
+
+                if (!json_string_unescape(event->data.scalar.value, event->data.scalar.length,
+                                          tape->strings.top + sizeof(uint64_t), &decoded)) {
+                    result = _myjson_parser_set_parser_error(parser, "found invalid escape sequence",
+                                                             event->start_pos);
+                    break;
+                }
+                length = decoded;
+            } else {
+                memcpy(tape->strings.top + sizeof(uint64_t), event->data.scalar.value, event->data.scalar.length);
+            }
+
+            memcpy(tape->strings.top, &length, sizeof(uint64_t));
+            tape->strings.top += sizeof(uint64_t) + length;
+            *tape->strings.top++ = '\0';
+
+            result = MYJSON_PUSH(parser, tape->allocator, tape->words, MYJSON_TAPE_WORD(JSON_TAPE_STRING, offset));
+            break;
+        case JSON_INTEGER:
+            value = event->data.scalar.number.uinteger;
+            result = MYJSON_PUSH(parser, tape->allocator, tape->words,
+                                 MYJSON_TAPE_WORD((event->data.scalar.flags & JSON_UNSIGNED_FLAG) ? JSON_TAPE_UINT64
+                                                                                                 : JSON_TAPE_INT64,
+                                                  0)) &&
+                     MYJSON_PUSH(parser, tape->allocator, tape->words, value);
+            break;
+        case JSON_DOUBLE:
+            memcpy(&value, &event->data.scalar.number.real, sizeof(uint64_t));
+            result = MYJSON_PUSH(parser, tape->allocator, tape->words, MYJSON_TAPE_WORD(JSON_TAPE_DOUBLE, 0)) &&
+                     MYJSON_PUSH(parser, tape->allocator, tape->words, value);
+            break;
+        case JSON_BOOLOEAN:
+            result = MYJSON_PUSH(
+                parser, tape->allocator, tape->words,
+                MYJSON_TAPE_WORD((event->data.scalar.value[0] == 't') ? JSON_TAPE_TRUE : JSON_TAPE_FALSE, 0));
+            break;
+        default:
+            result = MYJSON_PUSH(parser, tape->allocator, tape->words, MYJSON_TAPE_WORD(JSON_TAPE_NULL, 0));
+            break;
+    }
+
+    json_event_delete(event);
+
+    return result;
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Parallel NDJSON
+//-----------------------------------------------------------------------------
+
+static void _myjson_ndjson_run(void *data) {
+    JsonNdjsonWorker *worker = (JsonNdjsonWorker *)data;
+    JsonNdjsonPool *pool = worker->pool;
+    size_t index;
+
+    while (_myjson_ndjson_take(worker, &index)) {
+        JsonNdjsonChunk *chunk = pool->chunks + index;
+        int stop;
+
+        _myjson_mutex_lock(&pool->mutex);
+        stop = pool->stop;
+        _myjson_mutex_unlock(&pool->mutex);
+
+        /* The chunks after a failure are only taken, to empty the queues. */
+        if (!stop && !_myjson_ndjson_parse_chunk(worker, chunk)) {
+            chunk->error = 1;
+        }
+
+        _myjson_mutex_lock(&pool->mutex);
+        chunk->done = 1;
+        if (chunk->error && !pool->ordered) {
+            pool->stop = 1;
+        }
+        if (pool->ordered) {
+            _myjson_ndjson_deliver(pool);
+        }
+        _myjson_mutex_unlock(&pool->mutex);
+    }
+};
+
+static int _myjson_ndjson_take(JsonNdjsonWorker *worker, size_t *chunk) {
+    JsonNdjsonPool *pool = worker->pool;
+    size_t k;
+
+    /* The own chunks come first, in the input order. */
+    _myjson_mutex_lock(&worker->mutex);
+    if (worker->head != worker->tail) {
+        *chunk = worker->index + worker->head++ * pool->worker_count;
+        _myjson_mutex_unlock(&worker->mutex);
+        return MYJSON_SUCCESS;
+    }
+    _myjson_mutex_unlock(&worker->mutex);
+
+    /* Then the last chunks of the others, the furthest from their turn. */
+    for (k = 1; k < pool->worker_count; k++) {
+        JsonNdjsonWorker *victim = pool->workers + (worker->index + k) % pool->worker_count;
+
+        _myjson_mutex_lock(&victim->mutex);
+        if (victim->head != victim->tail) {
+            *chunk = victim->index + --victim->tail * pool->worker_count;
+            _myjson_mutex_unlock(&victim->mutex);
+            return MYJSON_SUCCESS;
+        }
+        _myjson_mutex_unlock(&victim->mutex);
+    }
+
+    return MYJSON_FAILURE;
+};
+
+static int _myjson_ndjson_parse_chunk(JsonNdjsonWorker *worker, JsonNdjsonChunk *chunk) {
+    JsonNdjsonPool *pool = worker->pool;
+    JsonParser *parser = &worker->parser;
+    JsonNdjsonDocument item;
+    size_t offset = chunk->start - pool->chunks[0].start;
+
+    json_parser_reset(parser);
+    json_parser_set_input_string(parser, chunk->start, chunk->size);
+    json_parser_set_stream_flags(parser, JSON_MULTI_DOCUMENT_FLAG);
+
+    for (;;) {
+        if (!json_parser_load(parser, &item.document)) {
+            return MYJSON_FAILURE;
+        }
+
+        if (!json_document_get_root_node(&item.document)) {
+            json_document_delete(&item.document);
+            return MYJSON_SUCCESS;
+        }
+
+        item.offset = offset + item.document.start_pos.index;
+
+        /* Keep the document until the chunk's turn... */
+        if (pool->ordered) {
+            if ((!chunk->documents.start &&
+                 !MYJSON_STACK_INIT(parser, pool->allocator, chunk->documents, JsonNdjsonDocument)) ||
+                !MYJSON_PUSH(parser, pool->allocator, chunk->documents, item)) {
+                json_document_delete(&item.document);
+                return MYJSON_FAILURE;
+            }
+            continue;
+        }
+
+        /* ...or hand it over right away. */
+        _myjson_mutex_lock(&pool->mutex);
+        if (!pool->stop && !pool->handler(pool->handler_data, &item.document, item.offset)) {
+            pool->stop = 1;
+        }
+        _myjson_mutex_unlock(&pool->mutex);
+
+        json_document_delete(&item.document);
+    }
+};
+
+static void _myjson_ndjson_deliver(JsonNdjsonPool *pool) {
+    while (pool->next < pool->count && pool->chunks[pool->next].done) {
+        JsonNdjsonChunk *chunk = pool->chunks + pool->next;
+        JsonNdjsonDocument *item;
+
+        /* The documents before a failure are still delivered. */
+        for (item = chunk->documents.start; item != chunk->documents.top && !pool->stop; item++) {
+            if (!pool->handler(pool->handler_data, &item->document, item->offset)) {
+                pool->stop = 1;
+            }
+        }
+        _myjson_ndjson_delete_documents(pool, chunk);
+
+        if (chunk->error) {
+            pool->stop = 1;
+        }
+
+        pool->next++;
+    }
+};
+
+static void _myjson_ndjson_delete_documents(JsonNdjsonPool *pool, JsonNdjsonChunk *chunk) {
+    JsonNdjsonDocument *item;
+
+    for (item = chunk->documents.start; item != chunk->documents.top; item++) {
+        json_document_delete(&item->document);
+    }
+    MYJSON_STACK_DEL(pool->allocator, chunk->documents);
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Parallel Loader
+//-----------------------------------------------------------------------------
+
+static int _myjson_parser_load_parallel(JsonParser *parser, JsonEvent *event, JsonDocument *document, int node_id,
+                                        int *loaded) {
+    JsonPieceWork work;
+    JsonNode *body;
+    size_t *splits = NULL;
+    size_t open = event->start_pos.index, close, count, capacity, thread_count = parser->thread_count, piece_size;
+    size_t remaining = (parser->buffer.last - parser->buffer.start) - open;
+    size_t nodes, items, k, share;
+    JsonPosition base = event->end_pos;
+    int result = MYJSON_SUCCESS;
+
+    *loaded = 0;
+
+    /* Only a whole UTF-8 input in memory can be cut, and only a large body is worth it. */
+    if (!parser->in_place || parser->push || remaining < 2 * MYJSON_PARALLEL_PIECE_SIZE) {
+        return MYJSON_SUCCESS;
+    }
+
+    if (!thread_count) {
+        thread_count = _myjson_processor_count();
+    }
+
+    piece_size = remaining / (thread_count * 8);
+    if (piece_size < MYJSON_PARALLEL_PIECE_SIZE) {
+        piece_size = MYJSON_PARALLEL_PIECE_SIZE;
+    }
+
+    /* No piece may take more than its share of the threads. */
+    share = remaining / thread_count > 2 * piece_size ? remaining / thread_count : 2 * piece_size;
+    if (!_myjson_parser_split_body(parser, open, piece_size, share, &splits, &count, &capacity, &close)) {
+        return parser->error.type ? MYJSON_FAILURE : MYJSON_SUCCESS;
+    }
+
+    memset(&work, 0, sizeof(work));
+    work.count = count + 1;
+    work.thread_count = thread_count < work.count ? thread_count : work.count;
+    work.type = (event->type == JSON_ARRAY_START_EVENT) ? JSON_ARRAY : JSON_OBJECT;
+    work.in_situ = parser->in_situ;
+    work.pack_flags = parser->pack_flags;
+    work.document = document;
+    work.node_id = node_id;
+    work.allocator = parser->allocator;
+
+    work.pieces = (JsonPiece *)_myjson_malloc(work.allocator, work.count * sizeof(JsonPiece));
+    if (!work.pieces || !_myjson_mutex_initialize(&work.mutex)) {
+        _myjson_free(work.allocator, work.pieces, work.count * sizeof(JsonPiece));
+        _myjson_free(work.allocator, splits, capacity * sizeof(size_t));
+        return MYJSON_MEMORY_ERROR(parser);
+    }
+
+    /* The pieces start after the opening bracket or at a separator, and the last one ends with the body. */
+    for (k = 0; k < work.count; k++) {
+        size_t start = k ? splits[k - 1] : open + 1;
+        size_t end = (k < count) ? splits[k] : close + 1;
+
+        memset(work.pieces + k, 0, sizeof(JsonPiece));
+        work.pieces[k].start = parser->buffer.start + start;
+        work.pieces[k].size = end - start;
+        work.pieces[k].document.allocator = document->allocator;
+    }
+    _myjson_free(work.allocator, splits, capacity * sizeof(size_t));
+
+    _myjson_piece_work_run(&work);
+
+    /* A malformed body is loaded again by the calling thread, to report the error where it is. */
+    for (k = 0; k < work.count; k++) {
+        if (!work.pieces[k].loaded) {
+            goto done;
+        }
+    }
+
+    /* Give each piece the place of its nodes and items, and make room for them. */
+    body = document->nodes.start + node_id - 1;
+    nodes = document->nodes.top - document->nodes.start;
+    items = (work.type == JSON_ARRAY) ? (size_t)(body->data.array.items.top - body->data.array.items.start)
+                                      : (size_t)(body->data.object.pairs.top - body->data.object.pairs.start);
+
+    for (k = 0; k < work.count; k++) {
+        JsonPiece *piece = work.pieces + k;
+        JsonNode *root = piece->document.nodes.start;
+
+        piece->base = base;
+        piece->node_offset = nodes;
+        piece->item_offset = items;
+
+        base = _myjson_position_advance(base, piece->end_pos);
+        nodes += (piece->document.nodes.top - piece->document.nodes.start) - 1;
+        items += (work.type == JSON_ARRAY) ? (size_t)(root->data.array.items.top - root->data.array.items.start)
+                                           : (size_t)(root->data.object.pairs.top - root->data.object.pairs.start);
+    }
+
+    if (!_myjson_stack_reserve(document->allocator, (void **)&document->nodes.start, (void **)&document->nodes.top,
+                               (void **)&document->nodes.end, nodes * sizeof(JsonNode))) {
+        result = MYJSON_MEMORY_ERROR(parser);
+        goto done;
+    }
+
+    body = document->nodes.start + node_id - 1;
+    if (work.type == JSON_ARRAY
+            ? !_myjson_arena_reserve(document, (void **)&body->data.array.items.start,
+                                     (void **)&body->data.array.items.top, (void **)&body->data.array.items.end,
+                                     items * sizeof(JsonNodeItem))
+            : !_myjson_arena_reserve(document, (void **)&body->data.object.pairs.start,
+                                     (void **)&body->data.object.pairs.top, (void **)&body->data.object.pairs.end,
+                                     items * sizeof(JsonNodePair))) {
+        result = MYJSON_MEMORY_ERROR(parser);
+        goto done;
+    }
+
+    /* The pieces do not overlap in the document either: they are moved in parallel too. */
+    work.moving = 1;
+    work.next = 0;
+    _myjson_piece_work_run(&work);
+
+    document->nodes.top = document->nodes.start + nodes;
+    for (k = 0; k < work.count; k++) {
+        _myjson_arena_adopt(document, &work.pieces[k].document);
+    }
+    if (work.type == JSON_ARRAY) {
+        body->data.array.items.top = body->data.array.items.start + items;
+    } else {
+        body->data.object.pairs.top = body->data.object.pairs.start + items;
+    }
+
+    /* Skip the body, as if the scanner had gone through it. */
+    while (!MYJSON_QUEUE_EMPTY(parser->tokens)) {
+        _myjson_token_delete(&MYJSON_DEQUEUE(parser, parser->tokens));
+    }
+    parser->token_available = 0;
+    parser->event = MYJSON_POP(parser, parser->events);
+    (void)MYJSON_POP(parser, parser->marks);
+
+    /* The strings of a mutable input are unescaped now: jump to the end the pieces counted. */
+    parser->buffer.pointer = parser->buffer.start + close + 1;
+    parser->position = base;
+    _myjson_parser_reset_index(parser, close + 1);
+
+    body->end_pos = parser->position;
+    *loaded = 1;
+
+    if (work.type == JSON_ARRAY && parser->pack_flags && !_myjson_parser_load_pack(parser, document, node_id)) {
+        result = MYJSON_FAILURE;
+    }
+
+done:
+    for (k = 0; k < work.count; k++) {
+        json_document_delete(&work.pieces[k].document);
+    }
+
+    _myjson_mutex_delete(&work.mutex);
+    _myjson_free(work.allocator, work.pieces, work.count * sizeof(JsonPiece));
+
+    return result;
+};
+
+static int _myjson_parser_split_body(JsonParser *parser, size_t open, size_t piece_size, size_t max_piece_size,
+                                     size_t **splits, size_t *count, size_t *capacity, size_t *close) {
+    struct {
+        size_t *start; /** The beginning of the stack. */
+        size_t *end;   /** The end of the stack. */
+        size_t *top;   /** The top of the stack. */
+    } found = {NULL, NULL, NULL};
+    const JsonChar_t *input = parser->buffer.start;
+    size_t length = parser->buffer.last - parser->buffer.start;
+    size_t offset = open + 1, last_split = open + 1, depth = 1;
+    uint64_t carry = 0, string = 0;
+    uint32_t previous = 0;
+
+    if (!MYJSON_STACK_INIT(parser, parser->allocator, found, size_t)) {
+        return MYJSON_FAILURE;
+    }
+
+    /* Go through the body 64 bytes at a time, like the structural indexer, and count the brackets. */
+    while (offset < length) {
+        JsonChar_t padded[MYJSON_STRUCTURAL_BLOCK_SIZE];
+        const JsonChar_t *block = input + offset;
+        JsonStructuralBlock masks;
+        uint64_t quote, body, op;
+
+        if (length - offset < MYJSON_STRUCTURAL_BLOCK_SIZE) {
+            memset(padded, ' ', MYJSON_STRUCTURAL_BLOCK_SIZE);
+            memcpy(padded, block, length - offset);
+            block = padded;
+        }
+
+        /* Invalid UTF-8 is left to the calling thread to report. */
+        if (!parser->kernel->classify_block(block, &masks, &previous)) {
+            break;
+        }
+
+        quote = masks.quote & ~_myjson_find_escaped(masks.backslash, &carry);
+        body = _myjson_prefix_xor(quote) ^ string;
+        string = 0 - (body >> 63);
+
+        for (op = masks.op & ~body; op; op &= op - 1) {
+            size_t at = offset + _myjson_trailing_zeroes(op);
+
+            switch (input[at]) {
+                case '[':
+                case '{':
+                    depth++;
+                    break;
+                case ']':
+                case '}':
+                    if (--depth) {
+                        break;
+                    }
+
+                    /* The last piece must not be too large either. */
+                    if (MYJSON_STACK_EMPTY(found) || at + 1 - last_split > max_piece_size) {
+                        goto error;
+                    }
+
+                    *splits = found.start;
+                    *count = found.top - found.start;
+                    *capacity = found.end - found.start;
+                    *close = at;
+                    return MYJSON_SUCCESS;
+                case ',':
+                    if (depth == 1 && at - last_split >= piece_size) {
+                        if (!MYJSON_PUSH(parser, parser->allocator, found, at)) {
+                            goto error;
+                        }
+                        last_split = at;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        offset += MYJSON_STRUCTURAL_BLOCK_SIZE;
+
+        /* A body made of a few large values is better cut inside them. */
+        if (offset - last_split > max_piece_size) {
+            break;
+        }
+    }
+
+error:
+    MYJSON_STACK_DEL(parser->allocator, found);
+    return MYJSON_FAILURE;
+};
+
+static void _myjson_piece_work_run(JsonPieceWork *work) {
+    JsonThread *threads = NULL;
+    size_t started = 0, k;
+
+    /* Fewer threads only make it slower. */
+    if (work->thread_count > 1) {
+        threads = (JsonThread *)_myjson_malloc(work->allocator, (work->thread_count - 1) * sizeof(JsonThread));
+    }
+
+    while (threads && started < work->thread_count - 1 &&
+           _myjson_thread_create(threads + started, _myjson_piece_run, work)) {
+        started++;
+    }
+
+    _myjson_piece_run(work);
+
+    for (k = 0; k < started; k++) {
+        _myjson_thread_join(threads + k);
+    }
+
+    if (threads) {
+        _myjson_free(work->allocator, threads, (work->thread_count - 1) * sizeof(JsonThread));
+    }
+};
+
+static void _myjson_piece_run(void *data) {
+    JsonPieceWork *work = (JsonPieceWork *)data;
+    JsonParser parser;
+    int initialized = 0;
+
+    for (;;) {
+        JsonPiece *piece;
+        size_t index;
+        int failed;
+
+        _myjson_mutex_lock(&work->mutex);
+        failed = work->failed;
+        index = work->next;
+        if (!failed && index < work->count) {
+            work->next++;
+        }
+        _myjson_mutex_unlock(&work->mutex);
+
+        if (failed || index >= work->count) {
+            break;
+        }
+
+        piece = work->pieces + index;
+
+        if (work->moving) {
+            _myjson_piece_move(work, piece);
+            continue;
+        }
+
+        if (!initialized) {
+            initialized = json_parser_initialize(&parser) && json_parser_set_allocator(&parser, work->allocator);
+        }
+
+        if (initialized) {
+            /* A mutable input is only written once every piece has loaded (see _myjson_piece_move). */
+            json_parser_reset(&parser);
+            json_parser_set_input_string(&parser, piece->start, piece->size);
+            json_parser_set_pack_flags(&parser, work->pack_flags);
+
+            if (_myjson_parser_load_piece(&parser, piece, work->type, index == 0, index == work->count - 1)) {
+                piece->loaded = 1;
+                continue;
+            }
+        }
+
+        _myjson_mutex_lock(&work->mutex);
+        work->failed = 1;
+        _myjson_mutex_unlock(&work->mutex);
+    }
+
+    if (initialized) {
+        json_parser_delete(&parser);
+    }
+};
+
+static int _myjson_parser_load_piece(JsonParser *parser, JsonPiece *piece, JsonValueType type, int first, int last) {
+    JsonPosition origin;
+    JsonEvent event;
+    size_t lines, tail;
+    int node_id;
+
+    memset(&origin, 0, sizeof(JsonPosition));
+    memset(&event, 0, sizeof(JsonEvent));
+
+    /* A string holds no line feed, so the piece ends after its last line feed. */
+    lines = parser->kernel->count_newlines(piece->start, piece->size, &tail);
+    piece->end_pos.index = piece->size;
+    piece->end_pos.line = lines;
+    piece->end_pos.column = tail;
+
+    if (!MYJSON_STACK_INIT(parser, piece->document.allocator, piece->document.nodes, JsonNode)) {
+        return MYJSON_FAILURE;
+    }
+    parser->parents.top = parser->parents.start;
+
+    /* The stand-in of the body is node 1. */
+    node_id = _myjson_parser_load_container(parser, &piece->document, &event, type);
+    if (!node_id || !MYJSON_PUSH(parser, parser->allocator, parser->parents, node_id)) {
+        return MYJSON_FAILURE;
+    }
+
+    /* Start the stream, then go on as if the opening bracket, or a value and its separator, were parsed. */
+    if (!json_parser_parse(parser, &event) || event.type != JSON_STREAM_START_EVENT) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!MYJSON_PUSH(parser, parser->allocator, parser->events, JSON_PARSE_END_EVENT) ||
+        !MYJSON_PUSH(parser, parser->allocator, parser->marks, origin)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (type == JSON_ARRAY) {
+        parser->event = first ? JSON_PARSE_ARRAY_FIRST_ITEM_EVENT : JSON_PARSE_ARRAY_ITEM_EVENT;
+    } else {
+        parser->event = first ? JSON_PARSE_OBJECT_FIRST_KEY_EVENT : JSON_PARSE_OBJECT_KEY_EVENT;
+    }
+
+    while (1) {
+        /* A piece cut at a separator ends between two values of the body. */
+        if (!last && parser->events.top - parser->events.start == 1 &&
+            (parser->event == JSON_PARSE_ARRAY_ITEM_EVENT || parser->event == JSON_PARSE_OBJECT_KEY_EVENT)) {
+            JsonToken *token = MYJSON_PEEK_TOKEN(parser);
+
+            if (!token) {
+                return MYJSON_FAILURE;
+            }
+            if (token->type == JSON_EOF_TOKEN) {
+                break;
+            }
+        }
+
+        if (!json_parser_parse(parser, &event)) {
+            return MYJSON_FAILURE;
+        }
+
+        switch (event.type) {
+            case JSON_SCALAR_EVENT:
+                node_id = _myjson_parser_load_scalar(parser, &piece->document, &event);
+                break;
+            case JSON_ARRAY_START_EVENT:
+                node_id = _myjson_parser_load_container(parser, &piece->document, &event, JSON_ARRAY);
+                break;
+            case JSON_OBJECT_START_EVENT:
+                node_id = _myjson_parser_load_container(parser, &piece->document, &event, JSON_OBJECT);
+                break;
+            case JSON_ARRAY_END_EVENT:
+            case JSON_OBJECT_END_EVENT:
+                node_id = MYJSON_POP(parser, parser->parents);
+                piece->document.nodes.start[node_id - 1].end_pos = event.end_pos;
+
+                /* Only the last piece closes the body, which is packed once it is put together. */
+                if (MYJSON_STACK_EMPTY(parser->parents)) {
+                    if (!last) {
+                        return MYJSON_FAILURE;
+                    }
+                    return MYJSON_SUCCESS;
+                }
+                if (event.type == JSON_ARRAY_END_EVENT && parser->pack_flags &&
+                    !_myjson_parser_load_pack(parser, &piece->document, node_id)) {
+                    return MYJSON_FAILURE;
+                }
+                continue;
+            default:
+                json_event_delete(&event);
+                return MYJSON_FAILURE;
+        }
+
+        if (!node_id || !_myjson_parser_load_append(parser, &piece->document, parser->parents.top[-1], node_id)) {
+            return MYJSON_FAILURE;
+        }
+
+        if (event.type != JSON_SCALAR_EVENT && !MYJSON_PUSH(parser, parser->allocator, parser->parents, node_id)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static MYJSON_INLINE JsonPosition _myjson_position_advance(JsonPosition base, JsonPosition relative) {
+    relative.index += base.index;
+    if (!relative.line) {
+        relative.column += base.column;
+    }
+    relative.line += base.line;
+
+    return relative;
+};
+
+static void _myjson_piece_move(JsonPieceWork *work, JsonPiece *piece) {
+    JsonNode *root = piece->document.nodes.start, *node;
+    JsonNode *target = work->document->nodes.start + piece->node_offset;
+    JsonNode *body = work->document->nodes.start + work->node_id - 1;
+    int shift = (int)piece->node_offset - 1;
+    JsonNodeItem *item, *item_target;
+    JsonNodePair *pair, *pair_target;
+
+    /* Node `k` of the piece becomes node `k + shift`, and its stand-in root the body node. */
+    for (node = root + 1; node != piece->document.nodes.top; node++, target++) {
+        *target = *node;
+        target->start_pos = _myjson_position_advance(piece->base, node->start_pos);
+        target->end_pos = _myjson_position_advance(piece->base, node->end_pos);
+
+        /* Unescape the strings of a mutable input in place, as the serial loader does. */
+        if (work->in_situ && target->type == JSON_STRING) {
+            JsonChar_t *value = piece->start + node->start_pos.index + 1;
+
+            if (!(target->data.scalar.flags & JSON_BORROWED_FLAG)) {
+                memcpy(value, target->data.scalar.value, target->data.scalar.length);
+                target->data.scalar.value = value;
+                target->data.scalar.flags = JSON_BORROWED_FLAG;
+            }
+            value[target->data.scalar.length] = '\0';
+        }
+
+        if (target->type == JSON_ARRAY) {
+            for (item = target->data.array.items.start; item != target->data.array.items.top; item++) {
+                *item += shift;
+            }
+        } else if (target->type == JSON_OBJECT) {
+            for (pair = target->data.object.pairs.start; pair != target->data.object.pairs.top; pair++) {
+                pair->key += shift;
+                pair->value += shift;
+            }
+        }
+    }
+
+    if (root->type == JSON_ARRAY) {
+        item_target = body->data.array.items.start + piece->item_offset;
+        for (item = root->data.array.items.start; item != root->data.array.items.top; item++) {
+            *item_target++ = *item + shift;
+        }
+    } else {
+        pair_target = body->data.object.pairs.start + piece->item_offset;
+        for (pair = root->data.object.pairs.start; pair != root->data.object.pairs.top; pair++, pair_target++) {
+            pair_target->key = pair->key + shift;
+            pair_target->value = pair->value + shift;
+        }
+    }
+
+    /* The document owns the nodes now (and takes the chunks of the piece once all are moved). */
+    MYJSON_STACK_DEL(piece->document.allocator, piece->document.nodes);
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Cursor
+//-----------------------------------------------------------------------------
+
+static int _myjson_cursor_fetch(JsonCursor *cursor, size_t count, JsonChar_t **pointer) {
+    JsonParser *parser = cursor->parser;
+
+    if (!_myjson_parser_fetch_structurals(parser, count)) {
+        return MYJSON_FAILURE;
+    }
+
+    if ((size_t)(parser->structurals.tail - parser->structurals.head) < count) {
+        *pointer = NULL;
+    } else {
+        *pointer = parser->buffer.start + *parser->structurals.head;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_cursor_set_error(JsonCursor *cursor, const char *problem) {
+    JsonParser *parser = cursor->parser;
+    JsonPosition position;
+    size_t tail;
+
+    /* The cursor does not follow the lines: count them up to the error. */
+    if (parser->structurals.head != parser->structurals.tail) {
+        position.index = *parser->structurals.head;
+    } else {
+        position.index = parser->buffer.last - parser->buffer.start;
+    }
+    position.line = parser->kernel->count_newlines(parser->buffer.start, position.index, &tail);
+    position.column = tail;
+
+    return _myjson_parser_set_parser_error(parser, problem, position);
+};
+
+static int _myjson_cursor_skip(JsonCursor *cursor) {
+    JsonParser *parser = cursor->parser;
+    JsonChar_t *pointer;
+    size_t depth = 0, match;
+
+    do {
+        if (!_myjson_cursor_fetch(cursor, 1, &pointer)) {
+            return MYJSON_FAILURE;
+        }
+
+        if (!pointer) {
+            return _myjson_cursor_set_error(cursor, "found unexpected end of stream");
+        }
+
+        switch (*pointer) {
+            case '[':
+            case '{':
+                /* Jump to the closing bracket if it is indexed. */
+                match = parser->structurals.matches[parser->structurals.head - parser->structurals.start];
+                if (match) {
+                    parser->structurals.head += match;
+                } else {
+                    depth++;
+                }
+                break;
+            case ']':
+            case '}':
+                if (!depth) {
+                    return _myjson_cursor_set_error(cursor, "did not find expected value");
+                }
+                depth--;
+                break;
+            case ',':
+            case ':':
+                if (!depth) {
+                    return _myjson_cursor_set_error(cursor, "did not find expected value");
+                }
+                break;
+            case '"':
+                /* Nothing is indexed inside a string: the closing quote is next. */
+                if (!_myjson_cursor_fetch(cursor, 2, &pointer)) {
+                    return MYJSON_FAILURE;
+                }
+                if (!pointer) {
+                    return _myjson_cursor_set_error(cursor, "found unexpected end of stream while scanning a string");
+                }
+                parser->structurals.head++;
+                break;
+            default:
+                break;
+        }
+
+        parser->structurals.head++;
+    } while (depth);
+
+    cursor->state = JSON_CURSOR_AFTER;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_cursor_read_key(JsonCursor *cursor) {
+    JsonParser *parser = cursor->parser;
+    JsonChar_t *pointer, *key;
+    size_t length;
+
+    if (!_myjson_cursor_fetch(cursor, 1, &pointer)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!pointer || *pointer != '"') {
+        return _myjson_cursor_set_error(cursor, "did not find expected key");
+    }
+
+    if (!_myjson_cursor_fetch(cursor, 2, &pointer)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!pointer) {
+        return _myjson_cursor_set_error(cursor, "found unexpected end of stream while scanning a string");
+    }
+
+    key = pointer + 1;
+    length = parser->structurals.head[1] - parser->structurals.head[0] - 1;
+    parser->structurals.head += 2;
+
+    if (!_myjson_cursor_fetch(cursor, 1, &pointer)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!pointer || *pointer != ':') {
+        return _myjson_cursor_set_error(cursor, "did not find expected ':'");
+    }
+
+    parser->structurals.head++;
+
+    if (!_myjson_cursor_read_string(cursor, key, &length, &cursor->key.flags)) {
+        return MYJSON_FAILURE;
+    }
+
+    cursor->key.value = key;
+    cursor->key.length = length;
+    cursor->state = JSON_CURSOR_VALUE;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_cursor_read_string(JsonCursor *cursor, JsonChar_t *string, size_t *length, int *flags) {
+    JsonParser *parser = cursor->parser;
+    JsonChar_t *value = parser->in_situ ? string : NULL;
+    size_t unescaped, offset, tail;
+    const char *problem;
+    JsonPosition position;
+
+    *flags = JSON_BORROWED_FLAG;
+
+    if (parser->kernel->scan_string(string, *length) != *length) {
+        problem = _myjson_unescape(parser->kernel, string, *length, value, &unescaped, &offset);
+
+        if (problem) {
+            position.index = (string - parser->buffer.start) + offset;
+            position.line = parser->kernel->count_newlines(parser->buffer.start, position.index, &tail);
+            position.column = tail;
+            return _myjson_parser_set_scanner_error(parser, problem, position);
+        }
+
+        if (value) {
+            *length = unescaped;
+        } else {
+            *flags |= JSON_ESCAPED_FLAG;
+        }
+    }
+
+    /* The closing quote (or a decoded escape) makes room for the NUL. */
+    if (value) {
+        value[*length] = '\0';
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_cursor_match_key(JsonCursor *cursor, const JsonChar_t *key, size_t length, int *match) {
+    JsonChar_t *decoded;
+    size_t decoded_length;
+
+    if (!(cursor->key.flags & JSON_ESCAPED_FLAG)) {
+        *match = (cursor->key.length == length && !memcmp(cursor->key.value, key, length));
+        return MYJSON_SUCCESS;
+    }
+
+    /* A key with escape sequences is never shorter than its decoded form. */
+    *match = 0;
+    if (cursor->key.length < length) {
+        return MYJSON_SUCCESS;
+    }
+
+    decoded = (JsonChar_t *)_myjson_malloc(cursor->parser->allocator, cursor->key.length);
+    if (!decoded) {
+        return MYJSON_MEMORY_ERROR(cursor->parser);
+    }
+
+    if (json_string_unescape(cursor->key.value, cursor->key.length, decoded, &decoded_length)) {
+        *match = (decoded_length == length && !memcmp(decoded, key, length));
+    }
+
+    _myjson_free(cursor->parser->allocator, decoded, cursor->key.length);
+
+    return MYJSON_SUCCESS;
+};
+
+static size_t _myjson_cursor_scalar(JsonCursor *cursor, JsonChar_t **value) {
+    JsonParser *parser = cursor->parser;
+    JsonChar_t *pointer;
+    size_t length = 0;
+
+    if (cursor->state != JSON_CURSOR_VALUE || !_myjson_cursor_fetch(cursor, 1, &pointer) || !pointer) {
+        return 0;
+    }
+
+    if (*pointer == '"' || *pointer == '[' || *pointer == '{') {
+        return 0;
+    }
+
+    while (pointer + length != parser->buffer.last && _myjson_is_scalar(pointer[length])) {
+        length++;
+    }
+
+    *value = pointer;
+
+    return length;
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Query
+//-----------------------------------------------------------------------------
+
+static int _myjson_query_set_error(JsonQuery *query, const char *problem, size_t offset) {
+    query->error.type = JSON_PARSER_ERROR;
+    query->error.message = problem;
+    query->error_offset = offset;
+
+    return MYJSON_FAILURE;
+};
+
+static int _myjson_query_parse_pointer(JsonQuery *query, const char *expression, JsonChar_t *key, size_t *step) {
+    const char *pointer = expression;
+    size_t length;
+
+    /* The empty pointer is the root value. */
+    while (*pointer == '/') {
+        pointer++;
+        length = 0;
+
+        while (*pointer && *pointer != '/') {
+            if (*pointer != '~') {
+                key[length++] = (JsonChar_t)*pointer++;
+            } else if (pointer[1] == '0' || pointer[1] == '1') {
+                key[length++] = (pointer[1] == '0') ? '~' : '/';
+                pointer += 2;
+            } else {
+                return _myjson_query_set_error(query, "found invalid escape sequence", (size_t)(pointer - expression));
+            }
+        }
+
+        if (!_myjson_query_add_step(query, step, key, length, _myjson_query_index(key, length), 0)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_query_parse_path(JsonQuery *query, const char *expression, JsonChar_t *key, size_t *step) {
+    const char *pointer = expression + 1;
+    const char *start;
+    const JsonChar_t *name;
+    size_t length, index;
+    char quote;
+    int wildcard;
+
+    while (*pointer) {
+        name = NULL;
+        length = 0;
+        index = (size_t)-1;
+        wildcard = 0;
+
+        if (*pointer == '.') {
+            pointer++;
+
+            if (*pointer == '.') {
+                return _myjson_query_set_error(query, "recursive descent is not supported",
+                                               (size_t)(pointer - expression));
+            }
+
+            if (*pointer == '*') {
+                wildcard = 1;
+                pointer++;
+            } else {
+                while (*pointer && *pointer != '.' && *pointer != '[') {
+                    key[length++] = (JsonChar_t)*pointer++;
+                }
+                if (!length) {
+                    return _myjson_query_set_error(query, "did not find expected key", (size_t)(pointer - expression));
+                }
+                name = key;
+            }
+        } else if (*pointer == '[') {
+            pointer++;
+
+            if (*pointer == '*') {
+                wildcard = 1;
+                pointer++;
+            } else if (*pointer == '\'' || *pointer == '"') {
+                quote = *pointer++;
+                while (*pointer != quote) {
+                    if (!*pointer) {
+                        return _myjson_query_set_error(query, "did not find expected closing quote",
+                                                       (size_t)(pointer - expression));
+                    }
+                    if (*pointer == '\\' && pointer[1]) {
+                        pointer++;
+                    }
+                    key[length++] = (JsonChar_t)*pointer++;
+                }
+                pointer++;
+                name = key;
+            } else {
+                start = pointer;
+                while (*pointer >= '0' && *pointer <= '9') {
+                    pointer++;
+                }
+                index = _myjson_query_index((const JsonChar_t *)start, (size_t)(pointer - start));
+                if (index == (size_t)-1) {
+                    return _myjson_query_set_error(query, "did not find expected index, quoted key or '*'",
+                                                   (size_t)(start - expression));
+                }
+            }
+
+            if (*pointer != ']') {
+                return _myjson_query_set_error(query, "did not find expected ']'", (size_t)(pointer - expression));
+            }
+            pointer++;
+        } else {
+            return _myjson_query_set_error(query, "did not find expected '.' or '['", (size_t)(pointer - expression));
+        }
+
+        if (!_myjson_query_add_step(query, step, name, length, index, wildcard)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static size_t _myjson_query_index(const JsonChar_t *key, size_t length) {
+    size_t index = 0, position;
+
+    /* No sign, and no leading zero. */
+    if (!length || (key[0] == '0' && length > 1)) {
+        return (size_t)-1;
+    }
+
+    for (position = 0; position < length; position++) {
+        if (key[position] < '0' || key[position] > '9' || index > ((size_t)-2 - (key[position] - '0')) / 10) {
+            return (size_t)-1;
+        }
+        index = index * 10 + (key[position] - '0');
+    }
+
+    return index;
+};
+
+static int _myjson_query_add_step(JsonQuery *query, size_t *step, const JsonChar_t *key, size_t length, size_t index,
+                                  int wildcard) {
+    JsonQueryStep new_step, *other;
+    size_t child, last = 0;
+
+    for (child = query->steps.start[*step].child; child; child = other->sibling) {
+        other = query->steps.start + child;
+        if (other->wildcard == wildcard && other->index == index && !other->key == !key &&
+            (!key || (other->key_length == length && !memcmp(other->key, key, length)))) {
+            *step = child;
+            return MYJSON_SUCCESS;
+        }
+        last = child;
+    }
+
+    memset(&new_step, 0, sizeof(JsonQueryStep));
+    new_step.index = index;
+    new_step.wildcard = wildcard;
+
+    if (key) {
+        new_step.key = (JsonChar_t *)_myjson_malloc(query->allocator, length + 1);
+        if (!new_step.key) {
+            return MYJSON_MEMORY_ERROR(query);
+        }
+        memcpy(new_step.key, key, length);
+        new_step.key[length] = '\0';
+        new_step.key_length = length;
+    }
+
+    if (!MYJSON_PUSH(query, query->allocator, query->steps, new_step)) {
+        _myjson_free(query->allocator, new_step.key, new_step.key_length + 1);
+        return MYJSON_FAILURE;
+    }
+
+    /* The steps keep the order of the expressions. */
+    child = (size_t)(query->steps.top - query->steps.start) - 1;
+    if (last) {
+        query->steps.start[last].sibling = child;
+    } else {
+        query->steps.start[*step].child = child;
+    }
+
+    *step = child;
+
+    return MYJSON_SUCCESS;
+};
+
+static MYJSON_INLINE int _myjson_query_step_match(const JsonQueryStep *step, const JsonChar_t *key, size_t length,
+                                                 size_t index) {
+    if (step->wildcard) {
+        return 1;
+    }
+
+    if (!key) {
+        return step->index == index;
+    }
+
+    return step->key && step->key_length == length && !memcmp(step->key, key, length);
+};
+
+static int _myjson_query_follow(JsonQueryRun *run, JsonQueryFrame *frame, const JsonChar_t *key, size_t length,
+                                size_t index) {
+    JsonQueryStep *steps = run->query->steps.start;
+    size_t position, child;
+
+    /* Forget the steps reached by the previous value. */
+    run->reached.top = run->reached.start + frame->last;
+
+    for (position = frame->first; position != frame->last; position++) {
+        for (child = steps[run->reached.start[position]].child; child; child = steps[child].sibling) {
+            if (_myjson_query_step_match(steps + child, key, length, index) &&
+                !MYJSON_PUSH(run->parser, run->parser->allocator, run->reached, child)) {
+                return MYJSON_FAILURE;
+            }
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_query_follow_key(JsonQueryRun *run, JsonQueryFrame *frame, JsonEvent *event) {
+    JsonChar_t *key;
+    size_t length;
+    int result;
+
+    if (!(event->data.scalar.flags & JSON_ESCAPED_FLAG)) {
+        return _myjson_query_follow(run, frame, event->data.scalar.value, event->data.scalar.length, 0);
+    }
+
+    /* A borrowed key still holding escape sequences is compared decoded. */
+    key = (JsonChar_t *)_myjson_malloc(run->parser->allocator, event->data.scalar.length + 1);
+    if (!key) {
+        return MYJSON_MEMORY_ERROR(run->parser);
+    }
+
+    if (!json_string_unescape(event->data.scalar.value, event->data.scalar.length, key, &length)) {
+        _myjson_free(run->parser->allocator, key, event->data.scalar.length + 1);
+        return _myjson_parser_set_parser_error(run->parser, "found invalid escape sequence", event->start_pos);
+    }
+
+    result = _myjson_query_follow(run, frame, key, length, 0);
+    _myjson_free(run->parser->allocator, key, event->data.scalar.length + 1);
+
+    return result;
+};
+
+static int _myjson_query_run_value(JsonQueryRun *run, JsonEvent *event) {
+    JsonParser *parser = run->parser;
+    JsonQueryFrame *frame;
+    JsonNode *node;
+    int result;
+
+    /* The loop goes on while a container is entered. */
+    do {
+        frame = MYJSON_STACK_EMPTY(run->frames) ? NULL : run->frames.top - 1;
+
+        switch (event->type) {
+            case JSON_ARRAY_END_EVENT:
+            case JSON_OBJECT_END_EVENT:
+                if (run->document) {
+                    node = run->document->nodes.start + frame->node_id - 1;
+                    node->end_pos = event->end_pos;
+                    if (event->type == JSON_ARRAY_END_EVENT && parser->pack_flags &&
+                        !_myjson_parser_load_pack(parser, run->document, frame->node_id)) {
+                        return MYJSON_FAILURE;
+                    }
+                }
+                run->reached.top = run->reached.start + frame->first;
+                run->frames.top--;
+                continue;
+            case JSON_SCALAR_EVENT:
+                /* A key only reaches steps, for the value following it (and waits for it, in a projection). */
+                if (parser->event == JSON_PARSE_OBJECT_VALUE_EVENT) {
+                    result = _myjson_query_follow_key(run, frame, event);
+                    if (result && run->document) {
+                        run->key = *event;
+                    } else {
+                        json_event_delete(event);
+                    }
+                    if (!result) {
+                        return MYJSON_FAILURE;
+                    }
+                    continue;
+                }
+                break;
+            case JSON_ARRAY_START_EVENT:
+            case JSON_OBJECT_START_EVENT:
+                break;
+            default:
+                /* The parser failed without an error. */
+                MYJSON_ASSERT(parser->error.type);
+                return MYJSON_FAILURE;
+        }
+
+        /* The root value is reached by the root step only. */
+        if (!frame) {
+            run->reached.top = run->reached.start;
+            if (!MYJSON_PUSH(parser, run->parser->allocator, run->reached, 0)) {
+                json_event_delete(event);
+                return MYJSON_FAILURE;
+            }
+        } else if (!frame->object && !_myjson_query_follow(run, frame, NULL, 0, frame->index++)) {
+            json_event_delete(event);
+            return MYJSON_FAILURE;
+        }
+
+        if (!_myjson_query_value(run, event, frame ? frame->last : 0)) {
+            return MYJSON_FAILURE;
+        }
+    } while (!MYJSON_STACK_EMPTY(run->frames) && _myjson_parser_load_event(parser, event));
+
+    return MYJSON_STACK_EMPTY(run->frames);
+};
+
+static int _myjson_query_value(JsonQueryRun *run, JsonEvent *event, size_t first) {
+    JsonQueryStep *steps = run->query->steps.start;
+    JsonQueryFrame frame;
+    size_t *step;
+    int matched = 0, descend = 0, node_id;
+
+    /* A projection keeps at least its root value, not to look like the end of the stream. */
+    int root = run->document && MYJSON_STACK_EMPTY(run->frames);
+
+    for (step = run->reached.start + first; step != run->reached.top; step++) {
+        matched |= (steps[*step].match != 0);
+        descend |= (steps[*step].child != 0);
+    }
+
+    if (matched || (root && event->type == JSON_SCALAR_EVENT)) {
+        return run->document ? _myjson_query_keep(run, event, 1, &node_id)
+                             : _myjson_query_load(run, event, first, descend);
+    }
+
+    if (event->type == JSON_SCALAR_EVENT) {
+        json_event_delete(event);
+        json_event_delete(&run->key);
+        return MYJSON_SUCCESS;
+    }
+
+    /* No expression goes on into the container. */
+    if (!descend && !root) {
+        json_event_delete(&run->key);
+        return json_parser_skip_value(run->parser);
+    }
+
+    frame.first = first;
+    frame.last = (size_t)(run->reached.top - run->reached.start);
+    frame.index = 0;
+    frame.object = (event->type == JSON_OBJECT_START_EVENT);
+    frame.node_id = 0;
+
+    if (run->document && !_myjson_query_keep(run, event, 0, &frame.node_id)) {
+        return MYJSON_FAILURE;
+    }
+
+    return MYJSON_PUSH(run->parser, run->parser->allocator, run->frames, frame);
+};
+
+static int _myjson_query_load(JsonQueryRun *run, JsonEvent *event, size_t first, int descend) {
+    JsonParser *parser = run->parser;
+    JsonDocument document;
+    size_t position;
+    int pack_flags = parser->pack_flags;
+    int result;
+
+    memset(&document, 0, sizeof(JsonDocument));
+    document.allocator = parser->allocator;
+    if (!MYJSON_STACK_INIT(parser, document.allocator, document.nodes, JsonNode)) {
+        json_event_delete(event);
+        return MYJSON_FAILURE;
+    }
+
+    document.start_pos = event->start_pos;
+
+    /* The expressions going on are matched against the nodes, which packing would take away. */
+    if (descend) {
+        parser->pack_flags = 0;
+    }
+
+    result = _myjson_parser_load_value(parser, event, &document);
+    parser->pack_flags = pack_flags;
+
+    if (result) {
+        document.end_pos = document.nodes.start[0].end_pos;
+    }
+
+    for (position = first; result && run->reached.start + position != run->reached.top; position++) {
+        result = _myjson_query_reach(run, &document, run->reached.start[position], 1);
+    }
+
+    json_document_delete(&document);
+
+    return result;
+};
+
+static int _myjson_query_keep(JsonQueryRun *run, JsonEvent *event, int whole, int *node_id) {
+    JsonParser *parser = run->parser;
+    JsonDocument *document = run->document;
+    JsonQueryFrame *parent = MYJSON_STACK_EMPTY(run->frames) ? NULL : run->frames.top - 1;
+    int key_id;
+
+    /* The key node of a member is only added along with its value. */
+    if (run->key.type == JSON_SCALAR_EVENT) {
+        key_id = _myjson_parser_load_scalar(parser, document, &run->key);
+        memset(&run->key, 0, sizeof(JsonEvent));
+        if (!key_id || !_myjson_parser_load_append(parser, document, parent->node_id, key_id)) {
+            json_event_delete(event);
+            return MYJSON_FAILURE;
+        }
+    }
+
+    if (whole) {
+        *node_id = (int)(document->nodes.top - document->nodes.start) + 1;
+        if (!_myjson_parser_load_value(parser, event, document)) {
+            return MYJSON_FAILURE;
+        }
+    } else {
+        *node_id = _myjson_parser_load_container(parser, document, event,
+                                                 (event->type == JSON_ARRAY_START_EVENT) ? JSON_ARRAY : JSON_OBJECT);
+        if (!*node_id) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    return !parent || _myjson_parser_load_append(parser, document, parent->node_id, *node_id);
+};
+
+static int _myjson_query_reach(JsonQueryRun *run, JsonDocument *document, size_t step, int node_id) {
+    JsonQuery *query = run->query;
+    JsonNode *node = document->nodes.start + node_id - 1;
+    JsonNodePair *pair;
+    JsonNode *key;
+    size_t match, child, index;
+
+    for (match = query->steps.start[step].match; match; match = query->matches.start[match - 1].next) {
+        if (!run->handler(run->handler_data, query->matches.start[match - 1].expression, document, node_id)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    for (child = query->steps.start[step].child; child; child = query->steps.start[child].sibling) {
+        if (node->type == JSON_ARRAY) {
+            for (index = 0; node->data.array.items.start + index != node->data.array.items.top; index++) {
+                if (_myjson_query_step_match(query->steps.start + child, NULL, 0, index) &&
+                    !_myjson_query_reach(run, document, child, node->data.array.items.start[index])) {
+                    return MYJSON_FAILURE;
+                }
+            }
+        } else if (node->type == JSON_OBJECT) {
+            for (pair = node->data.object.pairs.start; pair != node->data.object.pairs.top; pair++) {
+                key = document->nodes.start + pair->key - 1;
+                if (_myjson_query_step_match(query->steps.start + child, key->data.scalar.value,
+                                             key->data.scalar.length, 0) &&
+                    !_myjson_query_reach(run, document, child, pair->value)) {
+                    return MYJSON_FAILURE;
+                }
+            }
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+#pragma endregion  // Reader
+
+#endif  // MYJSON_DISABLE_READER
+
+#if !defined(MYJSON_DISABLE_WRITER) || !MYJSON_DISABLE_WRITER
+
+#pragma region Writer
+
+//-----------------------------------------------------------------------------
+// [SECTION] Emitter
+//-----------------------------------------------------------------------------
+
+/*
+ * String write handler.
+ */
+static int _myjson_string_write_handler(void *data, unsigned char *buffer, size_t size) {
+    JsonEmitter *emitter = (JsonEmitter *)data;
+
+    if (emitter->output.string.size - *emitter->output.string.size_written < size) {
+        memcpy(emitter->output.string.buffer + *emitter->output.string.size_written, buffer,
+               emitter->output.string.size - *emitter->output.string.size_written);
+        *emitter->output.string.size_written = emitter->output.string.size;
+        return MYJSON_FAILURE;
+    }
+
+    memcpy(emitter->output.string.buffer + *emitter->output.string.size_written, buffer, size);
+    *emitter->output.string.size_written += size;
+    return MYJSON_SUCCESS;
+};
+
+/*
+ * File write handler.
+ */
+static int _myjson_file_write_handler(void *data, unsigned char *buffer, size_t size) {
+    JsonEmitter *emitter = (JsonEmitter *)data;
+    return (fwrite(buffer, 1, size, emitter->output.file) == size);
+};
+
+static int _myjson_emitter_set_emitter_error(JsonEmitter *emitter, const char *problem) {
+    emitter->error.type = JSON_EMITTER_ERROR;
+    emitter->error.message = problem;
+
+    return MYJSON_FAILURE;
+};
+
+static int _myjson_emitter_set_writer_error(JsonEmitter *emitter, const char *problem) {
+    emitter->error.type = JSON_WRITER_ERROR;
+    emitter->error.message = problem;
+
+    return MYJSON_FAILURE;
+};
+
+static int _myjson_emitter_encode_buffer(JsonEmitter *emitter) {
+    const JsonChar_t *pointer = emitter->buffer.start;
+    const JsonChar_t *last = emitter->buffer.pointer;
+    const JsonChar_t *tail = (last - pointer > 4) ? last - 4 : pointer;
+    int big_endian = (emitter->encoding == JSON_UTF16BE_ENCODING || emitter->encoding == JSON_UTF32BE_ENCODING);
+    size_t width = (emitter->encoding == JSON_UTF16LE_ENCODING || emitter->encoding == JSON_UTF16BE_ENCODING) ? 2 : 4;
+    uint32_t previous = 0;
+    size_t rest;
+
+    /* Keep a character split by a full buffer for the next flush. */
+    for (; tail != last; tail++) {
+        previous = (previous >> 8) | ((uint32_t)*tail << 24);
+    }
+    last -= _myjson_utf8_pending(previous);
+
+    while (pointer != last) {
+        unsigned char *raw = emitter->raw_buffer.start;
+
+        while (pointer != last && emitter->raw_buffer.end - raw >= 4) {
+            size_t count = last - pointer;
+            size_t sequence;
+            unsigned int code;
+
+            /* Write the ASCII characters with the kernel. */
+            if (count > (emitter->raw_buffer.end - raw) / width) {
+                count = (emitter->raw_buffer.end - raw) / width;
+            }
+
+            count = (width == 2) ? emitter->kernel->widen_utf16(pointer, count, big_endian, raw)
+                                 : emitter->kernel->widen_utf32(pointer, count, big_endian, raw);
+            pointer += count;
+            raw += count * width;
+
+            if (pointer == last || emitter->raw_buffer.end - raw < 4) {
+                break;
+            }
+
+            /* Encode the next character. */
+            sequence = _myjson_utf8_sequence_length(pointer, last - pointer);
+            if (!sequence) {
+                return _myjson_emitter_set_writer_error(emitter, "invalid UTF-8 octet sequence");
+            }
+
+            code = _myjson_utf8_decode(pointer, sequence);
+            pointer += sequence;
+
+            if (width == 2 && code >= 0x10000) {
+                code -= 0x10000;
+                _myjson_store_unit(raw, 0xD800 + (code >> 10), 2, big_endian);
+                _myjson_store_unit(raw + 2, 0xDC00 + (code & 0x3FF), 2, big_endian);
+                raw += 4;
+            } else {
+                _myjson_store_unit(raw, code, width, big_endian);
+                raw += width;
+            }
+        }
+
+        if (!emitter->write_handler(emitter->write_handler_data, emitter->raw_buffer.start,
+                                    raw - emitter->raw_buffer.start)) {
+            return _myjson_emitter_set_writer_error(emitter, "write error");
+        }
+    }
+
+    rest = emitter->buffer.pointer - last;
+    memmove(emitter->buffer.start, last, rest);
+    emitter->buffer.pointer = emitter->buffer.start + rest;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_emitter_write(JsonEmitter *emitter, const JsonChar_t *value, size_t length) {
+    emitter->column += (int)length;
+
+    while (length) {
+        size_t size = emitter->buffer.end - emitter->buffer.pointer;
+
+        if (!size) {
+            if (!json_emitter_flush(emitter)) {
+                return MYJSON_FAILURE;
+            }
+            continue;
+        }
+
+        if (size > length) {
+            size = length;
+        }
+
+        memcpy(emitter->buffer.pointer, value, size);
+        emitter->buffer.pointer += size;
+        value += size;
+        length -= size;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_emitter_put(JsonEmitter *emitter, JsonChar_t value) {
+    if (emitter->buffer.pointer == emitter->buffer.end && !json_emitter_flush(emitter)) {
+        return MYJSON_FAILURE;
+    }
+
+    *(emitter->buffer.pointer++) = value;
+    emitter->column++;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_emitter_write_string(JsonEmitter *emitter, const JsonChar_t *value, size_t length, int flags) {
+    static const char hex[] = "0123456789abcdef";
+    const JsonChar_t *pointer = value;
+    const JsonChar_t *end = value + length;
+
+    if (!_myjson_emitter_put(emitter, '"')) {
+        return MYJSON_FAILURE;
+    }
+
+    /* A string still holding its escape sequences is written as it is. */
+    if (flags & JSON_ESCAPED_FLAG) {
+        pointer = end;
+        if (length && !_myjson_emitter_write(emitter, value, length)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    while (pointer != end) {
+        JsonChar_t escape[6] = {'\\', 0, '0', '0', 0, 0};
+        size_t escape_length = 2;
+        size_t run = emitter->kernel->scan_string(pointer, end - pointer);
+
+        /* Copy the characters that need no escaping at once. */
+        if (run && !_myjson_emitter_write(emitter, pointer, run)) {
+            return MYJSON_FAILURE;
+        }
+
+        pointer += run;
+        if (pointer == end) {
+            break;
+        }
+
+        switch (*pointer) {
+            case '"':
+            case '\\':
+                escape[1] = *pointer;
+                break;
+            case '\b':
+                escape[1] = 'b';
+                break;
+            case '\f':
+                escape[1] = 'f';
+                break;
+            case '\n':
+                escape[1] = 'n';
+                break;
+            case '\r':
+                escape[1] = 'r';
+                break;
+            case '\t':
+                escape[1] = 't';
+                break;
+            default:
+                escape[1] = 'u';
+                escape[4] = hex[*pointer >> 4];
+                escape[5] = hex[*pointer & 0x0F];
+                escape_length = 6;
+                break;
+        }
+
+        if (!_myjson_emitter_write(emitter, escape, escape_length)) {
+            return MYJSON_FAILURE;
+        }
+        pointer++;
+    }
+
+    return _myjson_emitter_put(emitter, '"');
+};
+
+static int _myjson_emitter_write_scalar(JsonEmitter *emitter, JsonEvent *event) {
+    if (event->data.scalar.type == JSON_STRING) {
+        return _myjson_emitter_write_string(emitter, event->data.scalar.value, event->data.scalar.length,
+                                           event->data.scalar.flags);
+    }
+
+    if (!event->data.scalar.length) {
+        return _myjson_emitter_set_emitter_error(emitter, "scalar value must not be empty");
+    }
+
+    return _myjson_emitter_write(emitter, event->data.scalar.value, event->data.scalar.length);
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] Emitter States
+//-----------------------------------------------------------------------------
+
+static int _myjson_emitter_state_machine(JsonEmitter *emitter, JsonEvent *event) {
+    switch (emitter->state) {
+        case JSON_EMIT_STREAM_START_EVENT:
+            return _myjson_emitter_emit_stream_start(emitter, event);
+        case JSON_EMIT_DOCUMENT_START_EVENT:
+            return _myjson_emitter_emit_document_start(emitter, event);
+        case JSON_EMIT_DOCUMENT_END_EVENT:
+            return _myjson_emitter_emit_document_end(emitter, event);
+        case JSON_EMIT_VALUE_EVENT:
+            return _myjson_emitter_emit_value(emitter, event);
+        case JSON_EMIT_ARRAY_FIRST_ITEM_EVENT:
+            return _myjson_emitter_emit_array_item(emitter, event, 1);
+        case JSON_EMIT_ARRAY_ITEM_EVENT:
+            return _myjson_emitter_emit_array_item(emitter, event, 0);
+        case JSON_EMIT_OBJECT_FIRST_KEY_EVENT:
+            return _myjson_emitter_emit_object_key(emitter, event, 1);
+        case JSON_EMIT_OBJECT_KEY_EVENT:
+            return _myjson_emitter_emit_object_key(emitter, event, 0);
+        case JSON_EMIT_OBJECT_VALUE_EVENT:
+            return _myjson_emitter_emit_object_value(emitter, event);
+        case JSON_EMIT_END_EVENT:
+            return _myjson_emitter_set_emitter_error(emitter, "expected nothing after STREAM-END");
+        default:
+            MYJSON_ASSERT(0); /* Invalid state. */
+    }
+
+    return MYJSON_FAILURE;
+};
+
+static int _myjson_emitter_emit_stream_start(JsonEmitter *emitter, JsonEvent *event) {
+    if (event->type != JSON_STREAM_START_EVENT) {
+        return _myjson_emitter_set_emitter_error(emitter, "expected STREAM-START");
+    }
+
+    if (!emitter->encoding) {
+        emitter->encoding = event->data.stream_start.encoding;
+    }
+
+    if (!emitter->encoding) {
+        emitter->encoding = JSON_UTF8_ENCODING;
+    }
+
+    /* UTF-16 and UTF-32 output is transcoded through the raw buffer, and starts with a byte order mark. */
+    if (emitter->encoding != JSON_UTF8_ENCODING) {
+        if (!emitter->raw_buffer.start) {
+            emitter->raw_buffer.start =
+                (unsigned char *)_myjson_malloc(emitter->allocator, MYJSON_OUTPUT_RAW_BUFFER_SIZE);
+            if (!emitter->raw_buffer.start) {
+                return MYJSON_MEMORY_ERROR(emitter);
+            }
+        }
+        emitter->raw_buffer.pointer = emitter->raw_buffer.start;
+        emitter->raw_buffer.last = emitter->raw_buffer.start;
+        emitter->raw_buffer.end = emitter->raw_buffer.start + MYJSON_OUTPUT_RAW_BUFFER_SIZE;
+
+        if (!_myjson_emitter_write(emitter, (const JsonChar_t *)"\xEF\xBB\xBF", 3)) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    emitter->line = 0;
+    emitter->column = 0;
+    emitter->state = JSON_EMIT_DOCUMENT_START_EVENT;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_emitter_emit_document_start(JsonEmitter *emitter, JsonEvent *event) {
+    if (event->type == JSON_STREAM_END_EVENT) {
+        if (!json_emitter_flush(emitter)) {
+            return MYJSON_FAILURE;
+        }
+
+        emitter->state = JSON_EMIT_END_EVENT;
+        return MYJSON_SUCCESS;
+    }
+
+    if (event->type != JSON_DOCUMENT_START_EVENT) {
+        return _myjson_emitter_set_emitter_error(emitter, "expected DOCUMENT-START or STREAM-END");
+    }
+
+    /* Documents are separated by a line break. */
+    if (emitter->column) {
+        if (!_myjson_emitter_put(emitter, '\n')) {
+            return MYJSON_FAILURE;
+        }
+        emitter->line++;
+        emitter->column = 0;
+    }
+
+    if (!MYJSON_PUSH(emitter, emitter->allocator, emitter->states, JSON_EMIT_DOCUMENT_END_EVENT)) {
+        return MYJSON_FAILURE;
+    }
+
+    emitter->state = JSON_EMIT_VALUE_EVENT;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_emitter_emit_document_end(JsonEmitter *emitter, JsonEvent *event) {
+    if (event->type != JSON_DOCUMENT_END_EVENT) {
+        return _myjson_emitter_set_emitter_error(emitter, "expected DOCUMENT-END");
+    }
+
+    emitter->state = JSON_EMIT_DOCUMENT_START_EVENT;
+
+    return json_emitter_flush(emitter);
+};
+
+static int _myjson_emitter_emit_value(JsonEmitter *emitter, JsonEvent *event) {
+    switch (event->type) {
+        case JSON_SCALAR_EVENT:
+            if (!_myjson_emitter_write_scalar(emitter, event)) {
+                return MYJSON_FAILURE;
+            }
+            emitter->state = MYJSON_POP(emitter, emitter->states);
+            return MYJSON_SUCCESS;
+
+        case JSON_ARRAY_START_EVENT:
+            emitter->state = JSON_EMIT_ARRAY_FIRST_ITEM_EVENT;
+            return _myjson_emitter_put(emitter, '[');
+
+        case JSON_OBJECT_START_EVENT:
+            emitter->state = JSON_EMIT_OBJECT_FIRST_KEY_EVENT;
+            return _myjson_emitter_put(emitter, '{');
+
+        default:
+            return _myjson_emitter_set_emitter_error(emitter, "expected SCALAR, ARRAY-START, or OBJECT-START");
+    }
+};
+
+static int _myjson_emitter_emit_array_item(JsonEmitter *emitter, JsonEvent *event, int first) {
+    if (event->type == JSON_ARRAY_END_EVENT) {
+        emitter->state = MYJSON_POP(emitter, emitter->states);
+        return _myjson_emitter_put(emitter, ']');
+    }
+
+    if (!first && !_myjson_emitter_put(emitter, ',')) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!MYJSON_PUSH(emitter, emitter->allocator, emitter->states, JSON_EMIT_ARRAY_ITEM_EVENT)) {
+        return MYJSON_FAILURE;
+    }
+
+    return _myjson_emitter_emit_value(emitter, event);
+};
+
+static int _myjson_emitter_emit_object_key(JsonEmitter *emitter, JsonEvent *event, int first) {
+    if (event->type == JSON_OBJECT_END_EVENT) {
+        emitter->state = MYJSON_POP(emitter, emitter->states);
+        return _myjson_emitter_put(emitter, '}');
+    }
+
+    if (event->type != JSON_SCALAR_EVENT) {
+        return _myjson_emitter_set_emitter_error(emitter, "expected a key or OBJECT-END");
+    }
+
+    if (!first && !_myjson_emitter_put(emitter, ',')) {
+        return MYJSON_FAILURE;
+    }
+
+    /* Keys are always written as strings. */
+    if (!_myjson_emitter_write_string(emitter, event->data.scalar.value, event->data.scalar.length,
+                                      event->data.scalar.flags) ||
+        !_myjson_emitter_put(emitter, ':')) {
+        return MYJSON_FAILURE;
+    }
+
+    emitter->state = JSON_EMIT_OBJECT_VALUE_EVENT;
+
+    return MYJSON_SUCCESS;
+};
+
+static int _myjson_emitter_emit_object_value(JsonEmitter *emitter, JsonEvent *event) {
+    if (!MYJSON_PUSH(emitter, emitter->allocator, emitter->states, JSON_EMIT_OBJECT_KEY_EVENT)) {
+        return MYJSON_FAILURE;
+    }
+
+    return _myjson_emitter_emit_value(emitter, event);
+};
+
+#pragma endregion  // Writer
+
+#endif  // MYJSON_DISABLE_WRITER
+
+#pragma endregion  // C Definations
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+//-----------------------------------------------------------------------------
+// [SECTION] C++ Only Classes
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+
+#pragma region Cpp Dec
+
+//-----------------------------------------------------------------------------
+// [SECTION] Declarations
+//-----------------------------------------------------------------------------
+
+#pragma endregion  // Cpp Declarations
+
+#pragma region Cpp Def
+
+//-----------------------------------------------------------------------------
+// [SECTION] Definations
+//-----------------------------------------------------------------------------
+
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
+#pragma region Reader
+
+#pragma endregion  // Reader
+
+#endif  // MYJSON_DISABLE_READER
+
+#if !defined(MYJSON_DISABLE_WRITER) || !MYJSON_DISABLE_WRITER
+
+#pragma region Writer
+
+#pragma endregion  // Writer
+
+#endif  // MYJSON_DISABLE_WRITER
+
+#pragma endregion  // Cpp Definations
+
+#endif  //__cplusplus
+
+#pragma endregion
+
+#pragma region Myjson
+
+#pragma region C
+
+//-----------------------------------------------------------------------------
+// [SECTION] C Only Functions
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#pragma region Allocator
+
+MYJSON_API void json_allocator_set(const JsonAllocator *allocator) {
+    MYJSON_ASSERT(!allocator || (allocator->allocate && allocator->reallocate &&
+                                 allocator->deallocate)); /**< The three allocator functions expected. */
+
+    _myjson_allocator = allocator ? allocator : &_myjson_default_allocator;
+};
+
+MYJSON_API const JsonAllocator *json_allocator_get(void) { return _myjson_allocator; };
+
+#pragma endregion  // Allocator
+
+#pragma region Kernel
+
+MYJSON_API int json_kernel_select(JsonKernelType kernel) {
+    if (kernel != JSON_AUTO_KERNEL && !json_kernel_is_supported(kernel)) {
+        return MYJSON_FAILURE;
+    }
+
+    _myjson_atomic_store(&_myjson_kernel_state, kernel);
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API JsonKernelType json_kernel_get_selected(void) { return _myjson_kernel_resolve()->type; };
+
+MYJSON_API int json_kernel_is_supported(JsonKernelType kernel) {
+    if (!_myjson_kernel_find(kernel)) {
+        return MYJSON_FAILURE;
+    }
+
+#if MYJSON_X86_KERNELS
+    switch (kernel) {
+        case JSON_SSE42_KERNEL:
+            return (_myjson_cpu_features() & MYJSON_CPU_SSE42) != 0;
+        case JSON_AVX2_KERNEL:
+            return (_myjson_cpu_features() & MYJSON_CPU_AVX2) != 0;
+        case JSON_AVX512_KERNEL:
+            return (_myjson_cpu_features() & MYJSON_CPU_AVX512) != 0;
+        default:
+            break;
+    }
+#endif  // MYJSON_X86_KERNELS
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API const char *json_kernel_get_name(JsonKernelType kernel) {
+    switch (kernel) {
+        case JSON_AUTO_KERNEL:
+            return "auto";
+        case JSON_FALLBACK_KERNEL:
+            return "fallback";
+        case JSON_SSE42_KERNEL:
+            return "sse42";
+        case JSON_AVX2_KERNEL:
+            return "avx2";
+        case JSON_AVX512_KERNEL:
+            return "avx512";
+        default:
+            return "unknown";
+    }
+};
+
+#pragma endregion  // Kernel
+
+#pragma region Event
+
+MYJSON_API int json_event_initialize_stream_start(JsonEvent *event, JsonEncoding encoding) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+
+    JsonPosition pos = {0, 0, 0};
+
+    memset(event, 0, sizeof(JsonEvent));
+    event->type = JSON_STREAM_START_EVENT;
+    event->start_pos = pos;
+    event->end_pos = pos;
+    event->data.stream_start.encoding = encoding;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_event_initialize_stream_end(JsonEvent *event) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+
+    JsonPosition pos = {0, 0, 0};
+
+    memset(event, 0, sizeof(JsonEvent));
+    event->type = JSON_STREAM_END_EVENT;
+    event->start_pos = pos;
+    event->end_pos = pos;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_event_initialize_document_start(JsonEvent *event) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+
+    JsonPosition pos = {0, 0, 0};
+
+    memset(event, 0, sizeof(JsonEvent));
+    event->type = JSON_DOCUMENT_START_EVENT;
+    event->start_pos = pos;
+    event->end_pos = pos;
+
+    return MYJSON_SUCCESS;
+};
+MYJSON_API int json_event_initialize_document_end(JsonEvent *event) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+
+    JsonPosition pos = {0, 0, 0};
+
+    memset(event, 0, sizeof(JsonEvent));
+    event->type = JSON_DOCUMENT_END_EVENT;
+    event->start_pos = pos;
+    event->end_pos = pos;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_event_initialize_scalar(JsonEvent *event, const JsonChar_t *value, int length) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+    MYJSON_ASSERT(value); /**< Non-NULL value is expected. */
+
+    JsonPosition pos = {0, 0, 0};
+    JsonChar_t *value_copy;
+
+    if (length < 0) {
+        length = (int)strlen((const char *)value);
+    }
+
+    value_copy = _myjson_string_malloc(_myjson_allocator, length + 1);
+    if (!value_copy) {
+        return MYJSON_FAILURE;
+    }
+    memcpy(value_copy, value, length);
+    value_copy[length] = '\0';
+
+    memset(event, 0, sizeof(JsonEvent));
+    event->type = JSON_SCALAR_EVENT;
+    event->start_pos = pos;
+    event->end_pos = pos;
+    event->data.scalar.value = value_copy;
+    event->data.scalar.length = length;
+    event->data.scalar.type = JSON_STRING;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_event_initialize_array_start(JsonEvent *event) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+
+    JsonPosition pos = {0, 0, 0};
+
+    memset(event, 0, sizeof(JsonEvent));
+    event->type = JSON_ARRAY_START_EVENT;
+    event->start_pos = pos;
+    event->end_pos = pos;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_event_initialize_array_end(JsonEvent *event) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+
+    JsonPosition pos = {0, 0, 0};
+
+    memset(event, 0, sizeof(JsonEvent));
+    event->type = JSON_ARRAY_END_EVENT;
+    event->start_pos = pos;
+    event->end_pos = pos;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_event_initialize_object_start(JsonEvent *event) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+
+    JsonPosition pos = {0, 0, 0};
+
+    memset(event, 0, sizeof(JsonEvent));
+    event->type = JSON_OBJECT_START_EVENT;
+    event->start_pos = pos;
+    event->end_pos = pos;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_event_initialize_object_end(JsonEvent *event) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+
+    JsonPosition pos = {0, 0, 0};
+
+    memset(event, 0, sizeof(JsonEvent));
+    event->type = JSON_OBJECT_END_EVENT;
+    event->start_pos = pos;
+    event->end_pos = pos;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API void json_event_delete(JsonEvent *event) {
+    MYJSON_ASSERT(event); /**< Non-NULL event object expected. */
+    switch (event->type) {
+        case JSON_SCALAR_EVENT:
+            if (!(event->data.scalar.flags & JSON_BORROWED_FLAG)) {
+                _myjson_string_free(event->data.scalar.value);
+            }
+            break;
+
+        case JSON_ARRAY_START_EVENT:
+            break;
+
+        case JSON_OBJECT_START_EVENT:
+            break;
+
+        default:
+            break;
+    }
+
+    memset(event, 0, sizeof(JsonEvent));
+};
+
+MYJSON_API int json_string_unescape(const JsonChar_t *value, size_t length, JsonChar_t *output, size_t *output_length) {
+    size_t problem_offset;
+
+    MYJSON_ASSERT(value || !length); /* Non-NULL value expected. */
+    MYJSON_ASSERT(output);           /* Non-NULL output buffer expected. */
+    MYJSON_ASSERT(output_length);    /* Non-NULL output length expected. */
+
+    return !_myjson_unescape(_myjson_kernel_resolve(), value, length, output, output_length, &problem_offset);
+};
+
+#pragma endregion  // Event
+
+#pragma region Json
+
+MYJSON_API int json_atom_table_initialize(JsonAtomTable *table) {
+    struct {
+        JsonError_t error;
+    } context;
+    size_t size = 2 * MYJSON_INITIAL_STACK_SIZE;
+
+    MYJSON_ASSERT(table); /* Non-NULL atom table object is expected. */
+
+    memset(table, 0, sizeof(JsonAtomTable));
+    table->allocator = _myjson_allocator;
+
+    if (!MYJSON_STACK_INIT(&context, table->allocator, table->atoms, JsonAtom)) {
+        return MYJSON_FAILURE;
+    }
+
+    table->slots.start = (int *)_myjson_malloc(table->allocator, size * sizeof(int));
+    if (!table->slots.start) {
+        MYJSON_STACK_DEL(table->allocator, table->atoms);
+        return MYJSON_FAILURE;
+    }
+    memset(table->slots.start, 0, size * sizeof(int));
+    table->slots.end = table->slots.start + size;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API void json_atom_table_delete(JsonAtomTable *table) {
+    MYJSON_ASSERT(table); /* Non-NULL atom table object is expected. */
+
+    _myjson_arena_free(table->allocator, table->strings.chunks);
+    _myjson_free(table->allocator, table->slots.start,
+                 (size_t)(table->slots.end - table->slots.start) * sizeof(int));
+    MYJSON_STACK_DEL(table->allocator, table->atoms);
+
+    memset(table, 0, sizeof(JsonAtomTable));
+};
+
+MYJSON_API int json_atom_table_intern(JsonAtomTable *table, const JsonChar_t *value, int length) {
+    struct {
+        JsonError_t error;
+    } context;
+    JsonAtom atom;
+    int *slot;
+
+    MYJSON_ASSERT(table);           /* Non-NULL atom table object is expected. */
+    MYJSON_ASSERT(value || !length); /* Non-NULL value is expected. */
+
+    if (length < 0) {
+        length = (int)strlen((const char *)value);
+    }
+
+    atom.length = (size_t)length;
+    atom.hash = _myjson_atom_hash(value, atom.length);
+
+    slot = _myjson_atom_table_slot(table, value, atom.length, atom.hash);
+    if (*slot) {
+        return *slot;
+    }
+
+    /* The index is kept at most half full. */
+    if ((size_t)(table->atoms.top - table->atoms.start + 1) * 2 > (size_t)(table->slots.end - table->slots.start)) {
+        if (!_myjson_atom_table_grow(table)) {
+            return 0;
+        }
+        slot = _myjson_atom_table_slot(table, value, atom.length, atom.hash);
+    }
+
+    atom.value = _myjson_atom_table_store(table, value, atom.length);
+    if (!atom.value || !MYJSON_PUSH(&context, table->allocator, table->atoms, atom)) {
+        return 0;
+    }
+
+    *slot = (int)(table->atoms.top - table->atoms.start);
+
+    return *slot;
+};
+
+MYJSON_API int json_atom_table_find(const JsonAtomTable *table, const JsonChar_t *value, int length) {
+    MYJSON_ASSERT(table);           /* Non-NULL atom table object is expected. */
+    MYJSON_ASSERT(value || !length); /* Non-NULL value is expected. */
+
+    if (length < 0) {
+        length = (int)strlen((const char *)value);
+    }
+
+    return *_myjson_atom_table_slot(table, value, (size_t)length, _myjson_atom_hash(value, (size_t)length));
+};
+
+MYJSON_API const JsonChar_t *json_atom_table_get_string(const JsonAtomTable *table, int atom, size_t *length) {
+    MYJSON_ASSERT(table); /* Non-NULL atom table object is expected. */
+
+    if (atom <= 0 || atom > table->atoms.top - table->atoms.start) {
+        return NULL;
+    }
+
+    if (length) {
+        *length = table->atoms.start[atom - 1].length;
+    }
+
+    return table->atoms.start[atom - 1].value;
+};
+
+MYJSON_API int json_document_initialize(JsonDocument *document) {
+    struct {
+        JsonError_t error;
+    } context;
+
+    MYJSON_ASSERT(document); /* Non-NULL document object is expected. */
+
+    memset(document, 0, sizeof(JsonDocument));
+    document->allocator = _myjson_allocator;
+
+    return MYJSON_STACK_INIT(&context, document->allocator, document->nodes, JsonNode);
+};
+
+MYJSON_API int json_document_set_allocator(JsonDocument *document, const JsonAllocator *allocator) {
+    struct {
+        JsonError_t error;
+    } context;
+
+    MYJSON_ASSERT(document);                                         /* Non-NULL document object is expected. */
+    MYJSON_ASSERT(document->nodes.start == document->nodes.top);     /* A document without nodes is expected. */
+    MYJSON_ASSERT(!document->arena.chunks && !document->arena.spare); /* A document without an arena is expected. */
+
+    /* The stack allocated by json_document_initialize goes back to the old allocator. */
+    MYJSON_STACK_DEL(document->allocator, document->nodes);
+
+    document->allocator = allocator ? allocator : _myjson_allocator;
+
+    return MYJSON_STACK_INIT(&context, document->allocator, document->nodes, JsonNode);
+};
+
+MYJSON_API void json_document_delete(JsonDocument *document) {
+    MYJSON_ASSERT(document); /* Non-NULL document object is expected. */
+
+    /* The nodes own nothing outside the arena. */
+    _myjson_arena_free(document->allocator, document->arena.chunks);
+    _myjson_arena_free(document->allocator, document->arena.spare);
+    MYJSON_STACK_DEL(document->allocator, document->nodes);
+
+    memset(document, 0, sizeof(JsonDocument));
+};
+
+MYJSON_API void json_document_reset(JsonDocument *document) {
+    JsonArenaChunk *chunk;
+
+    MYJSON_ASSERT(document);              /* Non-NULL document object is expected. */
+    MYJSON_ASSERT(document->nodes.start); /* An initialized document is expected. */
+
+    chunk = document->arena.chunks;
+
+    /* The newest chunk is allocated from again, and the older ones are kept aside. */
+    if (chunk) {
+        if (chunk->next) {
+            JsonArenaChunk *last = chunk->next;
+
+            while (last->next) {
+                last = last->next;
+            }
+            last->next = document->arena.spare;
+            document->arena.spare = chunk->next;
+            chunk->next = NULL;
+        }
+
+        document->arena.pointer = (JsonChar_t *)(chunk + 1);
+        document->arena.end = document->arena.pointer + chunk->size;
+    }
+
+    document->nodes.top = document->nodes.start;
+    document->keys.start = document->keys.end = NULL;
+    memset(&document->start_pos, 0, sizeof(JsonPosition));
+    memset(&document->end_pos, 0, sizeof(JsonPosition));
+};
+
+MYJSON_API void json_document_set_atom_table(JsonDocument *document, JsonAtomTable *table) {
+    MYJSON_ASSERT(document);                                     /* Non-NULL document object is expected. */
+    MYJSON_ASSERT(document->nodes.start == document->nodes.top); /* A document without nodes is expected. */
+
+    document->atoms = table;
+    document->keys.start = document->keys.end = NULL;
+};
+
+MYJSON_API JsonNode *json_document_get_root_node(JsonDocument *document) {
+    MYJSON_ASSERT(document); /* Non-NULL document object is expected. */
+
+    if (document->nodes.top != document->nodes.start) {
+        return document->nodes.start;
+    }
+
+    return NULL;
+};
+
+MYJSON_API JsonNode *json_document_get_node(JsonDocument *document, int index) {
+    MYJSON_ASSERT(document); /* Non-NULL document object is expected. */
+
+    if (index > 0 && document->nodes.start + index <= document->nodes.top) {
+        return document->nodes.start + index - 1;
+    }
+
+    return NULL;
+};
+
+MYJSON_API int json_document_add_scalar(JsonDocument *document, const JsonChar_t *value, int length) {
+    struct {
+        JsonError_t error;
+    } context;
+    JsonNode node;
+    JsonChar_t *value_copy;
+
+    MYJSON_ASSERT(document); /* Non-NULL document object is expected. */
+    MYJSON_ASSERT(value);    /* Non-NULL value is expected. */
+
+    if (length < 0) {
+        length = (int)strlen((const char *)value);
+    }
+
+    value_copy = (JsonChar_t *)_myjson_arena_alloc(document, length + 1, 1);
+    if (!value_copy) {
+        return 0;
+    }
+    memcpy(value_copy, value, length);
+    value_copy[length] = '\0';
+
+    memset(&node, 0, sizeof(JsonNode));
+    node.type = JSON_STRING;
+    node.data.scalar.value = value_copy;
+    node.data.scalar.length = length;
+
+    if (!MYJSON_PUSH(&context, document->allocator, document->nodes, node)) {
+        return 0;
+    }
+
+    return (int)(document->nodes.top - document->nodes.start);
+};
+
+MYJSON_API int json_document_add_array(JsonDocument *document) {
+    struct {
+        JsonError_t error;
+    } context;
+    JsonNode node;
+
+    MYJSON_ASSERT(document); /* Non-NULL document object is expected. */
+
+    memset(&node, 0, sizeof(JsonNode));
+    node.type = JSON_ARRAY;
+
+    if (!MYJSON_ARENA_STACK_INIT(&context, document, node.data.array.items, JsonNodeItem)) {
+        return 0;
+    }
+
+    if (!MYJSON_PUSH(&context, document->allocator, document->nodes, node)) {
+        return 0;
+    }
+
+    return (int)(document->nodes.top - document->nodes.start);
+};
+
+MYJSON_API int json_document_add_object(JsonDocument *document) {
+    struct {
+        JsonError_t error;
+    } context;
+    JsonNode node;
+
+    MYJSON_ASSERT(document); /* Non-NULL document object is expected. */
+
+    memset(&node, 0, sizeof(JsonNode));
+    node.type = JSON_OBJECT;
+
+    if (!MYJSON_ARENA_STACK_INIT(&context, document, node.data.object.pairs, JsonNodePair)) {
+        return 0;
+    }
+
+    if (!MYJSON_PUSH(&context, document->allocator, document->nodes, node)) {
+        return 0;
+    }
+
+    return (int)(document->nodes.top - document->nodes.start);
+};
+
+MYJSON_API int json_document_append_array_item(JsonDocument *document, int array, int item) {
+    struct {
+        JsonError_t error;
+    } context;
+    JsonNode *node = json_document_get_node(document, array);
+
+    MYJSON_ASSERT(node && node->type == JSON_ARRAY);       /* Valid array id is required. */
+    MYJSON_ASSERT(json_document_get_node(document, item)); /* Valid item id is required. */
+
+    return MYJSON_ARENA_PUSH(&context, document, node->data.array.items, item);
+};
+
+MYJSON_API int json_document_append_object_pair(JsonDocument *document, int object, int key, int value) {
+    struct {
+        JsonError_t error;
+    } context;
+    JsonNode *node = json_document_get_node(document, object);
+    JsonNodePair pair;
+
+    MYJSON_ASSERT(node && node->type == JSON_OBJECT); /* Valid object id is required. */
+    MYJSON_ASSERT(json_document_get_node(document, key) &&
+                  json_document_get_node(document, key)->type == JSON_STRING); /* Valid key id is required. */
+    MYJSON_ASSERT(json_document_get_node(document, value)); /* Valid value id is required. */
+
+    /* With an atom table, the first key node of a key stands for all of them. */
+    if (document->atoms) {
+        JsonNode *name = json_document_get_node(document, key);
+        int atom = json_atom_table_intern(document->atoms, name->data.scalar.value, (int)name->data.scalar.length);
+        int *key_node = atom ? _myjson_document_key_node(document, atom) : NULL;
+
+        if (!key_node) {
+            return MYJSON_MEMORY_ERROR(&context);
+        }
+
+        if (!*key_node) {
+            *key_node = key;
+        }
+        key = *key_node;
+    }
+
+    pair.key = key;
+    pair.value = value;
+
+    return MYJSON_ARENA_PUSH(&context, document, node->data.object.pairs, pair);
+};
+
+MYJSON_API const JsonChar_t *json_document_get_scalar_value(JsonDocument *document, int node_id) {
+    JsonNode *node = json_document_get_node(document, node_id);
+
+    if (!node || node->type == JSON_ARRAY || node->type == JSON_OBJECT || node->type == JSON_PACKED_ARRAY) {
+        return NULL;
+    }
+
+    return node->data.scalar.value;
+};
+
+MYJSON_API int json_document_get_scalar_length(JsonDocument *document, int node_id) {
+    JsonNode *node = json_document_get_node(document, node_id);
+
+    if (!node || node->type == JSON_ARRAY || node->type == JSON_OBJECT || node->type == JSON_PACKED_ARRAY) {
+        return -1;
+    }
+
+    return (int)node->data.scalar.length;
+};
+
+MYJSON_API int json_document_array_get_item(JsonDocument *document, int array_node_id, int index) {
+    JsonNode *node = json_document_get_node(document, array_node_id);
+
+    if (!node || node->type != JSON_ARRAY || index < 0 ||
+        index >= node->data.array.items.top - node->data.array.items.start) {
+        return 0;
+    }
+
+    return node->data.array.items.start[index];
+};
+
+MYJSON_API int json_document_object_get_value(JsonDocument *document, int object_node_id, const JsonChar_t *key,
+                                              int key_length) {
+    JsonNode *node = json_document_get_node(document, object_node_id);
+    JsonNodePair *pair;
+
+    MYJSON_ASSERT(key); /* Non-NULL key is expected. */
+
+    if (!node || node->type != JSON_OBJECT) {
+        return 0;
+    }
+
+    /* The keys of a document with an atom table are compared by their node id. */
+    if (document->atoms) {
+        return json_document_object_get_value_by_atom(document, object_node_id,
+                                                      json_atom_table_find(document->atoms, key, key_length));
+    }
+
+    if (key_length < 0) {
+        key_length = (int)strlen((const char *)key);
+    }
+
+    for (pair = node->data.object.pairs.start; pair != node->data.object.pairs.top; pair++) {
+        JsonNode *name = document->nodes.start + pair->key - 1;
+
+        if (name->data.scalar.length == (size_t)key_length && !memcmp(name->data.scalar.value, key, key_length)) {
+            return pair->value;
+        }
+    }
+
+    return 0;
+};
+
+MYJSON_API int json_document_object_get_value_by_atom(JsonDocument *document, int object_node_id, int atom) {
+    JsonNode *node = json_document_get_node(document, object_node_id);
+    JsonNodePair *pair;
+    int key;
+
+    MYJSON_ASSERT(document->atoms); /* A document with an atom table is expected. */
+
+    /* An atom the document never used is no key of it. */
+    if (!node || node->type != JSON_OBJECT || atom <= 0 || atom > document->keys.end - document->keys.start) {
+        return 0;
+    }
+
+    key = document->keys.start[atom - 1];
+    if (!key) {
+        return 0;
+    }
+
+    for (pair = node->data.object.pairs.start; pair != node->data.object.pairs.top; pair++) {
+        if (pair->key == key) {
+            return pair->value;
+        }
+    }
+
+    return 0;
+};
+
+MYJSON_API int json_document_get_node_by_path(JsonDocument *document, const JsonChar_t **keys, int key_count) {
+    int node_id = json_document_get_root_node(document) ? 1 : 0;
+    int index;
+
+    for (index = 0; index < key_count && node_id; index++) {
+        node_id = json_document_object_get_value(document, node_id, keys[index], -1);
+    }
+
+    return node_id;
+};
+
+MYJSON_API const JsonChar_t *json_document_get_value_by_path(JsonDocument *document, const JsonChar_t **keys,
+                                                             int key_count) {
+    return json_document_get_scalar_value(document, json_document_get_node_by_path(document, keys, key_count));
+};
+
+MYJSON_API int json_document_get_value_length_by_path(JsonDocument *document, const JsonChar_t **keys, int key_count) {
+    return json_document_get_scalar_length(document, json_document_get_node_by_path(document, keys, key_count));
+};
+
+MYJSON_API const void *json_document_get_packed_array(JsonDocument *document, int node_id, JsonPackedType *type,
+                                                      size_t *length) {
+    JsonNode *node = json_document_get_node(document, node_id);
+
+    if (!node || node->type != JSON_PACKED_ARRAY) {
+        return NULL;
+    }
+
+    if (type) {
+        *type = node->data.packed.type;
+    }
+    if (length) {
+        *length = node->data.packed.length;
+    }
+
+    return node->data.packed.values;
+};
+
+MYJSON_API void json_tape_delete(JsonTape *tape) {
+    MYJSON_ASSERT(tape); /**< Non-NULL tape object expected. */
+
+    MYJSON_STACK_DEL(tape->allocator, tape->words);
+    MYJSON_STACK_DEL(tape->allocator, tape->strings);
+};
+
+MYJSON_API JsonTapeType json_tape_get_type(const JsonTape *tape, size_t index) {
+    MYJSON_ASSERT(tape);                                                    /**< Non-NULL tape object expected. */
+    MYJSON_ASSERT(index < (size_t)(tape->words.top - tape->words.start)); /**< The index must be on the tape. */
+
+    return MYJSON_TAPE_TYPE(tape->words.start[index]);
+};
+
+MYJSON_API size_t json_tape_next(const JsonTape *tape, size_t index) {
+    uint64_t word;
+
+    MYJSON_ASSERT(tape);                                                    /**< Non-NULL tape object expected. */
+    MYJSON_ASSERT(index < (size_t)(tape->words.top - tape->words.start)); /**< The index must be on the tape. */
+
+    word = tape->words.start[index];
+
+    switch (MYJSON_TAPE_TYPE(word)) {
+        case JSON_TAPE_ARRAY:
+        case JSON_TAPE_OBJECT:
+            return MYJSON_TAPE_PAYLOAD(word) + 1;
+        case JSON_TAPE_INT64:
+        case JSON_TAPE_UINT64:
+        case JSON_TAPE_DOUBLE:
+            return index + 2;
+        default:
+            return index + 1;
+    }
+};
+
+MYJSON_API size_t json_tape_find_field(const JsonTape *tape, size_t index, const JsonChar_t *key, size_t key_length) {
+    const JsonChar_t *member;
+    size_t end, length;
+
+    MYJSON_ASSERT(tape);                                                       /**< Non-NULL tape object expected. */
+    MYJSON_ASSERT(key);                                                        /**< Non-NULL key expected. */
+    MYJSON_ASSERT(json_tape_get_type(tape, index) == JSON_TAPE_OBJECT); /**< An object is expected. */
+
+    end = MYJSON_TAPE_PAYLOAD(tape->words.start[index]);
+
+    for (index++; index != end; index = json_tape_next(tape, index + 1)) {
+        member = json_tape_get_string(tape, index, &length);
+        if (length == key_length && !memcmp(member, key, length)) {
+            return index + 1;
+        }
+    }
+
+    return 0;
+};
+
+MYJSON_API const JsonChar_t *json_tape_get_string(const JsonTape *tape, size_t index, size_t *length) {
+    const JsonChar_t *string;
+    uint64_t string_length;
+
+    MYJSON_ASSERT(json_tape_get_type(tape, index) == JSON_TAPE_STRING); /**< A string is expected. */
+
+    string = tape->strings.start + MYJSON_TAPE_PAYLOAD(tape->words.start[index]);
+    memcpy(&string_length, string, sizeof(uint64_t));
+
+    if (length) {
+        *length = (size_t)string_length;
+    }
+
+    return string + sizeof(uint64_t);
+};
+
+MYJSON_API int64_t json_tape_get_int64(const JsonTape *tape, size_t index) {
+    MYJSON_ASSERT(json_tape_get_type(tape, index) == JSON_TAPE_INT64 ||
+                  json_tape_get_type(tape, index) == JSON_TAPE_UINT64); /**< An integer is expected. */
+
+    return (int64_t)tape->words.start[index + 1];
+};
+
+MYJSON_API double json_tape_get_double(const JsonTape *tape, size_t index) {
+    uint64_t word;
+    double value;
+
+    MYJSON_ASSERT(tape); /**< Non-NULL tape object expected. */
+
+    switch (json_tape_get_type(tape, index)) {
+        case JSON_TAPE_INT64:
+            return (double)(int64_t)tape->words.start[index + 1];
+        case JSON_TAPE_UINT64:
+            return (double)tape->words.start[index + 1];
+        default:
+            MYJSON_ASSERT(json_tape_get_type(tape, index) == JSON_TAPE_DOUBLE); /**< A number is expected. */
+            word = tape->words.start[index + 1];
+            memcpy(&value, &word, sizeof(double));
+            return value;
+    }
+};
+
+#pragma endregion  // Json
+
+#if !defined(MYJSON_DISABLE_ENCODING) || !MYJSON_DISABLE_ENCODING
+
+#pragma region Encoding
+
+MYJSON_API size_t json_validate_utf8(const unsigned char *buffer, size_t length) {
+    MYJSON_ASSERT(buffer || !length); /* Non-NULL buffer expected. */
+
+    return _myjson_kernel_resolve()->validate_utf8(buffer, length);
+};
+
+#pragma endregion  // Encoding
+
+#endif  // MYJSON_DISABLE_ENCODING
+
+#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+
+#pragma region Reader
+
+MYJSON_API int json_parser_initialize(JsonParser *parser) {
+    MYJSON_ASSERT(parser); /**< Non-NULL parser object expected. */
+
+    memset(parser, 0, sizeof(JsonParser));
+    parser->allocator = _myjson_allocator;
+
+    /* The buffers and the structural index are allocated for the input once it is known. */
+    if (!MYJSON_QUEUE_INIT(parser, parser->allocator, parser->tokens, JsonToken, MYJSON_TOKEN_QUEUE_SIZE)) {
+        goto error;
+    }
+    if (!MYJSON_STACK_INIT(parser, parser->allocator, parser->events, JsonParseEvent)) {
+        goto error;
+    }
+    if (!MYJSON_STACK_INIT(parser, parser->allocator, parser->marks, JsonPosition)) {
+        goto error;
+    }
+    if (!MYJSON_STACK_INIT(parser, parser->allocator, parser->parents, int)) {
+        goto error;
+    }
+
+    parser->event = JSON_PARSE_STREAM_START_EVENT;
+    parser->kernel = _myjson_kernel_resolve();
+    parser->thread_count = 1;
+
+    return MYJSON_SUCCESS;
+
+error:
+
+    MYJSON_QUEUE_DEL(parser->allocator, parser->tokens);
+    MYJSON_STACK_DEL(parser->allocator, parser->events);
+    MYJSON_STACK_DEL(parser->allocator, parser->marks);
+    MYJSON_STACK_DEL(parser->allocator, parser->parents);
+
+    return MYJSON_FAILURE;
+};
+
+MYJSON_API int json_parser_parse(JsonParser *parser, JsonEvent *event) {
+    MYJSON_ASSERT(parser); /**< Non-NULL parser object is expected. */
+    MYJSON_ASSERT(event);  /**< Non-NULL event object is expected. */
+
+    /* Erase the event object. */
+    memset(event, 0, sizeof(JsonEvent));
+
+    /* Carry on after a malformed line. */
+    if ((parser->stream_flags & JSON_RESYNC_FLAG) &&
+        (parser->error.type == JSON_SCANNER_ERROR || parser->error.type == JSON_PARSER_ERROR)) {
+        _myjson_parser_resync(parser);
+    }
+
+    /* No events after the end of the stream or error. */
+    if (parser->stream_end_produced || parser->error.type || parser->event == JSON_PARSE_END_EVENT) {
+        return MYJSON_SUCCESS;
+    }
+
+    /* Skip the rest of a malformed line before any token of the next document is fetched. */
+    if (parser->event == JSON_PARSE_SKIP_LINE_EVENT) {
+        if (!_myjson_parser_skip_line(parser)) {
+            return (parser->waiting && !parser->error.type) ? MYJSON_NEED_MORE_INPUT : MYJSON_FAILURE;
+        }
+        parser->event = JSON_PARSE_DOCUMENT_START_EVENT;
+    }
+
+    /* A push parser fetches the tokens a state looks at before the state changes anything,
+       so that it can wait for the next chunk between any two states. */
+    if (parser->push && parser->event != JSON_PARSE_STREAM_START_EVENT && !_myjson_parser_fetch_lookahead(parser)) {
+        return (parser->waiting && !parser->error.type) ? MYJSON_NEED_MORE_INPUT : MYJSON_FAILURE;
+    }
+
+    /* Generate the next event. */
+    if (!_myjson_parser_state_machine(parser, event)) {
+        return (parser->waiting && !parser->error.type) ? MYJSON_NEED_MORE_INPUT : MYJSON_FAILURE;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_parse_batch(JsonParser *parser, JsonEvent *events, size_t capacity, size_t *count) {
+    JsonEvent *event;
+    int result;
+
+    MYJSON_ASSERT(parser); /**< Non-NULL parser object is expected. */
+    MYJSON_ASSERT(events); /**< Non-NULL events array is expected. */
+    MYJSON_ASSERT(count);  /**< Non-NULL count is expected. */
+
+    for (*count = 0; *count < capacity; (*count)++) {
+        event = events + *count;
+
+        /* Only the plain case runs the state machine directly; the others go through all the checks. */
+        if (parser->push || parser->error.type || parser->stream_end_produced ||
+            parser->event == JSON_PARSE_SKIP_LINE_EVENT || parser->event == JSON_PARSE_END_EVENT) {
+            result = json_parser_parse(parser, event);
+            if (result != MYJSON_SUCCESS) {
+                return result;
+            }
+        } else {
+            memset(event, 0, sizeof(JsonEvent));
+            if (!_myjson_parser_state_machine(parser, event)) {
+                return MYJSON_FAILURE;
+            }
+        }
+
+        if (event->type == JSON_NO_EVENT) {
+            break;
+        }
+
+        if (event->type == JSON_STREAM_END_EVENT) {
+            (*count)++;
+            break;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_scan_batch(JsonParser *parser, JsonToken *tokens, size_t capacity, size_t *count) {
+    MYJSON_ASSERT(parser); /**< Non-NULL parser object is expected. */
+    MYJSON_ASSERT(tokens); /**< Non-NULL tokens array is expected. */
+    MYJSON_ASSERT(count);  /**< Non-NULL count is expected. */
+
+    *count = 0;
+
+    if (parser->error.type) {
+        return MYJSON_FAILURE;
+    }
+
+    /* Determine the input encoding. */
+    if (!parser->stream_start_produced) {
+        if (!_myjson_parser_update_buffer(parser, 1)) {
+            return (parser->waiting && !parser->error.type) ? MYJSON_NEED_MORE_INPUT : MYJSON_FAILURE;
+        }
+        parser->stream_start_produced = 1;
+    }
+
+    /* The tokens are moved out of the ring one by one, as they are scanned. */
+    while (*count < capacity && !parser->stream_end_produced) {
+        if (MYJSON_QUEUE_EMPTY(parser->tokens) && !_myjson_parser_fetch_next_token(parser)) {
+            return (parser->waiting && !parser->error.type) ? MYJSON_NEED_MORE_INPUT : MYJSON_FAILURE;
+        }
+
+        tokens[*count] = MYJSON_DEQUEUE(parser, parser->tokens);
+        parser->tokens_parsed++;
+        parser->token_line = tokens[*count].end_pos.line;
+        parser->stream_end_produced = (tokens[*count].type == JSON_EOF_TOKEN);
+        (*count)++;
+    }
+
+    parser->token_available = 0;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API void json_token_delete(JsonToken *token) {
+    MYJSON_ASSERT(token); /**< Non-NULL token object expected. */
+
+    _myjson_token_delete(token);
+};
+
+MYJSON_API int json_parser_skip_value(JsonParser *parser) {
+    JsonChar_t close;
+
+    MYJSON_ASSERT(parser);        /**< Non-NULL parser object is expected. */
+    MYJSON_ASSERT(!parser->push); /**< A push parser cannot skip ahead of its chunks. */
+
+    if (parser->error.type) {
+        return MYJSON_FAILURE;
+    }
+
+    switch (parser->event) {
+        case JSON_PARSE_ARRAY_FIRST_ITEM_EVENT:
+        case JSON_PARSE_ARRAY_ITEM_EVENT:
+            close = ']';
+            break;
+        case JSON_PARSE_OBJECT_FIRST_KEY_EVENT:
+        case JSON_PARSE_OBJECT_KEY_EVENT:
+        case JSON_PARSE_OBJECT_VALUE_EVENT:
+            close = '}';
+            break;
+        default:
+            MYJSON_ASSERT(0); /**< The parser must be inside an array or an object. */
+            return MYJSON_FAILURE;
+    }
+
+    if (!_myjson_parser_skip_container(parser, close)) {
+        return MYJSON_FAILURE;
+    }
+
+    /* Go on as after the ARRAY-END or OBJECT-END event. */
+    parser->event = MYJSON_POP(parser, parser->events);
+    (void)MYJSON_POP(parser, parser->marks);
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_load(JsonParser *parser, JsonDocument *document) {
+    MYJSON_ASSERT(parser);   /**< Non-NULL parser object is expected. */
+    MYJSON_ASSERT(document); /**< Non-NULL document object is expected. */
+
+    memset(document, 0, sizeof(JsonDocument));
+    document->allocator = parser->allocator;
+    if (!MYJSON_STACK_INIT(parser, document->allocator, document->nodes, JsonNode)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!_myjson_parser_load_next(parser, document)) {
+        json_document_delete(document);
+        return MYJSON_FAILURE;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_reload(JsonParser *parser, JsonDocument *document) {
+    MYJSON_ASSERT(parser);   /**< Non-NULL parser object is expected. */
+    MYJSON_ASSERT(document); /**< Non-NULL document object is expected. */
+
+    /* A deleted document starts over. */
+    if (!document->nodes.start) {
+        document->allocator = parser->allocator;
+        if (!MYJSON_STACK_INIT(parser, document->allocator, document->nodes, JsonNode)) {
+            return MYJSON_FAILURE;
+        }
+    } else {
+        json_document_reset(document);
+    }
+
+    if (!_myjson_parser_load_next(parser, document)) {
+        json_document_reset(document);
+        return MYJSON_FAILURE;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_load_tape(JsonParser *parser, JsonTape *tape) {
+    struct {
+        size_t *start; /** The beginning of the stack. */
+        size_t *end;   /** The end of the stack. */
+        size_t *top;   /** The top of the stack. */
+    } opens = {NULL, NULL, NULL};
+    JsonEvent event;
+    size_t open, index;
+
+    MYJSON_ASSERT(parser); /**< Non-NULL parser object is expected. */
+    MYJSON_ASSERT(tape);   /**< Non-NULL tape object is expected. */
+
+    memset(tape, 0, sizeof(JsonTape));
+    tape->allocator = parser->allocator;
+    if (!MYJSON_STACK_INIT(parser, tape->allocator, tape->words, uint64_t) ||
+        !MYJSON_STACK_INIT(parser, tape->allocator, tape->strings, JsonChar_t) ||
+        !MYJSON_STACK_INIT(parser, parser->allocator, opens, size_t)) {
+        goto error;
+    }
+
+    /* Skip the STREAM-START event. */
+    if (parser->event == JSON_PARSE_STREAM_START_EVENT) {
+        if (!_myjson_parser_load_event(parser, &event)) {
+            goto error;
+        }
+    }
+
+    if (!_myjson_parser_load_event(parser, &event)) {
+        goto error;
+    }
+
+    /* The tape is left empty at the end of the stream. */
+    if (event.type != JSON_DOCUMENT_START_EVENT) {
+        MYJSON_STACK_DEL(parser->allocator, opens);
+        return MYJSON_SUCCESS;
+    }
+
+    while (1) {
+        if (!_myjson_parser_load_event(parser, &event)) {
+            goto error;
+        }
+
+        index = (size_t)(tape->words.top - tape->words.start);
+
+        switch (event.type) {
+            case JSON_SCALAR_EVENT:
+                if (!_myjson_parser_load_tape_scalar(parser, tape, &event)) {
+                    goto error;
+                }
+                break;
+            case JSON_ARRAY_START_EVENT:
+            case JSON_OBJECT_START_EVENT:
+                /* The index of the end is filled in at the end. */
+                if (!MYJSON_PUSH(parser, parser->allocator, opens, index) ||
+                    !MYJSON_PUSH(parser, tape->allocator, tape->words,
+                                 MYJSON_TAPE_WORD((event.type == JSON_ARRAY_START_EVENT) ? JSON_TAPE_ARRAY
+                                                                                         : JSON_TAPE_OBJECT,
+                                                  0))) {
+                    goto error;
+                }
+                break;
+            case JSON_ARRAY_END_EVENT:
+            case JSON_OBJECT_END_EVENT:
+                open = MYJSON_POP(parser, opens);
+                tape->words.start[open] |= (uint64_t)index;
+                if (!MYJSON_PUSH(parser, tape->allocator, tape->words,
+                                 MYJSON_TAPE_WORD((event.type == JSON_ARRAY_END_EVENT) ? JSON_TAPE_ARRAY_END
+                                                                                       : JSON_TAPE_OBJECT_END,
+                                                  open))) {
+                    goto error;
+                }
+                break;
+            case JSON_DOCUMENT_END_EVENT:
+                MYJSON_STACK_DEL(parser->allocator, opens);
+                return MYJSON_SUCCESS;
+            default:
+                /* The parser failed without an error. */
+                MYJSON_ASSERT(parser->error.type);
+                goto error;
+        }
+    }
+
+error:
+    MYJSON_STACK_DEL(parser->allocator, opens);
+    json_tape_delete(tape);
+    return MYJSON_FAILURE;
+};
+
+MYJSON_API int json_parser_delete(JsonParser *parser) {
+    MYJSON_ASSERT(parser); /**< Non-NULL parser object expected. */
+
+    while (!MYJSON_QUEUE_EMPTY(parser->tokens)) {
+        _myjson_token_delete(&MYJSON_DEQUEUE(parser, parser->tokens));
+    }
+
+    _myjson_free(parser->allocator, parser->raw_buffer.start, parser->raw_buffer.end - parser->raw_buffer.start);
+    if (!parser->in_place) {
+        _myjson_free(parser->allocator, parser->buffer.start, parser->buffer.end - parser->buffer.start);
+    }
+    _myjson_parser_delete_index(parser);
+    _myjson_parser_unmap_file(parser);
+    MYJSON_QUEUE_DEL(parser->allocator, parser->tokens);
+    MYJSON_STACK_DEL(parser->allocator, parser->events);
+    MYJSON_STACK_DEL(parser->allocator, parser->marks);
+    MYJSON_STACK_DEL(parser->allocator, parser->parents);
+
+    memset(parser, 0, sizeof(JsonParser));
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API void json_parser_reset(JsonParser *parser) {
+    JsonParser kept;
+
+    MYJSON_ASSERT(parser); /**< Non-NULL parser object expected. */
+
+    while (!MYJSON_QUEUE_EMPTY(parser->tokens)) {
+        _myjson_token_delete(&MYJSON_DEQUEUE(parser, parser->tokens));
+    }
+    _myjson_parser_unmap_file(parser);
+
+    kept = *parser;
+    memset(parser, 0, sizeof(JsonParser));
+
+    /* The buffers of a stream are kept for the next one (an input scanned in place is not the parser's). */
+    if (!kept.in_place) {
+        parser->buffer.start = kept.buffer.start;
+        parser->buffer.pointer = kept.buffer.start;
+        parser->buffer.last = kept.buffer.start;
+        parser->buffer.end = kept.buffer.end;
+    }
+
+    parser->raw_buffer.start = kept.raw_buffer.start;
+    parser->raw_buffer.pointer = kept.raw_buffer.start;
+    parser->raw_buffer.last = kept.raw_buffer.start;
+    parser->raw_buffer.end = kept.raw_buffer.end;
+
+    parser->tokens.start = kept.tokens.start;
+    parser->tokens.head = kept.tokens.start;
+    parser->tokens.tail = kept.tokens.start;
+    parser->tokens.end = kept.tokens.end;
+
+    parser->events.start = kept.events.start;
+    parser->events.top = kept.events.start;
+    parser->events.end = kept.events.end;
+
+    parser->marks.start = kept.marks.start;
+    parser->marks.top = kept.marks.start;
+    parser->marks.end = kept.marks.end;
+
+    parser->parents.start = kept.parents.start;
+    parser->parents.top = kept.parents.start;
+    parser->parents.end = kept.parents.end;
+
+    /* The index is reused by the next input if it is large enough. */
+    parser->structurals.start = kept.structurals.start;
+    parser->structurals.head = kept.structurals.start;
+    parser->structurals.tail = kept.structurals.start;
+    parser->structurals.end = kept.structurals.end;
+    parser->structurals.matches = kept.structurals.matches;
+
+    parser->structurals.opens.start = kept.structurals.opens.start;
+    parser->structurals.opens.top = kept.structurals.opens.start;
+    parser->structurals.opens.end = kept.structurals.opens.end;
+
+    parser->structurals.closes.start = kept.structurals.closes.start;
+    parser->structurals.closes.top = kept.structurals.closes.start;
+    parser->structurals.closes.end = kept.structurals.closes.end;
+
+    parser->event = JSON_PARSE_STREAM_START_EVENT;
+    parser->kernel = kept.kernel;
+    parser->allocator = kept.allocator;
+    parser->thread_count = 1;
+};
+
+#if defined(MYJSON_THREAD_LOCAL)
+
+/* The parser pool of the thread: bit `k` of the masks tells whether parser `k` is handed out, or initialized. */
+static MYJSON_THREAD_LOCAL struct {
+    JsonParser parsers[MYJSON_POOL_SIZE];
+    unsigned acquired;
+    unsigned initialized;
+} _myjson_parser_pool;
+
+#endif
+
+MYJSON_API JsonParser *json_parser_pool_acquire(void) {
+#if defined(MYJSON_THREAD_LOCAL)
+    unsigned k;
+
+    for (k = 0; k < MYJSON_POOL_SIZE; k++) {
+        if (_myjson_parser_pool.acquired & (1u << k)) {
+            continue;
+        }
+
+        if (!(_myjson_parser_pool.initialized & (1u << k))) {
+            if (!json_parser_initialize(_myjson_parser_pool.parsers + k)) {
+                return NULL;
+            }
+            _myjson_parser_pool.initialized |= 1u << k;
+        }
+
+        _myjson_parser_pool.acquired |= 1u << k;
+        return _myjson_parser_pool.parsers + k;
+    }
+#endif
+
+    /* The pool is exhausted, or there is no thread-local storage to keep one. */
+    return NULL;
+};
+
+MYJSON_API void json_parser_pool_release(JsonParser *parser) {
+#if defined(MYJSON_THREAD_LOCAL)
+    unsigned k;
+
+    for (k = 0; k < MYJSON_POOL_SIZE && parser != _myjson_parser_pool.parsers + k; k++) {
+    }
+
+    MYJSON_ASSERT(k < MYJSON_POOL_SIZE &&
+                  (_myjson_parser_pool.acquired & (1u << k))); /**< A parser of the pool of the thread expected. */
+
+    json_parser_reset(parser);
+    _myjson_parser_pool.acquired &= ~(1u << k);
+#else
+    MYJSON_ASSERT(!parser); /**< A parser of the pool of the thread expected. */
+#endif
+};
+
+MYJSON_API void json_parser_pool_clear(void) {
+#if defined(MYJSON_THREAD_LOCAL)
+    unsigned k;
+
+    MYJSON_ASSERT(!_myjson_parser_pool.acquired); /**< Every parser of the pool must be released. */
+
+    for (k = 0; k < MYJSON_POOL_SIZE; k++) {
+        if (_myjson_parser_pool.initialized & (1u << k)) {
+            json_parser_delete(_myjson_parser_pool.parsers + k);
+        }
+    }
+    _myjson_parser_pool.initialized = 0;
+#endif
+};
+
+MYJSON_API int json_parser_set_input_file(JsonParser *parser, FILE *file) {
+    MYJSON_ASSERT(file);                  /**<  Non-NULL file object expected. */
+    MYJSON_ASSERT(parser);                /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(!parser->read_handler); /**< You can set the source only once. */
+
+    parser->read_handler = _myjson_file_read_handler;
+    parser->read_handler_data = parser;
+
+    parser->input.file = file;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_set_input_string(JsonParser *parser, const unsigned char *input, size_t size) {
+    MYJSON_ASSERT(input);                 /**< Non-NULL input string expected. */
+    MYJSON_ASSERT(parser);                /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(!parser->read_handler); /**< You can set the source only once. */
+
+    parser->read_handler = _myjson_string_read_handler;
+    parser->read_handler_data = parser;
+
+    parser->input.string.start = input;
+    parser->input.string.current = input;
+    parser->input.string.end = input + size;
+
+    /* The input is scanned in place and the scalars borrow from it: the buffer kept by a reset is not needed. */
+    _myjson_free(parser->allocator, parser->buffer.start, parser->buffer.end - parser->buffer.start);
+    parser->buffer.start = (JsonChar_t *)input;
+    parser->buffer.pointer = parser->buffer.start;
+    parser->buffer.last = parser->buffer.start + size;
+    parser->buffer.end = parser->buffer.last;
+    parser->eof = 1;
+    parser->in_place = 1;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_set_input_mutable_string(JsonParser *parser, unsigned char *input, size_t size) {
+    if (!json_parser_set_input_string(parser, input, size)) {
+        return MYJSON_FAILURE;
+    }
+
+    parser->in_situ = 1;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_set_input_mmap(JsonParser *parser, const char *path, int flags) {
+    int fd, result;
+
+    MYJSON_ASSERT(path);                  /**<   Non-NULL file path expected. */
+    MYJSON_ASSERT(parser);                /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(!parser->read_handler); /**< You can set the source only once. */
+
+#if MYJSON_PLATFORM_IS(WINDOWS)
+    fd = _open(path, _O_RDONLY | _O_BINARY);
+#else
+    fd = open(path, O_RDONLY);
+#endif
+    if (fd < 0) {
+        return _myjson_parser_set_reader_error(parser, "cannot open the input file", 0);
+    }
+
+    /* The mapping outlives the descriptor. */
+    result = _myjson_parser_map_file(parser, fd, flags);
+
+#if MYJSON_PLATFORM_IS(WINDOWS)
+    _close(fd);
+#else
+    close(fd);
+#endif
+
+    return result;
+};
+
+MYJSON_API int json_parser_set_input_mmap_fd(JsonParser *parser, int fd, int flags) {
+    MYJSON_ASSERT(fd >= 0);               /**< Open file descriptor expected. */
+    MYJSON_ASSERT(parser);                /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(!parser->read_handler); /**< You can set the source only once. */
+
+    return _myjson_parser_map_file(parser, fd, flags);
+};
+
+MYJSON_API int json_parser_set_input(JsonParser *parser, JsonReadHandler *handler, void *data) {
+    MYJSON_ASSERT(parser);                /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(handler);               /**< Non-NULL read handler expected. */
+    MYJSON_ASSERT(!parser->read_handler); /**< You can set the source only once. */
+
+    parser->read_handler = handler;
+    parser->read_handler_data = data;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_set_stream_flags(JsonParser *parser, int flags) {
+    MYJSON_ASSERT(parser);                                           /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(parser->event == JSON_PARSE_STREAM_START_EVENT); /**< Set the flags before parsing. */
+
+    /* Resynchronizing is only possible between documents. */
+    if (flags & JSON_RESYNC_FLAG) {
+        flags |= JSON_MULTI_DOCUMENT_FLAG;
+    }
+
+    parser->stream_flags = flags;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_set_thread_count(JsonParser *parser, size_t thread_count) {
+    MYJSON_ASSERT(parser); /**< Non-NULL parser object expected. */
+
+    parser->thread_count = thread_count;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_set_pack_flags(JsonParser *parser, int flags) {
+    MYJSON_ASSERT(parser); /**< Non-NULL parser object expected. */
+
+    if (flags & JSON_PACK_FLOAT32) {
+        flags |= JSON_PACK_ARRAYS;
+    }
+
+    parser->pack_flags = flags;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_set_allocator(JsonParser *parser, const JsonAllocator *allocator) {
+    MYJSON_ASSERT(parser);                             /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(!parser->read_handler);              /**< Set the allocator before the input. */
+    MYJSON_ASSERT(MYJSON_QUEUE_EMPTY(parser->tokens)); /**< No token may be queued. */
+
+    /* The stacks allocated by json_parser_initialize, and the buffers kept by a reset, go back to the old allocator. */
+    _myjson_free(parser->allocator, parser->raw_buffer.start, parser->raw_buffer.end - parser->raw_buffer.start);
+    _myjson_free(parser->allocator, parser->buffer.start, parser->buffer.end - parser->buffer.start);
+    memset(&parser->raw_buffer, 0, sizeof(parser->raw_buffer));
+    memset(&parser->buffer, 0, sizeof(parser->buffer));
+    MYJSON_QUEUE_DEL(parser->allocator, parser->tokens);
+    MYJSON_STACK_DEL(parser->allocator, parser->events);
+    MYJSON_STACK_DEL(parser->allocator, parser->marks);
+    MYJSON_STACK_DEL(parser->allocator, parser->parents);
+    _myjson_parser_delete_index(parser);
+
+    parser->allocator = allocator ? allocator : _myjson_allocator;
+
+    if (!MYJSON_QUEUE_INIT(parser, parser->allocator, parser->tokens, JsonToken, MYJSON_TOKEN_QUEUE_SIZE) ||
+        !MYJSON_STACK_INIT(parser, parser->allocator, parser->events, JsonParseEvent) ||
+        !MYJSON_STACK_INIT(parser, parser->allocator, parser->marks, JsonPosition) ||
+        !MYJSON_STACK_INIT(parser, parser->allocator, parser->parents, int)) {
+        return MYJSON_FAILURE;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parser_feed(JsonParser *parser, const unsigned char *chunk, size_t size, int is_last) {
+    MYJSON_ASSERT(parser);                                /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(chunk || !size);                        /**< Non-NULL chunk expected. */
+    MYJSON_ASSERT(!parser->read_handler || parser->push); /**< You can set the source only once. */
+    MYJSON_ASSERT(!parser->last_fed);                     /**< Nothing can follow the last chunk. */
+    MYJSON_ASSERT(parser->input.string.current == parser->input.string.end); /**< The previous chunk is read. */
+
+    /* The chunk is read with the string read handler, and never scanned in place. */
+    parser->read_handler = _myjson_string_read_handler;
+    parser->read_handler_data = parser;
+
+    parser->input.string.start = chunk;
+    parser->input.string.current = chunk;
+    parser->input.string.end = size ? chunk + size : chunk;
+
+    parser->push = 1;
+    parser->last_fed = is_last;
+    parser->waiting = 0;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_read_ahead_initialize(JsonReadAhead *reader, int fd, size_t count, size_t size) {
+    JsonReadAheadState *state;
+    unsigned char *start;
+    size_t k;
+
+    MYJSON_ASSERT(reader);  /**< Non-NULL read-ahead object expected. */
+    MYJSON_ASSERT(fd >= 0); /**< Open file descriptor expected. */
+
+    memset(reader, 0, sizeof(JsonReadAhead));
+
+    reader->fd = fd;
+    reader->count = count ? count : MYJSON_READ_AHEAD_COUNT;
+    reader->size = size ? (size + MYJSON_PAGE_SIZE - 1) & ~(size_t)(MYJSON_PAGE_SIZE - 1) : MYJSON_READ_AHEAD_SIZE;
+
+    state = (JsonReadAheadState *)_myjson_malloc(_myjson_allocator, sizeof(JsonReadAheadState));
+    if (!state) {
+        return MYJSON_FAILURE;
+    }
+    memset(state, 0, sizeof(JsonReadAheadState));
+    state->allocator = _myjson_allocator;
+    reader->state = state;
+
+    state->memory = (unsigned char *)_myjson_malloc(state->allocator, reader->count * reader->size + MYJSON_PAGE_SIZE);
+    state->chunks =
+        (JsonReadAheadChunk *)_myjson_malloc(state->allocator, reader->count * sizeof(JsonReadAheadChunk));
+    if (!state->memory || !state->chunks) {
+        goto error;
+    }
+    memset(state->chunks, 0, reader->count * sizeof(JsonReadAheadChunk));
+
+    start = state->memory + (MYJSON_PAGE_SIZE - (uintptr_t)state->memory % MYJSON_PAGE_SIZE) % MYJSON_PAGE_SIZE;
+    for (k = 0; k < reader->count; k++) {
+        state->chunks[k].start = start + k * reader->size;
+    }
+
+#if MYJSON_IO_URING
+    /* Read the chunks at their offsets with io_uring, if the descriptor can be read at an offset. */
+    {
+        off_t base = lseek(fd, 0, SEEK_CUR);
+
+        if (base >= 0 && _myjson_ring_initialize(&state->ring, (unsigned)reader->count)) {
+            reader->io_uring = 1;
+            state->base = (uint64_t)base;
+
+            for (k = 0; k < reader->count; k++) {
+                state->chunks[k].offset = state->base + (uint64_t)k * reader->size;
+                state->chunks[k].size = reader->size;
+
+                if (!_myjson_read_ahead_submit(reader, state->chunks + k)) {
+                    json_read_ahead_delete(reader);
+                    return MYJSON_FAILURE;
+                }
+            }
+
+            return MYJSON_SUCCESS;
+        }
+    }
+#endif
+
+    /* Otherwise, read them in order on a thread. */
+    if (!_myjson_mutex_initialize(&state->mutex)) {
+        goto error;
+    }
+    if (!_myjson_condition_initialize(&state->condition)) {
+        _myjson_mutex_delete(&state->mutex);
+        goto error;
+    }
+    if (!_myjson_thread_create(&state->thread, _myjson_read_ahead_run, reader)) {
+        _myjson_condition_delete(&state->condition);
+        _myjson_mutex_delete(&state->mutex);
+        goto error;
+    }
+
+    return MYJSON_SUCCESS;
+
+error:
+    _myjson_free(state->allocator, state->memory, reader->count * reader->size + MYJSON_PAGE_SIZE);
+    _myjson_free(state->allocator, state->chunks, reader->count * sizeof(JsonReadAheadChunk));
+    _myjson_free(state->allocator, state, sizeof(JsonReadAheadState));
+    memset(reader, 0, sizeof(JsonReadAhead));
+
+    return MYJSON_FAILURE;
+};
+
+MYJSON_API int json_read_ahead_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read) {
+    JsonReadAhead *reader = (JsonReadAhead *)data;
+    JsonReadAheadState *state = (JsonReadAheadState *)reader->state;
+    JsonReadAheadChunk *chunk;
+
+    *size_read = 0;
+
+    if (state->eof) {
+        return MYJSON_SUCCESS;
+    }
+
+    /* Hand over the rest of the current chunk, at most. */
+    chunk = state->chunks + state->current % reader->count;
+    if (!_myjson_read_ahead_wait(reader, chunk) || chunk->error) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!chunk->length) {
+        state->eof = 1;
+        return MYJSON_SUCCESS;
+    }
+
+    *size_read = chunk->length - chunk->pointer;
+    if (*size_read > size) {
+        *size_read = size;
+    }
+    memcpy(buffer, chunk->start + chunk->pointer, *size_read);
+    chunk->pointer += *size_read;
+
+    if (chunk->pointer == chunk->length) {
+        return _myjson_read_ahead_release(reader, chunk);
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_read_ahead_delete(JsonReadAhead *reader) {
+    JsonReadAheadState *state;
+
+    MYJSON_ASSERT(reader); /**< Non-NULL read-ahead object expected. */
+
+    state = (JsonReadAheadState *)reader->state;
+    if (!state) {
+        return MYJSON_SUCCESS;
+    }
+
+#if MYJSON_IO_URING
+    if (reader->io_uring) {
+        /* The kernel may still write to the chunks. */
+        while (state->pending) {
+            if (!_myjson_read_ahead_complete(reader, (unsigned)state->pending)) {
+                break;
+            }
+        }
+        _myjson_ring_delete(&state->ring);
+    } else
+#endif
+    {
+        _myjson_mutex_lock(&state->mutex);
+        state->stop = 1;
+        _myjson_condition_broadcast(&state->condition);
+        _myjson_mutex_unlock(&state->mutex);
+
+        _myjson_thread_join(&state->thread);
+        _myjson_condition_delete(&state->condition);
+        _myjson_mutex_delete(&state->mutex);
+    }
+
+    _myjson_free(state->allocator, state->memory, reader->count * reader->size + MYJSON_PAGE_SIZE);
+    _myjson_free(state->allocator, state->chunks, reader->count * sizeof(JsonReadAheadChunk));
+    _myjson_free(state->allocator, state, sizeof(JsonReadAheadState));
+    memset(reader, 0, sizeof(JsonReadAhead));
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_parse_ndjson_parallel(const unsigned char *input, size_t length, size_t thread_count,
+                                          JsonDocumentHandler *handler, void *data, int ordered) {
+    JsonNdjsonPool pool;
+    size_t chunk_size, bom, k;
+    int result = MYJSON_SUCCESS;
+
+    MYJSON_ASSERT(input || !length); /**< Non-NULL input expected. */
+    MYJSON_ASSERT(handler);          /**< Non-NULL document handler expected. */
+
+    memset(&pool, 0, sizeof(pool));
+    pool.handler = handler;
+    pool.handler_data = data;
+    pool.ordered = ordered;
+    pool.allocator = _myjson_allocator;
+
+    if (!thread_count) {
+        thread_count = _myjson_processor_count();
+    }
+
+    /* A few chunks per thread, to balance the load; cutting the lines of other encodings is not safe. */
+    chunk_size = length / (thread_count * 8);
+    if (chunk_size > MYJSON_NDJSON_CHUNK_SIZE) {
+        chunk_size = MYJSON_NDJSON_CHUNK_SIZE;
+    }
+    if (chunk_size < MYJSON_NDJSON_CHUNK_SIZE / 16) {
+        chunk_size = MYJSON_NDJSON_CHUNK_SIZE / 16;
+    }
+    if (_myjson_detect_encoding(input, length, &bom) != JSON_UTF8_ENCODING) {
+        chunk_size = length;
+    }
+
+    /* Cut the input after the first line feed past every chunk size. */
+    pool.capacity = length / chunk_size + 1;
+    pool.chunks = (JsonNdjsonChunk *)_myjson_malloc(pool.allocator, pool.capacity * sizeof(JsonNdjsonChunk));
+    if (!pool.chunks) {
+        return MYJSON_FAILURE;
+    }
+
+    for (k = 0; k < length; pool.count++) {
+        JsonNdjsonChunk *chunk = pool.chunks + pool.count;
+        const unsigned char *newline = NULL;
+
+        if (length - k > chunk_size) {
+            newline = (const unsigned char *)memchr(input + k + chunk_size, '\n', length - k - chunk_size);
+        }
+
+        memset(chunk, 0, sizeof(JsonNdjsonChunk));
+        chunk->start = input + k;
+        chunk->size = newline ? (size_t)(newline + 1 - chunk->start) : length - k;
+        k += chunk->size;
+    }
+
+    if (!pool.count) {
+        _myjson_free(pool.allocator, pool.chunks, pool.capacity * sizeof(JsonNdjsonChunk));
+        return MYJSON_SUCCESS;
+    }
+
+    if (thread_count > pool.count) {
+        thread_count = pool.count;
+    }
+
+    pool.worker_count = thread_count;
+    pool.workers = (JsonNdjsonWorker *)_myjson_malloc(pool.allocator, thread_count * sizeof(JsonNdjsonWorker));
+    if (!pool.workers || !_myjson_mutex_initialize(&pool.mutex)) {
+        _myjson_free(pool.allocator, pool.workers, thread_count * sizeof(JsonNdjsonWorker));
+        _myjson_free(pool.allocator, pool.chunks, pool.capacity * sizeof(JsonNdjsonChunk));
+        return MYJSON_FAILURE;
+    }
+
+    for (k = 0; k < thread_count; k++) {
+        JsonNdjsonWorker *worker = pool.workers + k;
+
+        memset(worker, 0, sizeof(JsonNdjsonWorker));
+        worker->pool = &pool;
+        worker->index = k;
+        worker->tail = (pool.count - k + thread_count - 1) / thread_count;
+
+        if (!_myjson_mutex_initialize(&worker->mutex) || !json_parser_initialize(&worker->parser)) {
+            result = MYJSON_FAILURE;
+            pool.stop = 1;
+        }
+    }
+
+    /* The calling thread is the first worker; the chunks of a thread that fails to start are stolen. */
+    if (!pool.stop) {
+        for (k = 1; k < thread_count; k++) {
+            JsonNdjsonWorker *worker = pool.workers + k;
+
+            worker->started = _myjson_thread_create(&worker->thread, _myjson_ndjson_run, worker);
+        }
+
+        _myjson_ndjson_run(pool.workers);
+    }
+
+    /* A running worker may still steal from a finished one. */
+    for (k = 1; k < thread_count; k++) {
+        if (pool.workers[k].started) {
+            _myjson_thread_join(&pool.workers[k].thread);
+        }
+    }
+
+    for (k = 0; k < thread_count; k++) {
+        json_parser_delete(&pool.workers[k].parser);
+        _myjson_mutex_delete(&pool.workers[k].mutex);
+    }
+
+    /* The documents kept after a failure are not delivered. */
+    for (k = 0; k < pool.count; k++) {
+        if (pool.chunks[k].error) {
+            result = MYJSON_FAILURE;
+        }
+        _myjson_ndjson_delete_documents(&pool, pool.chunks + k);
+    }
+
+    if (pool.stop) {
+        result = MYJSON_FAILURE;
+    }
+
+    _myjson_mutex_delete(&pool.mutex);
+    _myjson_free(pool.allocator, pool.workers, thread_count * sizeof(JsonNdjsonWorker));
+    _myjson_free(pool.allocator, pool.chunks, pool.capacity * sizeof(JsonNdjsonChunk));
+
+    return result;
+};
+
+MYJSON_API int json_cursor_initialize(JsonCursor *cursor, JsonParser *parser) {
+    JsonChar_t *pointer;
+
+    MYJSON_ASSERT(cursor);                                           /**< Non-NULL cursor object expected. */
+    MYJSON_ASSERT(parser);                                           /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(parser->read_handler);                             /**< The input must be set. */
+    MYJSON_ASSERT(parser->event == JSON_PARSE_STREAM_START_EVENT); /**< The parser must not have parsed yet. */
+
+    memset(cursor, 0, sizeof(JsonCursor));
+    cursor->parser = parser;
+
+    /* The parser only serves the cursor from now on. */
+    parser->event = JSON_PARSE_END_EVENT;
+
+    if (!_myjson_parser_determine_encoding(parser)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!parser->in_place) {
+        return _myjson_parser_set_reader_error(parser, "a cursor needs a UTF-8 input in memory", 0);
+    }
+
+    if (!MYJSON_STACK_INIT(parser, parser->allocator, cursor->containers, JsonChar_t)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!_myjson_cursor_fetch(cursor, 1, &pointer)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!pointer) {
+        return _myjson_cursor_set_error(cursor, "did not find expected value");
+    }
+
+    cursor->state = JSON_CURSOR_VALUE;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API void json_cursor_delete(JsonCursor *cursor) {
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+
+    MYJSON_STACK_DEL(cursor->parser->allocator, cursor->containers);
+
+    memset(cursor, 0, sizeof(JsonCursor));
+};
+
+MYJSON_API int json_cursor_get_type(JsonCursor *cursor, JsonValueType *type) {
+    JsonChar_t *pointer;
+    size_t length, k;
+
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+    MYJSON_ASSERT(type);   /**< Non-NULL type expected. */
+
+    if (cursor->state != JSON_CURSOR_VALUE || !_myjson_cursor_fetch(cursor, 1, &pointer)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!pointer) {
+        return _myjson_cursor_set_error(cursor, "did not find expected value");
+    }
+
+    switch (*pointer) {
+        case '[':
+            *type = JSON_ARRAY;
+            return MYJSON_SUCCESS;
+        case '{':
+            *type = JSON_OBJECT;
+            return MYJSON_SUCCESS;
+        case '"':
+            *type = JSON_STRING;
+            return MYJSON_SUCCESS;
+        case 't':
+        case 'f':
+            *type = JSON_BOOLOEAN;
+            return MYJSON_SUCCESS;
+        case 'n':
+            *type = JSON_NULL;
+            return MYJSON_SUCCESS;
+        case ']':
+        case '}':
+        case ',':
+        case ':':
+            return _myjson_cursor_set_error(cursor, "did not find expected value");
+        default:
+            break;
+    }
+
+    /* A number is an integer unless it has a fraction or an exponent. */
+    length = _myjson_cursor_scalar(cursor, &pointer);
+    *type = JSON_INTEGER;
+    for (k = 0; k < length; k++) {
+        if (pointer[k] == '.' || pointer[k] == 'e' || pointer[k] == 'E') {
+            *type = JSON_DOUBLE;
+            break;
+        }
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_cursor_enter(JsonCursor *cursor) {
+    JsonParser *parser;
+    JsonChar_t *pointer, open;
+
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+
+    parser = cursor->parser;
+
+    if (cursor->state != JSON_CURSOR_VALUE || !_myjson_cursor_fetch(cursor, 1, &pointer) || !pointer ||
+        (*pointer != '[' && *pointer != '{')) {
+        return MYJSON_FAILURE;
+    }
+
+    open = *pointer;
+    if (!MYJSON_PUSH(parser, parser->allocator, cursor->containers, open)) {
+        return MYJSON_FAILURE;
+    }
+    parser->structurals.head++;
+
+    if (!_myjson_cursor_fetch(cursor, 1, &pointer)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (pointer && *pointer == (open == '[' ? ']' : '}')) {
+        cursor->state = JSON_CURSOR_END;
+        return MYJSON_FAILURE;
+    }
+
+    if (open == '{') {
+        return _myjson_cursor_read_key(cursor);
+    }
+
+    cursor->state = JSON_CURSOR_VALUE;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_cursor_next(JsonCursor *cursor) {
+    JsonParser *parser;
+    JsonChar_t *pointer, close;
+
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+
+    parser = cursor->parser;
+
+    if (cursor->state == JSON_CURSOR_END || parser->error.type) {
+        return MYJSON_FAILURE;
+    }
+
+    if (cursor->state == JSON_CURSOR_VALUE && !_myjson_cursor_skip(cursor)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!_myjson_cursor_fetch(cursor, 1, &pointer)) {
+        return MYJSON_FAILURE;
+    }
+
+    /* The root value has no siblings. */
+    if (MYJSON_STACK_EMPTY(cursor->containers)) {
+        if (pointer) {
+            return _myjson_cursor_set_error(cursor, "did not find expected end of stream");
+        }
+        cursor->state = JSON_CURSOR_END;
+        return MYJSON_FAILURE;
+    }
+
+    close = (cursor->containers.top[-1] == '[') ? ']' : '}';
+
+    if (pointer && *pointer == ',') {
+        parser->structurals.head++;
+
+        if (close == '}') {
+            return _myjson_cursor_read_key(cursor);
+        }
+
+        cursor->state = JSON_CURSOR_VALUE;
+        return MYJSON_SUCCESS;
+    }
+
+    if (pointer && *pointer == close) {
+        cursor->state = JSON_CURSOR_END;
+        return MYJSON_FAILURE;
+    }
+
+    return _myjson_cursor_set_error(cursor, (close == ']') ? "did not find expected ',' or ']'"
+                                                           : "did not find expected ',' or '}'");
+};
+
+MYJSON_API int json_cursor_leave(JsonCursor *cursor) {
+    MYJSON_ASSERT(cursor);                                   /**< Non-NULL cursor object expected. */
+    MYJSON_ASSERT(!MYJSON_STACK_EMPTY(cursor->containers)); /**< A container must be entered. */
+
+    while (cursor->state != JSON_CURSOR_END) {
+        if (!json_cursor_next(cursor) && cursor->parser->error.type) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    /* Step over the closing bracket: the container is read. */
+    (void)MYJSON_POP(cursor->parser, cursor->containers);
+    cursor->parser->structurals.head++;
+    cursor->state = JSON_CURSOR_AFTER;
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_cursor_find_field(JsonCursor *cursor, const JsonChar_t *key, int key_length) {
+    int match;
+
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+    MYJSON_ASSERT(key);    /**< Non-NULL key expected. */
+    MYJSON_ASSERT(!MYJSON_STACK_EMPTY(cursor->containers) &&
+                  cursor->containers.top[-1] == '{'); /**< An object must be entered. */
+
+    if (key_length < 0) {
+        key_length = (int)strlen((const char *)key);
+    }
+
+    while (cursor->state != JSON_CURSOR_END) {
+        if (cursor->state == JSON_CURSOR_VALUE) {
+            if (!_myjson_cursor_match_key(cursor, key, (size_t)key_length, &match)) {
+                return MYJSON_FAILURE;
+            }
+            if (match) {
+                return MYJSON_SUCCESS;
+            }
+        }
+
+        if (!json_cursor_next(cursor) && cursor->parser->error.type) {
+            return MYJSON_FAILURE;
+        }
+    }
+
+    return MYJSON_FAILURE;
+};
+
+MYJSON_API int json_cursor_get_key(JsonCursor *cursor, const JsonChar_t **value, size_t *length, int *flags) {
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+    MYJSON_ASSERT(value);  /**< Non-NULL value expected. */
+    MYJSON_ASSERT(length); /**< Non-NULL length expected. */
+
+    if (cursor->state == JSON_CURSOR_END || MYJSON_STACK_EMPTY(cursor->containers) ||
+        cursor->containers.top[-1] != '{') {
+        return MYJSON_FAILURE;
+    }
+
+    *value = cursor->key.value;
+    *length = cursor->key.length;
+    if (flags) {
+        *flags = cursor->key.flags;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_cursor_get_string(JsonCursor *cursor, const JsonChar_t **value, size_t *length, int *flags) {
+    JsonParser *parser;
+    JsonChar_t *pointer;
+    size_t string_length;
+    int string_flags;
+
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+    MYJSON_ASSERT(value);  /**< Non-NULL value expected. */
+    MYJSON_ASSERT(length); /**< Non-NULL length expected. */
+
+    parser = cursor->parser;
+
+    if (cursor->state != JSON_CURSOR_VALUE || !_myjson_cursor_fetch(cursor, 1, &pointer) || !pointer ||
+        *pointer != '"') {
+        return MYJSON_FAILURE;
+    }
+
+    if (!_myjson_cursor_fetch(cursor, 2, &pointer)) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!pointer) {
+        return _myjson_cursor_set_error(cursor, "found unexpected end of stream while scanning a string");
+    }
+
+    string_length = parser->structurals.head[1] - parser->structurals.head[0] - 1;
+    if (!_myjson_cursor_read_string(cursor, pointer + 1, &string_length, &string_flags)) {
+        return MYJSON_FAILURE;
+    }
+
+    parser->structurals.head += 2;
+    cursor->state = JSON_CURSOR_AFTER;
+
+    *value = pointer + 1;
+    *length = string_length;
+    if (flags) {
+        *flags = string_flags;
+    }
+
+    return MYJSON_SUCCESS;
+};
+
+MYJSON_API int json_cursor_get_int64(JsonCursor *cursor, int64_t *value) {
+    JsonChar_t *pointer;
+    JsonValueType type;
+    JsonNumber number;
+    size_t length;
+    int flags = 0;
+
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+    MYJSON_ASSERT(value);  /**< Non-NULL value expected. */
+
+    length = _myjson_cursor_scalar(cursor, &pointer);
+    if (!length || (*pointer != '-' && (*pointer < '0' || *pointer > '9'))) {
+        return MYJSON_FAILURE;
+    }
+
+    if (!_myjson_parse_number(pointer, length, &type, &number, &flags)) {
+        return _myjson_cursor_set_error(cursor, "found invalid number");
+    }
 
-    if (emitter->output.string.size - *emitter->output.string.size_written < size) {
-        memcpy(emitter->output.string.buffer + *emitter->output.string.size_written, buffer,
-               emitter->output.string.size - *emitter->output.string.size_written);
-        *emitter->output.string.size_written = emitter->output.string.size;
+    if (type != JSON_INTEGER || (flags & JSON_UNSIGNED_FLAG)) {
         return MYJSON_FAILURE;
     }
 
-    memcpy(emitter->output.string.buffer + *emitter->output.string.size_written, buffer, size);
-    *emitter->output.string.size_written += size;
+    cursor->parser->structurals.head++;
+    cursor->state = JSON_CURSOR_AFTER;
+    *value = number.integer;
+
     return MYJSON_SUCCESS;
 };
 
-/*
- * File write handler.
- */
-static int _myjson_file_write_handler(void *data, unsigned char *buffer, size_t size) {
-    JsonEmitter *emitter = (JsonEmitter *)data;
-    return (fwrite(buffer, 1, size, emitter->output.file) == size);
-};
+MYJSON_API int json_cursor_get_double(JsonCursor *cursor, double *value) {
+    JsonChar_t *pointer;
+    JsonValueType type;
+    JsonNumber number;
+    size_t length;
+    int flags = 0;
 
-#pragma endregion  // Writer
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+    MYJSON_ASSERT(value);  /**< Non-NULL value expected. */
 
-#endif  // MYJSON_DISABLE_WRITER
+    length = _myjson_cursor_scalar(cursor, &pointer);
+    if (!length || (*pointer != '-' && (*pointer < '0' || *pointer > '9'))) {
+        return MYJSON_FAILURE;
+    }
 
-#pragma endregion  // C Definations
+    if (!_myjson_parse_number(pointer, length, &type, &number, &flags)) {
+        return _myjson_cursor_set_error(cursor, "found invalid number");
+    }
 
-#ifdef __cplusplus
-}
-#endif  // __cplusplus
+    if (type == JSON_DOUBLE) {
+        *value = number.real;
+    } else if (flags & JSON_UNSIGNED_FLAG) {
+        *value = (double)number.uinteger;
+    } else {
+        *value = (double)number.integer;
+    }
 
-//-----------------------------------------------------------------------------
-// [SECTION] C++ Only Classes
-//-----------------------------------------------------------------------------
+    cursor->parser->structurals.head++;
+    cursor->state = JSON_CURSOR_AFTER;
 
-#ifdef __cplusplus
+    return MYJSON_SUCCESS;
+};
 
-#pragma region Cpp Dec
+MYJSON_API int json_cursor_get_boolean(JsonCursor *cursor, int *value) {
+    JsonChar_t *pointer;
+    size_t length;
 
-//-----------------------------------------------------------------------------
-// [SECTION] Declarations
-//-----------------------------------------------------------------------------
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
+    MYJSON_ASSERT(value);  /**< Non-NULL value expected. */
 
-#pragma endregion  // Cpp Declarations
+    length = _myjson_cursor_scalar(cursor, &pointer);
+    if (!length || (*pointer != 't' && *pointer != 'f')) {
+        return MYJSON_FAILURE;
+    }
 
-#pragma region Cpp Def
+    if (length == 4 && !memcmp(pointer, "true", 4)) {
+        *value = 1;
+    } else if (length == 5 && !memcmp(pointer, "false", 5)) {
+        *value = 0;
+    } else {
+        return _myjson_cursor_set_error(cursor, "found unknown literal");
+    }
 
-//-----------------------------------------------------------------------------
-// [SECTION] Definations
-//-----------------------------------------------------------------------------
+    cursor->parser->structurals.head++;
+    cursor->state = JSON_CURSOR_AFTER;
 
-#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+    return MYJSON_SUCCESS;
+};
 
-#pragma region Reader
+MYJSON_API int json_cursor_get_null(JsonCursor *cursor) {
+    JsonChar_t *pointer;
+    size_t length;
 
-#pragma endregion  // Reader
+    MYJSON_ASSERT(cursor); /**< Non-NULL cursor object expected. */
 
-#endif  // MYJSON_DISABLE_READER
+    length = _myjson_cursor_scalar(cursor, &pointer);
+    if (!length || *pointer != 'n') {
+        return MYJSON_FAILURE;
+    }
 
-#if !defined(MYJSON_DISABLE_WRITER) || !MYJSON_DISABLE_WRITER
+    if (length != 4 || memcmp(pointer, "null", 4)) {
+        return _myjson_cursor_set_error(cursor, "found unknown literal");
+    }
 
-#pragma region Writer
+    cursor->parser->structurals.head++;
+    cursor->state = JSON_CURSOR_AFTER;
 
-#pragma endregion  // Writer
+    return MYJSON_SUCCESS;
+};
 
-#endif  // MYJSON_DISABLE_WRITER
+MYJSON_API int json_query_initialize(JsonQuery *query) {
+    JsonQueryStep root;
 
-#pragma endregion  // Cpp Definations
+    MYJSON_ASSERT(query); /**< Non-NULL query object expected. */
 
-#endif  //__cplusplus
+    memset(query, 0, sizeof(JsonQuery));
+    query->allocator = _myjson_allocator;
 
-#pragma endregion
+    if (!MYJSON_STACK_INIT(query, query->allocator, query->steps, JsonQueryStep)) {
+        goto error;
+    }
+    if (!MYJSON_STACK_INIT(query, query->allocator, query->matches, JsonQueryMatch)) {
+        goto error;
+    }
 
-#pragma region Myjson
+    memset(&root, 0, sizeof(JsonQueryStep));
+    root.index = (size_t)-1;
 
-#pragma region C
+    if (!MYJSON_PUSH(query, query->allocator, query->steps, root)) {
+        goto error;
+    }
 
-//-----------------------------------------------------------------------------
-// [SECTION] C Only Functions
-//-----------------------------------------------------------------------------
+    return MYJSON_SUCCESS;
 
-#ifdef __cplusplus
-extern "C" {
-#endif  // __cplusplus
+error:
 
-#pragma region Event
+    MYJSON_STACK_DEL(query->allocator, query->steps);
+    MYJSON_STACK_DEL(query->allocator, query->matches);
 
-MYJSON_API int json_event_initialize_stream_start(JsonEvent *event, JsonEncoding encoding) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+    return MYJSON_FAILURE;
+};
 
-    JsonPosition pos = {0, 0, 0};
+MYJSON_API void json_query_delete(JsonQuery *query) {
+    JsonQueryStep *step;
 
-    memset(&(event), 0, sizeof(JsonEvent));
-    event->type = JSON_STREAM_START_EVENT;
-    event->start_pos = pos;
-    event->end_pos = pos;
-    event->data.stream_start.encoding = encoding;
+    MYJSON_ASSERT(query); /**< Non-NULL query object expected. */
 
-    return MYJSON_SUCCESS;
+    for (step = query->steps.start; step != query->steps.top; step++) {
+        if (step->key) {
+            _myjson_free(query->allocator, step->key, step->key_length + 1);
+        }
+    }
+
+    MYJSON_STACK_DEL(query->allocator, query->steps);
+    MYJSON_STACK_DEL(query->allocator, query->matches);
+
+    memset(query, 0, sizeof(JsonQuery));
 };
 
-MYJSON_API int json_event_initialize_stream_end(JsonEvent *event) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+MYJSON_API int json_query_add_expression(JsonQuery *query, const char *expression) {
+    JsonQueryMatch match;
+    JsonChar_t *key;
+    size_t step = 0, *last;
+    int result;
 
-    JsonPosition pos = {0, 0, 0};
+    MYJSON_ASSERT(query);      /**< Non-NULL query object expected. */
+    MYJSON_ASSERT(expression); /**< Non-NULL expression expected. */
 
-    memset(&(event), 0, sizeof(JsonEvent));
-    event->type = JSON_STREAM_END_EVENT;
-    event->start_pos = pos;
-    event->end_pos = pos;
+    /* No key is longer than the expression. */
+    key = (JsonChar_t *)_myjson_malloc(query->allocator, strlen(expression) + 1);
+    if (!key) {
+        return MYJSON_MEMORY_ERROR(query);
+    }
 
-    return MYJSON_SUCCESS;
-};
+    if (*expression == '$') {
+        result = _myjson_query_parse_path(query, expression, key, &step);
+    } else if (!*expression || *expression == '/') {
+        result = _myjson_query_parse_pointer(query, expression, key, &step);
+    } else {
+        result = _myjson_query_set_error(query, "did not find expected '/' or '$'", 0);
+    }
 
-MYJSON_API int json_event_initialize_document_start(JsonEvent *event) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+    _myjson_free(query->allocator, key, strlen(expression) + 1);
 
-    JsonPosition pos = {0, 0, 0};
+    if (!result) {
+        return MYJSON_FAILURE;
+    }
 
-    memset(&(event), 0, sizeof(JsonEvent));
-    event->type = JSON_DOCUMENT_START_EVENT;
-    event->start_pos = pos;
-    event->end_pos = pos;
+    match.expression = query->count;
+    match.next = 0;
 
-    return MYJSON_SUCCESS;
-};
-MYJSON_API int json_event_initialize_document_end(JsonEvent *event) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+    if (!MYJSON_PUSH(query, query->allocator, query->matches, match)) {
+        return MYJSON_FAILURE;
+    }
 
-    JsonPosition pos = {0, 0, 0};
+    /* The matches of a step keep the order of the expressions. */
+    for (last = &query->steps.start[step].match; *last; last = &query->matches.start[*last - 1].next) {
+    }
+    *last = (size_t)(query->matches.top - query->matches.start);
 
-    memset(&(event), 0, sizeof(JsonEvent));
-    event->type = JSON_DOCUMENT_END_EVENT;
-    event->start_pos = pos;
-    event->end_pos = pos;
+    query->count++;
 
     return MYJSON_SUCCESS;
 };
 
-MYJSON_API int json_event_initialize_scalar(JsonEvent *event, const JsonChar_t *value, int length) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+MYJSON_API int json_parser_query(JsonParser *parser, JsonQuery *query, JsonQueryHandler *handler, void *data) {
+    JsonQueryRun run;
+    JsonEvent event;
 
-    JsonPosition pos = {0, 0, 0};
+    MYJSON_ASSERT(parser);        /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(query);         /**< Non-NULL query object expected. */
+    MYJSON_ASSERT(handler);       /**< Non-NULL handler expected. */
+    MYJSON_ASSERT(!parser->push); /**< A push parser cannot skip ahead of its chunks. */
 
-    memset(&(event), 0, sizeof(JsonEvent));
-    event->type = JSON_SCALAR_EVENT;
-    event->start_pos = pos;
-    event->end_pos = pos;
+    memset(&run, 0, sizeof(JsonQueryRun));
+    run.parser = parser;
+    run.query = query;
+    run.handler = handler;
+    run.handler_data = data;
 
-    return MYJSON_SUCCESS;
+    if (!MYJSON_STACK_INIT(parser, parser->allocator, run.reached, size_t) ||
+        !MYJSON_STACK_INIT(parser, parser->allocator, run.frames, JsonQueryFrame)) {
+        goto error;
+    }
+
+    while (1) {
+        if (!_myjson_parser_load_event(parser, &event)) {
+            goto error;
+        }
+
+        switch (event.type) {
+            case JSON_STREAM_START_EVENT:
+            case JSON_DOCUMENT_START_EVENT:
+            case JSON_DOCUMENT_END_EVENT:
+                continue;
+            case JSON_STREAM_END_EVENT:
+                MYJSON_STACK_DEL(parser->allocator, run.reached);
+                MYJSON_STACK_DEL(parser->allocator, run.frames);
+                return MYJSON_SUCCESS;
+            default:
+                break;
+        }
+
+        if (!_myjson_query_run_value(&run, &event)) {
+            goto error;
+        }
+    }
+
+error:
+    MYJSON_STACK_DEL(parser->allocator, run.reached);
+    MYJSON_STACK_DEL(parser->allocator, run.frames);
+    return MYJSON_FAILURE;
 };
 
-MYJSON_API int json_event_initialize_array_start(JsonEvent *event) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+MYJSON_API int json_parser_load_projection(JsonParser *parser, JsonDocument *document, JsonQuery *mask) {
+    JsonQueryRun run;
+    JsonEvent event;
 
-    JsonPosition pos = {0, 0, 0};
+    MYJSON_ASSERT(parser);        /**< Non-NULL parser object expected. */
+    MYJSON_ASSERT(document);      /**< Non-NULL document object expected. */
+    MYJSON_ASSERT(mask);          /**< Non-NULL mask object expected. */
+    MYJSON_ASSERT(!parser->push); /**< A push parser cannot skip ahead of its chunks. */
 
-    memset(&(event), 0, sizeof(JsonEvent));
-    event->type = JSON_ARRAY_START_EVENT;
-    event->start_pos = pos;
-    event->end_pos = pos;
+    memset(document, 0, sizeof(JsonDocument));
+    document->allocator = parser->allocator;
+    if (!MYJSON_STACK_INIT(parser, document->allocator, document->nodes, JsonNode)) {
+        return MYJSON_FAILURE;
+    }
 
-    return MYJSON_SUCCESS;
-};
+    memset(&run, 0, sizeof(JsonQueryRun));
+    run.parser = parser;
+    run.query = mask;
+    run.document = document;
 
-MYJSON_API int json_event_initialize_array_end(JsonEvent *event) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+    if (!MYJSON_STACK_INIT(parser, parser->allocator, run.reached, size_t) ||
+        !MYJSON_STACK_INIT(parser, parser->allocator, run.frames, JsonQueryFrame)) {
+        goto error;
+    }
 
-    JsonPosition pos = {0, 0, 0};
+    /* Skip the STREAM-START event. */
+    if (parser->event == JSON_PARSE_STREAM_START_EVENT) {
+        if (!_myjson_parser_load_event(parser, &event)) {
+            goto error;
+        }
+    }
 
-    memset(&(event), 0, sizeof(JsonEvent));
-    event->type = JSON_ARRAY_END_EVENT;
-    event->start_pos = pos;
-    event->end_pos = pos;
+    if (!_myjson_parser_load_event(parser, &event)) {
+        goto error;
+    }
 
-    return MYJSON_SUCCESS;
-};
+    /* The document is left empty at the end of the stream. */
+    if (event.type == JSON_DOCUMENT_START_EVENT) {
+        document->start_pos = event.start_pos;
 
-MYJSON_API int json_event_initialize_object_start(JsonEvent *event) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+        if (!_myjson_parser_load_event(parser, &event) || !_myjson_query_run_value(&run, &event) ||
+            !_myjson_parser_load_event(parser, &event)) {
+            goto error;
+        }
 
-    JsonPosition pos = {0, 0, 0};
+        MYJSON_ASSERT(event.type == JSON_DOCUMENT_END_EVENT); /* DOCUMENT-END follows the root value. */
 
-    memset(&(event), 0, sizeof(JsonEvent));
-    event->type = JSON_OBJECT_START_EVENT;
-    event->start_pos = pos;
-    event->end_pos = pos;
+        document->end_pos = event.end_pos;
+    }
 
+    MYJSON_STACK_DEL(parser->allocator, run.reached);
+    MYJSON_STACK_DEL(parser->allocator, run.frames);
     return MYJSON_SUCCESS;
+
+error:
+    json_event_delete(&run.key);
+    MYJSON_STACK_DEL(parser->allocator, run.reached);
+    MYJSON_STACK_DEL(parser->allocator, run.frames);
+    json_document_delete(document);
+    return MYJSON_FAILURE;
 };
 
-MYJSON_API int json_event_initialize_object_end(JsonEvent *event) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object is expected. */
+#pragma endregion  // Reader
 
-    JsonPosition pos = {0, 0, 0};
+#endif  // MYJSON_DISABLE_READER
 
-    memset(&(event), 0, sizeof(JsonEvent));
-    event->type = JSON_OBJECT_END_EVENT;
-    event->start_pos = pos;
-    event->end_pos = pos;
+#if !defined(MYJSON_DISABLE_WRITER) || !MYJSON_DISABLE_WRITER
 
-    return MYJSON_SUCCESS;
-};
+#pragma region Writer
 
-MYJSON_API void json_event_delete(JsonEvent *event) {
-    MYJSON_ASSERT(event); /**< Non-NULL event object expected. */
-    switch (event->type) {
-        case JSON_SCALAR_EVENT:
-            break;
+MYJSON_API int json_emitter_initialize(JsonEmitter *emitter) {
+    MYJSON_ASSERT(emitter); /**< Non-NULL emitter object expected. */
 
-        case JSON_ARRAY_START_EVENT:
-            break;
+    memset(emitter, 0, sizeof(JsonEmitter));
+    emitter->allocator = _myjson_allocator;
 
-        case JSON_OBJECT_START_EVENT:
-            break;
+    emitter->buffer.start = (JsonChar_t *)_myjson_malloc(emitter->allocator, MYJSON_OUPUT_BUFFER_SIZE);
+    if (!emitter->buffer.start) {
+        goto error;
+    }
+    emitter->buffer.pointer = emitter->buffer.start;
+    emitter->buffer.last = emitter->buffer.start;
+    emitter->buffer.end = emitter->buffer.start + MYJSON_OUPUT_BUFFER_SIZE;
 
-        default:
-            break;
+    if (!MYJSON_STACK_INIT(emitter, emitter->allocator, emitter->states, JsonEmitterEvent)) {
+        goto error;
     }
 
-    memset(event, 0, sizeof(JsonEvent));
-};
+    emitter->state = JSON_EMIT_STREAM_START_EVENT;
+    emitter->kernel = _myjson_kernel_resolve();
 
-#pragma endregion  // Event
+    return MYJSON_SUCCESS;
 
-#pragma region Json
+error:
 
-MYJSON_API int json_document_initialize(JsonDocument *document) {};
-MYJSON_API void json_document_delete(JsonDocument *document) {};
+    _myjson_free(emitter->allocator, emitter->buffer.start, MYJSON_OUPUT_BUFFER_SIZE);
+    MYJSON_STACK_DEL(emitter->allocator, emitter->states);
 
-MYJSON_API JsonNode *json_document_get_root_node(JsonDocument *document) {};
-MYJSON_API JsonNode *json_document_get_node(JsonDocument *document, int index) {};
+    return MYJSON_FAILURE;
+};
 
-MYJSON_API int json_document_add_scalar(JsonDocument *document, const JsonChar_t *value, int length) {};
-MYJSON_API int json_document_add_array(JsonDocument *document) {};
-MYJSON_API int json_document_add_object(JsonDocument *document) {};
+MYJSON_API int json_emitter_emit(JsonEmitter *emitter, JsonEvent *event) {
+    MYJSON_ASSERT(emitter); /**< Non-NULL emitter object expected. */
+    MYJSON_ASSERT(event);   /**< Non-NULL event object expected. */
 
-MYJSON_API int json_document_append_array_item(JsonDocument *document, int array, int item) {};
-MYJSON_API int json_document_append_object_pair(JsonDocument *document, int object, int key, int value) {};
+    int result = emitter->error.type ? MYJSON_FAILURE : _myjson_emitter_state_machine(emitter, event);
 
-MYJSON_API const JsonChar_t *json_document_get_scalar_value(JsonDocument *document, int node_id) {};
-MYJSON_API int json_document_get_scalar_length(JsonDocument *document, int node_id) {};
-MYJSON_API int json_document_array_get_item(JsonDocument *document, int array_node_id, int index) {};
-MYJSON_API int json_document_object_get_value(JsonDocument *document, int object_node_id, const JsonChar_t *key,
-                                              int key_length) {};
+    /* The emitter takes the ownership of the event. */
+    json_event_delete(event);
 
-MYJSON_API int json_document_get_node_by_path(JsonDocument *document, const JsonChar_t **keys, int key_count) {};
-MYJSON_API const JsonChar_t *json_document_get_value_by_path(JsonDocument *document, const JsonChar_t **keys,
-                                                             int key_count) {};
-MYJSON_API int json_document_get_value_length_by_path(JsonDocument *document, const JsonChar_t **keys, int key_count) {
+    return result;
 };
 
-#pragma endregion  // Json
-
-#if !defined(MYJSON_DISABLE_ENCODING) || !MYJSON_DISABLE_ENCODING
+MYJSON_API int json_emitter_delete(JsonEmitter *emitter) {
+    MYJSON_ASSERT(emitter); /**< Non-NULL emitter object expected. */
 
-#pragma region Encoding
+    _myjson_free(emitter->allocator, emitter->buffer.start, emitter->buffer.end - emitter->buffer.start);
+    _myjson_free(emitter->allocator, emitter->raw_buffer.start, emitter->raw_buffer.end - emitter->raw_buffer.start);
+    MYJSON_STACK_DEL(emitter->allocator, emitter->states);
 
-#pragma endregion  // Encoding
+    memset(emitter, 0, sizeof(JsonEmitter));
 
-#endif  // MYJSON_DISABLE_ENCODING
+    return MYJSON_SUCCESS;
+};
 
-#if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
+MYJSON_API void json_emitter_reset(JsonEmitter *emitter) {
+    JsonEmitter kept;
 
-#pragma region Reader
+    MYJSON_ASSERT(emitter); /**< Non-NULL emitter object expected. */
 
-MYJSON_API int json_parser_initialize(JsonParser *parser) {};
-MYJSON_API int json_parser_parse(JsonParser *parser, JsonEvent *event) {};
-MYJSON_API int json_parser_load(JsonParser *parser, JsonDocument *document) {};
-MYJSON_API int json_parser_delete(JsonParser *parser) {};
+    kept = *emitter;
+    memset(emitter, 0, sizeof(JsonEmitter));
 
-MYJSON_API int json_parser_set_input_file(JsonParser *parser, FILE *file) {
-    MYJSON_ASSERT(file);                  /**<  Non-NULL file object expected. */
-    MYJSON_ASSERT(parser);                /**< Non-NULL parser object expected. */
-    MYJSON_ASSERT(!parser->read_handler); /**< You can set the source only once. */
+    emitter->buffer.start = kept.buffer.start;
+    emitter->buffer.pointer = kept.buffer.start;
+    emitter->buffer.last = kept.buffer.start;
+    emitter->buffer.end = kept.buffer.end;
 
-    parser->read_handler = _myjson_file_read_handler;
-    parser->read_handler_data = parser;
+    emitter->raw_buffer.start = kept.raw_buffer.start;
+    emitter->raw_buffer.pointer = kept.raw_buffer.start;
+    emitter->raw_buffer.last = kept.raw_buffer.start;
+    emitter->raw_buffer.end = kept.raw_buffer.end;
 
-    parser->input.file = file;
+    emitter->states.start = kept.states.start;
+    emitter->states.top = kept.states.start;
+    emitter->states.end = kept.states.end;
 
-    return MYJSON_SUCCESS;
+    emitter->state = JSON_EMIT_STREAM_START_EVENT;
+    emitter->kernel = kept.kernel;
+    emitter->allocator = kept.allocator;
 };
 
-MYJSON_API int json_parser_set_input_string(JsonParser *parser, const unsigned char *input, size_t size) {
-    MYJSON_ASSERT(input);                 /**< Non-NULL input string expected. */
-    MYJSON_ASSERT(parser);                /**< Non-NULL parser object expected. */
-    MYJSON_ASSERT(!parser->read_handler); /**< You can set the source only once. */
+#if defined(MYJSON_THREAD_LOCAL)
 
-    parser->read_handler = _myjson_string_read_handler;
-    parser->read_handler_data = parser;
+/* The emitter pool of the thread (see the parser pool). */
+static MYJSON_THREAD_LOCAL struct {
+    JsonEmitter emitters[MYJSON_POOL_SIZE];
+    unsigned acquired;
+    unsigned initialized;
+} _myjson_emitter_pool;
 
-    parser->input.string.start = input;
-    parser->input.string.current = input;
-    parser->input.string.end = input + size;
-};
+#endif
 
-MYJSON_API int json_parser_set_input(JsonParser *parser, JsonReadHandler *handler, void *data) {
-    MYJSON_ASSERT(parser);                /**< Non-NULL parser object expected. */
-    MYJSON_ASSERT(handler);               /**< Non-NULL read handler expected. */
-    MYJSON_ASSERT(!parser->read_handler); /**< You can set the source only once. */
+MYJSON_API JsonEmitter *json_emitter_pool_acquire(void) {
+#if defined(MYJSON_THREAD_LOCAL)
+    unsigned k;
 
-    parser->read_handler = handler;
-    parser->read_handler_data = data;
+    for (k = 0; k < MYJSON_POOL_SIZE; k++) {
+        if (_myjson_emitter_pool.acquired & (1u << k)) {
+            continue;
+        }
 
-    return MYJSON_SUCCESS;
+        if (!(_myjson_emitter_pool.initialized & (1u << k))) {
+            if (!json_emitter_initialize(_myjson_emitter_pool.emitters + k)) {
+                return NULL;
+            }
+            _myjson_emitter_pool.initialized |= 1u << k;
+        }
+
+        _myjson_emitter_pool.acquired |= 1u << k;
+        return _myjson_emitter_pool.emitters + k;
+    }
+#endif
+
+    return NULL;
 };
 
-#pragma endregion  // Reader
+MYJSON_API void json_emitter_pool_release(JsonEmitter *emitter) {
+#if defined(MYJSON_THREAD_LOCAL)
+    unsigned k;
 
-#endif  // MYJSON_DISABLE_READER
+    for (k = 0; k < MYJSON_POOL_SIZE && emitter != _myjson_emitter_pool.emitters + k; k++) {
+    }
 
-#if !defined(MYJSON_DISABLE_WRITER) || !MYJSON_DISABLE_WRITER
+    MYJSON_ASSERT(k < MYJSON_POOL_SIZE &&
+                  (_myjson_emitter_pool.acquired & (1u << k))); /**< An emitter of the pool of the thread expected. */
 
-#pragma region Writer
+    json_emitter_reset(emitter);
+    _myjson_emitter_pool.acquired &= ~(1u << k);
+#else
+    MYJSON_ASSERT(!emitter); /**< An emitter of the pool of the thread expected. */
+#endif
+};
+
+MYJSON_API void json_emitter_pool_clear(void) {
+#if defined(MYJSON_THREAD_LOCAL)
+    unsigned k;
+
+    MYJSON_ASSERT(!_myjson_emitter_pool.acquired); /**< Every emitter of the pool must be released. */
 
-MYJSON_API int json_emitter_initialize(JsonEmitter *emitter) {};
-MYJSON_API int json_emitter_emit(JsonEmitter *emitter, JsonEvent *event) {};
-MYJSON_API int json_emitter_delete(JsonEmitter *emitter) {};
+    for (k = 0; k < MYJSON_POOL_SIZE; k++) {
+        if (_myjson_emitter_pool.initialized & (1u << k)) {
+            json_emitter_delete(_myjson_emitter_pool.emitters + k);
+        }
+    }
+    _myjson_emitter_pool.initialized = 0;
+#endif
+};
 
 MYJSON_API int json_emitter_set_output_file(JsonEmitter *emitter, FILE *file) {
     MYJSON_ASSERT(file);                    /**< Non-NULL file object expected. */
@@ -649,6 +11671,30 @@ MYJSON_API int json_emitter_set_encoding(JsonEmitter *emitter, JsonEncoding enco
     return MYJSON_SUCCESS;
 };
 
+MYJSON_API int json_emitter_set_allocator(JsonEmitter *emitter, const JsonAllocator *allocator) {
+    MYJSON_ASSERT(emitter);                                        /**< Non-NULL emitter object expected. */
+    MYJSON_ASSERT(emitter->state == JSON_EMIT_STREAM_START_EVENT); /**< Set the allocator before the first event. */
+
+    /* The buffers and the stack, allocated at initialization or kept by a reset, go back to the old allocator. */
+    _myjson_free(emitter->allocator, emitter->buffer.start, emitter->buffer.end - emitter->buffer.start);
+    _myjson_free(emitter->allocator, emitter->raw_buffer.start, emitter->raw_buffer.end - emitter->raw_buffer.start);
+    memset(&emitter->buffer, 0, sizeof(emitter->buffer));
+    memset(&emitter->raw_buffer, 0, sizeof(emitter->raw_buffer));
+    MYJSON_STACK_DEL(emitter->allocator, emitter->states);
+
+    emitter->allocator = allocator ? allocator : _myjson_allocator;
+
+    emitter->buffer.start = (JsonChar_t *)_myjson_malloc(emitter->allocator, MYJSON_OUPUT_BUFFER_SIZE);
+    if (!emitter->buffer.start) {
+        return MYJSON_MEMORY_ERROR(emitter);
+    }
+    emitter->buffer.pointer = emitter->buffer.start;
+    emitter->buffer.last = emitter->buffer.start;
+    emitter->buffer.end = emitter->buffer.start + MYJSON_OUPUT_BUFFER_SIZE;
+
+    return MYJSON_STACK_INIT(emitter, emitter->allocator, emitter->states, JsonEmitterEvent);
+};
+
 MYJSON_API int json_emitter_open(JsonEmitter *emitter) {
     MYJSON_ASSERT(emitter);          /**< Non-NULL emitter object is required. */
     MYJSON_ASSERT(!emitter->opened); /**< Emitter should not be opened yet. */
@@ -656,7 +11702,7 @@ MYJSON_API int json_emitter_open(JsonEmitter *emitter) {
     JsonEvent event;
     JsonPosition pos = {0, 0, 0};
 
-    memset(&(event), 0, sizeof(JsonEvent));
+    memset(&event, 0, sizeof(JsonEvent));
     event.type = JSON_STREAM_START_EVENT;
     event.start_pos = pos;
     event.end_pos = pos;
@@ -682,7 +11728,7 @@ MYJSON_API int json_emitter_close(JsonEmitter *emitter) {
     JsonEvent event;
     JsonPosition pos = {0, 0, 0};
 
-    memset(&(event), 0, sizeof(JsonEvent));
+    memset(&event, 0, sizeof(JsonEvent));
     event.type = JSON_STREAM_END_EVENT;
     event.start_pos = pos;
     event.end_pos = pos;
@@ -696,7 +11742,29 @@ MYJSON_API int json_emitter_close(JsonEmitter *emitter) {
     return MYJSON_SUCCESS;
 };
 
-MYJSON_API int json_emitter_flush(JsonEmitter *emitter) {};
+MYJSON_API int json_emitter_flush(JsonEmitter *emitter) {
+    MYJSON_ASSERT(emitter);                /**< Non-NULL emitter object is expected. */
+    MYJSON_ASSERT(emitter->write_handler); /**< Write handler must be set. */
+
+    /* Check if the buffer is empty. */
+    if (emitter->buffer.start == emitter->buffer.pointer) {
+        return MYJSON_SUCCESS;
+    }
+
+    /* UTF-16 and UTF-32 are transcoded through the raw buffer. */
+    if (emitter->encoding != JSON_ANY_ENCODING && emitter->encoding != JSON_UTF8_ENCODING) {
+        return _myjson_emitter_encode_buffer(emitter);
+    }
+
+    if (!emitter->write_handler(emitter->write_handler_data, emitter->buffer.start,
+                                emitter->buffer.pointer - emitter->buffer.start)) {
+        return _myjson_emitter_set_writer_error(emitter, "write error");
+    }
+
+    emitter->buffer.pointer = emitter->buffer.start;
+
+    return MYJSON_SUCCESS;
+};
 
 #pragma endregion  // Writer
 
@@ -102,6 +102,7 @@
 #include <ctype.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -113,6 +114,7 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -177,6 +179,7 @@
 
 #define MYJSON_SUCCESS 1
 #define MYJSON_FAILURE 0
+#define MYJSON_NEED_MORE_INPUT 2 /**< A push parser waits for the next chunk (see @c json_parser_feed). */
 
 //-----------------------------------------------------------------------------
 // [SECTION] Function Macros
@@ -534,6 +537,19 @@
 #endif
 #endif
 
+/** thread-local storage for compiler */
+#ifndef MYJSON_THREAD_LOCAL
+#if MYJSON_COMPILER_IS(MSVC)
+#define MYJSON_THREAD_LOCAL __declspec(thread)
+#elif MYJSON_CPP_VERSION >= 201103L
+#define MYJSON_THREAD_LOCAL thread_local
+#elif MYJSON_STDC_VERSION >= 201112L && !defined(__STDC_NO_THREADS__)
+#define MYJSON_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define MYJSON_THREAD_LOCAL __thread
+#endif
+#endif
+
 /** align for compiler */
 #ifndef MYJSON_ALIGN
 #if MYJSON_COMPILER_SINCE(MSVC, 13, 0, 0)
@@ -717,6 +733,26 @@ typedef struct JsonPosition {
     size_t line;   /**< The position line. */
 } JsonPosition;
 
+/**
+ * The allocator structure: the functions the library gets its memory from.
+ *
+ * Every block is freed (or reallocated) with the size it was allocated
+ * with, for the allocators that do not keep the sizes themselves.  An
+ * allocator must outlive the objects, events and tokens allocated with it.
+ */
+typedef struct JsonAllocator {
+    /** Allocate @a size bytes, aligned for any type; @c NULL on failure. */
+    void *(*allocate)(void *data, size_t size);
+
+    /** Resize a block of @a old_size bytes to @a size bytes; @c NULL on failure (the block is left alone). */
+    void *(*reallocate)(void *data, void *pointer, size_t old_size, size_t size);
+
+    /** Free a block of @a size bytes. */
+    void (*deallocate)(void *data, void *pointer, size_t size);
+
+    void *data; /**< A pointer for passing to the functions. */
+} JsonAllocator;
+
 /**
  * @enum JsonValueType
  * @brief Enumerates types for JSON value.
@@ -732,10 +768,120 @@ typedef enum JsonValueType {
     JSON_INTEGER,  /**< Number value (signed integer) */
     JSON_BOOLOEAN, /**< Boolean value */
 
+    JSON_PACKED_ARRAY, /**< Array of numbers packed in one buffer (see @c JsonPackedType) */
+
 } JsonValueType;
 
+/**
+ * @enum JsonPackedType
+ * @brief Enumerates types for the values of a packed array.
+ */
+typedef enum JsonPackedType {
+
+    JSON_PACKED_INT32,  /**< @c int32_t values */
+    JSON_PACKED_INT64,  /**< @c int64_t values */
+    JSON_PACKED_FLOAT,  /**< @c float values */
+    JSON_PACKED_DOUBLE, /**< @c double values */
+
+} JsonPackedType;
+
 /** @} */
 
+/**
+ * @brief Definition of Unicode encoding types
+ *
+ * The parser detects the input encoding from its byte order mark, or else
+ * from the zero bytes around its first two characters, and transcodes UTF-16
+ * and UTF-32 to UTF-8.  The emitter transcodes its output to the encoding set
+ * with @c json_emitter_set_encoding (or the one of the STREAM-START event).
+ */
+typedef enum JsonEncoding {
+    JSON_ANY_ENCODING,     /** Let the parser choose the encoding. */
+    JSON_UTF8_ENCODING,    /** The default UTF-8 encoding. */
+    JSON_UTF16LE_ENCODING, /** The UTF-16-LE encoding with BOM. */
+    JSON_UTF16BE_ENCODING, /** The UTF-16-BE encoding with BOM. */
+    JSON_UTF32LE_ENCODING, /** The UTF-32-LE encoding with BOM. */
+    JSON_UTF32BE_ENCODING, /** The UTF-32-BE encoding with BOM. */
+} JsonEncoding;
+
+/**
+ * @brief Definition of the SIMD kernels used by the parser and the emitter.
+ *
+ * The best kernel supported by the CPU is selected at runtime, unless one is
+ * forced with @c json_kernel_select or the @c MYJSON_KERNEL environment
+ * variable (@c fallback, @c sse42, @c avx2 or @c avx512).
+ */
+typedef enum JsonKernelType {
+    JSON_AUTO_KERNEL,     /** Let the library choose the kernel. */
+    JSON_FALLBACK_KERNEL, /** The portable (SWAR) kernel. */
+    JSON_SSE42_KERNEL,    /** The SSE4.2 kernel. */
+    JSON_AVX2_KERNEL,     /** The AVX2 kernel. */
+    JSON_AVX512_KERNEL,   /** The AVX-512BW kernel. */
+} JsonKernelType;
+
+/**
+ * @brief Definition of the scalar value flags.
+ *
+ * Scalars parsed from a string set with @c json_parser_set_input_string are
+ * borrowed: they point into the caller's input, are not NUL-terminated, and
+ * stay valid for as long as the input does (even after the event and the
+ * parser are deleted).  Strings with escape sequences are borrowed verbatim;
+ * decode them with @c json_string_unescape.  With
+ * @c json_parser_set_input_mutable_string, strings are unescaped and
+ * NUL-terminated in place instead, and are never flagged as escaped.  Other
+ * scalars, and every scalar of a UTF-16 or UTF-32 input (which is
+ * transcoded), are owned by the event, unescaped, NUL-terminated, and freed by
+ * @c json_event_delete.
+ */
+typedef enum JsonScalarFlag {
+    JSON_BORROWED_FLAG = 1, /** The value points into the caller's input. */
+    JSON_ESCAPED_FLAG = 2,  /** The value still contains escape sequences. */
+    JSON_UNSIGNED_FLAG = 4, /** The integer is above @c INT64_MAX (see @c JsonNumber). */
+} JsonScalarFlag;
+
+/**
+ * @brief Definition of the stream flags.
+ *
+ * See @c json_parser_set_stream_flags.
+ */
+typedef enum JsonStreamFlag {
+    JSON_MULTI_DOCUMENT_FLAG = 1, /** Parse a stream of concatenated or newline-delimited values. */
+    JSON_RESYNC_FLAG = 2,         /** Skip a malformed line after an error, and carry on with the next one. */
+} JsonStreamFlag;
+
+/**
+ * @brief Definition of the packing flags.
+ *
+ * See @c json_parser_set_pack_flags.
+ */
+typedef enum JsonPackFlag {
+    JSON_PACK_ARRAYS = 1,  /** Load an array of numbers as one @c JSON_PACKED_ARRAY node. */
+    JSON_PACK_FLOAT32 = 2, /** Pack the arrays with a fraction or an exponent as @c float values. */
+} JsonPackFlag;
+
+/**
+ * @brief Definition of the memory-mapped input flags.
+ *
+ * See @c json_parser_set_input_mmap.
+ */
+typedef enum JsonMapFlag {
+    JSON_MAP_HUGE_PAGES = 1, /** Ask for transparent huge pages (ignored where unsupported). */
+} JsonMapFlag;
+
+/**
+ * @brief Definition of the decoded value of a number.
+ *
+ * Integers are decoded exactly over the full @c int64_t and @c uint64_t
+ * ranges (the latter flagged with @c JSON_UNSIGNED_FLAG); other integers and
+ * the numbers with a fraction or an exponent are decoded as correctly rounded
+ * doubles, regardless of the locale.
+ */
+typedef union JsonNumber {
+    int64_t integer;   /** The value of a @c JSON_INTEGER scalar. */
+    uint64_t uinteger; /** The value of a @c JSON_INTEGER scalar flagged with @c JSON_UNSIGNED_FLAG. */
+    double real;       /** The value of a @c JSON_DOUBLE scalar. */
+} JsonNumber;
+
 /**
  * @enum JsonEventType
  * @brief Enumerates types for JSON event.
@@ -769,6 +915,15 @@ typedef struct JsonEvent {
             JsonEncoding encoding;
         } stream_start;
 
+        /** The scalar parameters (for @c JSON_SCALAR_EVENT). */
+        struct {
+            JsonChar_t *value;  /** The scalar value. */
+            size_t length;      /** The length of the scalar value. */
+            JsonValueType type; /** The scalar type. */
+            int flags;          /** The scalar flags (@c JsonScalarFlag). */
+            JsonNumber number;  /** The decoded value of a number. */
+        } scalar;
+
     } data;
 
     JsonPosition start_pos; /** The beginning of the event. */
@@ -776,32 +931,246 @@ typedef struct JsonEvent {
 
 } JsonEvent;
 
-typedef struct JsonDocument {
-} JsonDocument;
+/** An element of an array node (a node id). */
+typedef int JsonNodeItem;
+
+/** An element of an object node. */
+typedef struct JsonNodePair {
+    int key;   /** The key (a string node id, shared by the pairs of a document with an atom table). */
+    int value; /** The value node id. */
+} JsonNodePair;
 
+/**< The node structure. */
 typedef struct JsonNode {
+    JsonValueType type; /** The node type. */
+
+    /** The node data. */
+    union {
+        /** The scalar parameters (for any type but @c JSON_ARRAY and @c JSON_OBJECT). */
+        struct {
+            JsonChar_t *value; /** The scalar value. */
+            size_t length;     /** The length of the scalar value. */
+            int flags;         /** The scalar flags (@c JsonScalarFlag, never escaped). */
+            JsonNumber number; /** The decoded value of a number. */
+        } scalar;
+
+        /** The array parameters (for @c JSON_ARRAY). */
+        struct {
+            /** The stack of array items. */
+            struct {
+                JsonNodeItem *start; /** The beginning of the stack. */
+                JsonNodeItem *end;   /** The end of the stack. */
+                JsonNodeItem *top;   /** The top of the stack. */
+            } items;
+        } array;
+
+        /** The object parameters (for @c JSON_OBJECT). */
+        struct {
+            /** The stack of object pairs. */
+            struct {
+                JsonNodePair *start; /** The beginning of the stack. */
+                JsonNodePair *end;   /** The end of the stack. */
+                JsonNodePair *top;   /** The top of the stack. */
+            } pairs;
+        } object;
+
+        /** The packed array parameters (for @c JSON_PACKED_ARRAY). */
+        struct {
+            void *values;        /** The values, aligned for their type. */
+            size_t length;       /** The number of values. */
+            JsonPackedType type; /** The type of the values. */
+        } packed;
+
+    } data;
+
+    JsonPosition start_pos; /** The beginning of the node. */
+    JsonPosition end_pos;   /** The end of the node. */
+
 } JsonNode;
 
-#if !defined(MYJSON_DISABLE_ENCODING) || !MYJSON_DISABLE_ENCODING
+/** A chunk of a document arena (its memory follows it). */
+typedef struct JsonArenaChunk {
+    struct JsonArenaChunk *next; /** The next chunk of the list. */
+    size_t size;                 /** The size of the memory. */
+} JsonArenaChunk;
+
+/** An atom: a string stored once in an atom table. */
+typedef struct JsonAtom {
+    JsonChar_t *value; /** The string (NUL-terminated). */
+    size_t length;     /** The length of the string. */
+    uint32_t hash;     /** The hash of the string. */
+} JsonAtom;
 
 /**
- * @brief Definition of Unicode encoding types
+ * The atom table structure: a set of strings (the keys of objects), each
+ * stored once.
+ *
+ * Atoms are referred to by their id, starting from @c 1; @c 0 means no atom.
+ * The ids and the strings stay valid until the table is deleted.  A table may
+ * be shared by several documents (see @c json_document_set_atom_table), but
+ * not used by several threads at once.
  */
-typedef enum JsonEncoding {
-    JSON_ANY_ENCODING,     /** Let the parser choose the encoding. */
-    JSON_UTF8_ENCODING,    /** The default UTF-8 encoding. */
-    JSON_UTF16LE_ENCODING, /** The UTF-16-LE encoding with BOM. */
-    JSON_UTF16BE_ENCODING, /** The UTF-16-BE encoding with BOM. */
-    JSON_UTF32LE_ENCODING, /** The UTF-32-LE encoding with BOM. */
-    JSON_UTF32BE_ENCODING, /** The UTF-32-BE encoding with BOM. */
-} JsonEncoding;
+typedef struct JsonAtomTable {
+    /** The atoms, by id. */
+    struct {
+        JsonAtom *start; /** The beginning of the stack. */
+        JsonAtom *end;   /** The end of the stack. */
+        JsonAtom *top;   /** The top of the stack. */
+    } atoms;
 
-#endif  // MYJSON_DISABLE_ENCODING
+    /** The hash index: an atom id per slot, @c 0 for a free slot. */
+    struct {
+        int *start; /** The beginning of the slots (a power of two of them). */
+        int *end;   /** The end of the slots. */
+    } slots;
+
+    /** The strings of the atoms. */
+    struct {
+        JsonArenaChunk *chunks; /** The chunks, newest first. */
+        JsonChar_t *pointer;    /** The free memory of the newest chunk. */
+        JsonChar_t *end;        /** The end of the newest chunk. */
+    } strings;
+
+    const JsonAllocator *allocator; /** The allocator of the atoms and their strings. */
+
+} JsonAtomTable;
+
+/**
+ * The document structure.
+ *
+ * Nodes are referred to by their id, starting from @c 1 for the root node;
+ * @c 0 means no node.  The strings, items, pairs and packed values of the
+ * nodes are bump-allocated from an arena of chunks, which the document frees
+ * at once (or keeps for the next load, see @c json_document_reset).
+ */
+typedef struct JsonDocument {
+    /** The document nodes. */
+    struct {
+        JsonNode *start; /** The beginning of the stack. */
+        JsonNode *end;   /** The end of the stack. */
+        JsonNode *top;   /** The top of the stack. */
+    } nodes;
+
+    /** The arena of the node data. */
+    struct {
+        JsonArenaChunk *chunks; /** The chunks in use, newest first. */
+        JsonArenaChunk *spare;  /** The chunks kept by a reset, largest first. */
+        JsonChar_t *pointer;    /** The free memory of the newest chunk. */
+        JsonChar_t *end;        /** The end of the newest chunk. */
+    } arena;
+
+    const JsonAllocator *allocator; /** The allocator of the nodes and the arena. */
+
+    JsonAtomTable *atoms; /** The atom table of the keys, or @c NULL (see @c json_document_set_atom_table). */
+
+    /** The key node of each atom, by atom id (@c 0 if the key is not used yet); kept in the arena. */
+    struct {
+        int *start; /** The beginning of the map. */
+        int *end;   /** The end of the map. */
+    } keys;
+
+    JsonPosition start_pos; /** The beginning of the document. */
+    JsonPosition end_pos;   /** The end of the document. */
+
+} JsonDocument;
+
+/**
+ * @enum JsonTapeType
+ * @brief Enumerates the types of the values of a tape (the tag of their first word).
+ */
+typedef enum JsonTapeType {
+
+    JSON_TAPE_ARRAY = '[',      /**< An array; the word holds the index of its end. */
+    JSON_TAPE_ARRAY_END = ']',  /**< The end of an array; the word holds the index of its start. */
+    JSON_TAPE_OBJECT = '{',     /**< An object; the word holds the index of its end. */
+    JSON_TAPE_OBJECT_END = '}', /**< The end of an object; the word holds the index of its start. */
+    JSON_TAPE_STRING = '"',     /**< A string; the word holds its offset in the strings. */
+    JSON_TAPE_INT64 = 'l',      /**< An @c int64_t, in the next word. */
+    JSON_TAPE_UINT64 = 'u',     /**< A @c uint64_t above @c INT64_MAX, in the next word. */
+    JSON_TAPE_DOUBLE = 'd',     /**< A @c double, in the next word. */
+    JSON_TAPE_TRUE = 't',       /**< @c true. */
+    JSON_TAPE_FALSE = 'f',      /**< @c false. */
+    JSON_TAPE_NULL = 'n',       /**< @c null. */
+
+} JsonTapeType;
+
+/**
+ * The tape structure: a document as a flat array of 64-bit words.
+ *
+ * Every value is one word (two for a number), tagged with its
+ * @c JsonTapeType in the top byte; the members of an object are its keys
+ * and values, in turn.  An array or object word holds the index of the
+ * matching end word, so a whole value is skipped at once (see
+ * @c json_tape_next).  The strings are kept in a side buffer, each one as
+ * its length (a @c uint64_t) followed by its bytes and a NUL.  The root
+ * value is at index @c 0.
+ */
+typedef struct JsonTape {
+    /** The words. */
+    struct {
+        uint64_t *start; /** The beginning of the stack. */
+        uint64_t *end;   /** The end of the stack. */
+        uint64_t *top;   /** The top of the stack. */
+    } words;
+
+    /** The strings. */
+    struct {
+        JsonChar_t *start; /** The beginning of the stack. */
+        JsonChar_t *end;   /** The end of the stack. */
+        JsonChar_t *top;   /** The top of the stack. */
+    } strings;
+
+    const JsonAllocator *allocator; /** The allocator of the words and strings (the parser's). */
+
+} JsonTape;
 
 #if !defined(MYJSON_DISABLE_READER) || !MYJSON_DISABLE_READER
 
 typedef int JsonReadHandler(void *data, unsigned char *buffer, size_t size, size_t *size_read);
 
+/**
+ * The prototype of a document handler (see @c json_parse_ndjson_parallel).
+ *
+ * @param[in,out]   data        A pointer to an application data specified by
+ *                              @c json_parse_ndjson_parallel.
+ * @param[in]       document    A loaded document, deleted after the call.
+ * @param[in]       offset      The offset of the document in the input.
+ *
+ * @returns @c 1 to carry on, @c 0 to stop the parse.
+ */
+typedef int JsonDocumentHandler(void *data, JsonDocument *document, size_t offset);
+
+/**
+ * The prototype of a query match handler (see @c json_parser_query).
+ *
+ * @param[in,out]   data        A pointer to an application data specified by
+ *                              @c json_parser_query.
+ * @param[in]       expression  The number of the expression matched (in the
+ *                              order they were added to the query).
+ * @param[in]       document    The loaded value holding the match, deleted
+ *                              after the call.
+ * @param[in]       node_id     The node matched in the document.
+ *
+ * @returns @c 1 to carry on, @c 0 to stop the parse.
+ */
+typedef int JsonQueryHandler(void *data, size_t expression, JsonDocument *document, int node_id);
+
+/**
+ * The read-ahead input structure.
+ *
+ * Keeps @c count chunks of a file descriptor in flight while the parser
+ * consumes the previous ones, with io_uring on Linux, and a background thread
+ * elsewhere (or for descriptors that cannot be read at an offset, like pipes).
+ * Set it as the parser input with @c json_read_ahead_handler.
+ */
+typedef struct JsonReadAhead {
+    int fd;        /**< The file descriptor. */
+    size_t count;  /**< The number of chunks in flight. */
+    size_t size;   /**< The size of a chunk (in bytes). */
+    int io_uring;  /**< Are the chunks read with io_uring (rather than a thread)? */
+    void *state;   /**< The private I/O state. */
+} JsonReadAhead;
+
 /**
  * @enum JsonParseEvent
  * @brief Enumerates types for JSON parse event.
@@ -812,7 +1181,20 @@ typedef enum JsonParseEvent {
     JSON_PARSE_ARRAY_START_EVENT,  /** A ARRAY-START event. */
     JSON_PARSE_ARRAY_END_EVENT,    /** A ARRAY-END event. */
     JSON_PARSE_OBJECT_START_EVENT, /** A OBJECT-START event. */
-    JSON_PARSE_OBJECT_END_EVENT    /** A OBJECT-END event. */
+    JSON_PARSE_OBJECT_END_EVENT,   /** A OBJECT-END event. */
+
+    JSON_PARSE_STREAM_START_EVENT,     /** Expect STREAM-START. */
+    JSON_PARSE_DOCUMENT_START_EVENT,   /** Expect DOCUMENT-START. */
+    JSON_PARSE_DOCUMENT_END_EVENT,     /** Expect DOCUMENT-END. */
+    JSON_PARSE_STREAM_END_EVENT,       /** Expect STREAM-END. */
+    JSON_PARSE_VALUE_EVENT,            /** Expect a value. */
+    JSON_PARSE_ARRAY_FIRST_ITEM_EVENT, /** Expect the first item of an array or ARRAY-END. */
+    JSON_PARSE_ARRAY_ITEM_EVENT,       /** Expect a value separator or ARRAY-END. */
+    JSON_PARSE_OBJECT_FIRST_KEY_EVENT, /** Expect the first key of an object or OBJECT-END. */
+    JSON_PARSE_OBJECT_KEY_EVENT,       /** Expect a value separator or OBJECT-END. */
+    JSON_PARSE_OBJECT_VALUE_EVENT,     /** Expect a name separator and an object value. */
+    JSON_PARSE_SKIP_LINE_EVENT,        /** Skip the rest of a malformed line, then expect DOCUMENT-START. */
+    JSON_PARSE_END_EVENT               /** Expect nothing. */
 
 } JsonParseEvent;
 
@@ -844,6 +1226,8 @@ typedef struct JsonToken {
     struct {
         JsonChar_t *value; /**< The value. */
         size_t length;     /**< The length of the value. */
+        int flags;         /**< The value flags (@c JsonScalarFlag). */
+        JsonNumber number; /**< The decoded value (for number tokens). */
     } data;
 
     JsonPosition start_pos; /**< The beginning of the token. */
@@ -891,6 +1275,29 @@ typedef struct JsonParser {
 
     int eof; /** EOF flag */
 
+    int in_place; /**< Is the input string scanned in place (scalars borrow from it)? */
+    int in_situ;  /**< May strings be unescaped in place (the input is mutable)? */
+
+    int stream_flags; /**< The stream flags (see @c JsonStreamFlag). */
+
+    size_t thread_count; /**< The number of threads loading a large body (see @c json_parser_set_thread_count). */
+
+    int pack_flags; /**< The packing flags (see @c JsonPackFlag). */
+
+    int push;     /**< Is the input fed with @c json_parser_feed? */
+    int last_fed; /**< Has the last chunk been fed? */
+    int waiting;  /**< Has the push parser run out of input before the last chunk? */
+
+    /** The memory-mapped input file, unmapped by @c json_parser_delete. */
+    struct {
+        void *start; /**< The beginning of the mapping. */
+        size_t size; /**< The length of the mapping (in bytes). */
+#if MYJSON_PLATFORM_IS(WINDOWS)
+        void *handle; /**< The file mapping object. */
+#endif
+
+    } mapping;
+
     /** The working buffer. */
     struct {
         JsonChar_t *pointer; /** The current position of the buffer. */
@@ -937,9 +1344,55 @@ typedef struct JsonParser {
     } tokens;
 
     size_t tokens_parsed; /** The number of tokens fetched from the queue. */
+    size_t token_line;    /**< The line of the end of the last token fetched from the queue. */
     int token_available;  /** Does the tokens queue contain a token ready for
                              dequeueing. */
 
+    const struct JsonKernel *kernel; /**< The kernel selected at initialization. */
+    const JsonAllocator *allocator;  /**< The allocator of the parser, its tokens and its events. */
+
+    /**
+     * The structural index.
+     *
+     * Offsets (from @c buffer.start) of every structural character, string
+     * quote and scalar start, filled 64 bytes at a time ahead of the scanner.
+     * Each bracket is linked to its matching one as it is indexed, so that a
+     * container is skipped at once.
+     */
+    struct {
+        size_t *start; /**< The beginning of the index. */
+        size_t *head;  /**< The next structural to scan. */
+        size_t *tail;  /**< The end of the indexed structurals. */
+        size_t *end;   /**< The end of the index. */
+
+        size_t *matches; /**< For each opening bracket of the index, the number of structurals up to its
+                              closing one (0 if not indexed yet). */
+        size_t base;     /**< The number of structurals dropped from the beginning of the index. */
+
+        /** The numbers of the opening brackets not closed yet, at the end of the index. */
+        struct {
+            size_t *start; /**< The beginning of the stack. */
+            size_t *end;   /**< The end of the stack. */
+            size_t *top;   /**< The top of the stack. */
+
+        } opens;
+
+        /** The numbers of the closing brackets of the containers opened by the scanner (0 if not indexed yet). */
+        struct {
+            size_t *start; /**< The beginning of the stack. */
+            size_t *end;   /**< The end of the stack. */
+            size_t *top;   /**< The top of the stack. */
+
+        } closes;
+
+        size_t indexed;   /**< The number of buffer bytes already indexed. */
+        uint64_t escaped; /**< Is the first byte of the next block escaped? */
+        uint64_t string;  /**< Does the next block start inside a string (all ones)? */
+        uint64_t scalar;  /**< Did the last block end inside a scalar? */
+        uint32_t utf8;    /**< The last 4 bytes indexed, for the UTF-8 checks. */
+
+    } structurals;
+
     /**
      * @}
      */
@@ -967,12 +1420,107 @@ typedef struct JsonParser {
 
     } marks;
 
+    /** The stack of the arrays and objects being loaded (their node ids). */
+    struct {
+        int *start; /** The beginning of the stack. */
+        int *end;   /** The end of the stack. */
+        int *top;   /** The top of the stack. */
+
+    } parents;
+
     /**
      * @}
      */
 
 } JsonParser;
 
+/**
+ * The cursor states.
+ */
+typedef enum JsonCursorState {
+    JSON_CURSOR_VALUE, /**< At a value, not read yet. */
+    JSON_CURSOR_AFTER, /**< After a value, read or skipped. */
+    JSON_CURSOR_END,   /**< At the end of a container (or of the input). */
+} JsonCursorState;
+
+/**
+ * The cursor structure.
+ *
+ * All members are internal.  Manage the structure using the @c json_cursor_
+ * family of functions.
+ */
+typedef struct JsonCursor {
+    JsonParser *parser;    /**< The parser holding the input and its structural index. */
+    JsonCursorState state; /**< The cursor state. */
+
+    /** The stack of the containers entered (their opening bracket). */
+    struct {
+        JsonChar_t *start; /** The beginning of the stack. */
+        JsonChar_t *end;   /** The end of the stack. */
+        JsonChar_t *top;   /** The top of the stack. */
+    } containers;
+
+    /** The key of the current member (in an object). */
+    struct {
+        const JsonChar_t *value; /** The key, without its quotes. */
+        size_t length;           /** The length of the key. */
+        int flags;               /** The scalar flags of the key. */
+    } key;
+
+} JsonCursor;
+
+/**
+ * A step of a compiled query: a node of the tree merging the expressions.
+ */
+typedef struct JsonQueryStep {
+    JsonChar_t *key;   /**< The key of a member, or @c NULL. */
+    size_t key_length; /**< The length of the key. */
+    size_t index;      /**< The index of an item, or @c (size_t)-1. */
+    int wildcard;      /**< Does the step take any member or item? */
+
+    size_t child;   /**< The first step following this one, or @c 0. */
+    size_t sibling; /**< The next step following the same parent, or @c 0. */
+    size_t match;   /**< The first match ending at this step (plus one), or @c 0. */
+} JsonQueryStep;
+
+/**
+ * An expression ending at a step of a compiled query.
+ */
+typedef struct JsonQueryMatch {
+    size_t expression; /**< The number of the expression. */
+    size_t next;       /**< The next match ending at the same step (plus one), or @c 0. */
+} JsonQueryMatch;
+
+/**
+ * The compiled query structure.
+ *
+ * All members are internal.  Manage the structure using the @c json_query_
+ * family of functions.
+ */
+typedef struct JsonQuery {
+    /** The steps, the first one being the root value. */
+    struct {
+        JsonQueryStep *start; /** The beginning of the stack. */
+        JsonQueryStep *end;   /** The end of the stack. */
+        JsonQueryStep *top;   /** The top of the stack. */
+    } steps;
+
+    /** The expressions ending at the steps. */
+    struct {
+        JsonQueryMatch *start; /** The beginning of the stack. */
+        JsonQueryMatch *end;   /** The end of the stack. */
+        JsonQueryMatch *top;   /** The top of the stack. */
+    } matches;
+
+    size_t count; /**< The number of expressions. */
+
+    JsonError_t error;   /**< Error type. */
+    size_t error_offset; /**< The offset of the problem in the expression. */
+
+    const JsonAllocator *allocator; /**< The allocator at initialization. */
+
+} JsonQuery;
+
 #endif  // MYJSON_DISABLE_READER
 
 #if !defined(MYJSON_DISABLE_WRITER) || !MYJSON_DISABLE_WRITER
@@ -989,7 +1537,18 @@ typedef enum JsonEmitterEvent {
     JSON_EMIT_ARRAY_START_EVENT,  /** A ARRAY-START event. */
     JSON_EMIT_ARRAY_END_EVENT,    /** A ARRAY-END event. */
     JSON_EMIT_OBJECT_START_EVENT, /** A OBJECT-START event. */
-    JSON_EMIT_OBJECT_END_EVENT    /** A OBJECT-END event. */
+    JSON_EMIT_OBJECT_END_EVENT,   /** A OBJECT-END event. */
+
+    JSON_EMIT_STREAM_START_EVENT,     /** Expect STREAM-START. */
+    JSON_EMIT_DOCUMENT_START_EVENT,   /** Expect DOCUMENT-START or STREAM-END. */
+    JSON_EMIT_DOCUMENT_END_EVENT,     /** Expect DOCUMENT-END. */
+    JSON_EMIT_VALUE_EVENT,            /** Expect a value. */
+    JSON_EMIT_ARRAY_FIRST_ITEM_EVENT, /** Expect the first item of an array or ARRAY-END. */
+    JSON_EMIT_ARRAY_ITEM_EVENT,       /** Expect an array item or ARRAY-END. */
+    JSON_EMIT_OBJECT_FIRST_KEY_EVENT, /** Expect the first key of an object or OBJECT-END. */
+    JSON_EMIT_OBJECT_KEY_EVENT,       /** Expect an object key or OBJECT-END. */
+    JSON_EMIT_OBJECT_VALUE_EVENT,     /** Expect an object value. */
+    JSON_EMIT_END_EVENT               /** Expect nothing. */
 
 } JsonEmitterEvent;
 
@@ -1086,6 +1645,9 @@ typedef struct JsonEmitter {
     int line;   /**< The current line. */
     int column; /**< The current column. */
 
+    const struct JsonKernel *kernel; /**< The kernel selected at initialization. */
+    const JsonAllocator *allocator;  /**< The allocator of the emitter buffers. */
+
     /**
      * @}
      */
@@ -1120,6 +1682,61 @@ typedef struct JsonEmitter {
 extern "C" {
 #endif  //__cplusplus
 
+#pragma region Allocator
+
+/**
+ * Set the allocator of the parsers, emitters, documents and queries
+ * initialized afterwards.
+ *
+ * The allocator is not copied: it must outlive everything allocated with
+ * it.  Set it before the threads using the library are started.
+ *
+ * @param[in]       allocator   The allocator, or @c NULL to restore the
+ *                              default one (@c malloc, @c realloc and
+ *                              @c free).
+ */
+MYJSON_API void json_allocator_set(const JsonAllocator *allocator);
+
+/**
+ * Get the allocator of the objects initialized afterwards.
+ */
+MYJSON_API const JsonAllocator *json_allocator_get(void);
+
+#pragma endregion  // Allocator
+
+#pragma region Kernel
+
+/**
+ * Force the kernel used by the parsers and emitters initialized afterwards.
+ *
+ * Call it before any parser or emitter is created: a parser initialized on
+ * another thread at the same time may still get the previous kernel.
+ *
+ * @param[in]       kernel  The kernel, or @c JSON_AUTO_KERNEL to restore the
+ *                          runtime selection.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if the kernel is not
+ * supported by this CPU or build.
+ */
+MYJSON_API int json_kernel_select(JsonKernelType kernel);
+
+/**
+ * Get the kernel used by the parsers and emitters initialized afterwards.
+ */
+MYJSON_API JsonKernelType json_kernel_get_selected(void);
+
+/**
+ * Check if a kernel is supported by this CPU and build.
+ */
+MYJSON_API int json_kernel_is_supported(JsonKernelType kernel);
+
+/**
+ * Get the name of a kernel (as accepted by @c MYJSON_KERNEL).
+ */
+MYJSON_API const char *json_kernel_get_name(JsonKernelType kernel);
+
+#pragma endregion  // Kernel
+
 #pragma region Event
 
 MYJSON_API int json_event_initialize_stream_start(JsonEvent *event, JsonEncoding encoding);
@@ -1140,40 +1757,273 @@ MYJSON_API int json_event_initialize_object_end(JsonEvent *event);
  */
 MYJSON_API void json_event_delete(JsonEvent *event);
 
+/**
+ * Decode the escape sequences of a string value (see @c JSON_ESCAPED_FLAG).
+ *
+ * @param[in]       value           The string value, without the quotes.
+ * @param[in]       length          The length of the value.
+ * @param[out]      output          A buffer of at least @a length bytes.
+ * @param[out]      output_length   The length of the decoded string.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on an invalid escape.
+ */
+MYJSON_API int json_string_unescape(const JsonChar_t *value, size_t length, JsonChar_t *output,
+                                    size_t *output_length);
+
 #pragma endregion  // Event
 
 #pragma region Json
 
-MYJSON_API int json_document_initialize(JsonDocument *document);
-MYJSON_API void json_document_delete(JsonDocument *document);
+/**
+ * Initialize an atom table, with the allocator set by @c json_allocator_set.
+ *
+ * @param[out]      table   An empty atom table object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_atom_table_initialize(JsonAtomTable *table);
 
-MYJSON_API JsonNode *json_document_get_root_node(JsonDocument *document);
-MYJSON_API JsonNode *json_document_get_node(JsonDocument *document, int index);
+/**
+ * Destroy an atom table: free its atoms and their strings.
+ *
+ * The documents using the table must be deleted (or reset) before.
+ *
+ * @param[in,out]   table   An atom table object.
+ */
+MYJSON_API void json_atom_table_delete(JsonAtomTable *table);
 
-MYJSON_API int json_document_add_scalar(JsonDocument *document, const JsonChar_t *value, int length);
-MYJSON_API int json_document_add_array(JsonDocument *document);
-MYJSON_API int json_document_add_object(JsonDocument *document);
+/**
+ * Intern a string: add it to an atom table unless it is there already.
+ *
+ * @param[in,out]   table   An atom table object.
+ * @param[in]       value   The string.
+ * @param[in]       length  The length of the string, or @c -1 if it is
+ *                          NUL-terminated.
+ *
+ * @returns the atom id of the string, or @c 0 on a memory error.
+ */
+MYJSON_API int json_atom_table_intern(JsonAtomTable *table, const JsonChar_t *value, int length);
 
-MYJSON_API int json_document_append_array_item(JsonDocument *document, int array, int item);
-MYJSON_API int json_document_append_object_pair(JsonDocument *document, int object, int key, int value);
+/**
+ * Find the atom of a string, without adding it.
+ *
+ * @param[in]       table   An atom table object.
+ * @param[in]       value   The string.
+ * @param[in]       length  The length of the string, or @c -1 if it is
+ *                          NUL-terminated.
+ *
+ * @returns the atom id of the string, or @c 0 if it was never interned.
+ */
+MYJSON_API int json_atom_table_find(const JsonAtomTable *table, const JsonChar_t *value, int length);
 
-MYJSON_API const JsonChar_t *json_document_get_scalar_value(JsonDocument *document, int node_id);
-MYJSON_API int json_document_get_scalar_length(JsonDocument *document, int node_id);
-MYJSON_API int json_document_array_get_item(JsonDocument *document, int array_node_id, int index);
-MYJSON_API int json_document_object_get_value(JsonDocument *document, int object_node_id, const JsonChar_t *key,
-                                              int key_length);
+/**
+ * Get the string of an atom.
+ *
+ * @param[in]       table   An atom table object.
+ * @param[in]       atom    The atom id.
+ * @param[out]      length  The length of the string (may be @c NULL).
+ *
+ * @returns the NUL-terminated string, or @c NULL if there is no such atom.
+ */
+MYJSON_API const JsonChar_t *json_atom_table_get_string(const JsonAtomTable *table, int atom, size_t *length);
+
+MYJSON_API int json_document_initialize(JsonDocument *document);
+
+/**
+ * Set the allocator of an empty document (see @c json_parser_reload).
+ *
+ * A document loaded by @c json_parser_load gets the allocator of its parser
+ * instead.
+ *
+ * @param[in,out]   document    An initialized document object, without nodes.
+ * @param[in]       allocator   The allocator, or @c NULL for the one set by
+ *                              @c json_allocator_set.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_document_set_allocator(JsonDocument *document, const JsonAllocator *allocator);
+
+/**
+ * Delete a document: free its nodes and the chunks of its arena (borrowed
+ * scalars are left alone).
+ *
+ * @param[in,out]   document    A document object.
+ */
+MYJSON_API void json_document_delete(JsonDocument *document);
+
+/**
+ * Empty a document, but keep its nodes stack and the chunks of its arena for
+ * the next nodes (see @c json_parser_reload).
+ *
+ * The nodes and values got from the document before are no longer valid.
+ *
+ * @param[in,out]   document    An initialized or loaded document object.
+ */
+MYJSON_API void json_document_reset(JsonDocument *document);
+
+/**
+ * Intern the keys of an empty document in an atom table (see
+ * @c json_parser_reload).
+ *
+ * The pairs of the document then share one key node per distinct key (with
+ * the position of its first use), whose string is the one of the atom, and
+ * @c json_document_object_get_value compares key ids instead of strings.
+ * The table may be shared by several documents, and must outlive them.  A
+ * document using an atom table is loaded on one thread (see
+ * @c json_parser_set_thread_count).
+ *
+ * @param[in,out]   document    An initialized document object, without nodes.
+ * @param[in]       table       The atom table, or @c NULL to stop interning.
+ */
+MYJSON_API void json_document_set_atom_table(JsonDocument *document, JsonAtomTable *table);
+
+MYJSON_API JsonNode *json_document_get_root_node(JsonDocument *document);
+MYJSON_API JsonNode *json_document_get_node(JsonDocument *document, int index);
+
+MYJSON_API int json_document_add_scalar(JsonDocument *document, const JsonChar_t *value, int length);
+MYJSON_API int json_document_add_array(JsonDocument *document);
+MYJSON_API int json_document_add_object(JsonDocument *document);
+
+MYJSON_API int json_document_append_array_item(JsonDocument *document, int array, int item);
+MYJSON_API int json_document_append_object_pair(JsonDocument *document, int object, int key, int value);
+
+MYJSON_API const JsonChar_t *json_document_get_scalar_value(JsonDocument *document, int node_id);
+MYJSON_API int json_document_get_scalar_length(JsonDocument *document, int node_id);
+MYJSON_API int json_document_array_get_item(JsonDocument *document, int array_node_id, int index);
+MYJSON_API int json_document_object_get_value(JsonDocument *document, int object_node_id, const JsonChar_t *key,
+                                              int key_length);
+
+/**
+ * Get the value of a member of an object node by the atom of its key.
+ *
+ * The atom comes from the atom table of the document (see
+ * @c json_document_set_atom_table), so that a key looked up often is hashed
+ * once.
+ *
+ * @param[in]       document        A document object with an atom table.
+ * @param[in]       object_node_id  The object node id.
+ * @param[in]       atom            The atom id of the key.
+ *
+ * @returns the value node id of the first member with this key, or @c 0 if
+ * there is none.
+ */
+MYJSON_API int json_document_object_get_value_by_atom(JsonDocument *document, int object_node_id, int atom);
 
 MYJSON_API int json_document_get_node_by_path(JsonDocument *document, const JsonChar_t **keys, int key_count);
 MYJSON_API const JsonChar_t *json_document_get_value_by_path(JsonDocument *document, const JsonChar_t **keys,
                                                              int key_count);
 MYJSON_API int json_document_get_value_length_by_path(JsonDocument *document, const JsonChar_t **keys, int key_count);
 
+/**
+ * Get the values of a packed array node (see @c json_parser_set_pack_flags).
+ *
+ * The values are contiguous and aligned, and stay valid for as long as the
+ * document does.
+ *
+ * @param[in]       document    A document object.
+ * @param[in]       node_id     The node id.
+ * @param[out]      type        The type of the values (may be @c NULL).
+ * @param[out]      length      The number of values (may be @c NULL).
+ *
+ * @returns the values, or @c NULL if the node is not a packed array.
+ */
+MYJSON_API const void *json_document_get_packed_array(JsonDocument *document, int node_id, JsonPackedType *type,
+                                                      size_t *length);
+
+/**
+ * Destroy a tape: free its words and strings.
+ *
+ * @param[in,out]   tape    A tape object.
+ */
+MYJSON_API void json_tape_delete(JsonTape *tape);
+
+/**
+ * Get the type of the value at an index of a tape.
+ *
+ * @param[in]       tape    A tape object.
+ * @param[in]       index   The index of a value.
+ *
+ * @returns the type of the value.
+ */
+MYJSON_API JsonTapeType json_tape_get_type(const JsonTape *tape, size_t index);
+
+/**
+ * Get the index following a value, skipping an array or object at once.
+ *
+ * The items of an array at @a index go from @c index+1 to its end word;
+ * the members of an object are a key then a value, in turn.
+ *
+ * @param[in]       tape    A tape object.
+ * @param[in]       index   The index of a value (or of a key).
+ *
+ * @returns the index of the next value, or of the end word of its container.
+ */
+MYJSON_API size_t json_tape_next(const JsonTape *tape, size_t index);
+
+/**
+ * Find the value of a member of an object of a tape.
+ *
+ * @param[in]       tape        A tape object.
+ * @param[in]       index       The index of an object.
+ * @param[in]       key         The key.
+ * @param[in]       key_length  The length of the key.
+ *
+ * @returns the index of the value of the first member with this key, or
+ * @c 0 if there is none.
+ */
+MYJSON_API size_t json_tape_find_field(const JsonTape *tape, size_t index, const JsonChar_t *key, size_t key_length);
+
+/**
+ * Get a string (or key) of a tape.
+ *
+ * @param[in]       tape    A tape object.
+ * @param[in]       index   The index of a string.
+ * @param[out]      length  The length of the string (may be @c NULL).
+ *
+ * @returns the NUL-terminated string, valid for as long as the tape is.
+ */
+MYJSON_API const JsonChar_t *json_tape_get_string(const JsonTape *tape, size_t index, size_t *length);
+
+/**
+ * Get an integer of a tape.
+ *
+ * @param[in]       tape    A tape object.
+ * @param[in]       index   The index of a @c JSON_TAPE_INT64 or
+ *                          @c JSON_TAPE_UINT64 value.
+ *
+ * @returns the integer (a @c JSON_TAPE_UINT64 value is cast).
+ */
+MYJSON_API int64_t json_tape_get_int64(const JsonTape *tape, size_t index);
+
+/**
+ * Get a number of a tape, as a double.
+ *
+ * @param[in]       tape    A tape object.
+ * @param[in]       index   The index of a number.
+ *
+ * @returns the number.
+ */
+MYJSON_API double json_tape_get_double(const JsonTape *tape, size_t index);
+
 #pragma endregion  // Json
 
 #if !defined(MYJSON_DISABLE_ENCODING) || !MYJSON_DISABLE_ENCODING
 
 #pragma region Encoding
 
+/**
+ * Validate a UTF-8 text with the selected kernel.
+ *
+ * Overlong forms, surrogates and code points above U+10FFFF are invalid.
+ *
+ * @param[in]       buffer  The text.
+ * @param[in]       length  The length of the text (in bytes).
+ *
+ * @returns the length of the longest valid prefix, which is @a length if the
+ * text is valid.
+ */
+MYJSON_API size_t json_validate_utf8(const unsigned char *buffer, size_t length);
+
 #pragma endregion  // Encoding
 
 #endif  // MYJSON_DISABLE_ENCODING
@@ -1184,13 +2034,612 @@ MYJSON_API int json_document_get_value_length_by_path(JsonDocument *document, co
 
 MYJSON_API int json_parser_initialize(JsonParser *parser);
 MYJSON_API int json_parser_parse(JsonParser *parser, JsonEvent *event);
+
+/**
+ * Parse the input stream and produce up to @a capacity events at once.
+ *
+ * Works like calling @c json_parser_parse until @a capacity events are
+ * produced, the STREAM-END event is, or a call fails, without the checks
+ * between two events.  Delete every event produced with
+ * @c json_event_delete, on failure too.
+ *
+ * @param[in,out]   parser      A parser object.
+ * @param[out]      events      An array of at least @a capacity events.
+ * @param[in]       capacity    The number of events to produce at most.
+ * @param[out]      count       The number of events produced.
+ *
+ * @returns @c 1 if the function succeeded (@a count is less than
+ * @a capacity only at the end of the stream), @c 0 on error (after the
+ * @a count events produced), or @c MYJSON_NEED_MORE_INPUT when a push
+ * parser waits for the next chunk.
+ */
+MYJSON_API int json_parser_parse_batch(JsonParser *parser, JsonEvent *events, size_t capacity, size_t *count);
+
+/**
+ * Scan the input stream and produce up to @a capacity tokens at once.
+ *
+ * The tokens are moved out of the scanner, without any grammar checks, up
+ * to the EOF token.  A parser is either scanned or parsed: do not mix this
+ * with the functions producing events or documents.  Delete every token
+ * produced with @c json_token_delete, on failure too.
+ *
+ * @param[in,out]   parser      A parser object.
+ * @param[out]      tokens      An array of at least @a capacity tokens.
+ * @param[in]       capacity    The number of tokens to produce at most.
+ * @param[out]      count       The number of tokens produced.
+ *
+ * @returns @c 1 if the function succeeded (@a count is less than
+ * @a capacity only after the EOF token), @c 0 on error (after the @a count
+ * tokens produced), or @c MYJSON_NEED_MORE_INPUT when a push parser waits
+ * for the next chunk.
+ */
+MYJSON_API int json_parser_scan_batch(JsonParser *parser, JsonToken *tokens, size_t capacity, size_t *count);
+
+/**
+ * Free any memory allocated for a token object.
+ *
+ * @param[in,out]   token   A token object.
+ */
+MYJSON_API void json_token_delete(JsonToken *token);
+
+/**
+ * Parse the input stream and produce the next document.
+ *
+ * At the end of the stream, the document has no root node.  On failure, the
+ * document is left empty.  Otherwise, delete it with @c json_document_delete.
+ *
+ * @param[in,out]   parser      A parser object.
+ * @param[out]      document    An empty document object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
 MYJSON_API int json_parser_load(JsonParser *parser, JsonDocument *document);
+
+/**
+ * Reset a document, then load the next document into it, reusing its memory.
+ *
+ * Once its arena has grown to fit the documents of the stream, the document
+ * allocates nothing more.  On failure, the document is left empty (but
+ * still has to be deleted).
+ *
+ * @param[in,out]   parser      A parser object.
+ * @param[in,out]   document    A document object, initialized by
+ *                              @c json_document_initialize, or loaded or
+ *                              deleted before.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_reload(JsonParser *parser, JsonDocument *document);
+
+/**
+ * Skip the rest of the array or object being parsed.
+ *
+ * Call it after the ARRAY-START or OBJECT-START event of a container, or
+ * after any event inside it.  The scanner jumps to its closing bracket, which
+ * the structural index links to the opening one: no tokens or events are
+ * produced for it, its scalars are not decoded, and it is only checked for
+ * balanced brackets.  The next event is the one following its
+ * ARRAY-END or OBJECT-END event, which is not produced either.  This is not
+ * available to a push parser.
+ *
+ * @param[in,out]   parser  A parser object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_skip_value(JsonParser *parser);
+
+/**
+ * Parse the input stream and produce the next document, as a tape.
+ *
+ * No nodes are built: the values are appended to the words of the tape as
+ * their events come, and the strings are copied (and decoded) into its
+ * strings.  The positions are not kept.  At the end of the stream, the tape
+ * has no words.  Otherwise, delete it with @c json_tape_delete.
+ *
+ * @param[in,out]   parser  A parser object.
+ * @param[out]      tape    An empty tape object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_load_tape(JsonParser *parser, JsonTape *tape);
 MYJSON_API int json_parser_delete(JsonParser *parser);
 
+/**
+ * Clear a parser for a new input, as if it were deleted and initialized
+ * again, but keep its memory.
+ *
+ * The buffers, the tokens queue, the stacks and the structural index stay
+ * allocated (with the allocator and the kernel), so that parsing the next
+ * input of a similar size from memory, and loading it with
+ * @c json_parser_reload, does not allocate at all.  The input, the flags,
+ * the thread count and the error are cleared, and the queued tokens and
+ * the input mapping are freed.
+ *
+ * @param[in,out]   parser  A parser object.
+ */
+MYJSON_API void json_parser_reset(JsonParser *parser);
+
+/**
+ * Get a reset parser from the pool of the calling thread.
+ *
+ * The pool keeps up to @c MYJSON_POOL_SIZE parsers per thread, initialized
+ * the first time they are handed out.  Put the parser back with
+ * @c json_parser_pool_release on the same thread.
+ *
+ * @returns A parser, or @c NULL if the pool is exhausted or on error.
+ */
+MYJSON_API JsonParser *json_parser_pool_acquire(void);
+
+/**
+ * Reset a parser of the pool of the calling thread and put it back.
+ *
+ * @param[in,out]   parser  A parser got from @c json_parser_pool_acquire.
+ */
+MYJSON_API void json_parser_pool_release(JsonParser *parser);
+
+/**
+ * Delete the parsers of the pool of the calling thread.  Call it before the
+ * thread exits, once the parsers are released.
+ */
+MYJSON_API void json_parser_pool_clear(void);
+
 MYJSON_API int json_parser_set_input_file(JsonParser *parser, FILE *file);
 MYJSON_API int json_parser_set_input_string(JsonParser *parser, const unsigned char *input, size_t size);
+
+/**
+ * Set a mutable string input, parsed destructively.
+ *
+ * Like @c json_parser_set_input_string, but strings are unescaped and
+ * NUL-terminated in place, overwriting the input, so that neither the events
+ * nor the documents loaded by @c json_parser_load allocate for them.
+ *
+ * @param[in,out]   parser  A parser object.
+ * @param[in,out]   input   A source data, rewritten while it is parsed.
+ * @param[in]       size    The length of the source data in bytes.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_set_input_mutable_string(JsonParser *parser, unsigned char *input, size_t size);
+
+/**
+ * Set a memory-mapped file input.
+ *
+ * The file is mapped read-only and parsed in place, like a string set with
+ * @c json_parser_set_input_string: the scalars borrow from the mapping and
+ * stay valid until the parser is deleted.  The mapping is advised for
+ * sequential access and read ahead, and the @c MYJSON_MAX_FILE_SIZE limit does
+ * not apply to it.  The file may be closed once the function returns.
+ *
+ * @param[in,out]   parser  A parser object.
+ * @param[in]       path    The path of the file.
+ * @param[in]       flags   A combination of @c JsonMapFlag values.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error (the parser error is
+ * set).
+ */
+MYJSON_API int json_parser_set_input_mmap(JsonParser *parser, const char *path, int flags);
+
+/**
+ * Set a memory-mapped file input from an open file descriptor.
+ *
+ * Like @c json_parser_set_input_mmap; the whole file is mapped, whatever the
+ * position of the descriptor, which is left open.
+ *
+ * @param[in,out]   parser  A parser object.
+ * @param[in]       fd      A file descriptor open for reading.
+ * @param[in]       flags   A combination of @c JsonMapFlag values.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error (the parser error is
+ * set).
+ */
+MYJSON_API int json_parser_set_input_mmap_fd(JsonParser *parser, int fd, int flags);
 MYJSON_API int json_parser_set_input(JsonParser *parser, JsonReadHandler *handler, void *data);
 
+/**
+ * Set the stream flags, before parsing.
+ *
+ * With @c JSON_MULTI_DOCUMENT_FLAG, the stream is a sequence of top-level
+ * values, separated by whitespace (a newline for NDJSON) or by nothing at all
+ * (like @c {}{}), each one between DOCUMENT-START and DOCUMENT-END events
+ * (or loaded by its own @c json_parser_load).  The stream may be empty.  The
+ * parser buffers are reused from one document to the next.
+ *
+ * With @c JSON_RESYNC_FLAG (which implies @c JSON_MULTI_DOCUMENT_FLAG), a
+ * scanner or parser error still fails the current event, but the next call
+ * of @c json_parser_parse (or @c json_parser_load) skips the rest of the
+ * malformed line and carries on with the next document.  A document cut
+ * short by the end of its line is dropped, and the next line is kept.
+ * Reader and memory errors still stop the stream.
+ *
+ * @param[in,out]   parser  A parser object.
+ * @param[in]       flags   A combination of @c JsonStreamFlag values.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_set_stream_flags(JsonParser *parser, int flags);
+
+/**
+ * Set the number of threads loading a document.
+ *
+ * With more than one thread, @c json_parser_load cuts the body of a large
+ * array or object at its top-level separators (found with the structural
+ * index), loads the pieces on several threads, and puts their nodes together
+ * in the document, in order.  A body made of a few large values is cut
+ * inside them instead.  This only applies to a UTF-8 string (or mapped file)
+ * input; a malformed body is loaded again by the calling thread, to report
+ * the error.
+ *
+ * @param[in,out]   parser          A parser object.
+ * @param[in]       thread_count    The number of threads (including the
+ *                                  calling one), or @c 0 for one per processor.
+ *                                  Default is @c 1.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_set_thread_count(JsonParser *parser, size_t thread_count);
+
+/**
+ * Set the packing flags of the documents loaded by @c json_parser_load.
+ *
+ * With @c JSON_PACK_ARRAYS, a non-empty array made only of numbers is loaded
+ * as a single @c JSON_PACKED_ARRAY node, whose values sit in one buffer (see
+ * @c json_document_get_packed_array) instead of one node each.  The values
+ * are packed as @c int32_t, or as @c int64_t if one of them needs it, or as
+ * @c double if one has a fraction or an exponent.  An array which cannot be
+ * packed without loss (an integer above @c INT64_MAX, or beyond 2^53 next to
+ * a fraction) is loaded as usual.  With @c JSON_PACK_FLOAT32 (which implies
+ * @c JSON_PACK_ARRAYS), the latter are packed as @c float instead, rounding
+ * them.  The positions of the packed values are not kept.
+ *
+ * @param[in,out]   parser  A parser object.
+ * @param[in]       flags   A combination of @c JsonPackFlag values.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_set_pack_flags(JsonParser *parser, int flags);
+
+/**
+ * Set the allocator of a parser, before its input is set.
+ *
+ * The allocator is used for the buffers and stacks of the parser, the
+ * strings of its tokens and events, and the documents and tapes it loads.
+ * The worker threads of a parser (see @c json_parser_set_thread_count) call
+ * it too.
+ *
+ * @param[in,out]   parser      A parser object.
+ * @param[in]       allocator   The allocator, or @c NULL for the one set by
+ *                              @c json_allocator_set.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_set_allocator(JsonParser *parser, const JsonAllocator *allocator);
+
+/**
+ * Feed the next chunk of the input to a push parser.
+ *
+ * Instead of reading, @c json_parser_parse returns @c MYJSON_NEED_MORE_INPUT
+ * (with an empty event) when it runs out of input in the middle of the
+ * stream, and carries on from there, even in the middle of a token, once the
+ * next chunk is fed.  The chunk is borrowed until then: feed the next one
+ * only after @c MYJSON_NEED_MORE_INPUT.  The scalars are always copied, so
+ * the chunks need not outlive the events.
+ *
+ * Events are produced as soon as the structural index has seen the 64-byte
+ * block that completes them, or at the last chunk.  @c json_parser_load
+ * cannot wait, and fails if it runs out of input before the last chunk.
+ *
+ * @param[in,out]   parser  A parser object.
+ * @param[in]       chunk   The next chunk of the input.
+ * @param[in]       size    The length of the chunk in bytes (may be @c 0).
+ * @param[in]       is_last Is it the last chunk?
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_feed(JsonParser *parser, const unsigned char *chunk, size_t size, int is_last);
+
+/**
+ * Initialize a read-ahead input, and start reading.
+ *
+ * The descriptor is read from its current position, ahead of the parser: its
+ * position is unspecified until the read-ahead input is deleted.  Set it as
+ * the parser input with
+ * @c json_parser_set_input(parser, json_read_ahead_handler, reader).
+ *
+ * @param[out]      reader  An empty read-ahead input object.
+ * @param[in]       fd      A file descriptor open for reading.
+ * @param[in]       count   The number of chunks in flight, or @c 0 for the
+ *                          default.
+ * @param[in]       size    The size of a chunk (rounded up to a page), or
+ *                          @c 0 for the default.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_read_ahead_initialize(JsonReadAhead *reader, int fd, size_t count, size_t size);
+
+/**
+ * The read handler of a read-ahead input.
+ *
+ * Copies the chunks already read to the parser, and only blocks when the next
+ * one is still in flight.
+ */
+MYJSON_API int json_read_ahead_handler(void *data, unsigned char *buffer, size_t size, size_t *size_read);
+
+/**
+ * Destroy a read-ahead input, after waiting for the reads in flight.
+ *
+ * The file descriptor is left open.
+ *
+ * @param[in,out]   reader  A read-ahead input object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_read_ahead_delete(JsonReadAhead *reader);
+
+/**
+ * Parse an NDJSON input on several threads.
+ *
+ * The input is cut into chunks of whole lines, parsed by a pool of threads
+ * with a parser each; an idle thread steals the chunks left to the others.
+ * Every document is handed to @c handler, one call at a time, either in the
+ * input order (@c ordered) or as soon as it is loaded.  The nodes positions
+ * are relative to the chunk: use the @c offset argument of the handler.
+ *
+ * A document must fit on its line.  An input in another encoding than UTF-8
+ * is parsed by a single thread.
+ *
+ * @param[in]       input           The NDJSON input (borrowed by the documents).
+ * @param[in]       length          The length of the input in bytes.
+ * @param[in]       thread_count    The number of threads (including the
+ *                                  calling one), or @c 0 for one per processor.
+ * @param[in]       handler         A document handler.
+ * @param[in,out]   data            Any application data for passing to the
+ *                                  handler.
+ * @param[in]       ordered         Are the documents delivered in order?
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if a line is malformed (the
+ * documents after it may or may not have been delivered, unless @c ordered),
+ * the handler stopped the parse, or on memory error.
+ */
+MYJSON_API int json_parse_ndjson_parallel(const unsigned char *input, size_t length, size_t thread_count,
+                                          JsonDocumentHandler *handler, void *data, int ordered);
+
+/**
+ * Initialize a forward-only cursor over the input of a parser.
+ *
+ * The cursor walks the structural index of the input without producing
+ * tokens, events or nodes: the values are only decoded when they are read,
+ * and the values stepped over are only checked for balanced brackets.  The
+ * input must be a UTF-8 string (or mapped file), set on a new parser, which
+ * is then only used by the cursor and holds its errors.
+ *
+ * The cursor starts at the root value.  The functions moving the cursor
+ * return @c 0 both at the end of a container and on error: tell them apart
+ * with the error type of the parser.
+ *
+ * @param[out]      cursor  An empty cursor object.
+ * @param[in,out]   parser  A parser object with an input set.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_cursor_initialize(JsonCursor *cursor, JsonParser *parser);
+
+/**
+ * Destroy a cursor (the parser is left alone).
+ *
+ * @param[in,out]   cursor  A cursor object.
+ */
+MYJSON_API void json_cursor_delete(JsonCursor *cursor);
+
+/**
+ * Get the type of the current value, without reading it.
+ *
+ * @param[in,out]   cursor  A cursor object.
+ * @param[out]      type    The type of the value.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if there is no current value
+ * or on error.
+ */
+MYJSON_API int json_cursor_get_type(JsonCursor *cursor, JsonValueType *type);
+
+/**
+ * Step into the current array or object, to its first item or member.
+ *
+ * @param[in,out]   cursor  A cursor object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if the container is empty
+ * (the cursor is then at its end) or on error.
+ */
+MYJSON_API int json_cursor_enter(JsonCursor *cursor);
+
+/**
+ * Skip the rest of the current value, and go to the next item or member.
+ *
+ * @param[in,out]   cursor  A cursor object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 at the end of the container
+ * or on error.
+ */
+MYJSON_API int json_cursor_next(JsonCursor *cursor);
+
+/**
+ * Skip the rest of the container entered last, and step out of it.
+ *
+ * The container is then the current value, read: @c json_cursor_next goes
+ * on with the next one.
+ *
+ * @param[in,out]   cursor  A cursor object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_cursor_leave(JsonCursor *cursor);
+
+/**
+ * Go to the value of a member of the object entered last.
+ *
+ * The members are searched forward, from the current one: look the fields
+ * up in the order they are written for a single pass over the object.
+ *
+ * @param[in,out]   cursor      A cursor object.
+ * @param[in]       key         The key.
+ * @param[in]       key_length  The length of the key, or @c -1 if it is
+ *                              NUL-terminated.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if no member is left with
+ * this key (the cursor is then at the end of the object) or on error.
+ */
+MYJSON_API int json_cursor_find_field(JsonCursor *cursor, const JsonChar_t *key, int key_length);
+
+/**
+ * Get the key of the current member.
+ *
+ * The key is borrowed from the input, as a string value (see
+ * @c json_cursor_get_string).
+ *
+ * @param[in,out]   cursor  A cursor object.
+ * @param[out]      value   The key, without its quotes.
+ * @param[out]      length  The length of the key.
+ * @param[out]      flags   The scalar flags of the key (may be @c NULL).
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if the cursor is not at a
+ * member.
+ */
+MYJSON_API int json_cursor_get_key(JsonCursor *cursor, const JsonChar_t **value, size_t *length, int *flags);
+
+/**
+ * Read the current string value.
+ *
+ * The value is borrowed from the input and is not NUL-terminated; with
+ * @c JSON_ESCAPED_FLAG, decode it with @c json_string_unescape.  With a
+ * mutable input, it is unescaped and NUL-terminated in place instead.
+ *
+ * @param[in,out]   cursor  A cursor object.
+ * @param[out]      value   The string, without its quotes.
+ * @param[out]      length  The length of the string.
+ * @param[out]      flags   The scalar flags of the string (may be @c NULL).
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if the value is not a string
+ * or on error.
+ */
+MYJSON_API int json_cursor_get_string(JsonCursor *cursor, const JsonChar_t **value, size_t *length, int *flags);
+
+/**
+ * Read the current integer value.
+ *
+ * @param[in,out]   cursor  A cursor object.
+ * @param[out]      value   The integer.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if the value is not an
+ * integer in the @c int64_t range or on error.
+ */
+MYJSON_API int json_cursor_get_int64(JsonCursor *cursor, int64_t *value);
+
+/**
+ * Read the current number value, as a double.
+ *
+ * @param[in,out]   cursor  A cursor object.
+ * @param[out]      value   The number.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if the value is not a number
+ * or on error.
+ */
+MYJSON_API int json_cursor_get_double(JsonCursor *cursor, double *value);
+
+/**
+ * Read the current boolean value.
+ *
+ * @param[in,out]   cursor  A cursor object.
+ * @param[out]      value   @c 1 for @c true, @c 0 for @c false.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if the value is not a boolean
+ * or on error.
+ */
+MYJSON_API int json_cursor_get_boolean(JsonCursor *cursor, int *value);
+
+/**
+ * Read the current value if it is @c null.
+ *
+ * @param[in,out]   cursor  A cursor object.
+ *
+ * @returns @c 1 if the value was @c null, @c 0 otherwise or on error.
+ */
+MYJSON_API int json_cursor_get_null(JsonCursor *cursor);
+
+/**
+ * Initialize a query, with no expressions.
+ *
+ * @param[out]      query   An empty query object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_query_initialize(JsonQuery *query);
+
+/**
+ * Destroy a query.
+ *
+ * @param[in,out]   query   A query object.
+ */
+MYJSON_API void json_query_delete(JsonQuery *query);
+
+/**
+ * Compile an expression into a query.
+ *
+ * The expression is either a JSON Pointer (@c "/store/book/0/title", where
+ * @c ~0 and @c ~1 stand for @c ~ and @c /, and a number also takes the item
+ * at that index), or a simple JSONPath (@c "$.store.book[*]['title']") made
+ * of keys, indices and @c * wildcards.  The expressions are numbered from
+ * @c 0, in the order they are added.
+ *
+ * @param[in,out]   query       A query object.
+ * @param[in]       expression  A NUL-terminated expression.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 if the expression is
+ * malformed (see the error of the query) or on memory error.
+ */
+MYJSON_API int json_query_add_expression(JsonQuery *query, const char *expression);
+
+/**
+ * Run a query over the rest of the input of a parser.
+ *
+ * The query follows the events of the parser: the arrays and objects that
+ * none of the expressions can reach into are skipped with
+ * @c json_parser_skip_value, and only the values matched are loaded, into a
+ * document of their own handed to @c handler.  The memory used depends on
+ * the depth of the input and the size of the values matched, not on the
+ * size of the input.  An expression reaching into a value matched by
+ * another one is matched in its document, after it.  Every document of the
+ * stream is queried.  This is not available to a push parser.
+ *
+ * @param[in,out]   parser      A parser object.
+ * @param[in]       query       A query object.
+ * @param[in]       handler     A query match handler.
+ * @param[in,out]   data        Any application data for passing to the
+ *                              handler.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error or if the handler
+ * stopped the parse.
+ */
+MYJSON_API int json_parser_query(JsonParser *parser, JsonQuery *query, JsonQueryHandler *handler, void *data);
+
+/**
+ * Load the next document of the input, keeping only the values of a mask.
+ *
+ * The mask is a query whose expressions tell the values to keep, with the
+ * arrays and objects leading to them: @c "$.user.name" and @c "$.id" turn
+ * @c {"id":1,"user":{"name":"x","age":2},"text":"..."} into
+ * @c {"id":1,"user":{"name":"x"}}.  The values left out are skipped like by
+ * @c json_parser_query, and no nodes are built for them.  The items kept
+ * from an array are numbered again from @c 0.  The root value is always
+ * kept, even if the mask leaves out all of it.  This is not available to a
+ * push parser.
+ *
+ * @param[in,out]   parser      A parser object.
+ * @param[out]      document    An empty document object.
+ * @param[in]       mask        A query object.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_parser_load_projection(JsonParser *parser, JsonDocument *document, JsonQuery *mask);
+
 #pragma endregion  // Reader
 
 #endif  // MYJSON_DISABLE_READER
@@ -1203,12 +2652,54 @@ MYJSON_API int json_emitter_initialize(JsonEmitter *emitter);
 MYJSON_API int json_emitter_emit(JsonEmitter *emitter, JsonEvent *event);
 MYJSON_API int json_emitter_delete(JsonEmitter *emitter);
 
+/**
+ * Clear an emitter for a new output, as if it were deleted and initialized
+ * again, but keep its buffers and its stack (with the allocator and the
+ * kernel).  The output, the encoding, the state and the error are cleared;
+ * what was not flushed is dropped.
+ *
+ * @param[in,out]   emitter     An emitter object.
+ */
+MYJSON_API void json_emitter_reset(JsonEmitter *emitter);
+
+/**
+ * Get a reset emitter from the pool of the calling thread (see
+ * @c json_parser_pool_acquire).
+ *
+ * @returns An emitter, or @c NULL if the pool is exhausted or on error.
+ */
+MYJSON_API JsonEmitter *json_emitter_pool_acquire(void);
+
+/**
+ * Reset an emitter of the pool of the calling thread and put it back.
+ *
+ * @param[in,out]   emitter     An emitter got from @c json_emitter_pool_acquire.
+ */
+MYJSON_API void json_emitter_pool_release(JsonEmitter *emitter);
+
+/**
+ * Delete the emitters of the pool of the calling thread.  Call it before the
+ * thread exits, once the emitters are released.
+ */
+MYJSON_API void json_emitter_pool_clear(void);
+
 MYJSON_API int json_emitter_set_output_file(JsonEmitter *emitter, FILE *file);
 MYJSON_API int json_emitter_set_output_string(JsonEmitter *emitter, const unsigned char *output, size_t size,
                                               size_t *size_written);
 MYJSON_API int json_emitter_set_output(JsonEmitter *emitter, JsonWriteHandler *handler, void *data);
 MYJSON_API int json_emitter_set_encoding(JsonEmitter *emitter, JsonEncoding encoding);
 
+/**
+ * Set the allocator of an emitter, before it is opened.
+ *
+ * @param[in,out]   emitter     An emitter object.
+ * @param[in]       allocator   The allocator, or @c NULL for the one set by
+ *                              @c json_allocator_set.
+ *
+ * @returns @c 1 if the function succeeded, @c 0 on error.
+ */
+MYJSON_API int json_emitter_set_allocator(JsonEmitter *emitter, const JsonAllocator *allocator);
+
 MYJSON_API int json_emitter_open(JsonEmitter *emitter);
 MYJSON_API int json_emitter_close(JsonEmitter *emitter);
 MYJSON_API int json_emitter_flush(JsonEmitter *emitter);
@@ -1253,6 +2744,159 @@ namespace json {
 
 #pragma region Reader
 
+/**
+ * The exception thrown on a malformed input, or on a value of another type.
+ */
+class exception : public std::exception {
+   public:
+    exception(const char *problem, JsonPosition position) : m_problem(problem), m_position(position) {}
+
+    const char *what() const noexcept override { return m_problem; }
+
+    /** The problem position. */
+    const JsonPosition &position() const noexcept { return m_position; }
+
+   private:
+    const char *m_problem;
+    JsonPosition m_position;
+};
+
+/**
+ * A forward-only cursor over a UTF-8 input in memory (see
+ * @c json_cursor_initialize).
+ *
+ * The input must outlive the cursor.  The moves return @c false at the end
+ * of a container, and throw @c json::exception on error.
+ */
+class cursor {
+   public:
+    cursor(const char *input, size_t size) {
+        json_parser_initialize(&m_parser);
+        json_parser_set_input_string(&m_parser, reinterpret_cast<const unsigned char *>(input), size);
+        if (!json_cursor_initialize(&m_cursor, &m_parser)) {
+            exception error(m_parser.error.message, m_parser.error_pos);
+
+            json_cursor_delete(&m_cursor);
+            json_parser_delete(&m_parser);
+            throw error;
+        }
+    }
+
+    explicit cursor(std::string_view input) : cursor(input.data(), input.size()) {}
+
+    cursor(const cursor &) = delete;
+    cursor &operator=(const cursor &) = delete;
+
+    ~cursor() {
+        json_cursor_delete(&m_cursor);
+        json_parser_delete(&m_parser);
+    }
+
+    /** The type of the current value. */
+    JsonValueType type() {
+        JsonValueType type;
+
+        if (!json_cursor_get_type(&m_cursor, &type)) {
+            fail("no current value");
+        }
+        return type;
+    }
+
+    bool enter() { return check(json_cursor_enter(&m_cursor)); }
+    bool next() { return check(json_cursor_next(&m_cursor)); }
+
+    void leave() {
+        if (!json_cursor_leave(&m_cursor)) {
+            fail("cannot leave the container");
+        }
+    }
+
+    bool find_field(std::string_view key) {
+        return check(json_cursor_find_field(&m_cursor, reinterpret_cast<const JsonChar_t *>(key.data()),
+                                            static_cast<int>(key.size())));
+    }
+
+    /** The key of the current member, unescaped. */
+    std::string key() {
+        const JsonChar_t *value;
+        size_t length;
+        int flags;
+
+        if (!json_cursor_get_key(&m_cursor, &value, &length, &flags)) {
+            fail("not at a member");
+        }
+        return decode(value, length, flags);
+    }
+
+    /** Read the current string, unescaped. */
+    std::string get_string() {
+        const JsonChar_t *value;
+        size_t length;
+        int flags;
+
+        if (!check(json_cursor_get_string(&m_cursor, &value, &length, &flags))) {
+            fail("not a string");
+        }
+        return decode(value, length, flags);
+    }
+
+    int64_t get_int64() {
+        int64_t value;
+
+        if (!check(json_cursor_get_int64(&m_cursor, &value))) {
+            fail("not an integer");
+        }
+        return value;
+    }
+
+    double get_double() {
+        double value;
+
+        if (!check(json_cursor_get_double(&m_cursor, &value))) {
+            fail("not a number");
+        }
+        return value;
+    }
+
+    bool get_boolean() {
+        int value;
+
+        if (!check(json_cursor_get_boolean(&m_cursor, &value))) {
+            fail("not a boolean");
+        }
+        return value;
+    }
+
+    /** Read the current value if it is @c null. */
+    bool get_null() { return check(json_cursor_get_null(&m_cursor)); }
+
+   private:
+    bool check(int result) {
+        if (!result && m_parser.error.type) {
+            throw exception(m_parser.error.message, m_parser.error_pos);
+        }
+        return result;
+    }
+
+    [[noreturn]] void fail(const char *problem) {
+        check(0);
+        throw exception(problem, m_parser.error_pos);
+    }
+
+    std::string decode(const JsonChar_t *value, size_t length, int flags) {
+        std::string decoded(reinterpret_cast<const char *>(value), length);
+
+        if (flags & JSON_ESCAPED_FLAG) {
+            json_string_unescape(value, length, reinterpret_cast<JsonChar_t *>(&decoded[0]), &length);
+            decoded.resize(length);
+        }
+        return decoded;
+    }
+
+    JsonParser m_parser;
+    JsonCursor m_cursor;
+};
+
 #pragma endregion  // Reader
 
 #endif  // MYJSON_DISABLE_READER
@@ -0,0 +1,293 @@
+/**
+ * @file test.h
+ * @brief Helpers shared by the test programs.
+ *
+ * Every test program includes this header, counts its failed checks, and
+ * exits with a failure status if any check failed.
+ */
+
+#ifndef MYJSON_TEST_H
+#define MYJSON_TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "myjson.h"
+
+static int test_failures = 0;
+
+/** Report a failed check, and carry on. */
+#define CHECK(condition)                                                                    \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+            test_failures++;                                                                \
+        }                                                                                   \
+    } while (0)
+
+/** Report a failed string comparison, with both strings. */
+#define CHECK_STRING(actual, expected)                                                                           \
+    do {                                                                                                         \
+        const char *_actual = (actual), *_expected = (expected);                                                 \
+        if (strcmp(_actual, _expected)) {                                                                        \
+            fprintf(stderr, "%s:%d: check failed: %s\n  got:      %s\n  expected: %s\n", __FILE__, __LINE__, \
+                    #actual, _actual, _expected);                                                                \
+            test_failures++;                                                                                     \
+        }                                                                                                        \
+    } while (0)
+
+/** The exit status of a test program. */
+#define TEST_RESULT() (test_failures ? EXIT_FAILURE : EXIT_SUCCESS)
+
+/** The kernels to run a test with, from the most portable to the fastest. */
+static const JsonKernelType test_kernels[] = {JSON_FALLBACK_KERNEL, JSON_SSE42_KERNEL, JSON_AVX2_KERNEL,
+                                              JSON_AVX512_KERNEL};
+
+#define TEST_KERNEL_COUNT (sizeof(test_kernels) / sizeof(test_kernels[0]))
+
+/** A growing text buffer. */
+typedef struct TestText {
+    char *start;   /**< The text (NUL-terminated). */
+    size_t length; /**< The length of the text. */
+    size_t size;   /**< The size of the buffer. */
+} TestText;
+
+static inline void test_text_append(TestText *text, const char *value, size_t length) {
+    if (text->length + length + 1 > text->size) {
+        text->size = (text->length + length + 1) * 2;
+        text->start = (char *)realloc(text->start, text->size);
+        if (!text->start) {
+            abort();
+        }
+    }
+
+    memcpy(text->start + text->length, value, length);
+    text->length += length;
+    text->start[text->length] = '\0';
+}
+
+static inline void test_text_clear(TestText *text) {
+    free(text->start);
+    memset(text, 0, sizeof(TestText));
+}
+
+/**
+ * Read a sample file of the @c json directory of the source tree.
+ *
+ * @returns the content (NUL-terminated), to be freed, or @c NULL.
+ */
+static inline char *test_read_sample(const char *name, size_t *length) {
+    const char *file = __FILE__;
+    size_t directory = strlen(file);
+    int levels = 2;
+    char path[4096];
+    char *content;
+    FILE *stream;
+    long size;
+
+    /* This header is in the tests directory, next to the json one. */
+    while (directory && levels) {
+        directory--;
+        if (file[directory] == '/' || file[directory] == '\\') {
+            levels--;
+        }
+    }
+    snprintf(path, sizeof(path), "%.*s%sjson/%s", (int)directory, file, directory ? "/" : "", name);
+
+    stream = fopen(path, "rb");
+    if (!stream) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return NULL;
+    }
+    fseek(stream, 0, SEEK_END);
+    size = ftell(stream);
+    fseek(stream, 0, SEEK_SET);
+
+    content = (char *)malloc((size_t)size + 1);
+    if (!content || fread(content, 1, (size_t)size, stream) != (size_t)size) {
+        abort();
+    }
+    content[size] = '\0';
+    fclose(stream);
+
+    *length = (size_t)size;
+    return content;
+}
+
+/**
+ * Append an event to a trace: @c ( @c ) for the stream, @c < @c > for a
+ * document, the brackets of the arrays and objects, and a scalar as its
+ * type letter, a colon and its (unescaped) value, then a space.
+ */
+static inline void test_trace_event(TestText *text, const JsonEvent *event) {
+    static const char scalars[] = "n?d??sib";
+    const char *mark = NULL;
+    char prefix[2];
+
+    switch (event->type) {
+        case JSON_STREAM_START_EVENT:
+            mark = "(";
+            break;
+        case JSON_STREAM_END_EVENT:
+            mark = ")";
+            break;
+        case JSON_DOCUMENT_START_EVENT:
+            mark = "<";
+            break;
+        case JSON_DOCUMENT_END_EVENT:
+            mark = ">";
+            break;
+        case JSON_ARRAY_START_EVENT:
+            mark = "[";
+            break;
+        case JSON_ARRAY_END_EVENT:
+            mark = "]";
+            break;
+        case JSON_OBJECT_START_EVENT:
+            mark = "{";
+            break;
+        case JSON_OBJECT_END_EVENT:
+            mark = "}";
+            break;
+        case JSON_SCALAR_EVENT:
+            prefix[0] = scalars[event->data.scalar.type < 8 ? event->data.scalar.type : 1];
+            prefix[1] = ':';
+            test_text_append(text, prefix, 2);
+            if (event->data.scalar.flags & JSON_ESCAPED_FLAG) {
+                JsonChar_t *decoded = (JsonChar_t *)malloc(event->data.scalar.length + 1);
+                size_t length = 0;
+
+                if (!decoded) {
+                    abort();
+                }
+                if (json_string_unescape(event->data.scalar.value, event->data.scalar.length, decoded, &length)) {
+                    test_text_append(text, (const char *)decoded, length);
+                } else {
+                    test_text_append(text, "!", 1);
+                }
+                free(decoded);
+            } else {
+                test_text_append(text, (const char *)event->data.scalar.value, event->data.scalar.length);
+            }
+            test_text_append(text, " ", 1);
+            return;
+        default:
+            mark = "?";
+            break;
+    }
+
+    test_text_append(text, mark, 1);
+}
+
+/**
+ * Parse the rest of the input of a parser into a trace, ending with @c ! on
+ * error.
+ *
+ * @returns @c 1 if the stream was parsed to its end, @c 0 on error.
+ */
+static inline int test_trace_parser(JsonParser *parser, TestText *text) {
+    JsonEvent event;
+    int done = 0;
+
+    while (!done) {
+        if (!json_parser_parse(parser, &event)) {
+            test_text_append(text, "!", 1);
+            return MYJSON_FAILURE;
+        }
+        test_trace_event(text, &event);
+        done = event.type == JSON_STREAM_END_EVENT;
+        json_event_delete(&event);
+    }
+
+    return MYJSON_SUCCESS;
+}
+
+/**
+ * Parse a string into a trace, with a new parser.
+ *
+ * @returns the trace, to be freed.
+ */
+static inline char *test_trace_string(const char *input, size_t length) {
+    JsonParser parser;
+    TestText text = {NULL, 0, 0};
+
+    test_text_append(&text, "", 0);
+    if (!json_parser_initialize(&parser)) {
+        abort();
+    }
+    json_parser_set_input_string(&parser, (const unsigned char *)input, length);
+    test_trace_parser(&parser, &text);
+    json_parser_delete(&parser);
+
+    return text.start;
+}
+
+/**
+ * Write the subtree of a node of a document as compact JSON.
+ */
+static inline void test_write_node(TestText *text, JsonDocument *document, int node_id) {
+    JsonNode *node = json_document_get_node(document, node_id);
+    JsonNodeItem *item;
+    JsonNodePair *pair;
+
+    if (!node) {
+        test_text_append(text, "?", 1);
+        return;
+    }
+
+    switch (node->type) {
+        case JSON_ARRAY:
+            test_text_append(text, "[", 1);
+            for (item = node->data.array.items.start; item < node->data.array.items.top; item++) {
+                if (item != node->data.array.items.start) {
+                    test_text_append(text, ",", 1);
+                }
+                test_write_node(text, document, *item);
+            }
+            test_text_append(text, "]", 1);
+            break;
+        case JSON_OBJECT:
+            test_text_append(text, "{", 1);
+            for (pair = node->data.object.pairs.start; pair < node->data.object.pairs.top; pair++) {
+                if (pair != node->data.object.pairs.start) {
+                    test_text_append(text, ",", 1);
+                }
+                test_write_node(text, document, pair->key);
+                test_text_append(text, ":", 1);
+                test_write_node(text, document, pair->value);
+            }
+            test_text_append(text, "}", 1);
+            break;
+        case JSON_STRING:
+            test_text_append(text, "\"", 1);
+            test_text_append(text, (const char *)node->data.scalar.value, node->data.scalar.length);
+            test_text_append(text, "\"", 1);
+            break;
+        case JSON_PACKED_ARRAY:
+            test_text_append(text, "[#]", 3);
+            break;
+        default:
+            test_text_append(text, (const char *)node->data.scalar.value, node->data.scalar.length);
+            break;
+    }
+}
+
+/**
+ * Write a document as compact JSON (strings are written decoded, without
+ * escaping).
+ *
+ * @returns the text, to be freed.
+ */
+static inline char *test_write_document(JsonDocument *document) {
+    TestText text = {NULL, 0, 0};
+
+    test_text_append(&text, "", 0);
+    if (json_document_get_root_node(document)) {
+        test_write_node(&text, document, 1);
+    }
+
+    return text.start;
+}
+
+#endif  // MYJSON_TEST_H
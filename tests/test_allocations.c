@@ -0,0 +1,158 @@
+/**
+ * @file test_allocations.c
+ * @brief Once warmed up, the pooled parsers and emitters, and a reloaded
+ * document, parse and emit without allocating.
+ */
+
+#include "test.h"
+
+#define WARM_UP_COUNT 3
+#define ITERATION_COUNT 20
+
+typedef struct TestCounts {
+    size_t allocations;   /**< The number of calls to allocate. */
+    size_t reallocations; /**< The number of calls to reallocate. */
+    size_t deallocations; /**< The number of calls to deallocate. */
+} TestCounts;
+
+static void *count_allocate(void *data, size_t size) {
+    ((TestCounts *)data)->allocations++;
+
+    return malloc(size ? size : 1);
+}
+
+static void *count_reallocate(void *data, void *pointer, size_t old_size, size_t size) {
+    (void)old_size;
+    ((TestCounts *)data)->reallocations++;
+
+    return realloc(pointer, size ? size : 1);
+}
+
+static void count_deallocate(void *data, void *pointer, size_t size) {
+    (void)size;
+    ((TestCounts *)data)->deallocations++;
+
+    free(pointer);
+}
+
+/*
+ * Load an input into a reloaded document with a pooled parser.
+ */
+static void load(const char *input, size_t length, JsonDocument *document) {
+    JsonParser *parser = json_parser_pool_acquire();
+
+    CHECK(parser != NULL);
+    if (!parser) {
+        return;
+    }
+
+    CHECK(json_parser_set_input_string(parser, (const unsigned char *)input, length));
+    CHECK(json_parser_reload(parser, document));
+    CHECK(json_document_get_root_node(document) != NULL);
+
+    json_parser_pool_release(parser);
+}
+
+/*
+ * Parse an input with a pooled parser, and emit its events with a pooled
+ * emitter.
+ */
+static void emit(const char *input, size_t length, unsigned char *output, size_t size) {
+    JsonParser *parser = json_parser_pool_acquire();
+    JsonEmitter *emitter = json_emitter_pool_acquire();
+    JsonEvent event;
+    size_t written = 0;
+    int done = 0;
+
+    CHECK(parser != NULL && emitter != NULL);
+    if (!parser || !emitter) {
+        return;
+    }
+
+    CHECK(json_parser_set_input_string(parser, (const unsigned char *)input, length));
+    CHECK(json_emitter_set_output_string(emitter, output, size, &written));
+
+    while (!done) {
+        if (!json_parser_parse(parser, &event)) {
+            CHECK(0);
+            break;
+        }
+        done = event.type == JSON_STREAM_END_EVENT;
+        if (!json_emitter_emit(emitter, &event)) {
+            CHECK(0);
+            break;
+        }
+    }
+
+    CHECK(written > 0 && written < size);
+
+    json_emitter_pool_release(emitter);
+    json_parser_pool_release(parser);
+}
+
+static void test_steady_state(const char *input, size_t length) {
+    TestCounts counts = {0, 0, 0};
+    JsonAllocator allocator = {count_allocate, count_reallocate, count_deallocate, NULL};
+    JsonDocument document;
+    size_t size = 2 * length + 64, allocations, reallocations;
+    unsigned char *output = (unsigned char *)malloc(size);
+    int i;
+
+    CHECK(output != NULL);
+    if (!output) {
+        return;
+    }
+
+    allocator.data = &counts;
+    json_allocator_set(&allocator);
+    CHECK(json_document_initialize(&document));
+
+    for (i = 0; i < WARM_UP_COUNT; i++) {
+        load(input, length, &document);
+        emit(input, length, output, size);
+    }
+
+    allocations = counts.allocations;
+    reallocations = counts.reallocations;
+    CHECK(allocations > 0);
+
+    for (i = 0; i < ITERATION_COUNT; i++) {
+        load(input, length, &document);
+        emit(input, length, output, size);
+    }
+
+    if (counts.allocations != allocations || counts.reallocations != reallocations) {
+        fprintf(stderr, "%zu allocations and %zu reallocations after the warm-up\n", counts.allocations - allocations,
+                counts.reallocations - reallocations);
+        CHECK(0);
+    }
+
+    /* Everything is freed with the allocator it was allocated with. */
+    json_document_delete(&document);
+    json_parser_pool_clear();
+    json_emitter_pool_clear();
+    CHECK(counts.deallocations == counts.allocations);
+
+    json_allocator_set(NULL);
+    free(output);
+}
+
+int main(void) {
+    static const char *names[] = {"twitter.json", "mesh.json"};
+    const char *small = "{\"id\":1,\"user\":{\"name\":\"x\\u00e9\",\"tags\":[true,null,-2.5e3]},\"text\":\"...\"}";
+    size_t i, length;
+
+    test_steady_state(small, strlen(small));
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        char *input = test_read_sample(names[i], &length);
+
+        CHECK(input != NULL);
+        if (input) {
+            test_steady_state(input, length);
+            free(input);
+        }
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,243 @@
+/**
+ * @file test_atoms.c
+ * @brief The atom table interns each string once, and the documents sharing a
+ * table find their members by atom as they do by key.
+ */
+
+#include "test.h"
+
+#define KEY_COUNT 5000
+
+static void test_table(void) {
+    JsonAtomTable table;
+    const JsonChar_t *strings[KEY_COUNT];
+    const JsonChar_t *value;
+    char key[32];
+    size_t length;
+    int a, b, i;
+
+    CHECK(json_atom_table_initialize(&table));
+
+    a = json_atom_table_intern(&table, (const JsonChar_t *)"a", 1);
+    CHECK(a > 0);
+    CHECK(json_atom_table_intern(&table, (const JsonChar_t *)"a", 1) == a);
+    CHECK(json_atom_table_intern(&table, (const JsonChar_t *)"a", -1) == a);
+    CHECK(json_atom_table_find(&table, (const JsonChar_t *)"a", -1) == a);
+
+    /* A string with a NUL, and the empty string, are atoms of their own. */
+    b = json_atom_table_intern(&table, (const JsonChar_t *)"a\0b", 3);
+    CHECK(b > 0 && b != a);
+    CHECK(json_atom_table_intern(&table, (const JsonChar_t *)"", 0) > 0);
+    CHECK(json_atom_table_find(&table, (const JsonChar_t *)"", 0) != a);
+
+    value = json_atom_table_get_string(&table, b, &length);
+    CHECK(value && length == 3 && !memcmp(value, "a\0b", 4));
+
+    /* Never interned. */
+    CHECK(json_atom_table_find(&table, (const JsonChar_t *)"b", 1) == 0);
+    CHECK(json_atom_table_find(&table, (const JsonChar_t *)"a\0", 2) == 0);
+    CHECK(json_atom_table_get_string(&table, 0, NULL) == NULL);
+    CHECK(json_atom_table_get_string(&table, 1000, NULL) == NULL);
+
+    /* The ids and strings stay valid as the table grows. */
+    for (i = 0; i < KEY_COUNT; i++) {
+        int atom;
+
+        snprintf(key, sizeof(key), "key%d", i);
+        atom = json_atom_table_intern(&table, (const JsonChar_t *)key, -1);
+        CHECK(atom == b + 2 + i);
+        strings[i] = json_atom_table_get_string(&table, atom, NULL);
+    }
+    for (i = 0; i < KEY_COUNT; i++) {
+        snprintf(key, sizeof(key), "key%d", i);
+        CHECK(json_atom_table_find(&table, (const JsonChar_t *)key, -1) == b + 2 + i);
+        CHECK(json_atom_table_get_string(&table, b + 2 + i, &length) == strings[i]);
+        CHECK(length == strlen(key) && !strcmp((const char *)strings[i], key));
+    }
+    CHECK(json_atom_table_intern(&table, (const JsonChar_t *)"a", 1) == a);
+
+    json_atom_table_delete(&table);
+}
+
+static int load(const char *input, JsonDocument *document) {
+    JsonParser parser;
+    int result;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+    result = json_parser_reload(&parser, document);
+    json_parser_delete(&parser);
+
+    return result;
+}
+
+static int is_scalar(JsonDocument *document, int node_id, const char *value) {
+    JsonNode *node = json_document_get_node(document, node_id);
+
+    return node && node->data.scalar.length == strlen(value) && !memcmp(node->data.scalar.value, value, strlen(value));
+}
+
+static char *write_node(JsonDocument *document, int node_id) {
+    TestText text = {NULL, 0, 0};
+
+    test_text_append(&text, "", 0);
+    test_write_node(&text, document, node_id);
+
+    return text.start;
+}
+
+/*
+ * Walk a node of a document with an atom table, and the same node of the
+ * document loaded without one: every member is found by atom and by key, as
+ * it is by key in the latter.
+ */
+static void compare_node(JsonDocument *document, int node_id, JsonDocument *plain, int plain_id,
+                         JsonAtomTable *table) {
+    JsonNode *node = json_document_get_node(document, node_id);
+    JsonNode *plain_node = json_document_get_node(plain, plain_id);
+    size_t i, count;
+
+    if (node->type == JSON_ARRAY) {
+        count = (size_t)(node->data.array.items.top - node->data.array.items.start);
+        for (i = 0; i < count; i++) {
+            compare_node(document, node->data.array.items.start[i], plain, plain_node->data.array.items.start[i],
+                         table);
+        }
+        return;
+    }
+    if (node->type != JSON_OBJECT) {
+        return;
+    }
+
+    count = (size_t)(node->data.object.pairs.top - node->data.object.pairs.start);
+    for (i = 0; i < count; i++) {
+        JsonNode *key = json_document_get_node(document, node->data.object.pairs.start[i].key);
+        int atom = json_atom_table_find(table, key->data.scalar.value, (int)key->data.scalar.length);
+        int value = json_document_object_get_value_by_atom(document, node_id, atom);
+        int plain_value = json_document_object_get_value(plain, plain_id, key->data.scalar.value,
+                                                         (int)key->data.scalar.length);
+        char *text, *expected;
+
+        /* The key node holds the string of its atom. */
+        CHECK(atom > 0);
+        CHECK(key->data.scalar.value == json_atom_table_get_string(table, atom, NULL));
+        CHECK(value == json_document_object_get_value(document, node_id, key->data.scalar.value,
+                                                      (int)key->data.scalar.length));
+
+        text = write_node(document, value);
+        expected = write_node(plain, plain_value);
+        CHECK_STRING(text, expected);
+        free(text);
+        free(expected);
+
+        compare_node(document, node->data.object.pairs.start[i].value, plain,
+                     plain_node->data.object.pairs.start[i].value, table);
+    }
+}
+
+static void check_document(JsonDocument *document, JsonAtomTable *table, const char *input) {
+    JsonDocument plain;
+    JsonParser parser;
+    char *text, *expected;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+    CHECK(json_parser_load(&parser, &plain));
+    json_parser_delete(&parser);
+
+    text = test_write_document(document);
+    expected = test_write_document(&plain);
+    CHECK_STRING(text, expected);
+    free(text);
+    free(expected);
+
+    compare_node(document, 1, &plain, 1, table);
+
+    json_document_delete(&plain);
+}
+
+static void test_documents(void) {
+    static const char *first_input = "{\"id\":1,\"name\":\"x\",\"tags\":{\"id\":2,\"a\\nb\":3},\"id\":4}";
+    static const char *second_input = "[{\"name\":\"y\",\"id\":5},{\"other\":6},{}]";
+    JsonAtomTable table;
+    JsonDocument first, second;
+    JsonNode *root;
+    int id, name, other, tags, missing, object;
+
+    CHECK(json_atom_table_initialize(&table));
+    CHECK(json_document_initialize(&first));
+    CHECK(json_document_initialize(&second));
+    json_document_set_atom_table(&first, &table);
+    json_document_set_atom_table(&second, &table);
+
+    CHECK(load(first_input, &first));
+    CHECK(load(second_input, &second));
+    check_document(&first, &table, first_input);
+    check_document(&second, &table, second_input);
+
+    id = json_atom_table_find(&table, (const JsonChar_t *)"id", 2);
+    name = json_atom_table_find(&table, (const JsonChar_t *)"name", 4);
+    other = json_atom_table_find(&table, (const JsonChar_t *)"other", 5);
+    tags = json_atom_table_find(&table, (const JsonChar_t *)"tags", 4);
+    CHECK(id && name && other && tags);
+    CHECK(json_atom_table_find(&table, (const JsonChar_t *)"a\nb", 3) > 0);
+
+    /* One key node per distinct key, and the first member of a key is found. */
+    root = json_document_get_root_node(&first);
+    CHECK(root->data.object.pairs.start[0].key == root->data.object.pairs.start[3].key);
+    CHECK(is_scalar(&first, json_document_object_get_value_by_atom(&first, 1, id), "1"));
+
+    /* The atoms of one document are looked up in the other. */
+    object = json_document_array_get_item(&second, 1, 0);
+    CHECK(is_scalar(&second, json_document_object_get_value_by_atom(&second, object, id), "5"));
+    CHECK(json_document_object_get_value_by_atom(&first, 1, other) == 0);
+    CHECK(json_document_object_get_value_by_atom(&second, object, tags) == 0);
+    CHECK(json_document_object_get_value_by_atom(&second, json_document_array_get_item(&second, 1, 2), id) == 0);
+
+    /* An atom interned after the load, no atom, and an atom out of the table. */
+    missing = json_atom_table_intern(&table, (const JsonChar_t *)"missing", -1);
+    CHECK(missing > 0);
+    CHECK(json_document_object_get_value_by_atom(&first, 1, missing) == 0);
+    CHECK(json_document_object_get_value_by_atom(&first, 1, 0) == 0);
+    CHECK(json_document_object_get_value_by_atom(&first, 1, missing + 100) == 0);
+
+    /* A reloaded document maps the atoms of its new keys. */
+    CHECK(load(second_input, &first));
+    check_document(&first, &table, second_input);
+    CHECK(json_document_object_get_value_by_atom(&first, 1, id) == 0);
+
+    json_document_delete(&first);
+    json_document_delete(&second);
+    json_atom_table_delete(&table);
+}
+
+static void test_sample(void) {
+    JsonAtomTable table;
+    JsonDocument document;
+    size_t length;
+    char *input = test_read_sample("twitter.json", &length);
+
+    CHECK(input != NULL);
+    if (!input) {
+        return;
+    }
+
+    CHECK(json_atom_table_initialize(&table));
+    CHECK(json_document_initialize(&document));
+    json_document_set_atom_table(&document, &table);
+
+    CHECK(load(input, &document));
+    check_document(&document, &table, input);
+
+    json_document_delete(&document);
+    json_atom_table_delete(&table);
+    free(input);
+}
+
+int main(void) {
+    test_table();
+    test_documents();
+    test_sample();
+
+    return TEST_RESULT();
+}
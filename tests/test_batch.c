@@ -0,0 +1,234 @@
+/**
+ * @file test_batch.c
+ * @brief The events and tokens produced in batches match the ones produced
+ * one at a time, whatever the batch size against the token ring, and up to
+ * an error in the middle of a batch.
+ */
+
+#include "test.h"
+
+/* Around the 16 tokens of the ring, and past it. */
+static const size_t capacities[] = {1, 2, 3, 7, 15, 16, 17, 31, 33, 64, 1000};
+
+static const char *inputs[] = {
+    "{}",
+    "[1,-2,3.5e-7,true,false,null,\"a\\\"b\\\\c\\u00e9\\ud83d\\ude00\",{\"k\":[[]]}]",
+    "[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]]",
+    "[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,x]",
+    "{\"a\":1,\"b\":[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17],\"c\" 1}",
+    "[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,\"\\x\"]",
+    "[1,]",
+    "",
+};
+
+/*
+ * Parse an input in batches of `capacity` events, pushed in chunks of `chunk`
+ * bytes if not zero, and trace the events.
+ */
+static char *trace_batch(const char *input, size_t length, size_t capacity, size_t chunk) {
+    JsonEvent *events = (JsonEvent *)malloc(capacity * sizeof(JsonEvent));
+    TestText text = {NULL, 0, 0};
+    JsonParser parser;
+    size_t fed = length, count, i;
+    int result, done = 0;
+
+    if (!events) {
+        abort();
+    }
+
+    test_text_append(&text, "", 0);
+    json_parser_initialize(&parser);
+    if (chunk) {
+        fed = chunk < length ? chunk : length;
+        json_parser_feed(&parser, (const unsigned char *)input, fed, fed == length);
+    } else {
+        json_parser_set_input_string(&parser, (const unsigned char *)input, length);
+    }
+
+    while (!done) {
+        result = json_parser_parse_batch(&parser, events, capacity, &count);
+        CHECK(count <= capacity);
+        for (i = 0; i < count; i++) {
+            test_trace_event(&text, events + i);
+            done = events[i].type == JSON_STREAM_END_EVENT;
+            json_event_delete(events + i);
+        }
+        if (result == MYJSON_NEED_MORE_INPUT) {
+            size_t size = chunk < length - fed ? chunk : length - fed;
+
+            CHECK(chunk && (fed < length || length == 0));
+            json_parser_feed(&parser, (const unsigned char *)input + fed, size, fed + size == length);
+            fed += size;
+            continue;
+        }
+        if (!result) {
+            test_text_append(&text, "!", 1);
+
+            /* No events after an error. */
+            CHECK(json_parser_parse_batch(&parser, events, capacity, &count) == MYJSON_SUCCESS);
+            CHECK(count == 0);
+            break;
+        }
+        CHECK(count == capacity || done);
+    }
+
+    json_parser_delete(&parser);
+    free(events);
+
+    return text.start;
+}
+
+static void check_events(const char *input, size_t length) {
+    static const size_t chunks[] = {0, 4096, 7, 1};
+    char *expected = test_trace_string(input, length);
+    size_t i, j;
+
+    for (i = 0; i < sizeof(capacities) / sizeof(capacities[0]); i++) {
+        /* The samples are only pushed in large chunks. */
+        for (j = 0; j < (length < 4096 ? 4 : 2); j++) {
+            char *trace = trace_batch(input, length, capacities[i], chunks[j]);
+
+            if (strcmp(trace, expected)) {
+                fprintf(stderr, "batches of %zu events, chunks of %zu bytes\n", capacities[i], chunks[j]);
+                CHECK_STRING(trace, expected);
+            }
+            free(trace);
+        }
+    }
+
+    free(expected);
+}
+
+static void test_token(TestText *text, const JsonToken *token) {
+    static const char types[] = "etndfsi]}[{:,";
+
+    test_text_append(text, types + token->type, 1);
+    if (token->data.value) {
+        test_text_append(text, ":", 1);
+        test_text_append(text, (const char *)token->data.value, token->data.length);
+        test_text_append(text, " ", 1);
+    }
+}
+
+/*
+ * Scan an input in batches of `capacity` tokens, and trace the tokens.
+ */
+static char *trace_scan(const char *input, size_t length, size_t capacity) {
+    JsonToken *tokens = (JsonToken *)malloc(capacity * sizeof(JsonToken));
+    TestText text = {NULL, 0, 0};
+    JsonParser parser;
+    size_t count, i;
+    int result, done = 0;
+
+    if (!tokens) {
+        abort();
+    }
+
+    test_text_append(&text, "", 0);
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, length);
+
+    while (!done) {
+        result = json_parser_scan_batch(&parser, tokens, capacity, &count);
+        CHECK(count <= capacity);
+        for (i = 0; i < count; i++) {
+            test_token(&text, tokens + i);
+            done = tokens[i].type == JSON_EOF_TOKEN;
+            json_token_delete(tokens + i);
+        }
+        if (!result) {
+            test_text_append(&text, "!", 1);
+            CHECK(!json_parser_scan_batch(&parser, tokens, capacity, &count));
+            CHECK(count == 0);
+            break;
+        }
+        CHECK(result == MYJSON_SUCCESS);
+        CHECK(count == capacity || done);
+    }
+
+    /* Nothing comes after the EOF token. */
+    if (done) {
+        CHECK(json_parser_scan_batch(&parser, tokens, capacity, &count) == MYJSON_SUCCESS);
+        CHECK(count == 0);
+    }
+
+    json_parser_delete(&parser);
+    free(tokens);
+
+    return text.start;
+}
+
+static void check_tokens(const char *input, size_t length) {
+    char *expected = trace_scan(input, length, 1);
+    size_t i;
+
+    for (i = 1; i < sizeof(capacities) / sizeof(capacities[0]); i++) {
+        char *trace = trace_scan(input, length, capacities[i]);
+
+        if (strcmp(trace, expected)) {
+            fprintf(stderr, "batches of %zu tokens\n", capacities[i]);
+            CHECK_STRING(trace, expected);
+        }
+        free(trace);
+    }
+
+    free(expected);
+}
+
+static void test_inputs(void) {
+    size_t k, i;
+
+    for (k = 0; k < TEST_KERNEL_COUNT; k++) {
+        if (!json_kernel_select(test_kernels[k])) {
+            continue;
+        }
+        for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+            check_events(inputs[i], strlen(inputs[i]));
+            check_tokens(inputs[i], strlen(inputs[i]));
+        }
+    }
+
+    json_kernel_select(JSON_AUTO_KERNEL);
+}
+
+static void test_scan(void) {
+    char *trace;
+
+    trace = trace_scan("{\"a\":[1,2.5,true,null,\"x\\n\"]}", 29, 4);
+    CHECK_STRING(trace, "{s:a :[i:1 ,d:2.5 ,t:true ,n:null ,s:x\\n ]}e");
+    free(trace);
+
+    /* The tokens before the error are produced, with no grammar checks. */
+    trace = trace_scan("]]{:,1 \"\\x\"", 11, 64);
+    CHECK_STRING(trace, "]]{:,i:1 !");
+    free(trace);
+
+    trace = trace_scan("", 0, 64);
+    CHECK_STRING(trace, "e");
+    free(trace);
+}
+
+static void test_samples(void) {
+    static const char *names[] = {"twitter.json", "mesh.json"};
+    size_t i, length;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        char *input = test_read_sample(names[i], &length);
+
+        CHECK(input != NULL);
+        if (!input) {
+            continue;
+        }
+        check_events(input, length);
+        check_tokens(input, length);
+        free(input);
+    }
+}
+
+int main(void) {
+    test_inputs();
+    test_scan();
+    test_samples();
+
+    return TEST_RESULT();
+}
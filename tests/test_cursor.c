@@ -0,0 +1,110 @@
+/**
+ * @file test_cursor.c
+ * @brief The cursor over the structural index: stepping, lookups, reads, and
+ * the errors of malformed inputs.
+ */
+
+#include "test.h"
+
+static const char *document_text =
+    "{\"a\":1,\"b\":[10,[20,21],{\"c\":\"x\"}],\"d\":\"\\u00e9\\n\",\"e\":true,\"f\":null,\"g\":-2.5,"
+    "\"h\":{\"deep\":[[[{}]]]},\"i\":18446744073709551615}";
+
+static void test_cursor(void) {
+    JsonParser parser;
+    JsonCursor cursor;
+    JsonValueType type;
+    const JsonChar_t *value;
+    JsonChar_t decoded[16];
+    size_t length;
+    int64_t integer;
+    double real;
+    int flags, boolean;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)document_text, strlen(document_text));
+    CHECK(json_cursor_initialize(&cursor, &parser));
+
+    CHECK(json_cursor_get_type(&cursor, &type) && type == JSON_OBJECT);
+    CHECK(json_cursor_enter(&cursor));
+    CHECK(json_cursor_get_key(&cursor, &value, &length, NULL) && length == 1 && value[0] == 'a');
+    CHECK(json_cursor_get_int64(&cursor, &integer) && integer == 1);
+
+    /* Step into the array, over its items, and out of it. */
+    CHECK(json_cursor_next(&cursor));
+    CHECK(json_cursor_get_key(&cursor, &value, &length, NULL) && length == 1 && value[0] == 'b');
+    CHECK(json_cursor_get_type(&cursor, &type) && type == JSON_ARRAY);
+    CHECK(json_cursor_enter(&cursor));
+    CHECK(json_cursor_get_double(&cursor, &real) && real == 10.0);
+    CHECK(json_cursor_next(&cursor));
+    CHECK(json_cursor_get_type(&cursor, &type) && type == JSON_ARRAY);
+    CHECK(json_cursor_next(&cursor));
+    CHECK(json_cursor_get_type(&cursor, &type) && type == JSON_OBJECT);
+    CHECK(json_cursor_enter(&cursor));
+    CHECK(json_cursor_get_key(&cursor, &value, &length, NULL) && length == 1 && value[0] == 'c');
+    CHECK(json_cursor_get_string(&cursor, &value, &length, &flags) && length == 1 && value[0] == 'x');
+    CHECK(!json_cursor_next(&cursor));
+    CHECK(parser.error.type == JSON_NO_ERROR);
+    CHECK(json_cursor_leave(&cursor));
+    CHECK(!json_cursor_next(&cursor));
+    CHECK(json_cursor_leave(&cursor));
+
+    /* Look the fields up forward. */
+    CHECK(json_cursor_find_field(&cursor, (const JsonChar_t *)"d", -1));
+    CHECK(json_cursor_get_string(&cursor, &value, &length, &flags));
+    CHECK(flags & JSON_ESCAPED_FLAG);
+    CHECK(json_string_unescape(value, length, decoded, &length));
+    CHECK(length == 3 && !memcmp(decoded, "\xC3\xA9\n", 3));
+
+    CHECK(json_cursor_find_field(&cursor, (const JsonChar_t *)"e", 1));
+    CHECK(!json_cursor_get_null(&cursor));
+    CHECK(json_cursor_get_boolean(&cursor, &boolean) && boolean == 1);
+    CHECK(json_cursor_find_field(&cursor, (const JsonChar_t *)"f", -1));
+    CHECK(json_cursor_get_null(&cursor));
+    CHECK(json_cursor_find_field(&cursor, (const JsonChar_t *)"g", -1));
+    CHECK(!json_cursor_get_int64(&cursor, &integer));
+    CHECK(json_cursor_get_double(&cursor, &real) && real == -2.5);
+
+    /* A value not in the int64_t range is only read as a double. */
+    CHECK(json_cursor_find_field(&cursor, (const JsonChar_t *)"i", -1));
+    CHECK(!json_cursor_get_int64(&cursor, &integer));
+    CHECK(json_cursor_get_double(&cursor, &real) && real == 18446744073709551615.0);
+
+    /* Fields are only searched forward. */
+    CHECK(!json_cursor_find_field(&cursor, (const JsonChar_t *)"a", -1));
+    CHECK(parser.error.type == JSON_NO_ERROR);
+
+    json_cursor_delete(&cursor);
+    json_parser_delete(&parser);
+}
+
+static void test_cursor_malformed(void) {
+    static const char *inputs[] = {"[1,[2,3]", "{\"a\":[1,2,3}", "[\"abc", "[1 2]"};
+    size_t i;
+
+    for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        JsonParser parser;
+        JsonCursor cursor;
+        int moved = 1, steps = 0;
+
+        json_parser_initialize(&parser);
+        json_parser_set_input_string(&parser, (const unsigned char *)inputs[i], strlen(inputs[i]));
+        if (json_cursor_initialize(&cursor, &parser)) {
+            if (json_cursor_enter(&cursor)) {
+                while (moved && steps++ < 10) {
+                    moved = json_cursor_next(&cursor);
+                }
+            }
+            json_cursor_delete(&cursor);
+        }
+        CHECK(parser.error.type != JSON_NO_ERROR);
+        json_parser_delete(&parser);
+    }
+}
+
+int main(void) {
+    test_cursor();
+    test_cursor_malformed();
+
+    return TEST_RESULT();
+}
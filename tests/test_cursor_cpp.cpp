@@ -0,0 +1,223 @@
+/**
+ * @file test_cursor_cpp.cpp
+ * @brief The C++ cursor walks a sample as the document loaded from it, and
+ * throws json::exception on malformed inputs and on values of another type.
+ */
+
+#include "test.h"
+
+static void write_number(std::string &text, double value) {
+    char number[32];
+
+    snprintf(number, sizeof(number), "%.17g", value);
+    text += number;
+}
+
+/*
+ * Write the current value of a cursor as compact JSON, with the strings
+ * decoded and the numbers as doubles.
+ */
+static void write_cursor(json::cursor &cursor, std::string &text) {
+    bool first = true;
+
+    switch (cursor.type()) {
+        case JSON_ARRAY:
+        case JSON_OBJECT: {
+            bool object = cursor.type() == JSON_OBJECT;
+
+            text += object ? '{' : '[';
+            if (cursor.enter()) {
+                do {
+                    if (!first) {
+                        text += ',';
+                    }
+                    first = false;
+                    if (object) {
+                        text += '"' + cursor.key() + "\":";
+                    }
+                    write_cursor(cursor, text);
+                } while (cursor.next());
+            }
+            cursor.leave();
+            text += object ? '}' : ']';
+            break;
+        }
+        case JSON_STRING:
+            text += '"' + cursor.get_string() + '"';
+            break;
+        case JSON_INTEGER:
+        case JSON_DOUBLE:
+            write_number(text, cursor.get_double());
+            break;
+        case JSON_BOOLOEAN:
+            text += cursor.get_boolean() ? "true" : "false";
+            break;
+        default:
+            CHECK(cursor.get_null());
+            text += "null";
+            break;
+    }
+}
+
+static void write_node(JsonDocument *document, int node_id, std::string &text) {
+    JsonNode *node = json_document_get_node(document, node_id);
+
+    switch (node->type) {
+        case JSON_ARRAY:
+            text += '[';
+            for (JsonNodeItem *item = node->data.array.items.start; item < node->data.array.items.top; item++) {
+                if (item != node->data.array.items.start) {
+                    text += ',';
+                }
+                write_node(document, *item, text);
+            }
+            text += ']';
+            break;
+        case JSON_OBJECT:
+            text += '{';
+            for (JsonNodePair *pair = node->data.object.pairs.start; pair < node->data.object.pairs.top; pair++) {
+                if (pair != node->data.object.pairs.start) {
+                    text += ',';
+                }
+                write_node(document, pair->key, text);
+                text += ':';
+                write_node(document, pair->value, text);
+            }
+            text += '}';
+            break;
+        case JSON_STRING:
+            text += '"';
+            text.append(reinterpret_cast<const char *>(node->data.scalar.value), node->data.scalar.length);
+            text += '"';
+            break;
+        case JSON_INTEGER:
+            write_number(text, node->data.scalar.flags & JSON_UNSIGNED_FLAG
+                                   ? static_cast<double>(node->data.scalar.number.uinteger)
+                                   : static_cast<double>(node->data.scalar.number.integer));
+            break;
+        case JSON_DOUBLE:
+            write_number(text, node->data.scalar.number.real);
+            break;
+        default:
+            text.append(reinterpret_cast<const char *>(node->data.scalar.value), node->data.scalar.length);
+            break;
+    }
+}
+
+static void test_samples() {
+    static const char *names[] = {"twitter.json", "mesh.json", "random.json"};
+
+    for (const char *name : names) {
+        size_t length;
+        char *input = test_read_sample(name, &length);
+        std::string walked, expected;
+        JsonDocument document;
+        JsonParser parser;
+
+        CHECK(input != NULL);
+        if (!input) {
+            continue;
+        }
+
+        json_parser_initialize(&parser);
+        json_parser_set_input_string(&parser, reinterpret_cast<const unsigned char *>(input), length);
+        CHECK(json_parser_load(&parser, &document));
+        json_parser_delete(&parser);
+        write_node(&document, 1, expected);
+        json_document_delete(&document);
+
+        try {
+            json::cursor cursor(std::string_view(input, length));
+
+            write_cursor(cursor, walked);
+        } catch (const json::exception &error) {
+            fprintf(stderr, "%s: %s\n", name, error.what());
+            CHECK(0);
+        }
+        CHECK(walked == expected);
+
+        free(input);
+    }
+}
+
+static void test_lookups() {
+    json::cursor cursor("{\"a\":1,\"b\":[true,null],\"c\\n\":\"x\\u00e9\",\"d\":-2.5}");
+
+    CHECK(cursor.type() == JSON_OBJECT);
+    CHECK(cursor.enter());
+    CHECK(cursor.key() == "a" && cursor.get_int64() == 1);
+    CHECK(cursor.find_field("b"));
+    CHECK(cursor.enter());
+    CHECK(cursor.get_boolean());
+    CHECK(cursor.next() && cursor.get_null());
+    CHECK(!cursor.next());
+    cursor.leave();
+    CHECK(cursor.find_field("d"));
+    CHECK(cursor.get_double() == -2.5);
+
+    /* The fields are only searched forward. */
+    CHECK(!cursor.find_field("c\n"));
+}
+
+/*
+ * Walk an input, and return the message of the exception thrown, or NULL.
+ */
+static const char *walk_malformed(const char *input) {
+    std::string text;
+
+    try {
+        json::cursor cursor(input);
+
+        write_cursor(cursor, text);
+    } catch (const json::exception &error) {
+        return error.what();
+    }
+
+    return NULL;
+}
+
+static void test_exceptions() {
+    static const char *inputs[] = {"[1,[2,3]", "{\"a\":[1,2,3}", "[\"abc", "[1 2]", "{\"a\" 1}", "[1,]", ""};
+
+    for (const char *input : inputs) {
+        const char *message = walk_malformed(input);
+
+        if (!message) {
+            fprintf(stderr, "no exception for %s\n", input);
+        }
+        CHECK(message != NULL && message[0] != '\0');
+    }
+
+    /* A value of another type. */
+    json::cursor cursor("[\"x\",1.5]");
+    bool thrown = false;
+
+    CHECK(cursor.enter());
+    try {
+        cursor.get_int64();
+    } catch (const json::exception &error) {
+        thrown = true;
+        CHECK(!strcmp(error.what(), "not an integer"));
+    }
+    CHECK(thrown);
+
+    /* The cursor goes on after a read of another type. */
+    CHECK(cursor.get_string() == "x");
+    CHECK(cursor.next());
+    thrown = false;
+    try {
+        cursor.get_string();
+    } catch (const json::exception &) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(cursor.get_double() == 1.5);
+}
+
+int main() {
+    test_samples();
+    test_lookups();
+    test_exceptions();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,246 @@
+/**
+ * @file test_encoding.c
+ * @brief UTF-16 and UTF-32 input, with and without a byte order mark, and
+ * the emitter output in each encoding.
+ */
+
+#include "test.h"
+
+static const char *texts[] = {
+    "{\"name\":\"\xD0\x9B\xD0\xB5\xD0\xBE\xD0\xBD\xD0\xB0\xD1\x80\xD0\xB4\",\"emoji\":\"\xF0\x9F\x98\x80\","
+    "\"list\":[1,-2.5,true,false,null,\"\xE2\x82\xAC\"],\"escaped\":\"a\\\"b\\\\c\\n\\u00e9\"}",
+    "[\"\xE4\xB8\xAD\xE6\x96\x87\",{\"\xC3\xA9t\xC3\xA9\":\"\xF4\x8F\xBF\xBF\"}]",
+    "42",
+    "\"x\"",
+};
+
+/*
+ * Append a code point as UTF-16 or UTF-32 (width 2 or 4).
+ */
+static void put_code(unsigned char *output, size_t *size, unsigned int code, int width, int big_endian) {
+    unsigned int units[2] = {code, 0};
+    size_t count = 1, i, k;
+
+    if (width == 2 && code >= 0x10000) {
+        units[0] = 0xD800 + ((code - 0x10000) >> 10);
+        units[1] = 0xDC00 + ((code - 0x10000) & 0x3FF);
+        count = 2;
+    }
+
+    for (i = 0; i < count; i++) {
+        for (k = 0; k < (size_t)width; k++) {
+            size_t shift = big_endian ? (width - 1 - k) * 8 : k * 8;
+
+            output[(*size)++] = (unsigned char)(units[i] >> shift);
+        }
+    }
+}
+
+/*
+ * Encode a UTF-8 text as UTF-16 or UTF-32, maybe with a byte order mark.
+ */
+static unsigned char *encode(const char *text, int width, int big_endian, int bom, size_t *length) {
+    const unsigned char *pointer = (const unsigned char *)text;
+    unsigned char *output = (unsigned char *)malloc((strlen(text) + 1) * 8);
+    size_t size = 0;
+
+    if (!output) {
+        abort();
+    }
+
+    if (bom) {
+        put_code(output, &size, 0xFEFF, width, big_endian);
+    }
+
+    while (*pointer) {
+        unsigned int code;
+
+        if (*pointer < 0x80) {
+            code = *pointer++;
+        } else if (*pointer < 0xE0) {
+            code = ((pointer[0] & 0x1Fu) << 6) | (pointer[1] & 0x3Fu);
+            pointer += 2;
+        } else if (*pointer < 0xF0) {
+            code = ((pointer[0] & 0x0Fu) << 12) | ((pointer[1] & 0x3Fu) << 6) | (pointer[2] & 0x3Fu);
+            pointer += 3;
+        } else {
+            code = ((pointer[0] & 0x07u) << 18) | ((pointer[1] & 0x3Fu) << 12) | ((pointer[2] & 0x3Fu) << 6) |
+                   (pointer[3] & 0x3Fu);
+            pointer += 4;
+        }
+
+        put_code(output, &size, code, width, big_endian);
+    }
+
+    *length = size;
+    return output;
+}
+
+static JsonEncoding encoding_of(int width, int big_endian) {
+    if (width == 2) {
+        return big_endian ? JSON_UTF16BE_ENCODING : JSON_UTF16LE_ENCODING;
+    }
+
+    return big_endian ? JSON_UTF32BE_ENCODING : JSON_UTF32LE_ENCODING;
+}
+
+/*
+ * Parse an input into a trace, and get the encoding of its STREAM-START event.
+ */
+static char *trace_input(const unsigned char *input, size_t length, JsonEncoding *encoding) {
+    JsonParser parser;
+    JsonEvent event;
+    TestText text = {NULL, 0, 0};
+
+    test_text_append(&text, "", 0);
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, input, length);
+
+    *encoding = JSON_ANY_ENCODING;
+    if (json_parser_parse(&parser, &event)) {
+        if (event.type == JSON_STREAM_START_EVENT) {
+            *encoding = event.data.stream_start.encoding;
+        }
+        test_trace_event(&text, &event);
+        json_event_delete(&event);
+        test_trace_parser(&parser, &text);
+    } else {
+        test_text_append(&text, "!", 1);
+    }
+
+    json_parser_delete(&parser);
+
+    return text.start;
+}
+
+static void test_input(void) {
+    size_t i, length;
+    int width, big_endian, bom;
+
+    for (i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+        JsonEncoding encoding;
+        char *expected = trace_input((const unsigned char *)texts[i], strlen(texts[i]), &encoding);
+
+        CHECK(encoding == JSON_UTF8_ENCODING);
+        CHECK(expected[strlen(expected) - 1] == ')');
+
+        for (width = 2; width <= 4; width += 2) {
+            for (big_endian = 0; big_endian < 2; big_endian++) {
+                for (bom = 0; bom < 2; bom++) {
+                    unsigned char *input = encode(texts[i], width, big_endian, bom, &length);
+                    char *trace = trace_input(input, length, &encoding);
+
+                    CHECK_STRING(trace, expected);
+                    CHECK(encoding == encoding_of(width, big_endian));
+
+                    free(trace);
+                    free(input);
+                }
+            }
+        }
+
+        free(expected);
+    }
+}
+
+static void test_malformed(void) {
+    /* A lone high surrogate, and a lone low one. */
+    static const unsigned char high[] = {'[', 0, '"', 0, 0x3D, 0xD8, '"', 0, ']', 0};
+    static const unsigned char low[] = {0xFF, 0xFE, '[', 0, '"', 0, 0x00, 0xDC, '"', 0, ']', 0};
+    /* A code point above U+10FFFF. */
+    static const unsigned char large[] = {0, 0, 0, '[', 0, 0, 0, '"', 0, 0x11, 0, 0, 0, 0, 0, '"', 0, 0, 0, ']'};
+    JsonEncoding encoding;
+    char *trace;
+
+    trace = trace_input(high, sizeof(high), &encoding);
+    CHECK(trace[strlen(trace) - 1] == '!');
+    free(trace);
+
+    trace = trace_input(low, sizeof(low), &encoding);
+    CHECK(trace[strlen(trace) - 1] == '!');
+    free(trace);
+
+    trace = trace_input(large, sizeof(large), &encoding);
+    CHECK(trace[strlen(trace) - 1] == '!');
+    free(trace);
+}
+
+/*
+ * Parse a UTF-8 text and emit its events in an encoding.
+ */
+static unsigned char *emit(const char *text, JsonEncoding encoding, size_t *length) {
+    size_t size = strlen(text) * 8 + 64;
+    unsigned char *output = (unsigned char *)malloc(size);
+    JsonParser parser;
+    JsonEmitter emitter;
+    JsonEvent event;
+    int done = 0;
+
+    if (!output) {
+        abort();
+    }
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)text, strlen(text));
+    json_emitter_initialize(&emitter);
+    json_emitter_set_output_string(&emitter, output, size, length);
+    json_emitter_set_encoding(&emitter, encoding);
+
+    while (!done) {
+        if (!json_parser_parse(&parser, &event)) {
+            CHECK(0);
+            break;
+        }
+        done = event.type == JSON_STREAM_END_EVENT;
+        CHECK(json_emitter_emit(&emitter, &event));
+    }
+
+    json_emitter_delete(&emitter);
+    json_parser_delete(&parser);
+
+    return output;
+}
+
+static void test_output(void) {
+    size_t i, length, expected_length;
+    int width, big_endian;
+
+    for (i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+        JsonEncoding encoding;
+        unsigned char *output = emit(texts[i], JSON_UTF8_ENCODING, &length);
+        char *expected = trace_input((const unsigned char *)texts[i], strlen(texts[i]), &encoding);
+
+        /* The texts are compact: they are written back as they are. */
+        CHECK(length == strlen(texts[i]) && !memcmp(output, texts[i], length));
+        free(output);
+
+        for (width = 2; width <= 4; width += 2) {
+            for (big_endian = 0; big_endian < 2; big_endian++) {
+                unsigned char *encoded = encode(texts[i], width, big_endian, 1, &expected_length);
+                char *trace;
+
+                output = emit(texts[i], encoding_of(width, big_endian), &length);
+                CHECK(length == expected_length && !memcmp(output, encoded, length));
+
+                /* And the output is parsed back to the same events. */
+                trace = trace_input(output, length, &encoding);
+                CHECK_STRING(trace, expected);
+                CHECK(encoding == encoding_of(width, big_endian));
+
+                free(trace);
+                free(encoded);
+                free(output);
+            }
+        }
+
+        free(expected);
+    }
+}
+
+int main(void) {
+    test_input();
+    test_malformed();
+    test_output();
+
+    return TEST_RESULT();
+}
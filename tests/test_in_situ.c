@@ -0,0 +1,197 @@
+/**
+ * @file test_in_situ.c
+ * @brief The scalars borrowed from a string input, and the strings unescaped
+ * in place in a mutable input.
+ */
+
+#include "test.h"
+
+static const char *input_text = "{\"plain\":\"abc\",\"escaped\":\"a\\\"b\\\\c\\u00e9\\n\",\"key\\t\":[1,-2.5e3,true,"
+                                "null,\"\\ud83d\\ude00\",\"\",\"\\/\"],\"long\":\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+                                "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\\u0041\"}";
+
+static int points_into(const JsonChar_t *value, size_t length, const unsigned char *buffer, size_t size) {
+    return value >= buffer && value + length <= buffer + size;
+}
+
+/*
+ * Parse a mutable copy of the input: every string is borrowed from the copy,
+ * decoded in place, NUL-terminated, and not flagged as escaped.
+ */
+static void check_mutable(const char *input) {
+    size_t size = strlen(input), strings = 0;
+    unsigned char *buffer = (unsigned char *)malloc(size + 1);
+    char *expected = test_trace_string(input, size);
+    TestText trace = {NULL, 0, 0};
+    JsonParser parser;
+    JsonEvent event;
+    int done = 0;
+
+    if (!buffer) {
+        abort();
+    }
+    memcpy(buffer, input, size + 1);
+
+    test_text_append(&trace, "", 0);
+    json_parser_initialize(&parser);
+    CHECK(json_parser_set_input_mutable_string(&parser, buffer, size));
+
+    while (!done) {
+        if (!json_parser_parse(&parser, &event)) {
+            test_text_append(&trace, "!", 1);
+            break;
+        }
+        if (event.type == JSON_SCALAR_EVENT && event.data.scalar.type == JSON_STRING) {
+            CHECK(event.data.scalar.flags & JSON_BORROWED_FLAG);
+            CHECK(!(event.data.scalar.flags & JSON_ESCAPED_FLAG));
+            CHECK(points_into(event.data.scalar.value, event.data.scalar.length + 1, buffer, size));
+            CHECK(event.data.scalar.value[event.data.scalar.length] == '\0');
+            strings++;
+        }
+        test_trace_event(&trace, &event);
+        done = event.type == JSON_STREAM_END_EVENT;
+        json_event_delete(&event);
+    }
+
+    CHECK(strings > 0);
+    CHECK_STRING(trace.start, expected);
+    CHECK(memcmp(buffer, input, size));
+
+    json_parser_delete(&parser);
+    test_text_clear(&trace);
+    free(expected);
+    free(buffer);
+}
+
+/*
+ * Parse a read-only input: every string is borrowed verbatim, and flagged as
+ * escaped if it has escape sequences.
+ */
+static void check_borrowed(const char *input) {
+    size_t size = strlen(input), escaped = 0;
+    const unsigned char *buffer = (const unsigned char *)input;
+    JsonParser parser;
+    JsonEvent event;
+    int done = 0;
+
+    json_parser_initialize(&parser);
+    CHECK(json_parser_set_input_string(&parser, buffer, size));
+
+    while (!done) {
+        if (!json_parser_parse(&parser, &event)) {
+            CHECK(0);
+            break;
+        }
+        if (event.type == JSON_SCALAR_EVENT && event.data.scalar.type == JSON_STRING) {
+            const JsonChar_t *value = event.data.scalar.value;
+            size_t length = event.data.scalar.length;
+
+            CHECK(event.data.scalar.flags & JSON_BORROWED_FLAG);
+            CHECK(points_into(value, length, buffer, size));
+            CHECK(value[-1] == '"' && value[length] == '"');
+            CHECK(!(event.data.scalar.flags & JSON_ESCAPED_FLAG) == !memchr(value, '\\', length));
+            escaped += (event.data.scalar.flags & JSON_ESCAPED_FLAG) != 0;
+        }
+        done = event.type == JSON_STREAM_END_EVENT;
+        json_event_delete(&event);
+    }
+
+    CHECK(escaped > 0);
+    json_parser_delete(&parser);
+}
+
+/*
+ * The strings of a document loaded from a mutable input stay in the input,
+ * after the parser is deleted.
+ */
+static void test_document(void) {
+    size_t size = strlen(input_text);
+    unsigned char *buffer = (unsigned char *)malloc(size + 1);
+    JsonParser parser;
+    JsonDocument document;
+    JsonNode *node;
+    char *text;
+
+    if (!buffer) {
+        abort();
+    }
+    memcpy(buffer, input_text, size + 1);
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_mutable_string(&parser, buffer, size);
+    CHECK(json_parser_load(&parser, &document));
+    json_parser_delete(&parser);
+
+    node = json_document_get_node(&document,
+                                  json_document_object_get_value(&document, 1, (const JsonChar_t *)"escaped", 7));
+    CHECK(node && node->type == JSON_STRING);
+    if (node) {
+        CHECK(points_into(node->data.scalar.value, node->data.scalar.length, buffer, size));
+        CHECK(node->data.scalar.length == 8 && !memcmp(node->data.scalar.value, "a\"b\\c\xC3\xA9\n", 8));
+    }
+
+    node = json_document_get_node(&document,
+                                  json_document_object_get_value(&document, 1, (const JsonChar_t *)"key\t", 4));
+    CHECK(node && node->type == JSON_ARRAY);
+
+    text = test_write_document(&document);
+    CHECK_STRING(text, "{\"plain\":\"abc\",\"escaped\":\"a\"b\\c\xC3\xA9\n\",\"key\t\":[1,-2.5e3,true,null,"
+                       "\"\xF0\x9F\x98\x80\",\"\",\"/\"],\"long\":\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+                       "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaA\"}");
+    free(text);
+
+    json_document_delete(&document);
+    free(buffer);
+}
+
+static void test_events(void) {
+    size_t k;
+
+    for (k = 0; k < TEST_KERNEL_COUNT; k++) {
+        if (!json_kernel_select(test_kernels[k])) {
+            continue;
+        }
+        check_mutable(input_text);
+        check_borrowed(input_text);
+    }
+
+    json_kernel_select(JSON_AUTO_KERNEL);
+}
+
+/*
+ * A malformed escape fails, without reading past the input.
+ */
+static void test_malformed(void) {
+    static const char *inputs[] = {"[\"a\\x\"]", "[\"\\u12\"]", "[\"\\ud800\"]", "[\"abc"};
+    size_t i;
+
+    for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        size_t size = strlen(inputs[i]);
+        unsigned char *buffer = (unsigned char *)malloc(size);
+        TestText trace = {NULL, 0, 0};
+        JsonParser parser;
+
+        if (!buffer) {
+            abort();
+        }
+        memcpy(buffer, inputs[i], size);
+
+        test_text_append(&trace, "", 0);
+        json_parser_initialize(&parser);
+        json_parser_set_input_mutable_string(&parser, buffer, size);
+        CHECK(!test_trace_parser(&parser, &trace));
+        CHECK(parser.error.type == JSON_SCANNER_ERROR);
+
+        json_parser_delete(&parser);
+        test_text_clear(&trace);
+        free(buffer);
+    }
+}
+
+int main(void) {
+    test_events();
+    test_document();
+    test_malformed();
+
+    return TEST_RESULT();
+}
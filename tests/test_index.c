@@ -0,0 +1,202 @@
+/**
+ * @file test_index.c
+ * @brief The structural index and the events it feeds, with every kernel.
+ *
+ * Each kernel supported by the CPU is forced in turn: the small inputs must
+ * produce the expected events, and the generated and sample inputs the same
+ * events as with the portable kernel.
+ */
+
+#include "test.h"
+
+typedef struct TestCase {
+    const char *input;    /**< The input. */
+    const char *expected; /**< The trace of its events. */
+} TestCase;
+
+static const TestCase cases[] = {
+    {"{}", "(<{}>)"},
+    {" [ ] ", "(<[]>)"},
+    {"[1,-2,3.5,true,false,null]", "(<[i:1 i:-2 d:3.5 b:true b:false n:null ]>)"},
+    {"{\"a\":{\"b\":[\"c\",{}]},\"d\":\"\"}", "(<{s:a {s:b [s:c {}]}s:d s: }>)"},
+    {"\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"", "(<s:\"\\/\b\f\n\r\t >)"},
+    {"\"\\u00e9\\ud83d\\ude00\"", "(<s:\xC3\xA9\xF0\x9F\x98\x80 >)"},
+    {"[\"[{,:}]\"]", "(<[s:[{,:}] ]>)"},
+    {"\"\\\\\"", "(<s:\\ >)"},
+    {"\t\r\n 0 \n", "(<i:0 >)"},
+    {"", "(!"},
+    {"{", "(<{!"},
+    {"[1,]", "(<[i:1 !"},
+    {"[1 2]", "(<[i:1 !"},
+    {"{\"a\" 1}", "(<{s:a !"},
+    {"\"abc", "(!"},
+    {"[tru]", "(<[!"},
+    {"1 2", "(<i:1 >!"},
+};
+
+/*
+ * Inputs whose strings, escapes and scalars fall on every position of the
+ * 64-byte blocks of the index.
+ */
+static void test_generated(void) {
+    size_t shift, k;
+
+    for (shift = 0; shift < 140; shift++) {
+        TestText input = {NULL, 0, 0};
+        char *expected = NULL;
+
+        test_text_append(&input, "[", 1);
+        for (k = 0; k < shift; k++) {
+            test_text_append(&input, " ", 1);
+        }
+        test_text_append(&input, "\"", 1);
+        for (k = 0; k < shift % 9; k++) {
+            test_text_append(&input, "\\\\", 2);
+        }
+        test_text_append(&input, "\\\"x\",", 5);
+        for (k = 0; k < shift % 5; k++) {
+            test_text_append(&input, "\"\\\\\",", 5);
+        }
+        test_text_append(&input, "{\"key\":\"", 8);
+        for (k = 0; k < shift; k++) {
+            test_text_append(&input, k % 11 ? "v" : "\\u0041", k % 11 ? 1 : 6);
+        }
+        test_text_append(&input, "\",\"n\":-123456.5e-3},true,null,[[[]]]]", 37);
+
+        for (k = 0; k < TEST_KERNEL_COUNT; k++) {
+            char *trace;
+
+            if (!json_kernel_select(test_kernels[k])) {
+                continue;
+            }
+            trace = test_trace_string(input.start, input.length);
+            if (!expected) {
+                expected = trace;
+                CHECK(!strchr(trace, '!'));
+            } else {
+                CHECK_STRING(trace, expected);
+                free(trace);
+            }
+        }
+
+        free(expected);
+        test_text_clear(&input);
+    }
+
+    json_kernel_select(JSON_AUTO_KERNEL);
+}
+
+static void test_samples(void) {
+    static const char *names[] = {"twitter.json", "mesh.json", "random.json"};
+    size_t i, k, length;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        char *input = test_read_sample(names[i], &length);
+        char *expected = NULL;
+
+        CHECK(input != NULL);
+        if (!input) {
+            continue;
+        }
+
+        for (k = 0; k < TEST_KERNEL_COUNT; k++) {
+            char *trace;
+
+            if (!json_kernel_select(test_kernels[k])) {
+                continue;
+            }
+            trace = test_trace_string(input, length);
+            if (!expected) {
+                expected = trace;
+                CHECK(trace[strlen(trace) - 1] == ')');
+            } else {
+                CHECK(!strcmp(trace, expected));
+                free(trace);
+            }
+        }
+
+        free(expected);
+        free(input);
+    }
+
+    json_kernel_select(JSON_AUTO_KERNEL);
+}
+
+/*
+ * Strings longer than MYJSON_MAX_STRING_LENGTH are read from a string input
+ * (borrowed) and from a file (copied, as long as they fit in its buffer).
+ */
+static void test_long_strings(void) {
+    static const size_t lengths[] = {4095, 4096, 4097, 40000, 100000};
+    TestText input = {NULL, 0, 0}, expected = {NULL, 0, 0};
+    size_t i, k;
+
+    for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        JsonParser parser;
+        TestText trace = {NULL, 0, 0};
+        FILE *file;
+        char *borrowed;
+
+        test_text_append(&input, "[\"", 2);
+        test_text_append(&expected, "(<[s:", 5);
+        for (k = 0; k < lengths[i]; k++) {
+            test_text_append(&input, k % 1000 == 999 ? "\\n" : "x", k % 1000 == 999 ? 2 : 1);
+            test_text_append(&expected, k % 1000 == 999 ? "\n" : "x", 1);
+        }
+        test_text_append(&input, "\"]", 2);
+        test_text_append(&expected, " ]>)", 4);
+
+        borrowed = test_trace_string(input.start, input.length);
+        CHECK(!strcmp(borrowed, expected.start));
+        free(borrowed);
+
+        file = lengths[i] < 100000 ? tmpfile() : NULL;
+        if (file) {
+            fwrite(input.start, 1, input.length, file);
+            rewind(file);
+
+            test_text_append(&trace, "", 0);
+            json_parser_initialize(&parser);
+            json_parser_set_input_file(&parser, file);
+            test_trace_parser(&parser, &trace);
+            CHECK(!strcmp(trace.start, expected.start));
+            json_parser_delete(&parser);
+            test_text_clear(&trace);
+            fclose(file);
+        }
+
+        test_text_clear(&input);
+        test_text_clear(&expected);
+    }
+}
+
+static void test_cases(void) {
+    size_t i, k;
+
+    for (k = 0; k < TEST_KERNEL_COUNT; k++) {
+        if (!json_kernel_is_supported(test_kernels[k])) {
+            CHECK(!json_kernel_select(test_kernels[k]));
+            continue;
+        }
+
+        CHECK(json_kernel_select(test_kernels[k]));
+
+        for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            char *trace = test_trace_string(cases[i].input, strlen(cases[i].input));
+
+            CHECK_STRING(trace, cases[i].expected);
+            free(trace);
+        }
+    }
+
+    json_kernel_select(JSON_AUTO_KERNEL);
+}
+
+int main(void) {
+    test_cases();
+    test_generated();
+    test_samples();
+    test_long_strings();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,57 @@
+/**
+ * @file test_kernels.c
+ * @brief The kernel registry: the kernels supported by the CPU can be forced,
+ * the others are refused, and the automatic choice is a supported one.
+ */
+
+#include "test.h"
+
+static void test_select(void) {
+    JsonKernelType automatic, selected;
+    size_t k;
+
+    CHECK(json_kernel_select(JSON_AUTO_KERNEL));
+    automatic = json_kernel_get_selected();
+    CHECK(automatic != JSON_AUTO_KERNEL);
+    CHECK(json_kernel_is_supported(automatic));
+    CHECK(json_kernel_is_supported(JSON_FALLBACK_KERNEL));
+    CHECK(!json_kernel_is_supported(JSON_AUTO_KERNEL));
+
+    selected = automatic;
+    for (k = 0; k < TEST_KERNEL_COUNT; k++) {
+        if (!json_kernel_is_supported(test_kernels[k])) {
+            /* An unsupported kernel leaves the selection alone. */
+            CHECK(!json_kernel_select(test_kernels[k]));
+            CHECK(json_kernel_get_selected() == selected);
+            continue;
+        }
+
+        CHECK(json_kernel_select(test_kernels[k]));
+        CHECK(json_kernel_get_selected() == test_kernels[k]);
+        selected = test_kernels[k];
+    }
+
+    /* The automatic choice is the fastest kernel supported (unless MYJSON_KERNEL forces one). */
+    CHECK(json_kernel_select(JSON_AUTO_KERNEL));
+    CHECK(json_kernel_get_selected() == automatic);
+    for (k = 0; k < TEST_KERNEL_COUNT && !getenv("MYJSON_KERNEL"); k++) {
+        if (json_kernel_is_supported(test_kernels[k])) {
+            CHECK(test_kernels[k] <= automatic);
+        }
+    }
+}
+
+static void test_names(void) {
+    CHECK_STRING(json_kernel_get_name(JSON_AUTO_KERNEL), "auto");
+    CHECK_STRING(json_kernel_get_name(JSON_FALLBACK_KERNEL), "fallback");
+    CHECK_STRING(json_kernel_get_name(JSON_SSE42_KERNEL), "sse42");
+    CHECK_STRING(json_kernel_get_name(JSON_AVX2_KERNEL), "avx2");
+    CHECK_STRING(json_kernel_get_name(JSON_AVX512_KERNEL), "avx512");
+}
+
+int main(void) {
+    test_select();
+    test_names();
+
+    return TEST_RESULT();
+}
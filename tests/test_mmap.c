@@ -0,0 +1,206 @@
+/**
+ * @file test_mmap.c
+ * @brief The memory-mapped file input: the events of a mapped sample, the
+ * inputs larger than MYJSON_MAX_FILE_SIZE, an empty file, and the paths
+ * that cannot be mapped.
+ */
+
+#include "test.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#define open _open
+#define close _close
+#define read _read
+#define O_RDONLY (_O_RDONLY | _O_BINARY)
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define TEMPORARY_PATH "test_mmap.tmp"
+
+/** Above the 1 GB MYJSON_MAX_FILE_SIZE of the string and file inputs. */
+#define LARGE_SIZE (((size_t)1 << 30) + 4096)
+
+static int write_file(const char *path, const char *content, size_t length) {
+    FILE *file = fopen(path, "wb");
+    int result;
+
+    if (!file) {
+        return 0;
+    }
+    result = fwrite(content, 1, length, file) == length;
+
+    return fclose(file) == 0 && result;
+}
+
+static void test_sample(void) {
+    static const char *names[] = {"twitter.json", "mesh.json"};
+    size_t i, length;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        char *input = test_read_sample(names[i], &length);
+        TestText trace = {NULL, 0, 0};
+        JsonParser parser;
+        char *expected;
+        int fd;
+
+        CHECK(input != NULL);
+        if (!input) {
+            continue;
+        }
+        expected = test_trace_string(input, length);
+        CHECK(write_file(TEMPORARY_PATH, input, length));
+
+        test_text_append(&trace, "", 0);
+        json_parser_initialize(&parser);
+        CHECK(json_parser_set_input_mmap(&parser, TEMPORARY_PATH, JSON_MAP_HUGE_PAGES));
+        test_trace_parser(&parser, &trace);
+        CHECK(!strcmp(trace.start, expected));
+        json_parser_delete(&parser);
+        test_text_clear(&trace);
+
+        /* The whole file is mapped, whatever the position of the descriptor. */
+        fd = open(TEMPORARY_PATH, O_RDONLY);
+        CHECK(fd >= 0);
+        if (fd >= 0) {
+            char byte;
+
+            CHECK(read(fd, &byte, 1) == 1);
+            test_text_append(&trace, "", 0);
+            json_parser_initialize(&parser);
+            CHECK(json_parser_set_input_mmap_fd(&parser, fd, 0));
+            test_trace_parser(&parser, &trace);
+            CHECK(!strcmp(trace.start, expected));
+            json_parser_delete(&parser);
+            test_text_clear(&trace);
+            close(fd);
+        }
+
+        remove(TEMPORARY_PATH);
+        free(expected);
+        free(input);
+    }
+}
+
+/*
+ * A sparse file holding a document followed by zero bytes: the mapped input
+ * is parsed up to the first zero byte, while a string input of the same size
+ * is refused.
+ */
+static void test_large(void) {
+#if !defined(_WIN32)
+    static const char document[] = "[1,2,3]\n";
+    TestText trace = {NULL, 0, 0};
+    JsonParser parser;
+    void *mapping;
+    int fd = open(TEMPORARY_PATH, O_RDWR | O_CREAT | O_TRUNC, 0600);
+
+    CHECK(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+    if (write(fd, document, sizeof(document) - 1) != (ssize_t)(sizeof(document) - 1) ||
+        ftruncate(fd, (off_t)LARGE_SIZE)) {
+        fprintf(stderr, "cannot write a sparse file of %zu bytes, skipped\n", (size_t)LARGE_SIZE);
+        close(fd);
+        remove(TEMPORARY_PATH);
+        return;
+    }
+
+    test_text_append(&trace, "", 0);
+    json_parser_initialize(&parser);
+    CHECK(json_parser_set_input_mmap_fd(&parser, fd, 0));
+    CHECK(!test_trace_parser(&parser, &trace));
+    CHECK_STRING(trace.start, "(<[i:1 i:2 i:3 ]!");
+    CHECK(parser.error.type != JSON_READER_ERROR);
+    CHECK(parser.error_pos.index == sizeof(document) - 1);
+    json_parser_delete(&parser);
+    test_text_clear(&trace);
+
+    mapping = mmap(NULL, LARGE_SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+    CHECK(mapping != MAP_FAILED);
+    if (mapping != MAP_FAILED) {
+        test_text_append(&trace, "", 0);
+        json_parser_initialize(&parser);
+        json_parser_set_input_string(&parser, (const unsigned char *)mapping, LARGE_SIZE);
+        CHECK(!test_trace_parser(&parser, &trace));
+        CHECK_STRING(trace.start, "!");
+        CHECK(parser.error.type == JSON_READER_ERROR);
+        json_parser_delete(&parser);
+        test_text_clear(&trace);
+        munmap(mapping, LARGE_SIZE);
+    }
+
+    close(fd);
+    remove(TEMPORARY_PATH);
+#endif
+}
+
+static void test_empty(void) {
+    JsonParser parser;
+    TestText trace = {NULL, 0, 0};
+
+    CHECK(write_file(TEMPORARY_PATH, "", 0));
+
+    test_text_append(&trace, "", 0);
+    json_parser_initialize(&parser);
+    CHECK(json_parser_set_input_mmap(&parser, TEMPORARY_PATH, 0));
+    CHECK(!test_trace_parser(&parser, &trace));
+    CHECK_STRING(trace.start, "(!");
+    json_parser_delete(&parser);
+    test_text_clear(&trace);
+
+    /* An empty stream of documents. */
+    test_text_append(&trace, "", 0);
+    json_parser_initialize(&parser);
+    json_parser_set_stream_flags(&parser, JSON_MULTI_DOCUMENT_FLAG);
+    CHECK(json_parser_set_input_mmap(&parser, TEMPORARY_PATH, 0));
+    CHECK(test_trace_parser(&parser, &trace));
+    CHECK_STRING(trace.start, "()");
+    json_parser_delete(&parser);
+    test_text_clear(&trace);
+
+    remove(TEMPORARY_PATH);
+}
+
+static void test_unreadable(void) {
+    JsonParser parser;
+    int fd;
+
+    json_parser_initialize(&parser);
+    CHECK(!json_parser_set_input_mmap(&parser, "no/such/directory/input.json", 0));
+    CHECK(parser.error.type == JSON_READER_ERROR);
+    json_parser_delete(&parser);
+
+    /* A directory opens, but is not a regular file. */
+    json_parser_initialize(&parser);
+    CHECK(!json_parser_set_input_mmap(&parser, ".", 0));
+    CHECK(parser.error.type == JSON_READER_ERROR);
+    json_parser_delete(&parser);
+
+#if !defined(_WIN32)
+    fd = open(".", O_RDONLY);
+    CHECK(fd >= 0);
+    if (fd >= 0) {
+        json_parser_initialize(&parser);
+        CHECK(!json_parser_set_input_mmap_fd(&parser, fd, 0));
+        CHECK(parser.error.type == JSON_READER_ERROR);
+        json_parser_delete(&parser);
+        close(fd);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+int main(void) {
+    test_sample();
+    test_large();
+    test_empty();
+    test_unreadable();
+
+    return TEST_RESULT();
+}
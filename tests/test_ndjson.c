@@ -0,0 +1,151 @@
+/**
+ * @file test_ndjson.c
+ * @brief The order of the documents of json_parse_ndjson_parallel, and its
+ * stop on a malformed line or at the request of the handler.
+ */
+
+#include "test.h"
+
+#define LINE_COUNT 5000
+
+typedef struct TestRun {
+    int *ids;          /**< The ids of the documents, in the order they were delivered. */
+    size_t count;      /**< The number of documents delivered. */
+    size_t *offsets;   /**< The offset of each line, by id. */
+    size_t stop_after; /**< The number of documents after which the handler stops the parse, or @c 0. */
+    int mismatches;    /**< The number of documents whose offset or content does not match their line. */
+} TestRun;
+
+/*
+ * Build an input of LINE_COUNT lines, each holding its id; the line `bad`
+ * (if any) is malformed.
+ */
+static char *build_input(size_t *length, size_t *offsets, int bad) {
+    TestText text = {NULL, 0, 0};
+    char line[128];
+    int id;
+
+    for (id = 0; id < LINE_COUNT; id++) {
+        int size;
+
+        if (id == bad) {
+            size = snprintf(line, sizeof(line), "{\"id\":%d,\"value\":[1,2,}\n", id);
+        } else {
+            size = snprintf(line, sizeof(line), "{\"id\":%d,\"value\":[%d,\"%*s\",{\"k\":null}]}\n", id, id * 3,
+                            id % 40, "");
+        }
+        offsets[id] = text.length;
+        test_text_append(&text, line, (size_t)size);
+    }
+
+    *length = text.length;
+    return text.start;
+}
+
+static int record(void *data, JsonDocument *document, size_t offset) {
+    TestRun *run = (TestRun *)data;
+    JsonNode *node =
+        json_document_get_node(document, json_document_object_get_value(document, 1, (const JsonChar_t *)"id", 2));
+    int id = node && node->type == JSON_INTEGER ? (int)node->data.scalar.number.integer : -1;
+
+    if (id < 0 || id >= LINE_COUNT || run->offsets[id] != offset) {
+        run->mismatches++;
+    }
+
+    run->ids[run->count++] = id;
+
+    return !run->stop_after || run->count < run->stop_after;
+}
+
+static int run_parse(TestRun *run, const char *input, size_t length, size_t thread_count, int ordered) {
+    run->count = 0;
+    run->mismatches = 0;
+
+    return json_parse_ndjson_parallel((const unsigned char *)input, length, thread_count, record, run, ordered);
+}
+
+static void test_order(void) {
+    static const size_t thread_counts[] = {1, 2, 4, 0};
+    size_t offsets[LINE_COUNT], length, i, k;
+    int ids[LINE_COUNT];
+    char seen[LINE_COUNT];
+    char *input = build_input(&length, offsets, -1);
+    TestRun run = {ids, 0, offsets, 0, 0};
+
+    for (i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        /* In order: every line, one after the other. */
+        CHECK(run_parse(&run, input, length, thread_counts[i], 1));
+        CHECK(run.count == LINE_COUNT);
+        CHECK(!run.mismatches);
+        for (k = 0; k < run.count; k++) {
+            if (ids[k] != (int)k) {
+                CHECK(ids[k] == (int)k);
+                break;
+            }
+        }
+
+        /* As loaded: every line, once. */
+        CHECK(run_parse(&run, input, length, thread_counts[i], 0));
+        CHECK(run.count == LINE_COUNT);
+        CHECK(!run.mismatches);
+        memset(seen, 0, sizeof(seen));
+        for (k = 0; k < run.count; k++) {
+            if (ids[k] >= 0 && ids[k] < LINE_COUNT) {
+                CHECK(!seen[ids[k]]);
+                seen[ids[k]] = 1;
+            }
+        }
+        CHECK(!memchr(seen, 0, sizeof(seen)));
+    }
+
+    free(input);
+}
+
+static void test_stop(void) {
+    size_t offsets[LINE_COUNT], length, k;
+    int ids[LINE_COUNT];
+    char *input = build_input(&length, offsets, 3000);
+    TestRun run = {ids, 0, offsets, 0, 0};
+
+    /* A malformed line: in order, exactly the lines before it are delivered. */
+    CHECK(!run_parse(&run, input, length, 4, 1));
+    CHECK(run.count == 3000);
+    CHECK(!run.mismatches);
+    for (k = 0; k < run.count; k++) {
+        if (ids[k] != (int)k) {
+            CHECK(ids[k] == (int)k);
+            break;
+        }
+    }
+
+    CHECK(!run_parse(&run, input, length, 4, 0));
+    CHECK(run.count < LINE_COUNT);
+    CHECK(!run.mismatches);
+
+    CHECK(!run_parse(&run, input, length, 1, 1));
+    CHECK(run.count == 3000);
+
+    free(input);
+
+    /* The handler stops the parse: no document is delivered after that. */
+    input = build_input(&length, offsets, -1);
+    run.stop_after = 100;
+
+    CHECK(!run_parse(&run, input, length, 4, 1));
+    CHECK(run.count == 100);
+    for (k = 0; k < run.count; k++) {
+        CHECK(ids[k] == (int)k);
+    }
+
+    CHECK(!run_parse(&run, input, length, 4, 0));
+    CHECK(run.count == 100);
+
+    free(input);
+}
+
+int main(void) {
+    test_order();
+    test_stop();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_numbers.c
+ * @brief The exact decoding of numbers, and the numbers rejected.
+ */
+
+#include <float.h>
+#include <stdint.h>
+
+#include "test.h"
+
+/*
+ * Parse a single scalar, and get its event.
+ */
+static int parse_number(const char *input, JsonEvent *scalar) {
+    JsonParser parser;
+    JsonEvent event;
+    int result, found = 0;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+
+    do {
+        result = json_parser_parse(&parser, &event);
+        if (!result) {
+            break;
+        }
+        if (event.type == JSON_SCALAR_EVENT) {
+            *scalar = event;
+            found = 1;
+        }
+    } while (event.type != JSON_STREAM_END_EVENT);
+
+    CHECK(result || parser.error.type == JSON_SCANNER_ERROR);
+    json_parser_delete(&parser);
+
+    return result && found;
+}
+
+static void check_integer(const char *input, int64_t expected) {
+    JsonEvent event;
+
+    if (!parse_number(input, &event)) {
+        fprintf(stderr, "cannot parse %s\n", input);
+        CHECK(0);
+        return;
+    }
+    CHECK(event.data.scalar.type == JSON_INTEGER);
+    CHECK(!(event.data.scalar.flags & JSON_UNSIGNED_FLAG));
+    CHECK(event.data.scalar.number.integer == expected);
+}
+
+static void check_unsigned(const char *input, uint64_t expected) {
+    JsonEvent event;
+
+    if (!parse_number(input, &event)) {
+        fprintf(stderr, "cannot parse %s\n", input);
+        CHECK(0);
+        return;
+    }
+    CHECK(event.data.scalar.type == JSON_INTEGER);
+    CHECK(event.data.scalar.flags & JSON_UNSIGNED_FLAG);
+    CHECK(event.data.scalar.number.uinteger == expected);
+}
+
+static void check_double(const char *input, double expected) {
+    JsonEvent event;
+
+    if (!parse_number(input, &event)) {
+        fprintf(stderr, "cannot parse %s\n", input);
+        CHECK(0);
+        return;
+    }
+    CHECK(event.data.scalar.type == JSON_DOUBLE);
+    if (event.data.scalar.number.real != expected) {
+        fprintf(stderr, "%s: got %.17g, expected %.17g\n", input, event.data.scalar.number.real, expected);
+        CHECK(0);
+    }
+}
+
+static void check_rejected(const char *input) {
+    JsonEvent event;
+
+    if (parse_number(input, &event)) {
+        fprintf(stderr, "parsed %s\n", input);
+        CHECK(0);
+    }
+}
+
+static void test_integers(void) {
+    check_integer("0", 0);
+    check_integer("-0", 0);
+    check_integer("42", 42);
+    check_integer("-42", -42);
+    check_integer("999999999", 999999999);
+    check_integer("1000000000", 1000000000);
+    check_integer("9007199254740993", INT64_C(9007199254740993));
+    check_integer("9223372036854775807", INT64_MAX);
+    check_integer("-9223372036854775808", INT64_MIN);
+
+    check_unsigned("9223372036854775808", UINT64_C(9223372036854775808));
+    check_unsigned("18446744073709551615", UINT64_MAX);
+
+    /* Beyond the integer ranges, integers become doubles. */
+    check_double("18446744073709551616", 18446744073709551616.0);
+    check_double("-9223372036854775809", -9223372036854775809.0);
+    check_double("123456789012345678901234567890", 123456789012345678901234567890.0);
+}
+
+static void test_doubles(void) {
+    check_double("0.0", 0.0);
+    check_double("-0.0", -0.0);
+    check_double("0.1", 0.1);
+    check_double("1.5", 1.5);
+    check_double("-2.5e3", -2.5e3);
+    check_double("1E2", 100.0);
+    check_double("1e-2", 0.01);
+    check_double("1.0e+2", 100.0);
+    check_double("0.30000000000000004", 0.30000000000000004);
+    check_double("100000000000000000000000.0", 1e23);
+    check_double("1e308", 1e308);
+    check_double("1.7976931348623157e308", DBL_MAX);
+    check_double("2.2250738585072014e-308", DBL_MIN);
+    check_double("4.9e-324", 4.9e-324);
+    check_double("-1e-400", -0.0);
+    check_double("3.141592653589793238462643383279", 3.141592653589793);
+}
+
+static void test_rejected(void) {
+    static const char *inputs[] = {"01", "-01", "00", "-", "--1", "+1", ".5", "1.", "1.e5", "1e",
+                                   "1e+", "1E-", "0x1", "1a", "NaN", "Infinity", "-Infinity", "[-]", "[1.]", "[01]"};
+    size_t i;
+
+    for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        check_rejected(inputs[i]);
+    }
+}
+
+static void test_document(void) {
+    const char *input = "[9223372036854775807,18446744073709551615,-1.25,7]";
+    JsonParser parser;
+    JsonDocument document;
+    JsonNode *node;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+    CHECK(json_parser_load(&parser, &document));
+
+    node = json_document_get_node(&document, json_document_array_get_item(&document, 1, 0));
+    CHECK(node && node->type == JSON_INTEGER && node->data.scalar.number.integer == INT64_MAX);
+    node = json_document_get_node(&document, json_document_array_get_item(&document, 1, 1));
+    CHECK(node && node->type == JSON_INTEGER && (node->data.scalar.flags & JSON_UNSIGNED_FLAG) &&
+          node->data.scalar.number.uinteger == UINT64_MAX);
+    node = json_document_get_node(&document, json_document_array_get_item(&document, 1, 2));
+    CHECK(node && node->type == JSON_DOUBLE && node->data.scalar.number.real == -1.25);
+    node = json_document_get_node(&document, json_document_array_get_item(&document, 1, 3));
+    CHECK(node && node->type == JSON_INTEGER && node->data.scalar.number.integer == 7);
+
+    json_document_delete(&document);
+    json_parser_delete(&parser);
+}
+
+int main(void) {
+    test_integers();
+    test_doubles();
+    test_rejected();
+    test_document();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,253 @@
+/**
+ * @file test_packed.c
+ * @brief The arrays of numbers packed into typed buffers, and the arrays that
+ * must not be packed.
+ */
+
+#include "test.h"
+
+#include <stdint.h>
+
+static int load(const char *input, int pack_flags, JsonDocument *document) {
+    JsonParser parser;
+    int result;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+    json_parser_set_pack_flags(&parser, pack_flags);
+    result = json_parser_load(&parser, document);
+    json_parser_delete(&parser);
+
+    return result;
+}
+
+/*
+ * Check the packed array of a node against the expected values, as doubles.
+ */
+static void check_packed(JsonDocument *document, int node_id, JsonPackedType expected_type, const double *expected,
+                         size_t expected_length) {
+    JsonPackedType type;
+    size_t length, i, size;
+    const void *values = json_document_get_packed_array(document, node_id, &type, &length);
+    JsonNode *node = json_document_get_node(document, node_id);
+
+    CHECK(values != NULL);
+    CHECK(node && node->type == JSON_PACKED_ARRAY);
+    if (!values) {
+        return;
+    }
+
+    CHECK(type == expected_type);
+    CHECK(length == expected_length);
+    if (type != expected_type || length != expected_length) {
+        return;
+    }
+
+    size = type == JSON_PACKED_INT32 || type == JSON_PACKED_FLOAT ? 4 : 8;
+    CHECK((uintptr_t)values % size == 0);
+
+    for (i = 0; i < length; i++) {
+        double value = 0;
+
+        switch (type) {
+            case JSON_PACKED_INT32:
+                value = (double)((const int32_t *)values)[i];
+                break;
+            case JSON_PACKED_INT64:
+                value = (double)((const int64_t *)values)[i];
+                break;
+            case JSON_PACKED_FLOAT:
+                value = (double)((const float *)values)[i];
+                break;
+            case JSON_PACKED_DOUBLE:
+                value = ((const double *)values)[i];
+                break;
+        }
+        if (value != expected[i]) {
+            fprintf(stderr, "value %zu: %.17g, expected %.17g\n", i, value, expected[i]);
+            CHECK(value == expected[i]);
+        }
+    }
+}
+
+static void test_types(void) {
+    static const double small[] = {1, 2, -3, 0, 2147483647, -2147483648.0};
+    static const double large[] = {1, 2147483648.0, -9223372036854775807.0 - 1};
+    static const double mixed[] = {1, 2.5, -3, 100, 0.001};
+    static const double rounded[] = {1, 0.1f, 16777217.0f};
+    static const double wide[] = {0.5, -9007199254740992.0};
+    static const double pair[] = {1, -2};
+    JsonDocument document;
+
+    CHECK(load("[1,2,-3,0,2147483647,-2147483648]", JSON_PACK_ARRAYS, &document));
+    check_packed(&document, 1, JSON_PACKED_INT32, small, 6);
+    json_document_delete(&document);
+
+    CHECK(load("[1,2147483648,-9223372036854775808]", JSON_PACK_ARRAYS, &document));
+    check_packed(&document, 1, JSON_PACKED_INT64, large, 3);
+    json_document_delete(&document);
+
+    /* Integers next to a fraction or an exponent are packed as doubles. */
+    CHECK(load("[1,2.5,-3,1e2,1E-3]", JSON_PACK_ARRAYS, &document));
+    check_packed(&document, 1, JSON_PACKED_DOUBLE, mixed, 5);
+    json_document_delete(&document);
+
+    CHECK(load("[1,0.1,16777217.0]", JSON_PACK_FLOAT32, &document));
+    check_packed(&document, 1, JSON_PACKED_FLOAT, rounded, 3);
+    json_document_delete(&document);
+
+    /* The floats are rounded, however large the integers next to them. */
+    CHECK(load("[0.5,-9007199254740993]", JSON_PACK_FLOAT32, &document));
+    check_packed(&document, 1, JSON_PACKED_FLOAT, wide, 2);
+    json_document_delete(&document);
+
+    /* JSON_PACK_FLOAT32 leaves the integers alone. */
+    CHECK(load("[1,-2]", JSON_PACK_FLOAT32, &document));
+    check_packed(&document, 1, JSON_PACKED_INT32, pair, 2);
+    json_document_delete(&document);
+}
+
+static void test_nested(void) {
+    static const double first[] = {1, 2};
+    static const double second[] = {1.5};
+    JsonDocument document;
+    JsonNode *node;
+    char *text;
+    int a, b;
+
+    CHECK(load("{\"a\":[1,2],\"b\":[[1.5],[],[\"x\",3]],\"c\":3}", JSON_PACK_ARRAYS, &document));
+    text = test_write_document(&document);
+    CHECK_STRING(text, "{\"a\":[#],\"b\":[[#],[],[\"x\",3]],\"c\":3}");
+    free(text);
+
+    a = json_document_object_get_value(&document, 1, (const JsonChar_t *)"a", 1);
+    b = json_document_object_get_value(&document, 1, (const JsonChar_t *)"b", 1);
+    check_packed(&document, a, JSON_PACKED_INT32, first, 2);
+
+    node = json_document_get_node(&document, b);
+    CHECK(node && node->type == JSON_ARRAY);
+    if (node && node->type == JSON_ARRAY) {
+        CHECK(node->data.array.items.top - node->data.array.items.start == 3);
+        check_packed(&document, node->data.array.items.start[0], JSON_PACKED_DOUBLE, second, 1);
+        CHECK(!json_document_get_packed_array(&document, node->data.array.items.start[1], NULL, NULL));
+        CHECK(!json_document_get_packed_array(&document, node->data.array.items.start[2], NULL, NULL));
+    }
+
+    /* The type and length are optional. */
+    CHECK(json_document_get_packed_array(&document, a, NULL, NULL) != NULL);
+    CHECK(!json_document_get_packed_array(&document, b, NULL, NULL));
+    CHECK(!json_document_get_packed_array(&document, 1, NULL, NULL));
+
+    json_document_delete(&document);
+}
+
+/*
+ * The arrays which are not only numbers, or which would lose precision, are
+ * loaded as usual.
+ */
+static void test_not_packed(void) {
+    static const struct {
+        const char *input;
+        int flags;
+        const char *expected;
+    } cases[] = {
+        {"[1,2,3]", 0, "[1,2,3]"},
+        {"[]", JSON_PACK_ARRAYS, "[]"},
+        {"[1,\"a\"]", JSON_PACK_ARRAYS, "[1,\"a\"]"},
+        {"[1,null]", JSON_PACK_ARRAYS, "[1,null]"},
+        {"[true,1]", JSON_PACK_ARRAYS, "[true,1]"},
+        {"[[1],2]", JSON_PACK_ARRAYS, "[[#],2]"},
+        {"[1,18446744073709551615]", JSON_PACK_ARRAYS, "[1,18446744073709551615]"},
+        {"[9007199254740993,0.5]", JSON_PACK_ARRAYS, "[9007199254740993,0.5]"},
+    };
+    JsonDocument document;
+    size_t i;
+
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        char *text;
+
+        CHECK(load(cases[i].input, cases[i].flags, &document));
+        text = test_write_document(&document);
+        CHECK_STRING(text, cases[i].expected);
+        CHECK(!json_document_get_packed_array(&document, 1, NULL, NULL));
+        free(text);
+        json_document_delete(&document);
+    }
+}
+
+/*
+ * The arrays of numbers of a sample are packed with the numbers loaded as
+ * usual.
+ */
+static void test_sample(void) {
+    JsonDocument plain, packed;
+    JsonNode *root;
+    JsonNodePair *pair;
+    size_t length, count = 0;
+    char *input = test_read_sample("mesh.json", &length);
+
+    CHECK(input != NULL);
+    if (!input) {
+        return;
+    }
+
+    CHECK(load(input, 0, &plain));
+    CHECK(load(input, JSON_PACK_ARRAYS, &packed));
+
+    root = json_document_get_node(&plain, 1);
+    for (pair = root->data.object.pairs.start; pair < root->data.object.pairs.top; pair++) {
+        JsonNode *key = json_document_get_node(&plain, pair->key);
+        JsonNode *value = json_document_get_node(&plain, pair->value);
+        JsonNode *first;
+        JsonPackedType type;
+        const void *values;
+        size_t items, i;
+        int id;
+
+        if (value->type != JSON_ARRAY || value->data.array.items.start == value->data.array.items.top) {
+            continue;
+        }
+
+        id = json_document_object_get_value(&packed, 1, key->data.scalar.value, (int)key->data.scalar.length);
+        values = json_document_get_packed_array(&packed, id, &type, &items);
+        first = json_document_get_node(&plain, value->data.array.items.start[0]);
+        CHECK(!values == (first->type != JSON_INTEGER && first->type != JSON_DOUBLE));
+        if (!values) {
+            continue;
+        }
+
+        CHECK(items == (size_t)(value->data.array.items.top - value->data.array.items.start));
+        for (i = 0; i < items; i++) {
+            JsonNode *item = json_document_get_node(&plain, value->data.array.items.start[i]);
+            double expected = item->type == JSON_INTEGER ? (double)item->data.scalar.number.integer
+                                                         : item->data.scalar.number.real;
+            double actual = type == JSON_PACKED_INT32   ? ((const int32_t *)values)[i]
+                            : type == JSON_PACKED_INT64 ? (double)((const int64_t *)values)[i]
+                                                        : ((const double *)values)[i];
+
+            if (actual != expected) {
+                fprintf(stderr, "%s[%zu]: %.17g, expected %.17g\n", (const char *)key->data.scalar.value, i, actual,
+                        expected);
+                CHECK(actual == expected);
+                break;
+            }
+        }
+        count++;
+    }
+
+    CHECK(count == 5);
+    CHECK(packed.nodes.top - packed.nodes.start < plain.nodes.top - plain.nodes.start);
+
+    json_document_delete(&plain);
+    json_document_delete(&packed);
+    free(input);
+}
+
+int main(void) {
+    test_types();
+    test_nested();
+    test_not_packed();
+    test_sample();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,184 @@
+/**
+ * @file test_parallel.c
+ * @brief The documents loaded on several threads hold the nodes of the
+ * documents loaded by the calling thread alone.
+ */
+
+#include "test.h"
+
+/*
+ * Load an input with a number of threads.
+ */
+static int load(const char *input, size_t length, size_t thread_count, int pack_flags, JsonDocument *document,
+                JsonError_t *error) {
+    JsonParser parser;
+    int result;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, length);
+    json_parser_set_thread_count(&parser, thread_count);
+    json_parser_set_pack_flags(&parser, pack_flags);
+
+    result = json_parser_load(&parser, document);
+    *error = parser.error;
+    json_parser_delete(&parser);
+
+    return result;
+}
+
+static int same_position(const JsonPosition *a, const JsonPosition *b) {
+    return a->index == b->index && a->line == b->line && a->column == b->column;
+}
+
+/*
+ * Compare two documents node by node.
+ */
+static int same_documents(JsonDocument *a, JsonDocument *b) {
+    size_t count = (size_t)(a->nodes.top - a->nodes.start), i, k;
+
+    if (count != (size_t)(b->nodes.top - b->nodes.start)) {
+        fprintf(stderr, "%zu nodes against %zu\n", count, (size_t)(b->nodes.top - b->nodes.start));
+        return 0;
+    }
+
+    for (i = 0; i < count; i++) {
+        JsonNode *x = a->nodes.start + i, *y = b->nodes.start + i;
+        int same = x->type == y->type && same_position(&x->start_pos, &y->start_pos) &&
+                   same_position(&x->end_pos, &y->end_pos);
+
+        if (same) {
+            switch (x->type) {
+                case JSON_ARRAY:
+                    k = (size_t)(x->data.array.items.top - x->data.array.items.start);
+                    same = k == (size_t)(y->data.array.items.top - y->data.array.items.start) &&
+                           !memcmp(x->data.array.items.start, y->data.array.items.start, k * sizeof(JsonNodeItem));
+                    break;
+                case JSON_OBJECT:
+                    k = (size_t)(x->data.object.pairs.top - x->data.object.pairs.start);
+                    same = k == (size_t)(y->data.object.pairs.top - y->data.object.pairs.start) &&
+                           !memcmp(x->data.object.pairs.start, y->data.object.pairs.start, k * sizeof(JsonNodePair));
+                    break;
+                case JSON_PACKED_ARRAY:
+                    k = x->data.packed.type == JSON_PACKED_INT32 || x->data.packed.type == JSON_PACKED_FLOAT ? 4 : 8;
+                    same = x->data.packed.type == y->data.packed.type &&
+                           x->data.packed.length == y->data.packed.length &&
+                           !memcmp(x->data.packed.values, y->data.packed.values, x->data.packed.length * k);
+                    break;
+                default:
+                    same = x->data.scalar.length == y->data.scalar.length &&
+                           x->data.scalar.flags == y->data.scalar.flags &&
+                           !memcmp(x->data.scalar.value, y->data.scalar.value, x->data.scalar.length) &&
+                           !memcmp(&x->data.scalar.number, &y->data.scalar.number, sizeof(JsonNumber));
+                    break;
+            }
+        }
+
+        if (!same) {
+            fprintf(stderr, "node %zu differs\n", i + 1);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static void check_input(const char *input, size_t length, int pack_flags) {
+    static const size_t thread_counts[] = {2, 3, 8, 0};
+    JsonDocument serial;
+    JsonError_t error;
+    size_t i;
+
+    CHECK(load(input, length, 1, pack_flags, &serial, &error));
+
+    for (i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        JsonDocument parallel;
+
+        CHECK(load(input, length, thread_counts[i], pack_flags, &parallel, &error));
+        CHECK(same_documents(&serial, &parallel));
+        json_document_delete(&parallel);
+    }
+
+    json_document_delete(&serial);
+}
+
+static void test_samples(void) {
+    static const char *names[] = {"mesh.json", "twitter.json", "random.json"};
+    size_t i, length;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        char *input = test_read_sample(names[i], &length);
+
+        CHECK(input != NULL);
+        if (input) {
+            check_input(input, length, 0);
+            check_input(input, length, JSON_PACK_ARRAYS);
+            free(input);
+        }
+    }
+}
+
+/*
+ * A large array of small values, and an object made of a few large values.
+ */
+static void test_generated(void) {
+    TestText text = {NULL, 0, 0};
+    char item[128];
+    int i, size;
+
+    test_text_append(&text, "[", 1);
+    for (i = 0; i < 60000; i++) {
+        size = snprintf(item, sizeof(item), "%s{\"id\":%d,\"name\":\"n\\u00e9%d\",\"tags\":[%d,%d.5,true,null]}\n",
+                        i ? "," : "", i, i, i, -i);
+        test_text_append(&text, item, (size_t)size);
+    }
+    test_text_append(&text, "]", 1);
+    check_input(text.start, text.length, 0);
+    test_text_clear(&text);
+
+    test_text_append(&text, "{", 1);
+    for (i = 0; i < 3; i++) {
+        int k;
+
+        size = snprintf(item, sizeof(item), "%s\"part%d\":[", i ? "," : "", i);
+        test_text_append(&text, item, (size_t)size);
+        for (k = 0; k < 50000; k++) {
+            size = snprintf(item, sizeof(item), "%s[\"%d\",{\"k\":%d}]", k ? "," : "", k, k);
+            test_text_append(&text, item, (size_t)size);
+        }
+        test_text_append(&text, "]", 1);
+    }
+    test_text_append(&text, "}", 1);
+    check_input(text.start, text.length, 0);
+    test_text_clear(&text);
+}
+
+/*
+ * A malformed large body fails with the error of the serial load.
+ */
+static void test_malformed(void) {
+    TestText text = {NULL, 0, 0};
+    JsonDocument document;
+    JsonError_t serial, parallel;
+    int i;
+
+    test_text_append(&text, "[", 1);
+    for (i = 0; i < 100000; i++) {
+        test_text_append(&text, i == 70000 ? "{\"a\":1,},\n" : "{\"a\":[1,2]},\n", i == 70000 ? 10 : 13);
+    }
+    test_text_append(&text, "0]", 2);
+
+    CHECK(!load(text.start, text.length, 1, 0, &document, &serial));
+    CHECK(!load(text.start, text.length, 4, 0, &document, &parallel));
+    CHECK(serial.type == parallel.type);
+    CHECK(serial.message && parallel.message && !strcmp(serial.message, parallel.message));
+
+    test_text_clear(&text);
+}
+
+int main(void) {
+    test_samples();
+    test_generated();
+    test_malformed();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,68 @@
+/**
+ * @file test_projection.c
+ * @brief json_parser_load_projection keeps the values of a mask, with the
+ * containers leading to them.
+ */
+
+#include "test.h"
+
+static char *run_projection(const char *input, const char **expressions, size_t count) {
+    JsonParser parser;
+    JsonQuery mask;
+    JsonDocument document;
+    char *text;
+    size_t i;
+
+    CHECK(json_query_initialize(&mask));
+    for (i = 0; i < count; i++) {
+        CHECK(json_query_add_expression(&mask, expressions[i]));
+    }
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+    if (json_parser_load_projection(&parser, &document, &mask)) {
+        text = test_write_document(&document);
+        json_document_delete(&document);
+    } else {
+        text = (char *)malloc(2);
+        if (!text) {
+            abort();
+        }
+        strcpy(text, "!");
+    }
+
+    json_parser_delete(&parser);
+    json_query_delete(&mask);
+
+    return text;
+}
+
+static void test_projection(void) {
+    static const char *user[] = {"$.user.name", "$.id"};
+    static const char *items[] = {"$.list[1]", "$.list[3].k"};
+    static const char *nothing[] = {"$.absent"};
+    const char *input = "{\"id\":1,\"user\":{\"name\":\"x\",\"age\":2},\"text\":\"...\"}";
+    char *text;
+
+    text = run_projection(input, user, 2);
+    CHECK_STRING(text, "{\"id\":1,\"user\":{\"name\":\"x\"}}");
+    free(text);
+
+    text = run_projection("{\"list\":[10,20,30,{\"k\":[1],\"j\":2}],\"other\":[[[]]]}", items, 2);
+    CHECK_STRING(text, "{\"list\":[20,{\"k\":[1]}]}");
+    free(text);
+
+    text = run_projection(input, nothing, 1);
+    CHECK_STRING(text, "{}");
+    free(text);
+
+    text = run_projection("{\"id\":1,\"skipped\":[1,2}}", user, 2);
+    CHECK_STRING(text, "!");
+    free(text);
+}
+
+int main(void) {
+    test_projection();
+
+    return TEST_RESULT();
+}
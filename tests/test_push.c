@@ -0,0 +1,191 @@
+/**
+ * @file test_push.c
+ * @brief A push parser fed in small chunks produces the events of the string
+ * input.
+ */
+
+#include "test.h"
+
+static const char *inputs[] = {
+    "{}",
+    "[1,-2,3.5e-7,true,false,null,\"a\\\"b\\\\c\\u00e9\\ud83d\\ude00\",{\"k\":[[]]}]",
+    "{\"\xC3\xA9t\xC3\xA9\":\"\xF0\x9F\x98\x80\xE2\x82\xAC\",\"long\":"
+    "\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+    "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\",\"n\":12345678901234567890}",
+    "  \n\t 123456789  ",
+    "\"x\"",
+    "[1,]",
+    "{\"a\" 1}",
+    "[\"abc",
+    "[tru",
+    "",
+};
+
+/*
+ * Feed an input in chunks of `chunk` bytes, and trace the events.
+ */
+static char *trace_push(const char *input, size_t length, size_t chunk) {
+    JsonParser parser;
+    JsonEvent event;
+    TestText text = {NULL, 0, 0};
+    size_t fed = 0, size;
+    int result, done = 0;
+
+    test_text_append(&text, "", 0);
+    json_parser_initialize(&parser);
+
+    size = chunk < length ? chunk : length;
+    json_parser_feed(&parser, (const unsigned char *)input, size, size == length);
+    fed = size;
+
+    while (!done) {
+        result = json_parser_parse(&parser, &event);
+        if (result == MYJSON_NEED_MORE_INPUT) {
+            CHECK(event.type == JSON_NO_EVENT);
+            CHECK(fed < length || length == 0);
+            size = chunk < length - fed ? chunk : length - fed;
+            json_parser_feed(&parser, (const unsigned char *)input + fed, size, fed + size == length);
+            fed += size;
+            continue;
+        }
+        if (!result) {
+            test_text_append(&text, "!", 1);
+            break;
+        }
+        test_trace_event(&text, &event);
+        done = event.type == JSON_STREAM_END_EVENT;
+        json_event_delete(&event);
+    }
+
+    json_parser_delete(&parser);
+
+    return text.start;
+}
+
+static void check_chunks(const char *input, size_t length) {
+    static const size_t chunks[] = {1, 2, 3, 7, 63, 64, 65, 1000};
+    char *expected = test_trace_string(input, length);
+    size_t i;
+
+    for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        char *trace = trace_push(input, length, chunks[i]);
+
+        if (strcmp(trace, expected)) {
+            fprintf(stderr, "chunks of %zu bytes\n", chunks[i]);
+            CHECK_STRING(trace, expected);
+        }
+        free(trace);
+    }
+
+    free(expected);
+}
+
+static void test_inputs(void) {
+    size_t i;
+
+    for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        check_chunks(inputs[i], strlen(inputs[i]));
+    }
+}
+
+static void test_sample(void) {
+    size_t length;
+    char *input = test_read_sample("twitter.json", &length);
+    char *expected, *trace;
+
+    CHECK(input != NULL);
+    if (!input) {
+        return;
+    }
+
+    expected = test_trace_string(input, length);
+    CHECK(expected[strlen(expected) - 1] == ')');
+
+    trace = trace_push(input, length, 1);
+    CHECK(!strcmp(trace, expected));
+    free(trace);
+
+    trace = trace_push(input, length, 4093);
+    CHECK(!strcmp(trace, expected));
+    free(trace);
+
+    free(expected);
+    free(input);
+}
+
+/*
+ * Feed an input in chunks of `chunk` bytes until the parse fails, ends, or
+ * stops making progress.
+ *
+ * @returns the result of the last json_parser_parse call.
+ */
+static int push_result(const char *input, size_t length, size_t chunk, JsonErrorType *error) {
+    JsonParser parser;
+    JsonEvent event;
+    size_t fed, size, calls;
+    int result = MYJSON_SUCCESS;
+
+    json_parser_initialize(&parser);
+
+    size = chunk < length ? chunk : length;
+    json_parser_feed(&parser, (const unsigned char *)input, size, size == length);
+    fed = size;
+
+    for (calls = 0; calls < 4 * length + 16; calls++) {
+        result = json_parser_parse(&parser, &event);
+        if (result == MYJSON_NEED_MORE_INPUT) {
+            size = chunk < length - fed ? chunk : length - fed;
+            json_parser_feed(&parser, (const unsigned char *)input + fed, size, fed + size == length);
+            fed += size;
+            continue;
+        }
+        if (!result || event.type == JSON_STREAM_END_EVENT) {
+            break;
+        }
+        json_event_delete(&event);
+    }
+
+    *error = parser.error.type;
+    json_parser_delete(&parser);
+
+    return result;
+}
+
+/*
+ * A malformed number across a chunk boundary and a 64-byte block boundary
+ * fails with the scanner error, instead of waiting for more input.
+ */
+static void test_malformed_number(void) {
+    static const size_t chunks[] = {1, 5, 7, 8, 13};
+    TestText text = {NULL, 0, 0};
+    JsonErrorType error;
+    size_t padding, i;
+
+    for (padding = 50; padding < 64; padding++) {
+        test_text_clear(&text);
+        for (i = 0; i < padding; i++) {
+            test_text_append(&text, " ", 1);
+        }
+        test_text_append(&text, "[922x372036854775807 \"]", 23);
+
+        for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+            int result = push_result(text.start, text.length, chunks[i], &error);
+
+            if (result != MYJSON_FAILURE || error != JSON_SCANNER_ERROR) {
+                fprintf(stderr, "%zu spaces, chunks of %zu bytes: result %d, error %d\n", padding, chunks[i], result,
+                        (int)error);
+                CHECK(result == MYJSON_FAILURE && error == JSON_SCANNER_ERROR);
+            }
+        }
+    }
+
+    test_text_clear(&text);
+}
+
+int main(void) {
+    test_inputs();
+    test_sample();
+    test_malformed_number();
+
+    return TEST_RESULT();
+}
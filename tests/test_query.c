@@ -0,0 +1,120 @@
+/**
+ * @file test_query.c
+ * @brief The compiled queries: JSON Pointer and JSONPath matches, and the
+ * malformed expressions.
+ */
+
+#include "test.h"
+
+typedef struct TestMatches {
+    TestText text;  /**< The matches: the expression number and the value, separated by spaces. */
+    size_t count;   /**< The number of matches. */
+    size_t stop_at; /**< The number of matches after which the handler stops the parse, or @c 0. */
+} TestMatches;
+
+static int record_match(void *data, size_t expression, JsonDocument *document, int node_id) {
+    TestMatches *matches = (TestMatches *)data;
+    char number[32];
+    int size = snprintf(number, sizeof(number), "%zu=", expression);
+
+    test_text_append(&matches->text, number, (size_t)size);
+    test_write_node(&matches->text, document, node_id);
+    test_text_append(&matches->text, " ", 1);
+    matches->count++;
+
+    return !matches->stop_at || matches->count < matches->stop_at;
+}
+
+static char *run_query(const char *input, int flags, const char **expressions, size_t count, size_t stop_at,
+                       int *result) {
+    TestMatches matches = {{NULL, 0, 0}, 0, stop_at};
+    JsonParser parser;
+    JsonQuery query;
+    size_t i;
+
+    test_text_append(&matches.text, "", 0);
+    CHECK(json_query_initialize(&query));
+    for (i = 0; i < count; i++) {
+        CHECK(json_query_add_expression(&query, expressions[i]));
+    }
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+    CHECK(json_parser_set_stream_flags(&parser, flags));
+    *result = json_parser_query(&parser, &query, record_match, &matches);
+
+    json_parser_delete(&parser);
+    json_query_delete(&query);
+
+    return matches.text.start;
+}
+
+static void test_query(void) {
+    static const char *store =
+        "{\"store\":{\"book\":[{\"title\":\"A\",\"price\":8},{\"title\":\"B~/\",\"price\":12.5},{\"price\":1}],"
+        "\"bicycle\":{\"color\":\"red\"}},\"a/b\":{\"~\":3}}";
+    static const char *titles[] = {"$.store.book[*].title"};
+    static const char *pointers[] = {"/store/book/1", "/a~1b/~0", "/store/bicycle/color"};
+    static const char *nested[] = {"$.store.book[0]", "$.store.book[0].price", "$['store']['bicycle']"};
+    static const char *missing[] = {"$.nothing", "/store/book/7"};
+    int result;
+    char *trace;
+
+    trace = run_query(store, 0, titles, 1, 0, &result);
+    CHECK(result);
+    CHECK_STRING(trace, "0=\"A\" 0=\"B~/\" ");
+    free(trace);
+
+    trace = run_query(store, 0, pointers, 3, 0, &result);
+    CHECK(result);
+    CHECK_STRING(trace, "0={\"title\":\"B~/\",\"price\":12.5} 2=\"red\" 1=3 ");
+    free(trace);
+
+    /* A match inside another one is matched after it. */
+    trace = run_query(store, 0, nested, 3, 0, &result);
+    CHECK(result);
+    CHECK_STRING(trace, "0={\"title\":\"A\",\"price\":8} 1=8 2={\"color\":\"red\"} ");
+    free(trace);
+
+    trace = run_query(store, 0, missing, 2, 0, &result);
+    CHECK(result);
+    CHECK_STRING(trace, "");
+    free(trace);
+
+    /* The handler stops the parse. */
+    trace = run_query(store, 0, titles, 1, 1, &result);
+    CHECK(!result);
+    CHECK_STRING(trace, "0=\"A\" ");
+    free(trace);
+
+    /* Every document of a stream is queried. */
+    trace = run_query("{\"store\":{\"book\":[{\"title\":\"A\"}]}}\n[]\n{\"store\":{\"book\":[{\"title\":\"C\"}]}}",
+                      JSON_MULTI_DOCUMENT_FLAG, titles, 1, 0, &result);
+    CHECK(result);
+    CHECK_STRING(trace, "0=\"A\" 0=\"C\" ");
+    free(trace);
+}
+
+static void test_query_malformed(void) {
+    static const char *expressions[] = {"$.a[", "$.a[x]", "store", "$..a", "/a/~2"};
+    JsonQuery query;
+    size_t i;
+
+    for (i = 0; i < sizeof(expressions) / sizeof(expressions[0]); i++) {
+        CHECK(json_query_initialize(&query));
+        if (json_query_add_expression(&query, expressions[i])) {
+            fprintf(stderr, "compiled %s\n", expressions[i]);
+            CHECK(0);
+        } else {
+            CHECK(query.error.type != JSON_NO_ERROR);
+        }
+        json_query_delete(&query);
+    }
+}
+
+int main(void) {
+    test_query();
+    test_query_malformed();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_read_ahead.c
+ * @brief The read-ahead input produces the events of the string input, with
+ * io_uring where the kernel has it, and with the thread fallback for a pipe.
+ */
+
+#include "test.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#define open _open
+#define close _close
+#define O_RDONLY (_O_RDONLY | _O_BINARY)
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define TEMPORARY_PATH "test_read_ahead.tmp"
+
+/*
+ * Parse a descriptor through a read-ahead input of `count` chunks of `size`
+ * bytes.
+ *
+ * @returns the trace, to be freed.
+ */
+static char *trace_read_ahead(int fd, size_t count, size_t size, int *io_uring) {
+    JsonReadAhead reader;
+    JsonParser parser;
+    TestText trace = {NULL, 0, 0};
+
+    test_text_append(&trace, "", 0);
+    if (!json_read_ahead_initialize(&reader, fd, count, size)) {
+        test_text_append(&trace, "?", 1);
+        return trace.start;
+    }
+    *io_uring = reader.io_uring;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input(&parser, json_read_ahead_handler, &reader);
+    test_trace_parser(&parser, &trace);
+    json_parser_delete(&parser);
+
+    CHECK(json_read_ahead_delete(&reader));
+
+    return trace.start;
+}
+
+static void test_file(const char *input, size_t length, const char *expected) {
+    static const size_t sizes[][2] = {{0, 0}, {1, 4096}, {2, 4096}, {3, 10000}, {8, 65536}};
+    FILE *file = fopen(TEMPORARY_PATH, "wb");
+    size_t i;
+
+    CHECK(file != NULL);
+    if (!file) {
+        return;
+    }
+    CHECK(fwrite(input, 1, length, file) == length);
+    fclose(file);
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        int fd = open(TEMPORARY_PATH, O_RDONLY), io_uring = 0;
+        char *trace;
+
+        CHECK(fd >= 0);
+        if (fd < 0) {
+            continue;
+        }
+
+        trace = trace_read_ahead(fd, sizes[i][0], sizes[i][1], &io_uring);
+        if (strcmp(trace, expected)) {
+            fprintf(stderr, "%zu chunks of %zu bytes, %s\n", sizes[i][0], sizes[i][1],
+                    io_uring ? "io_uring" : "thread");
+            CHECK(!strcmp(trace, expected));
+        }
+        free(trace);
+        close(fd);
+    }
+
+    remove(TEMPORARY_PATH);
+}
+
+#if !defined(_WIN32)
+
+typedef struct TestWriter {
+    int fd;             /**< The write end of the pipe. */
+    const char *input;  /**< The input to write. */
+    size_t length;      /**< The length of the input. */
+} TestWriter;
+
+static void *write_pipe(void *data) {
+    TestWriter *writer = (TestWriter *)data;
+    size_t written = 0;
+
+    while (written < writer->length) {
+        ssize_t size = write(writer->fd, writer->input + written, writer->length - written);
+
+        if (size <= 0) {
+            break;
+        }
+        written += (size_t)size;
+    }
+    close(writer->fd);
+
+    return NULL;
+}
+
+/*
+ * A pipe cannot be read at an offset: the chunks are read on a thread.
+ */
+static void test_pipe(const char *input, size_t length, const char *expected) {
+    static const size_t sizes[][2] = {{0, 0}, {2, 4096}};
+    size_t i;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        TestWriter writer;
+        pthread_t thread;
+        int fds[2], io_uring = 1;
+        char *trace;
+
+        CHECK(!pipe(fds));
+        writer.fd = fds[1];
+        writer.input = input;
+        writer.length = length;
+        CHECK(!pthread_create(&thread, NULL, write_pipe, &writer));
+
+        trace = trace_read_ahead(fds[0], sizes[i][0], sizes[i][1], &io_uring);
+        CHECK(!io_uring);
+        CHECK(!strcmp(trace, expected));
+        free(trace);
+
+        pthread_join(thread, NULL);
+        close(fds[0]);
+    }
+}
+
+#endif
+
+int main(void) {
+    static const char *names[] = {"twitter.json", "random.json"};
+    const char *small = "{\"a\":[1,2.5,\"x\\u00e9\",true,null]}";
+    size_t i, length;
+    char *expected;
+
+    expected = test_trace_string(small, strlen(small));
+    test_file(small, strlen(small), expected);
+    test_file("", 0, "(!");
+    free(expected);
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        char *input = test_read_sample(names[i], &length);
+
+        CHECK(input != NULL);
+        if (!input) {
+            continue;
+        }
+
+        expected = test_trace_string(input, length);
+        test_file(input, length, expected);
+#if !defined(_WIN32)
+        test_pipe(input, length, expected);
+#endif
+        free(expected);
+        free(input);
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,212 @@
+/**
+ * @file test_reload.c
+ * @brief A document reset and reloaded with another input holds the nodes of
+ * a fresh load of that input, and nothing of the previous one, in the arena
+ * chunks it already had.
+ */
+
+#include "test.h"
+
+static const char *small_input = "{\"a\\n\":[1,\"x\\u00e9\",{\"b\":null}],\"c\":\"\\ud83d\\ude00\",\"d\":-2.5}";
+
+static size_t count_nodes(JsonDocument *document) {
+    return (size_t)(document->nodes.top - document->nodes.start);
+}
+
+static size_t count_chunks(const JsonArenaChunk *chunk) {
+    size_t count = 0;
+
+    for (; chunk; chunk = chunk->next) {
+        count++;
+    }
+
+    return count;
+}
+
+static int in_chunks(const JsonArenaChunk *chunk, const JsonChar_t *value, size_t length) {
+    for (; chunk; chunk = chunk->next) {
+        const JsonChar_t *start = (const JsonChar_t *)(chunk + 1);
+
+        if (value >= start && value + length <= start + chunk->size) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Check a reloaded document against a fresh load of the same input: the same
+ * nodes, links within the nodes, and the strings copied into the chunks in
+ * use rather than the spare ones.
+ */
+static void check_document(JsonDocument *document, const char *input, size_t length) {
+    JsonDocument expected;
+    JsonParser parser;
+    JsonNode *node;
+    char *text, *expected_text;
+    size_t count;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, length);
+    CHECK(json_parser_load(&parser, &expected));
+    json_parser_delete(&parser);
+
+    count = count_nodes(&expected);
+    CHECK(count_nodes(document) == count);
+    CHECK(json_document_get_node(document, (int)count + 1) == NULL);
+
+    for (node = document->nodes.start; node < document->nodes.top; node++) {
+        JsonNodeItem *item;
+        JsonNodePair *pair;
+
+        switch (node->type) {
+            case JSON_ARRAY:
+                for (item = node->data.array.items.start; item < node->data.array.items.top; item++) {
+                    CHECK(*item > 0 && (size_t)*item <= count);
+                }
+                break;
+            case JSON_OBJECT:
+                for (pair = node->data.object.pairs.start; pair < node->data.object.pairs.top; pair++) {
+                    CHECK(pair->key > 0 && (size_t)pair->key <= count);
+                    CHECK(pair->value > 0 && (size_t)pair->value <= count);
+                }
+                break;
+            case JSON_STRING:
+                if (!(node->data.scalar.flags & JSON_BORROWED_FLAG)) {
+                    CHECK(in_chunks(document->arena.chunks, node->data.scalar.value, node->data.scalar.length));
+                    CHECK(!in_chunks(document->arena.spare, node->data.scalar.value, node->data.scalar.length));
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    text = test_write_document(document);
+    expected_text = test_write_document(&expected);
+    CHECK_STRING(text, expected_text);
+    free(text);
+    free(expected_text);
+
+    json_document_delete(&expected);
+}
+
+static int reload(JsonDocument *document, const char *input, size_t length) {
+    JsonParser parser;
+    int result;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, length);
+    result = json_parser_reload(&parser, document);
+    json_parser_delete(&parser);
+
+    return result;
+}
+
+/*
+ * A large document, then a small one: the small one is loaded in the newest
+ * chunk, and the other chunks are kept aside.
+ */
+static void test_smaller(void) {
+    JsonDocument document;
+    size_t length, chunks;
+    char *input = test_read_sample("twitter.json", &length);
+
+    CHECK(input != NULL);
+    if (!input) {
+        return;
+    }
+
+    CHECK(json_document_initialize(&document));
+    CHECK(reload(&document, input, length));
+    check_document(&document, input, length);
+    chunks = count_chunks(document.arena.chunks);
+    CHECK(chunks > 1 && document.arena.spare == NULL);
+
+    json_document_reset(&document);
+    CHECK(count_nodes(&document) == 0);
+    CHECK(json_document_get_root_node(&document) == NULL);
+    CHECK(json_document_get_node(&document, 1) == NULL);
+    CHECK(count_chunks(document.arena.chunks) == 1);
+    CHECK(count_chunks(document.arena.spare) == chunks - 1);
+
+    CHECK(reload(&document, small_input, strlen(small_input)));
+    check_document(&document, small_input, strlen(small_input));
+    CHECK(count_chunks(document.arena.chunks) + count_chunks(document.arena.spare) == chunks);
+
+    /* The large document again, in the same chunks. */
+    CHECK(reload(&document, input, length));
+    check_document(&document, input, length);
+    CHECK(count_chunks(document.arena.chunks) + count_chunks(document.arena.spare) == chunks);
+
+    json_document_delete(&document);
+    free(input);
+}
+
+/*
+ * The documents of a stream, each reloaded into the same document.
+ */
+static void test_stream(void) {
+    static const char *documents[] = {"[1,2,3]", "{\"a\\t\":\"\\u00e9\"}", "\"x\\ny\"", "[[[[{}]]]]", "null"};
+    JsonDocument document;
+    JsonParser parser;
+    TestText input = {NULL, 0, 0};
+    size_t i;
+
+    for (i = 0; i < sizeof(documents) / sizeof(documents[0]); i++) {
+        test_text_append(&input, documents[i], strlen(documents[i]));
+        test_text_append(&input, "\n", 1);
+    }
+
+    json_parser_initialize(&parser);
+    json_parser_set_stream_flags(&parser, JSON_MULTI_DOCUMENT_FLAG);
+    json_parser_set_input_string(&parser, (const unsigned char *)input.start, input.length);
+    CHECK(json_document_initialize(&document));
+
+    for (i = 0; i < sizeof(documents) / sizeof(documents[0]); i++) {
+        CHECK(json_parser_reload(&parser, &document));
+        check_document(&document, documents[i], strlen(documents[i]));
+    }
+
+    /* The end of the stream leaves the document empty. */
+    CHECK(json_parser_reload(&parser, &document));
+    CHECK(count_nodes(&document) == 0);
+
+    json_parser_delete(&parser);
+    json_document_delete(&document);
+    test_text_clear(&input);
+}
+
+/*
+ * A failed reload leaves the document empty, ready for the next one; a
+ * deleted document is reloaded too.
+ */
+static void test_failure(void) {
+    static const char *malformed = "{\"a\":[1,2,\"\\x\"]}";
+    JsonDocument document;
+
+    CHECK(json_document_initialize(&document));
+    CHECK(reload(&document, small_input, strlen(small_input)));
+
+    CHECK(!reload(&document, malformed, strlen(malformed)));
+    CHECK(count_nodes(&document) == 0);
+    CHECK(json_document_get_root_node(&document) == NULL);
+
+    CHECK(reload(&document, small_input, strlen(small_input)));
+    check_document(&document, small_input, strlen(small_input));
+
+    json_document_delete(&document);
+    CHECK(reload(&document, "[true]", 6));
+    check_document(&document, "[true]", 6);
+
+    json_document_delete(&document);
+}
+
+int main(void) {
+    test_smaller();
+    test_stream();
+    test_failure();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,165 @@
+/**
+ * @file test_skip.c
+ * @brief json_parser_skip_value skips a container without its events, from
+ * anywhere inside it and however far its closing bracket is, and so does a
+ * cursor stepping over a value.
+ */
+
+#include "test.h"
+
+/*
+ * Parse up to the `skip_at`-th container start and `after` more events, skip
+ * the container the parser is in, and trace the rest.  The input is read from
+ * a file if `file` is not NULL.
+ */
+static char *trace_input(const char *input, size_t length, FILE *file, int skip_at, int after) {
+    JsonParser parser;
+    JsonEvent event;
+    TestText text = {NULL, 0, 0};
+    int starts = 0, result = MYJSON_SUCCESS;
+
+    test_text_append(&text, "", 0);
+    json_parser_initialize(&parser);
+    if (file) {
+        fwrite(input, 1, length, file);
+        rewind(file);
+        json_parser_set_input_file(&parser, file);
+    } else {
+        json_parser_set_input_string(&parser, (const unsigned char *)input, length);
+    }
+
+    while ((starts < skip_at || after-- > 0) && (result = json_parser_parse(&parser, &event))) {
+        test_trace_event(&text, &event);
+        if (event.type == JSON_ARRAY_START_EVENT || event.type == JSON_OBJECT_START_EVENT) {
+            starts++;
+        }
+        json_event_delete(&event);
+    }
+
+    if (result && json_parser_skip_value(&parser)) {
+        test_text_append(&text, "~", 1);
+        test_trace_parser(&parser, &text);
+    } else {
+        test_text_append(&text, "!", 1);
+    }
+
+    json_parser_delete(&parser);
+
+    return text.start;
+}
+
+static char *trace_skip(const char *input, int skip_at) {
+    return trace_input(input, strlen(input), NULL, skip_at, 0);
+}
+
+static void test_skip(void) {
+    char *trace;
+
+    trace = trace_skip("[1,[2,[3],\"]\"],{\"a\":[4]},5]", 2);
+    CHECK_STRING(trace, "(<[i:1 [~{s:a [i:4 ]}i:5 ]>)");
+    free(trace);
+
+    trace = trace_skip("{\"a\":{\"b\":{\"c\":[]}},\"d\":2}", 2);
+    CHECK_STRING(trace, "(<{s:a {~s:d i:2 }>)");
+    free(trace);
+
+    trace = trace_skip("[[1,2,3]]", 1);
+    CHECK_STRING(trace, "(<[~>)");
+    free(trace);
+
+    trace = trace_skip("[[1,2}],3]", 2);
+    CHECK(trace[strlen(trace) - 1] == '!');
+    free(trace);
+}
+
+/*
+ * A container of `count` items, each with a few structurals and a bracket in
+ * a string, so that the larger ones are not indexed at once.
+ */
+static void make_container(TestText *input, const char *head, size_t count, const char *tail) {
+    size_t i;
+
+    test_text_append(input, head, strlen(head));
+    for (i = 0; i < count; i++) {
+        test_text_append(input, "[1,{\"a\":\"]\"}],\n", 15);
+    }
+    test_text_append(input, "0", 1);
+    test_text_append(input, tail, strlen(tail));
+}
+
+static void check_large(const char *tail, size_t count, int after, const char *expected) {
+    TestText input = {NULL, 0, 0};
+    char *trace;
+    FILE *file;
+
+    make_container(&input, "[[", count, tail);
+
+    trace = trace_input(input.start, input.length, NULL, 2, after);
+    if (strcmp(trace, expected)) {
+        fprintf(stderr, "%zu items, string\n", count);
+        CHECK_STRING(trace, expected);
+    }
+    free(trace);
+
+    file = tmpfile();
+    if (file) {
+        trace = trace_input(input.start, input.length, file, 2, after);
+        if (strcmp(trace, expected)) {
+            fprintf(stderr, "%zu items, file\n", count);
+            CHECK_STRING(trace, expected);
+        }
+        free(trace);
+        fclose(file);
+    }
+
+    test_text_clear(&input);
+}
+
+static void test_large(void) {
+    static const size_t counts[] = {1, 100, 1000, 10000, 100000};
+    size_t i;
+
+    for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        /* From the start of the container, and from after its first item. */
+        check_large("],2]", counts[i], 0, "(<[[~i:2 ]>)");
+        check_large("],2]", counts[i], 7, "(<[[[i:1 {s:a s:] }]~i:2 ]>)");
+
+        /* A closing bracket of the other kind, or none. */
+        check_large("}]", counts[i], 0, "(<[[!");
+        check_large("", counts[i], 7, "(<[[[i:1 {s:a s:] }]!");
+    }
+}
+
+static void test_cursor(void) {
+    static const size_t counts[] = {1, 1000, 100000};
+    TestText input = {NULL, 0, 0};
+    JsonParser parser;
+    JsonCursor cursor;
+    int64_t integer;
+    size_t i;
+
+    for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        make_container(&input, "{\"a\":[", counts[i], "],\"b\":2}");
+
+        json_parser_initialize(&parser);
+        json_parser_set_input_string(&parser, (const unsigned char *)input.start, input.length);
+        CHECK(json_cursor_initialize(&cursor, &parser));
+        CHECK(json_cursor_enter(&cursor));
+        CHECK(json_cursor_next(&cursor));
+        CHECK(json_cursor_get_int64(&cursor, &integer) && integer == 2);
+        CHECK(!json_cursor_next(&cursor));
+        CHECK(parser.error.type == JSON_NO_ERROR);
+        json_cursor_delete(&cursor);
+        json_parser_delete(&parser);
+
+        test_text_clear(&input);
+    }
+}
+
+int main(void) {
+    test_skip();
+    test_large();
+    test_cursor();
+
+    return TEST_RESULT();
+}
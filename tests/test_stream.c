@@ -0,0 +1,120 @@
+/**
+ * @file test_stream.c
+ * @brief Multi-document streams, and the resynchronization on the next line
+ * after an error.
+ */
+
+#include "test.h"
+
+typedef struct TestCase {
+    int flags;            /**< The stream flags. */
+    const char *input;    /**< The input. */
+    const char *expected; /**< The trace of its events, with @c ! for each error. */
+} TestCase;
+
+static const TestCase cases[] = {
+    {0, "{}{}", "(<{}>!"},
+    {JSON_MULTI_DOCUMENT_FLAG, "", "()"},
+    {JSON_MULTI_DOCUMENT_FLAG, " \n ", "()"},
+    {JSON_MULTI_DOCUMENT_FLAG, "{}{}", "(<{}><{}>)"},
+    {JSON_MULTI_DOCUMENT_FLAG, "1 2\n3", "(<i:1 ><i:2 ><i:3 >)"},
+    {JSON_MULTI_DOCUMENT_FLAG, "[1,\n2]\n\"x\"", "(<[i:1 i:2 ]><s:x >)"},
+    {JSON_MULTI_DOCUMENT_FLAG, "{\"a\":1}\n{bad\n[2]\n", "(<{s:a i:1 }><{!"},
+    {JSON_MULTI_DOCUMENT_FLAG, "{}x", "(<{}!"},
+    {JSON_RESYNC_FLAG, "{\"a\":1}\n{bad\n[2]\n", "(<{s:a i:1 }><{!<[i:2 ]>)"},
+    {JSON_RESYNC_FLAG, "1\n2 x\n4", "(<i:1 ><i:2 !<i:4 >)"},
+    {JSON_RESYNC_FLAG, "tru\nfalse\n", "(!<b:false >)"},
+    {JSON_RESYNC_FLAG, "[1]\n[\n\n", "(<[i:1 ]><[!)"},
+    {JSON_RESYNC_FLAG, "{\"a\":\n1}\n\"z\"", "(<{s:a i:1 }><s:z >)"},
+    {JSON_RESYNC_FLAG, "x\ny\nz\n[]", "(!!!<[]>)"},
+};
+
+/*
+ * Trace a stream, carrying on after the errors if the parser resyncs.
+ */
+static char *trace_stream(const char *input, int flags) {
+    JsonParser parser;
+    JsonEvent event;
+    TestText text = {NULL, 0, 0};
+    size_t errors = 0;
+    int done = 0;
+
+    test_text_append(&text, "", 0);
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+    CHECK(json_parser_set_stream_flags(&parser, flags));
+
+    while (!done) {
+        if (!json_parser_parse(&parser, &event)) {
+            test_text_append(&text, "!", 1);
+            if (!(flags & JSON_RESYNC_FLAG) || ++errors > 10) {
+                break;
+            }
+            continue;
+        }
+        test_trace_event(&text, &event);
+        done = event.type == JSON_STREAM_END_EVENT;
+        json_event_delete(&event);
+    }
+
+    json_parser_delete(&parser);
+
+    return text.start;
+}
+
+static void test_cases(void) {
+    size_t i;
+
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        char *trace = trace_stream(cases[i].input, cases[i].flags);
+
+        CHECK_STRING(trace, cases[i].expected);
+        free(trace);
+    }
+}
+
+static void test_load(void) {
+    static const char *expected[] = {"[1]", "{\"a\":\"b\"}", "3"};
+    const char *input = "[1]\n{bad\n{\"a\":\"b\"}\n\n3\n";
+    JsonParser parser;
+    JsonDocument document;
+    size_t loaded = 0, errors = 0;
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+    json_parser_set_stream_flags(&parser, JSON_RESYNC_FLAG);
+
+    while (loaded + errors < 10) {
+        char *text;
+
+        if (!json_parser_load(&parser, &document)) {
+            errors++;
+            continue;
+        }
+        if (!json_document_get_root_node(&document)) {
+            json_document_delete(&document);
+            break;
+        }
+
+        text = test_write_document(&document);
+        CHECK(loaded < 3);
+        if (loaded < 3) {
+            CHECK_STRING(text, expected[loaded]);
+        }
+        free(text);
+        json_document_delete(&document);
+        loaded++;
+    }
+
+    CHECK(loaded == 3);
+    CHECK(errors == 1);
+
+    json_parser_delete(&parser);
+}
+
+int main(void) {
+    test_cases();
+    test_load();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,248 @@
+/**
+ * @file test_tape.c
+ * @brief A tape holds the values of the document loaded from the same input,
+ * with its strings decoded, and skips a container at once.
+ */
+
+#include "test.h"
+
+#define TAPE_WORDS(tape) ((size_t)((tape)->words.top - (tape)->words.start))
+
+static size_t compare_value(const JsonTape *tape, size_t index, JsonDocument *document, int node_id);
+
+/*
+ * Compare a string of a tape with the one of a node.
+ */
+static void compare_string(const JsonTape *tape, size_t index, const JsonNode *node) {
+    size_t length = 0;
+    const JsonChar_t *value = json_tape_get_string(tape, index, &length);
+
+    CHECK(json_tape_get_type(tape, index) == JSON_TAPE_STRING);
+    CHECK(length == node->data.scalar.length && !memcmp(value, node->data.scalar.value, length));
+    CHECK(value[length] == '\0');
+}
+
+static size_t compare_container(const JsonTape *tape, size_t index, JsonDocument *document, int node_id) {
+    JsonNode *node = json_document_get_node(document, node_id);
+    size_t next = index + 1;
+    JsonNodeItem *item;
+    JsonNodePair *pair;
+
+    if (node->type == JSON_ARRAY) {
+        CHECK(json_tape_get_type(tape, index) == JSON_TAPE_ARRAY);
+        for (item = node->data.array.items.start; item < node->data.array.items.top && next; item++) {
+            next = compare_value(tape, next, document, *item);
+        }
+        CHECK(next && json_tape_get_type(tape, next) == JSON_TAPE_ARRAY_END);
+    } else {
+        CHECK(json_tape_get_type(tape, index) == JSON_TAPE_OBJECT);
+        for (pair = node->data.object.pairs.start; pair < node->data.object.pairs.top && next; pair++) {
+            JsonNode *key = json_document_get_node(document, pair->key);
+
+            compare_string(tape, next, key);
+
+            /* The first member with a key is found. */
+            if (json_document_object_get_value(document, node_id, key->data.scalar.value,
+                                               (int)key->data.scalar.length) == pair->value) {
+                CHECK(json_tape_find_field(tape, index, key->data.scalar.value, key->data.scalar.length) == next + 1);
+            }
+            next = compare_value(tape, next + 1, document, pair->value);
+        }
+        CHECK(next && json_tape_get_type(tape, next) == JSON_TAPE_OBJECT_END);
+    }
+
+    return next ? next + 1 : 0;
+}
+
+/*
+ * Compare the value at an index of a tape with a node.
+ *
+ * @returns the index after the value, or 0 on a difference.
+ */
+static size_t compare_value(const JsonTape *tape, size_t index, JsonDocument *document, int node_id) {
+    JsonNode *node = json_document_get_node(document, node_id);
+    JsonTapeType type = json_tape_get_type(tape, index);
+    size_t next;
+
+    if (!node || index >= TAPE_WORDS(tape)) {
+        CHECK(0);
+        return 0;
+    }
+
+    switch (node->type) {
+        case JSON_ARRAY:
+        case JSON_OBJECT:
+            next = compare_container(tape, index, document, node_id);
+            break;
+        case JSON_STRING:
+            compare_string(tape, index, node);
+            next = index + 1;
+            break;
+        case JSON_INTEGER:
+            if (node->data.scalar.flags & JSON_UNSIGNED_FLAG) {
+                CHECK(type == JSON_TAPE_UINT64);
+                CHECK((uint64_t)json_tape_get_int64(tape, index) == node->data.scalar.number.uinteger);
+            } else {
+                CHECK(type == JSON_TAPE_INT64);
+                CHECK(json_tape_get_int64(tape, index) == node->data.scalar.number.integer);
+                CHECK(json_tape_get_double(tape, index) == (double)node->data.scalar.number.integer);
+            }
+            next = index + 2;
+            break;
+        case JSON_DOUBLE:
+            CHECK(type == JSON_TAPE_DOUBLE);
+            CHECK(json_tape_get_double(tape, index) == node->data.scalar.number.real);
+            next = index + 2;
+            break;
+        case JSON_BOOLOEAN:
+            CHECK(type == (node->data.scalar.value[0] == 't' ? JSON_TAPE_TRUE : JSON_TAPE_FALSE));
+            next = index + 1;
+            break;
+        default:
+            CHECK(type == JSON_TAPE_NULL);
+            next = index + 1;
+            break;
+    }
+
+    if (next != json_tape_next(tape, index)) {
+        fprintf(stderr, "value %zu of type %c: next %zu, expected %zu\n", index, (char)type,
+                json_tape_next(tape, index), next);
+        CHECK(0);
+        return 0;
+    }
+
+    return next;
+}
+
+/*
+ * Load every document of an input as a tape and as a document, and compare
+ * them.
+ *
+ * @returns the number of documents.
+ */
+static size_t check_input(const char *input, size_t length, int stream_flags) {
+    JsonParser tapes, documents;
+    size_t count = 0;
+
+    json_parser_initialize(&tapes);
+    json_parser_initialize(&documents);
+    json_parser_set_stream_flags(&tapes, stream_flags);
+    json_parser_set_stream_flags(&documents, stream_flags);
+    json_parser_set_input_string(&tapes, (const unsigned char *)input, length);
+    json_parser_set_input_string(&documents, (const unsigned char *)input, length);
+
+    while (1) {
+        JsonDocument document;
+        JsonTape tape;
+        int loaded = json_parser_load(&documents, &document);
+
+        CHECK(json_parser_load_tape(&tapes, &tape) == loaded);
+        if (!loaded) {
+            break;
+        }
+        if (!json_document_get_root_node(&document)) {
+            CHECK(TAPE_WORDS(&tape) == 0);
+            json_tape_delete(&tape);
+            json_document_delete(&document);
+            break;
+        }
+
+        CHECK(compare_value(&tape, 0, &document, 1) == TAPE_WORDS(&tape));
+        json_tape_delete(&tape);
+        json_document_delete(&document);
+        count++;
+    }
+
+    json_parser_delete(&tapes);
+    json_parser_delete(&documents);
+
+    return count;
+}
+
+static void test_samples(void) {
+    static const char *names[] = {"twitter.json", "mesh.json", "random.json"};
+    size_t i, length;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        char *input = test_read_sample(names[i], &length);
+
+        CHECK(input != NULL);
+        if (!input) {
+            continue;
+        }
+        CHECK(check_input(input, length, 0) == 1);
+        free(input);
+    }
+}
+
+static void test_values(void) {
+    static const char *stream = "[] {} 1 -2.5e-3 \"x\" true false null [1,[2,[3]],{\"a\":{}}] "
+                                "{\"a\":1,\"a\":2,\"b\":[18446744073709551615,-9223372036854775808,1e400]}";
+
+    CHECK(check_input(stream, strlen(stream), JSON_MULTI_DOCUMENT_FLAG) == 10);
+}
+
+/*
+ * The strings and keys are decoded, and found by their decoded bytes.
+ */
+static void test_escaped(void) {
+    static const char *input = "{\"a\\\"b\":\"x\\u00e9\\n\\ud83d\\ude00\",\"\\/\":\"\\t\\\\\",\"\\u0000\":\"\"}";
+    JsonParser parser;
+    JsonTape tape;
+    const JsonChar_t *value;
+    size_t index, length;
+
+    CHECK(check_input(input, strlen(input), 0) == 1);
+
+    json_parser_initialize(&parser);
+    json_parser_set_input_string(&parser, (const unsigned char *)input, strlen(input));
+    CHECK(json_parser_load_tape(&parser, &tape));
+
+    index = json_tape_find_field(&tape, 0, (const JsonChar_t *)"a\"b", 3);
+    CHECK(index == 2);
+    value = json_tape_get_string(&tape, index, &length);
+    CHECK(length == 8 && !memcmp(value, "x\xC3\xA9\n\xF0\x9F\x98\x80", 8));
+
+    index = json_tape_find_field(&tape, 0, (const JsonChar_t *)"/", 1);
+    CHECK(index == 4);
+    value = json_tape_get_string(&tape, index, &length);
+    CHECK(length == 2 && !memcmp(value, "\t\\", 2));
+
+    /* A key with a NUL is found by its length. */
+    index = json_tape_find_field(&tape, 0, (const JsonChar_t *)"", 1);
+    CHECK(index == 6);
+    value = json_tape_get_string(&tape, index, &length);
+    CHECK(length == 0 && value[0] == '\0');
+
+    CHECK(json_tape_find_field(&tape, 0, (const JsonChar_t *)"a\\\"b", 4) == 0);
+    CHECK(json_tape_find_field(&tape, 0, (const JsonChar_t *)"", 0) == 0);
+
+    json_tape_delete(&tape);
+    json_parser_delete(&parser);
+}
+
+static void test_malformed(void) {
+    static const char *inputs[] = {"[1,{\"a\":x}]", "{\"a\":\"\\x\"}", "[[[]]", ""};
+    size_t i;
+
+    for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        JsonParser parser;
+        JsonTape tape;
+
+        json_parser_initialize(&parser);
+        json_parser_set_input_string(&parser, (const unsigned char *)inputs[i], strlen(inputs[i]));
+        CHECK(!json_parser_load_tape(&parser, &tape));
+        CHECK(parser.error.type != JSON_NO_ERROR);
+        CHECK(TAPE_WORDS(&tape) == 0);
+        json_parser_delete(&parser);
+    }
+}
+
+int main(void) {
+    test_samples();
+    test_values();
+    test_escaped();
+    test_malformed();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_utf8.c
+ * @brief The longest valid prefix found by json_validate_utf8, with every
+ * kernel, and the UTF-8 errors of the parser.
+ */
+
+#include "test.h"
+
+/*
+ * A plain validator to check the kernels against.
+ */
+static size_t reference_prefix(const unsigned char *text, size_t length) {
+    size_t i = 0;
+
+    while (i < length) {
+        unsigned char byte = text[i];
+        unsigned int code, minimum;
+        size_t width, k;
+
+        if (byte < 0x80) {
+            i++;
+            continue;
+        } else if ((byte & 0xE0) == 0xC0) {
+            width = 2, code = byte & 0x1F, minimum = 0x80;
+        } else if ((byte & 0xF0) == 0xE0) {
+            width = 3, code = byte & 0x0F, minimum = 0x800;
+        } else if ((byte & 0xF8) == 0xF0) {
+            width = 4, code = byte & 0x07, minimum = 0x10000;
+        } else {
+            return i;
+        }
+
+        if (i + width > length) {
+            return i;
+        }
+        for (k = 1; k < width; k++) {
+            if ((text[i + k] & 0xC0) != 0x80) {
+                return i;
+            }
+            code = (code << 6) | (text[i + k] & 0x3F);
+        }
+        if (code < minimum || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+            return i;
+        }
+
+        i += width;
+    }
+
+    return length;
+}
+
+typedef struct TestSequence {
+    const char *bytes; /**< The sequence. */
+    size_t length;     /**< The length of the sequence. */
+    int valid;         /**< Is it valid? */
+} TestSequence;
+
+static const TestSequence sequences[] = {
+    {"\x7F", 1, 1},
+    {"\xC2\x80", 2, 1},
+    {"\xDF\xBF", 2, 1},
+    {"\xE0\xA0\x80", 3, 1},
+    {"\xED\x9F\xBF", 3, 1},
+    {"\xEE\x80\x80", 3, 1},
+    {"\xEF\xBF\xBF", 3, 1},
+    {"\xF0\x90\x80\x80", 4, 1},
+    {"\xF4\x8F\xBF\xBF", 4, 1},
+    {"\x80", 1, 0},
+    {"\xBF", 1, 0},
+    {"\xC0\x80", 2, 0},
+    {"\xC1\xBF", 2, 0},
+    {"\xC2", 1, 0},
+    {"\xC2\x41", 2, 0},
+    {"\xE0\x80\x80", 3, 0},
+    {"\xE0\x9F\xBF", 3, 0},
+    {"\xED\xA0\x80", 3, 0},
+    {"\xED\xBF\xBF", 3, 0},
+    {"\xE2\x82", 2, 0},
+    {"\xF0\x80\x80\x80", 4, 0},
+    {"\xF0\x8F\xBF\xBF", 4, 0},
+    {"\xF4\x90\x80\x80", 4, 0},
+    {"\xF5\x80\x80\x80", 4, 0},
+    {"\xF0\x90\x80", 3, 0},
+    {"\xFE", 1, 0},
+    {"\xFF", 1, 0},
+};
+
+/*
+ * Every sequence, at every position of two 64-byte blocks, followed by
+ * ASCII or by the end of the text.
+ */
+static void test_sequences(void) {
+    unsigned char text[160];
+    size_t i, position, tail;
+
+    for (i = 0; i < sizeof(sequences) / sizeof(sequences[0]); i++) {
+        for (position = 0; position < 130; position++) {
+            for (tail = 0; tail < 2; tail++) {
+                size_t length = position + sequences[i].length + tail * 20;
+                size_t expected = sequences[i].valid ? length : position;
+                size_t prefix;
+
+                memset(text, 'a', sizeof(text));
+                memcpy(text + position, sequences[i].bytes, sequences[i].length);
+
+                CHECK(reference_prefix(text, length) == expected);
+                prefix = json_validate_utf8(text, length);
+                if (prefix != expected) {
+                    fprintf(stderr, "sequence %zu at %zu (%s): got %zu, expected %zu\n", i, position,
+                            json_kernel_get_name(json_kernel_get_selected()), prefix, expected);
+                    CHECK(0);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Random texts made mostly of valid characters, against the plain validator.
+ */
+static void test_random(void) {
+    static const char *pieces[] = {"a", " ", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xD0\x96", "\x80",
+                                   "\xED\xA0\x80", "\xC0\xAF", "\xF4\x90\x80\x80"};
+    unsigned char text[600];
+    unsigned int seed = 12345;
+    size_t round, length, piece;
+
+    for (round = 0; round < 2000; round++) {
+        length = 0;
+        while (length < 500) {
+            seed = seed * 1103515245 + 12345;
+            /* The invalid pieces are rare, so that some texts are valid. */
+            piece = (seed >> 16) % 1000 < 997 ? (seed >> 8) % 6 : 6 + (seed >> 4) % 4;
+            memcpy(text + length, pieces[piece], strlen(pieces[piece]));
+            length += strlen(pieces[piece]);
+        }
+
+        /* Cut the text anywhere, maybe in the middle of a character. */
+        length -= (seed >> 3) % 4;
+        CHECK(json_validate_utf8(text, length) == reference_prefix(text, length));
+    }
+}
+
+static void test_parser(void) {
+    static const char *valid = "[\"\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\"]";
+    static const char *invalid[] = {"[\"\xC3\"]", "[\"\xED\xA0\x80\"]", "[\"\xC0\xAF\"]", "[\"a\xFF\"]",
+                                    "[\"\xF4\x90\x80\x80\"]"};
+    size_t i;
+    char *trace;
+
+    trace = test_trace_string(valid, strlen(valid));
+    CHECK_STRING(trace, "(<[s:\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80 ]>)");
+    free(trace);
+
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        trace = test_trace_string(invalid[i], strlen(invalid[i]));
+        CHECK(trace[strlen(trace) - 1] == '!');
+        free(trace);
+    }
+}
+
+int main(void) {
+    size_t k;
+
+    for (k = 0; k < TEST_KERNEL_COUNT; k++) {
+        if (!json_kernel_select(test_kernels[k])) {
+            continue;
+        }
+        test_sequences();
+        test_random();
+        test_parser();
+    }
+    json_kernel_select(JSON_AUTO_KERNEL);
+
+    return TEST_RESULT();
+}